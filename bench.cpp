@@ -0,0 +1,392 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks of the simulation's hot paths and an end-to-end throughput benchmark.
+ *
+ * @details Built and run by @c "make bench", which compiles the simulation
+ * sources with optimisation into @c build/bench. Each benchmark repeats its
+ * body until it has run for at least @c MIN_SECONDS and reports the mean
+ * cost of one unit of work (a request, a value or a simulated cycle) and the
+ * resulting rate:
+ *  - @c firewall/rules=N — Firewall::filterRequests() on 64-request bursts
+ *    of random sources, with 3, 1000 and 100000 blocked ranges.
+ *  - @c dispatch/POLICY/servers=N — LoadBalancer::runCycle() on a pool kept
+ *    about 90% busy, per request dispatched. The O(n)-per-request policies,
+ *    and affinity, whose busy home servers fall back to a full scan, are
+ *    only run up to 1000 servers.
+ *  - @c queue/... — RequestQueue single and bulk push/pop throughput.
+ *  - @c generator/... — TrafficGenerator arrivals, per request generated.
+ *  - @c histogram/record — LatencyHistogram::record().
+ *  - @c simulation/... — runSimulation() on the default configuration with
+ *    logging off, per simulated cycle.
+ *
+ * Arguments are substring filters: @c "./bench firewall dispatch/first"
+ * runs only the benchmarks whose names contain either string. Workloads are
+ * drawn from fixed seeds, so runs are comparable with each other.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dispatchPolicy.h"
+#include "firewall.h"
+#include "latencyHistogram.h"
+#include "loadBalancer.h"
+#include "logger.h"
+#include "requestQueue.h"
+#include "rng.h"
+#include "simulation.h"
+#include "trafficGenerator.h"
+#include "webServer.h"
+
+/// Minimum measured time per benchmark, in seconds.
+static const double MIN_SECONDS = 0.25;
+
+/// Substring filters from the command line; empty selects everything.
+static std::vector<std::string> filters;
+
+/// Sink that keeps benchmark results observable so they are not optimised away.
+static volatile uint64_t sink;
+
+/**
+ * @brief Returns whether benchmark @p name passes the command-line filters.
+ * @param name Benchmark name.
+ * @return @c true if it should run.
+ */
+static bool selected(const std::string& name) {
+    if (filters.empty()) {
+        return true;
+    }
+    for (const std::string& filter : filters) {
+        if (name.find(filter) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs @p body once to warm up, then repeatedly for at least
+ *        @c MIN_SECONDS, and prints the cost per unit.
+ *
+ * @param name Benchmark name.
+ * @param unit Name of one unit of work, for the report.
+ * @param body Performs some work and returns how many units it did.
+ */
+static void measure(const std::string& name, const char* unit, const std::function<uint64_t()>& body) {
+    sink = sink + body();
+
+    uint64_t units = 0;
+    uint64_t calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed(0.0);
+    while (elapsed.count() < MIN_SECONDS) {
+        units += body();
+        calls++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    double seconds = elapsed.count();
+    double perUnit = units > 0 ? seconds * 1e9 / static_cast<double>(units) : 0.0;
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(1) << perUnit << " ns/" << std::left << std::setw(8) << unit
+              << std::right << std::setw(12) << std::setprecision(3) << static_cast<double>(units) / seconds / 1e6
+              << " M/s  (" << calls << " calls)" << std::endl;
+}
+
+/**
+ * @brief Pre-generates @p count requests from a default TrafficGenerator.
+ * @param count   Number of requests.
+ * @param jobType Job class of every request.
+ * @return The requests.
+ */
+static std::vector<Request> makeRequests(size_t count, char jobType) {
+    TrafficGenerator generator(TrafficProfile(), {jobType}, 42);
+    std::vector<Request> requests;
+    requests.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        requests.push_back(generator.makeRequest(jobType));
+    }
+    return requests;
+}
+
+/**
+ * @brief Formats a packed address and prefix length as CIDR text.
+ * @param network Network address.
+ * @param prefix  Prefix length.
+ * @return CIDR string.
+ */
+static std::string cidr(uint32_t network, int prefix) {
+    std::ostringstream text;
+    text << (network >> 24) << '.' << ((network >> 16) & 0xFF) << '.'
+         << ((network >> 8) & 0xFF) << '.' << (network & 0xFF) << '/' << prefix;
+    return text.str();
+}
+
+/**
+ * @brief Filters 64-request bursts through firewalls with 3, 1000 and 100000 rules.
+ *
+ * @details Beyond the Switch's three built-in ranges, rules are distinct
+ * random /16 to /28 networks. The DoS limiter is set high enough that the
+ * random sources are never banned, so every burst does the same work.
+ *
+ * @param logger Disabled logger.
+ */
+static void benchFirewall(Logger& logger) {
+    const size_t BURST = 64;
+    std::vector<Request> traffic = makeRequests(1 << 16, 'P');
+
+    for (size_t rules : {3, 1000, 100000}) {
+        std::string name = "firewall/rules=" + std::to_string(rules);
+        if (!selected(name)) {
+            continue;
+        }
+
+        Firewall firewall(INT_MAX, 20);
+        firewall.blockRange("10.0.0.0/8", false);
+        firewall.blockRange("172.16.0.0/12", false);
+        firewall.blockRange("192.168.0.0/16", false);
+        Rng rng(7);
+        std::set<std::pair<uint32_t, int>> added;
+        while (added.size() + 3 < rules) {
+            int prefix = 16 + static_cast<int>(rng.below(13));
+            uint32_t network = static_cast<uint32_t>(rng.next()) & (~0u << (32 - prefix));
+            if (added.insert({network, prefix}).second) {
+                firewall.blockRange(cidr(network, prefix), false);
+            }
+        }
+
+        size_t offset = 0;
+        int tick = 0;
+        std::vector<Request> batch;
+        measure(name, "request", [&]() {
+            uint64_t units = 0;
+            for (int i = 0; i < 64; i++) {
+                batch.assign(traffic.begin() + offset, traffic.begin() + offset + BURST);
+                offset = (offset + BURST) % traffic.size();
+                firewall.filterRequests(batch, tick++, logger);
+                units += BURST;
+            }
+            sink = sink + batch.size();
+            return units;
+        });
+    }
+}
+
+/**
+ * @brief Runs load-balancer cycles on pools of 10, 1000 and 100000 servers.
+ *
+ * @details Scaling is effectively disabled (thresholds 0 and 1e6, and a
+ * cooldown longer than the run) so the pool size stays fixed. Each cycle
+ * delivers @c servers / 6 requests, which keeps the pool about 90% busy at
+ * the default mean processing time of 5.5 cycles. One call is one cycle, so
+ * a slow policy on a large pool still finishes after a few cycles.
+ *
+ * @param logger Disabled logger.
+ */
+static void benchDispatch(Logger& logger) {
+    const struct {
+        DispatchPolicyKind kind;
+        const char* name;
+        size_t maxServers;
+    } POLICIES[] = {
+        {DispatchPolicyKind::FIRST_IDLE, "first-idle", 100000},
+        {DispatchPolicyKind::POWER_OF_TWO, "power-of-two", 100000},
+        {DispatchPolicyKind::LEAST_WORK, "least-work", 1000},
+        {DispatchPolicyKind::SHORTEST_EXPECTED_DELAY, "sed", 1000},
+        {DispatchPolicyKind::AFFINITY, "affinity", 1000},
+    };
+
+    for (const auto& policy : POLICIES) {
+        for (size_t servers : {10, 1000, 100000}) {
+            std::string name = std::string("dispatch/") + policy.name + "/servers=" + std::to_string(servers);
+            if (servers > policy.maxServers || !selected(name)) {
+                continue;
+            }
+
+            std::vector<WebServer> pool;
+            for (size_t i = 0; i < servers; i++) {
+                pool.push_back(WebServer(static_cast<int>(i)));
+            }
+            LoadBalancer balancer(std::queue<Request>(), pool, 'P', 0, 1000000, INT_MAX / 2);
+            balancer.setDispatchPolicy(makeDispatchPolicy(policy.kind, 1));
+
+            size_t perCycle = servers / 6 > 0 ? servers / 6 : 1;
+            std::vector<Request> traffic = makeRequests(perCycle * 64, 'P');
+            size_t offset = 0;
+            std::vector<Request> arrivals;
+            measure(name, "request", [&]() {
+                arrivals.assign(traffic.begin() + offset, traffic.begin() + offset + perCycle);
+                offset = (offset + perCycle) % traffic.size();
+                sink = sink + static_cast<uint64_t>(balancer.runCycle(&arrivals, logger));
+                return static_cast<uint64_t>(perCycle);
+            });
+        }
+    }
+}
+
+/**
+ * @brief Measures RequestQueue push/pop one at a time and in blocks of 64.
+ *
+ * @details The queue is kept about 1024 deep so both ends of the ring move
+ * without reallocating.
+ */
+static void benchQueue() {
+    std::vector<Request> traffic = makeRequests(4096, 'P');
+
+    if (selected("queue/push-pop")) {
+        RequestQueue queue;
+        for (size_t i = 0; i < 1024; i++) {
+            queue.push(traffic[i]);
+        }
+        measure("queue/push-pop", "request", [&]() {
+            uint64_t checksum = 0;
+            for (const Request& request : traffic) {
+                queue.push(request);
+                checksum += queue.front().getIPin();
+                queue.pop();
+            }
+            sink = sink + checksum;
+            return static_cast<uint64_t>(traffic.size());
+        });
+    }
+
+    if (selected("queue/bulk-64")) {
+        RequestQueue queue;
+        queue.enqueue(traffic.data(), 1024);
+        std::vector<Request> out(64);
+        measure("queue/bulk-64", "request", [&]() {
+            for (size_t i = 0; i < traffic.size(); i += 64) {
+                queue.enqueue(traffic.data() + i, 64);
+                queue.dequeue(out.data(), 64);
+            }
+            sink = sink + out[0].getIPin();
+            return static_cast<uint64_t>(traffic.size());
+        });
+    }
+}
+
+/**
+ * @brief Generates arrivals with each arrival process and with Pareto process times.
+ */
+static void benchGenerator() {
+    const struct {
+        const char* name;
+        ArrivalProcess arrivals;
+        ServiceDistribution service;
+    } PROFILES[] = {
+        {"generator/bernoulli", ArrivalProcess::BERNOULLI, ServiceDistribution::UNIFORM},
+        {"generator/poisson", ArrivalProcess::POISSON, ServiceDistribution::UNIFORM},
+        {"generator/mmpp", ArrivalProcess::MMPP, ServiceDistribution::UNIFORM},
+        {"generator/poisson-pareto", ArrivalProcess::POISSON, ServiceDistribution::PARETO},
+    };
+
+    for (const auto& entry : PROFILES) {
+        if (!selected(entry.name)) {
+            continue;
+        }
+        TrafficProfile profile;
+        profile.arrivals = entry.arrivals;
+        profile.service = entry.service;
+        TrafficGenerator generator(profile, {'P', 'S'}, 1);
+
+        int tick = 0;
+        std::vector<Request> out;
+        measure(entry.name, "request", [&]() {
+            int end = tick + 1000;
+            out.clear();
+            for (tick = generator.nextArrival(tick, end); tick < end; tick = generator.nextArrival(tick, end)) {
+                generator.takeArrivals(tick, out);
+                tick++;
+            }
+            tick = end;
+            return static_cast<uint64_t>(out.size());
+        });
+    }
+}
+
+/**
+ * @brief Records latency values spread over the histogram's range.
+ */
+static void benchHistogram() {
+    if (!selected("histogram/record")) {
+        return;
+    }
+    Rng rng(3);
+    std::vector<int> values(4096);
+    for (int& value : values) {
+        value = static_cast<int>(rng.below(1u << static_cast<int>(rng.below(16))));
+    }
+    LatencyHistogram histogram;
+    measure("histogram/record", "value", [&]() {
+        for (int value : values) {
+            histogram.record(value);
+        }
+        sink = sink + histogram.count();
+        return static_cast<uint64_t>(values.size());
+    });
+}
+
+/**
+ * @brief Runs complete default simulations with logging off.
+ *
+ * @param logger Disabled logger.
+ */
+static void benchSimulation(Logger& logger) {
+    const struct {
+        const char* name;
+        const char* key;
+        const char* value;
+    } MODES[] = {
+        {"simulation/tick", "Simulation Mode", "tick"},
+        {"simulation/event", "Simulation Mode", "event"},
+        {"simulation/parallel", "Parallel Load Balancers", "on"},
+    };
+
+    for (const auto& mode : MODES) {
+        if (!selected(mode.name)) {
+            continue;
+        }
+        SimulationConfig config;
+        config.quiet = true;
+        config.settings[mode.key] = mode.value;
+        measure(mode.name, "cycle", [&]() {
+            SimulationSummary summary = runSimulation(config, logger);
+            sink = sink + summary.completed;
+            return static_cast<uint64_t>(config.clockCycles);
+        });
+    }
+}
+
+/**
+ * @brief Runs every selected benchmark in a fixed order.
+ *
+ * @param argc Argument count.
+ * @param argv Substring filters.
+ * @return 0.
+ */
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        filters.push_back(argv[i]);
+    }
+
+    Logger logger("", LogLevel::OFF, false);
+    benchFirewall(logger);
+    benchDispatch(logger);
+    benchQueue();
+    benchGenerator();
+    benchHistogram();
+    benchSimulation(logger);
+    return 0;
+}
@@ -0,0 +1,1051 @@
+/**
+ * @file check.cpp
+ * @brief Randomised consistency checks of the simulation's data structures.
+ *
+ * @details Built and run by @c "make check", which compiles the simulation
+ * sources into @c build/check. Each check drives a component with
+ * pseudo-random operations and compares it with a reference, printing one
+ * @c PASS or @c FAIL line:
+ *  - @c snapshot/balancer/servers=N — a LoadBalancer saved after a few
+ *    hundred cycles of bursty traffic restores to the same state, and the
+ *    original and the copy stay identical when run on.
+ *  - @c snapshot/affinity/servers=N — the same with the affinity policy and
+ *    local queues, whose table length depends on how the pool has grown
+ *    and shrunk.
+ *  - @c dispatch/<policy> — on random pools of idle, busy and retired
+ *    servers with local queues, first-idle, least-work, power-of-two and
+ *    sed each pick a server that can accept, and the scanning policies
+ *    pick the one their rule ranks best.
+ *  - @c dispatch/affinity — each source address keeps its server, and
+ *    adding or retiring one server moves few of the other addresses.
+ *  - @c queue/drr — two always-backlogged classes of weights 1 and 3
+ *    receive processing time in that ratio, to within one turn.
+ *  - @c queue/sjf — under random pushes and pops, every pop returns the
+ *    shortest waiting job, earliest first among equals.
+ *  - @c shed/tail-drop, @c shed/drop-oldest — a bounded queue fed random
+ *    bursts keeps the same requests as a reference and counts the same drops.
+ *  - @c shed/codel — a standing queue is dropped from on the ticks CoDel's
+ *    control law schedules.
+ *  - @c histogram/percentiles — percentiles of random latencies, recorded
+ *    into two histograms and merged, match the exact nearest-rank values to
+ *    the histogram's 1/64 resolution.
+ *  - @c ring/requestQueue — random single and bulk pushes and pops, which
+ *    wrap the ring and grow it while wrapped, leave the same contents as a
+ *    std::deque.
+ *  - @c ipTable/map — random inserts, erasures and eraseIf() sweeps leave
+ *    an IpTable with the same entries as a std::map.
+ *  - @c prefixTrie/lookup — longest-prefix lookups of random addresses
+ *    agree with a linear scan of the registered prefixes.
+ *  - @c firewall/fixed, @c firewall/sliding, @c firewall/token — each
+ *    rate-limit mode passes and bans the requests its algorithm allows for.
+ *  - @c trace/jsonl, @c trace/binary — small traces written to the temporary
+ *    directory replay the expected requests on the expected ticks and count
+ *    the malformed records.
+ *
+ * Arguments are substring filters, as for the benchmarks. The exit status
+ * is 1 if any check failed.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "dispatchPolicy.h"
+#include "firewall.h"
+#include "ipTable.h"
+#include "latencyHistogram.h"
+#include "loadBalancer.h"
+#include "loadShedder.h"
+#include "prefixTrie.h"
+#include "logger.h"
+#include "requestQueue.h"
+#include "rng.h"
+#include "schedulingQueue.h"
+#include "serverPool.h"
+#include "snapshot.h"
+#include "traceReader.h"
+#include "trafficGenerator.h"
+#include "webServer.h"
+
+/// Substring filters from the command line; empty selects everything.
+static std::vector<std::string> filters;
+
+/// Number of checks that failed.
+static int failures;
+
+/**
+ * @brief Returns whether check @p name passes the command-line filters.
+ * @param name Check name.
+ * @return @c true if it should run.
+ */
+static bool selected(const std::string& name) {
+    if (filters.empty()) {
+        return true;
+    }
+    for (const std::string& filter : filters) {
+        if (name.find(filter) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Prints the outcome of one check and counts a failure.
+ * @param name   Check name.
+ * @param ok     Whether it passed.
+ * @param detail What went wrong, printed on failure.
+ */
+static void report(const std::string& name, bool ok, const std::string& detail = std::string()) {
+    if (ok) {
+        std::cout << "PASS " << name << std::endl;
+    } else {
+        std::cout << "FAIL " << name << ": " << detail << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * @brief Returns a balancer's snapshot payload.
+ * @param balancer Balancer to save.
+ * @return Bytes written by LoadBalancer::saveState().
+ */
+static std::string saved(const LoadBalancer& balancer) {
+    SnapshotWriter out;
+    balancer.saveState(out);
+    return out.payload();
+}
+
+/**
+ * @brief Saves and restores balancers of 10 to 200 servers.
+ *
+ * @details Traffic alternates between bursts and quiet spells, so the pool
+ * scales both ways and leaves retired slots behind. Pools of more than 32
+ * servers reserve more than 64 slots up front, which spans several words
+ * of the pool's bitmaps. The affinity runs also use two-deep local queues,
+ * and the save falls after a quiet spell, when the pool has shrunk but the
+ * policy may still hold the table length it chose while the pool was large.
+ *
+ * @param logger Disabled logger.
+ */
+static void checkSnapshot(Logger& logger) {
+    for (bool affinity : {false, true})
+    for (size_t servers : {10, 33, 100, 200}) {
+        std::string name = std::string(affinity ? "snapshot/affinity" : "snapshot/balancer") + "/servers=" + std::to_string(servers);
+        if (!selected(name)) {
+            continue;
+        }
+
+        auto make = [&]() {
+            std::vector<WebServer> pool;
+            for (size_t i = 0; i < servers; i++) {
+                pool.push_back(WebServer(static_cast<int>(i)));
+            }
+            LoadBalancer balancer(std::queue<Request>(), pool, 'P', 50, 80, 5);
+            if (affinity) {
+                balancer.setDispatchPolicy(makeDispatchPolicy(DispatchPolicyKind::AFFINITY, 1));
+                balancer.setLocalQueueDepth(2);
+            }
+            return balancer;
+        };
+        TrafficGenerator generator(TrafficProfile(), {'P'}, 7);
+        Rng rng(11);
+        auto arrivals = [&](int cycle) {
+            std::vector<Request> batch;
+            size_t count = (cycle / 100) % 2 == 0 ? rng.below(static_cast<uint32_t>(servers)) : rng.below(3);
+            for (size_t i = 0; i < count; i++) {
+                batch.push_back(generator.makeRequest('P'));
+            }
+            return batch;
+        };
+
+        LoadBalancer original = make();
+        int cycle = 0;
+        for (; cycle < 500; cycle++) {
+            std::vector<Request> batch = arrivals(cycle);
+            original.runCycle(&batch, logger);
+        }
+
+        // Restoring unwraps the queue's ring, so payloads are compared after
+        // one more round trip, which leaves them in that canonical layout.
+        auto restored = [&](const std::string& payload, LoadBalancer& into) {
+            SnapshotReader in(payload.data(), payload.size());
+            return into.restoreState(in) && in.remaining() == 0;
+        };
+        auto canonical = [&](const LoadBalancer& balancer) {
+            LoadBalancer scratch = make();
+            return restored(saved(balancer), scratch) ? saved(scratch) : std::string();
+        };
+
+        LoadBalancer copy = make();
+        if (!restored(saved(original), copy)) {
+            report(name, false, "restore rejected its own snapshot");
+            continue;
+        }
+        if (canonical(copy) != canonical(original)) {
+            report(name, false, "restored state differs from the saved state");
+            continue;
+        }
+
+        for (; cycle < 800; cycle++) {
+            std::vector<Request> batch = arrivals(cycle);
+            std::vector<Request> same = batch;
+            original.runCycle(&batch, logger);
+            copy.runCycle(&same, logger);
+        }
+        report(name, canonical(copy) == canonical(original), "runs diverged after the restore");
+    }
+}
+
+/**
+ * @brief Fills @p pool with up to 40 servers in random states.
+ *
+ * @details About one server in eight is retired, and most of the rest are
+ * busy until a random tick with a random number of requests in their local
+ * queues, which are up to two deep.
+ *
+ * @param rng       Random stream.
+ * @param pool      Empty pool to fill.
+ * @param clockTime Tick the pool is inspected at.
+ */
+static void randomPool(Rng& rng, ServerPool& pool, int clockTime) {
+    pool.setLocalQueueDepth(rng.below(3));
+    size_t servers = 1 + rng.below(40);
+    for (size_t i = 0; i < servers; i++) {
+        pool.add(static_cast<int>(i));
+    }
+    for (size_t i = 0; i < servers; i++) {
+        uint32_t roll = rng.below(8);
+        if (roll == 0) {
+            pool.retire(i);
+        } else if (roll < 6) {
+            pool.assign(i, Request(0, 0, 1 + static_cast<int>(rng.below(20)), 'P'), clockTime + 1 + static_cast<int>(rng.below(20)));
+            size_t queued = rng.below(static_cast<uint32_t>(pool.getLocalQueueDepth() + 1));
+            for (size_t j = 0; j < queued; j++) {
+                pool.pushLocal(i, Request(0, 0, 1 + static_cast<int>(rng.below(20)), 'P'));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks each load-aware policy's choice against its rule on random pools.
+ *
+ * @details First-idle must return the lowest idle live slot, least-work a
+ * slot of minimum outstanding work and sed one of minimum expected delay.
+ * Power-of-two samples, so it is only required to return a slot that can
+ * accept whenever one exists. Every policy returns -1 exactly when no slot
+ * can accept, except first-idle, which ignores local queues and returns -1
+ * whenever no server is idle.
+ */
+static void checkDispatch() {
+    const char* policies[] = {"first-idle", "least-work", "power-of-two", "sed"};
+    for (const char* policyName : policies) {
+        std::string name = std::string("dispatch/") + policyName;
+        if (!selected(name)) {
+            continue;
+        }
+
+        DispatchPolicyKind kind = DispatchPolicyKind::FIRST_IDLE;
+        parseDispatchPolicy(policyName, kind);
+        std::unique_ptr<DispatchPolicy> policy = makeDispatchPolicy(kind, 5);
+        Rng rng(13);
+        const int clockTime = 100;
+        std::string failure;
+
+        for (int trial = 0; trial < 2000 && failure.empty(); trial++) {
+            ServerPool pool;
+            randomPool(rng, pool, clockTime);
+            Request request(0, 0, 1 + static_cast<int>(rng.below(20)), 'P');
+            long choice = policy->selectServer(pool, request, clockTime);
+
+            if (choice < 0) {
+                bool capacity = kind == DispatchPolicyKind::FIRST_IDLE ? pool.firstIdle() >= 0 : pool.hasCapacity();
+                if (capacity) {
+                    failure = "returned -1 while a server could accept";
+                }
+                continue;
+            }
+            size_t chosen = static_cast<size_t>(choice);
+            if (chosen >= pool.slotCount() || !pool.canAccept(chosen)) {
+                failure = "chose slot " + std::to_string(choice) + ", which cannot accept";
+                continue;
+            }
+
+            for (size_t i = 0; i < pool.slotCount() && failure.empty(); i++) {
+                if (!pool.canAccept(i)) {
+                    continue;
+                }
+                bool better = false;
+                if (kind == DispatchPolicyKind::FIRST_IDLE) {
+                    better = pool.isIdle(i) && i < chosen;
+                } else if (kind == DispatchPolicyKind::LEAST_WORK) {
+                    better = pool.outstandingWork(i, clockTime) < pool.outstandingWork(chosen, clockTime);
+                } else if (kind == DispatchPolicyKind::SHORTEST_EXPECTED_DELAY) {
+                    auto delay = [&](size_t slot) {
+                        float mean = pool.serviceEstimate(slot) > 0.0f ? pool.serviceEstimate(slot)
+                                                                       : static_cast<float>(request.getProcessTime());
+                        return static_cast<float>(pool.outstandingRequests(slot) + 1) * mean;
+                    };
+                    better = delay(i) < delay(chosen);
+                }
+                if (better) {
+                    failure = "chose slot " + std::to_string(choice) + " over better slot " + std::to_string(i);
+                }
+            }
+        }
+        report(name, failure.empty(), failure);
+    }
+}
+
+/**
+ * @brief Checks that AffinityPolicy keeps sources on their servers across scaling.
+ *
+ * @details With every server idle each address is sent to its home server.
+ * Adding a 51st server should move about 1/51 of the addresses, and
+ * retiring one should move little more than the addresses it owned; twice
+ * those shares are allowed.
+ */
+static void checkAffinity() {
+    const std::string name = "dispatch/affinity";
+    if (!selected(name)) {
+        return;
+    }
+
+    const size_t servers = 50;
+    const uint32_t sources = 5000;
+    ServerPool pool;
+    for (size_t i = 0; i < servers; i++) {
+        pool.add(static_cast<int>(i));
+    }
+    AffinityPolicy policy;
+    Rng rng(17);
+    std::vector<uint32_t> addresses(sources);
+    for (uint32_t& address : addresses) {
+        address = static_cast<uint32_t>(rng.next());
+    }
+    auto route = [&]() {
+        std::vector<long> homes;
+        for (uint32_t address : addresses) {
+            homes.push_back(policy.selectServer(pool, Request(address, 0, 5, 'P'), 0));
+        }
+        return homes;
+    };
+    auto moved = [&](const std::vector<long>& before, const std::vector<long>& after, long ignore) {
+        size_t count = 0;
+        for (size_t i = 0; i < before.size(); i++) {
+            count += before[i] != ignore && before[i] != after[i];
+        }
+        return count;
+    };
+
+    std::vector<long> homes = route();
+    for (long home : homes) {
+        if (home < 0) {
+            report(name, false, "left a request queued with every server idle");
+            return;
+        }
+    }
+    if (route() != homes) {
+        report(name, false, "routed an address to a different server without a scaling step");
+        return;
+    }
+
+    pool.add(static_cast<int>(servers));
+    std::vector<long> grown = route();
+    size_t movedByAdd = moved(homes, grown, -1);
+    if (movedByAdd > 2 * sources / (servers + 1)) {
+        report(name, false, "adding one server moved " + std::to_string(movedByAdd) + " of " + std::to_string(sources) + " addresses");
+        return;
+    }
+
+    pool.retire(7);
+    std::vector<long> shrunk = route();
+    size_t movedByRetire = moved(grown, shrunk, 7);
+    report(name, movedByRetire <= 2 * sources / servers,
+           "retiring one server moved " + std::to_string(movedByRetire) + " addresses it did not own");
+}
+
+/**
+ * @brief Checks that deficit round robin shares processing time by weight.
+ *
+ * @details Class 0 holds jobs of 1-5 cycles and class 1 jobs of 6-10, with
+ * weights 1 and 3 and a quantum of 10. Both classes stay backlogged, so
+ * after every pop class 1 should have received three times class 0's
+ * time, give or take one turn of each class.
+ */
+static void checkDrr() {
+    const std::string name = "queue/drr";
+    if (!selected(name)) {
+        return;
+    }
+
+    const int quantum = 10;
+    SchedulingQueue queue;
+    queue.configure(QueueDiscipline::DRR, {5}, {1, 3}, quantum);
+    Rng rng(19);
+    size_t waiting[2] = {0, 0};
+    auto refill = [&]() {
+        for (size_t cls = 0; cls < 2; cls++) {
+            for (; waiting[cls] < 100; waiting[cls]++) {
+                int time = static_cast<int>(1 + 5 * cls + rng.below(5));
+                queue.push(Request(0, 0, time, 'P'));
+            }
+        }
+    };
+
+    int64_t served[2] = {0, 0};
+    const int64_t slack = (1 + 3) * quantum + 10;
+    for (int pop = 0; pop < 20000; pop++) {
+        refill();
+        const Request& next = queue.front();
+        size_t cls = queue.classOf(next);
+        served[cls] += next.getProcessTime();
+        waiting[cls]--;
+        queue.pop();
+
+        int64_t imbalance = 3 * served[0] - served[1];
+        if (imbalance > slack || -imbalance > slack) {
+            report(name, false, "classes served " + std::to_string(served[0]) + " and " + std::to_string(served[1])
+                                + " cycles after " + std::to_string(pop + 1) + " pops");
+            return;
+        }
+    }
+    report(name, true);
+}
+
+/**
+ * @brief Checks shortest-job-first order against an ordered reference.
+ *
+ * @details Processing times stay below 32 cycles, where every time has its
+ * own bucket, so the queue must release jobs in exact (time, arrival)
+ * order. The source address carries the arrival number.
+ */
+static void checkSjf() {
+    const std::string name = "queue/sjf";
+    if (!selected(name)) {
+        return;
+    }
+
+    SchedulingQueue queue;
+    queue.configure(QueueDiscipline::SJF, {}, {}, 1);
+    std::map<std::pair<int, uint32_t>, bool> reference;
+    Rng rng(23);
+    uint32_t arrivals = 0;
+
+    for (int op = 0; op < 50000; op++) {
+        if (reference.empty() || rng.below(5) < 3) {
+            int time = 1 + static_cast<int>(rng.below(31));
+            queue.push(Request(arrivals, 0, time, 'P'));
+            reference[{time, arrivals}] = true;
+            arrivals++;
+            continue;
+        }
+
+        std::pair<int, uint32_t> expected = reference.begin()->first;
+        reference.erase(reference.begin());
+        const Request& next = queue.front();
+        if (next.getProcessTime() != expected.first || next.getIPin() != expected.second) {
+            report(name, false, "released arrival " + std::to_string(next.getIPin()) + " (" + std::to_string(next.getProcessTime())
+                                + " cycles) before arrival " + std::to_string(expected.second) + " ("
+                                + std::to_string(expected.first) + " cycles)");
+            return;
+        }
+        queue.pop();
+    }
+    report(name, queue.size() == reference.size(), "size differs from the reference");
+}
+
+/**
+ * @brief Checks tail drop and drop-oldest against a reference deque.
+ *
+ * @details A queue of capacity 10 takes bursts of up to 8 requests between
+ * random pops. Tail drop keeps the head of each burst that fits; drop-oldest
+ * admits the burst and trims the queue from the front. The source address
+ * carries the arrival number.
+ */
+static void checkShedding() {
+    for (SheddingPolicy policy : {SheddingPolicy::TAIL_DROP, SheddingPolicy::DROP_OLDEST}) {
+        bool tail = policy == SheddingPolicy::TAIL_DROP;
+        std::string name = tail ? "shed/tail-drop" : "shed/drop-oldest";
+        if (!selected(name)) {
+            continue;
+        }
+
+        const size_t capacity = 10;
+        SchedulingQueue queue;
+        LoadShedder shedder;
+        shedder.configure(policy, capacity, 5, 100);
+        std::deque<uint32_t> reference;
+        uint64_t dropped = 0;
+        uint32_t arrivals = 0;
+        Rng rng(29);
+        std::string failure;
+
+        for (int op = 0; op < 20000 && failure.empty(); op++) {
+            if (rng.below(2) == 0) {
+                std::vector<Request> burst;
+                for (uint32_t n = rng.below(9); n > 0; n--) {
+                    burst.push_back(Request(arrivals, 0, 5, 'P'));
+                    reference.push_back(arrivals++);
+                }
+                shedder.admit(queue, burst);
+                while (reference.size() > capacity) {
+                    if (tail) {
+                        reference.pop_back();
+                    } else {
+                        reference.pop_front();
+                    }
+                    dropped++;
+                }
+            } else if (!reference.empty()) {
+                if (queue.empty() || queue.front().getIPin() != reference.front()) {
+                    failure = "released a different request from the reference";
+                }
+                queue.pop();
+                reference.pop_front();
+            }
+            if (queue.size() != reference.size()) {
+                failure = "holds " + std::to_string(queue.size()) + " requests, reference " + std::to_string(reference.size());
+            }
+        }
+
+        const ShedCounts& counts = shedder.getCounts();
+        uint64_t counted = tail ? counts.tailDropped : counts.oldestDropped;
+        if (failure.empty() && (counted != dropped || counts.total() != dropped)) {
+            failure = "counted " + std::to_string(counts.total()) + " drops, reference " + std::to_string(dropped);
+        }
+        report(name, failure.empty(), failure);
+    }
+}
+
+/**
+ * @brief Checks CoDel's drop schedule on a queue that never drains.
+ *
+ * @details With a target of 5 and an interval of 10, a head that has waited
+ * since tick 0 goes above target at tick 5 and is first dropped at tick 15.
+ * The following drops come interval / sqrt(n) later: at 25, 32.07 and
+ * 37.85, i.e. on ticks 25, 33 and 38.
+ */
+static void checkCodel() {
+    const std::string name = "shed/codel";
+    if (!selected(name)) {
+        return;
+    }
+
+    SchedulingQueue queue;
+    LoadShedder shedder;
+    shedder.configure(SheddingPolicy::CODEL, 0, 5, 10);
+    std::vector<Request> backlog;
+    for (uint32_t i = 0; i < 100; i++) {
+        Request request(i, 0, 5, 'P');
+        request.markEnqueued(0);
+        backlog.push_back(request);
+    }
+    shedder.admit(queue, backlog);
+
+    std::vector<int> drops;
+    for (int tick = 0; tick <= 40; tick++) {
+        uint64_t before = shedder.getCounts().codelDropped;
+        shedder.shedStale(queue, tick);
+        for (uint64_t n = before; n < shedder.getCounts().codelDropped; n++) {
+            drops.push_back(tick);
+        }
+    }
+
+    std::string seen;
+    for (int tick : drops) {
+        seen += (seen.empty() ? "" : ",") + std::to_string(tick);
+    }
+    report(name, drops == std::vector<int>{15, 25, 33, 38} && queue.size() == 96, "dropped on ticks " + seen);
+}
+
+/**
+ * @brief Checks histogram percentiles against the exact nearest-rank values.
+ *
+ * @details Values are spread log-uniformly up to about a million cycles.
+ * A percentile may overstate the exact value by at most the width of its
+ * bucket, which is 1/64 of the value above 128 and zero below it. The
+ * count, mean and maximum must be exact.
+ */
+static void checkHistogram() {
+    const std::string name = "histogram/percentiles";
+    if (!selected(name)) {
+        return;
+    }
+
+    LatencyHistogram halves[2];
+    std::vector<int> values;
+    Rng rng(31);
+    for (int i = 0; i < 100000; i++) {
+        int value = static_cast<int>(std::exp(rng.uniform() * std::log(1.0e6)));
+        values.push_back(value);
+        halves[i % 2].record(value);
+    }
+    LatencyHistogram histogram;
+    histogram.merge(halves[0]);
+    histogram.merge(halves[1]);
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (int value : values) {
+        sum += value;
+    }
+    if (histogram.count() != values.size() || histogram.max() != values.back()
+        || std::fabs(histogram.mean() - sum / static_cast<double>(values.size())) > 1e-6 * histogram.mean()) {
+        report(name, false, "count, mean or maximum differs from the recorded values");
+        return;
+    }
+
+    for (double percentile : {0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+        int exact = values[rank > 0 ? rank - 1 : 0];
+        int reported = histogram.percentile(percentile);
+        int bound = exact < 128 ? exact : exact + exact / 64;
+        if (reported < exact || reported > bound) {
+            report(name, false, "p" + std::to_string(percentile) + " reported " + std::to_string(reported)
+                                + ", exact " + std::to_string(exact));
+            return;
+        }
+    }
+    report(name, true);
+}
+
+/**
+ * @brief Checks RequestQueue against a std::deque under random operations.
+ *
+ * @details The ring starts at 4 slots. Pushes outnumber pops slightly, so
+ * it keeps wrapping and is grown with its contents split across the end of
+ * the buffer. Bulk enqueues and dequeues cross the end the same way. The
+ * source address carries the arrival number.
+ */
+static void checkRequestQueue() {
+    const std::string name = "ring/requestQueue";
+    if (!selected(name)) {
+        return;
+    }
+
+    RequestQueue ring(4);
+    std::deque<uint32_t> reference;
+    uint32_t arrivals = 0;
+    Rng rng(37);
+    std::vector<Request> block;
+
+    for (int op = 0; op < 100000; op++) {
+        uint32_t n = rng.below(6);
+        switch (rng.below(5)) {
+            case 0:
+                ring.push(Request(arrivals, 0, 5, 'P'));
+                reference.push_back(arrivals++);
+                break;
+            case 1:
+                if (!reference.empty()) {
+                    ring.pop();
+                    reference.pop_front();
+                }
+                break;
+            case 2:
+                block.clear();
+                for (uint32_t i = 0; i < 2 * n + 1; i++) {
+                    block.push_back(Request(arrivals, 0, 5, 'P'));
+                    reference.push_back(arrivals++);
+                }
+                ring.enqueue(block.data(), block.size());
+                break;
+            case 3: {
+                block.assign(n, Request());
+                size_t taken = ring.dequeue(block.data(), n);
+                for (size_t i = 0; i < taken; i++) {
+                    if (reference.empty() || block[i].getIPin() != reference.front()) {
+                        report(name, false, "bulk dequeue returned a different request from the reference");
+                        return;
+                    }
+                    reference.pop_front();
+                }
+                if (taken != std::min<size_t>(n, taken + reference.size())) {
+                    report(name, false, "bulk dequeue returned too few requests");
+                    return;
+                }
+                break;
+            }
+            default: {
+                size_t dropped = ring.discard(n);
+                for (size_t i = 0; i < dropped && !reference.empty(); i++) {
+                    reference.pop_front();
+                }
+                break;
+            }
+        }
+
+        if (ring.size() != reference.size() || (!ring.empty() && ring.front().getIPin() != reference.front())) {
+            report(name, false, "differs from the reference after operation " + std::to_string(op));
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < reference.size(); i++) {
+        if (ring.at(i).getIPin() != reference[i]) {
+            report(name, false, "element " + std::to_string(i) + " differs from the reference");
+            return;
+        }
+    }
+    report(name, true);
+}
+
+/**
+ * @brief Checks IpTable against a std::map under random operations.
+ *
+ * @details Keys come from a pool of 3000 addresses, so the table keeps
+ * growing, long probe runs form and erasures shift entries back across
+ * them. Every 500 operations an eraseIf() sweep removes about a third of
+ * the entries, and every key in the pool is looked up in both containers.
+ */
+static void checkIpTable() {
+    const std::string name = "ipTable/map";
+    if (!selected(name)) {
+        return;
+    }
+
+    IpTable<int> table;
+    std::map<uint32_t, int> reference;
+    Rng rng(41);
+    std::vector<uint32_t> keys(3000);
+    for (uint32_t& key : keys) {
+        key = static_cast<uint32_t>(rng.next());
+    }
+
+    for (int op = 1; op <= 50000; op++) {
+        uint32_t key = keys[rng.below(static_cast<uint32_t>(keys.size()))];
+        int value = static_cast<int>(rng.below(1000));
+        switch (rng.below(4)) {
+            case 0:
+                table.insert(key, value);
+                reference[key] = value;
+                break;
+            case 1:
+                table.findOrInsert(key, value)++;
+                reference.emplace(key, value).first->second++;
+                break;
+            case 2:
+                if (table.erase(key) != (reference.erase(key) == 1)) {
+                    report(name, false, "erase() disagreed with the reference about a key's presence");
+                    return;
+                }
+                break;
+            default: {
+                const int* found = table.find(key);
+                auto it = reference.find(key);
+                if ((found == nullptr) != (it == reference.end()) || (found != nullptr && *found != it->second)) {
+                    report(name, false, "find() disagreed with the reference");
+                    return;
+                }
+                break;
+            }
+        }
+
+        if (op % 500 == 0) {
+            auto doomed = [](uint32_t, int stored) { return stored % 3 == 0; };
+            size_t expected = 0;
+            for (auto it = reference.begin(); it != reference.end(); ) {
+                if (doomed(it->first, it->second)) {
+                    it = reference.erase(it);
+                    expected++;
+                } else {
+                    ++it;
+                }
+            }
+            if (table.eraseIf(doomed) != expected) {
+                report(name, false, "eraseIf() removed a different number of entries from the reference");
+                return;
+            }
+            for (uint32_t probe : keys) {
+                const int* found = table.find(probe);
+                auto it = reference.find(probe);
+                if ((found == nullptr) != (it == reference.end()) || (found != nullptr && *found != it->second)) {
+                    report(name, false, "lost or kept an entry after eraseIf()");
+                    return;
+                }
+            }
+        }
+        if (table.size() != reference.size()) {
+            report(name, false, "holds " + std::to_string(table.size()) + " entries, reference " + std::to_string(reference.size()));
+            return;
+        }
+    }
+    report(name, true);
+}
+
+/**
+ * @brief Checks PrefixTrie lookups against a linear longest-prefix scan.
+ *
+ * @details Prefixes of every length from /0 to /32 are registered, many of
+ * them nested inside earlier ones, and duplicates must be refused. Half the
+ * probes are drawn near registered networks so that the longer prefixes
+ * are exercised.
+ */
+static void checkPrefixTrie() {
+    const std::string name = "prefixTrie/lookup";
+    if (!selected(name)) {
+        return;
+    }
+
+    struct Prefix {
+        uint32_t network;
+        int length;
+        int value;
+    };
+    auto maskOf = [](int length) { return length == 0 ? 0u : ~0u << (32 - length); };
+
+    PrefixTrie trie;
+    std::vector<Prefix> prefixes;
+    Rng rng(43);
+    for (int value = 0; value < 2000; value++) {
+        int length = static_cast<int>(rng.below(33));
+        uint32_t network = static_cast<uint32_t>(rng.next());
+        if (!prefixes.empty() && rng.below(2) == 0) {
+            const Prefix& outer = prefixes[rng.below(static_cast<uint32_t>(prefixes.size()))];
+            length = outer.length + static_cast<int>(rng.below(static_cast<uint32_t>(33 - outer.length)));
+            network = (outer.network & maskOf(outer.length)) | (network & ~maskOf(outer.length));
+        }
+        network &= maskOf(length);
+
+        bool duplicate = false;
+        for (const Prefix& prefix : prefixes) {
+            duplicate = duplicate || (prefix.network == network && prefix.length == length);
+        }
+        if (trie.insert(network, length, value) == duplicate) {
+            report(name, false, "insert() misreported whether a prefix was new");
+            return;
+        }
+        if (!duplicate) {
+            prefixes.push_back({network, length, value});
+        }
+    }
+    if (trie.size() != static_cast<int>(prefixes.size())) {
+        report(name, false, "size() differs from the number of prefixes added");
+        return;
+    }
+
+    for (int probe = 0; probe < 20000; probe++) {
+        uint32_t ip = static_cast<uint32_t>(rng.next());
+        if (probe % 2 == 0) {
+            const Prefix& near = prefixes[rng.below(static_cast<uint32_t>(prefixes.size()))];
+            ip = near.network | (ip & ~maskOf(near.length));
+        }
+        int expected = -1;
+        int longest = -1;
+        for (const Prefix& prefix : prefixes) {
+            if ((ip & maskOf(prefix.length)) == prefix.network && prefix.length > longest) {
+                longest = prefix.length;
+                expected = prefix.value;
+            }
+        }
+        if (trie.lookup(ip) != expected) {
+            report(name, false, "lookup(" + std::to_string(ip) + ") returned " + std::to_string(trie.lookup(ip))
+                                + ", expected " + std::to_string(expected));
+            return;
+        }
+    }
+    report(name, true);
+}
+
+/**
+ * @brief Checks each rate-limit mode on bursts that separate the algorithms.
+ *
+ * @details The limit is 5 requests per 10-cycle window, and every scenario
+ * uses its own source so that earlier bans do not interfere:
+ *  - Fixed window lets 5 requests through at tick 9 and 5 more at tick 10,
+ *    the 2x burst across a reset, then bans the source.
+ *  - Sliding window still counts half of tick 9's 5 requests at tick 15,
+ *    so only 2 more pass there.
+ *  - Token bucket passes 5 of a 6-request burst, and a source that spent
+ *    its tokens at tick 0 has 2 back by tick 4.
+ * Banned sources stay blocked.
+ *
+ * @param logger Disabled logger.
+ */
+static void checkRateLimits(Logger& logger) {
+    struct Burst {
+        uint32_t source;
+        int tick;
+        int size;
+        int passes;
+    };
+    struct Scenario {
+        const char* name;
+        RateLimitMode mode;
+        std::vector<Burst> bursts;
+    };
+    const uint32_t A = 0xCB007101u, B = 0xCB007102u;  // 203.0.113.1, 203.0.113.2
+    const Scenario scenarios[] = {
+        {"firewall/fixed", RateLimitMode::FIXED_WINDOW, {{A, 9, 5, 5}, {A, 10, 5, 5}, {A, 10, 1, 0}, {A, 30, 1, 0}}},
+        {"firewall/sliding", RateLimitMode::SLIDING_WINDOW, {{A, 9, 5, 5}, {A, 15, 3, 2}, {A, 30, 1, 0}}},
+        {"firewall/token", RateLimitMode::TOKEN_BUCKET, {{A, 0, 6, 5}, {A, 30, 1, 0}, {B, 0, 5, 5}, {B, 4, 3, 2}}},
+    };
+
+    for (const Scenario& scenario : scenarios) {
+        if (!selected(scenario.name)) {
+            continue;
+        }
+
+        Firewall firewall(5, 10);
+        firewall.setRateLimitMode(scenario.mode);
+        std::string failure;
+        int blocked = 0;
+        for (const Burst& burst : scenario.bursts) {
+            std::vector<Request> requests(static_cast<size_t>(burst.size), Request(burst.source, 0xC6336407u, 5, 'P'));
+            firewall.filterRequests(requests, burst.tick, logger);
+            blocked += burst.size - static_cast<int>(requests.size());
+            if (failure.empty() && static_cast<int>(requests.size()) != burst.passes) {
+                failure = std::to_string(requests.size()) + " of " + std::to_string(burst.size) + " requests passed at tick "
+                        + std::to_string(burst.tick) + ", expected " + std::to_string(burst.passes);
+            }
+        }
+        if (failure.empty() && firewall.getTotalBlocked() != blocked) {
+            failure = "getTotalBlocked() differs from the requests dropped";
+        }
+        report(scenario.name, failure.empty(), failure);
+    }
+}
+
+/**
+ * @brief Checks that both trace formats replay what they encode.
+ *
+ * @details The JSONL trace gives one address as a string and the same
+ * address as a packed integer, adds unknown keys, a blank line and a bad
+ * address, and ends with a record whose tick is earlier than its
+ * predecessor's, which is delivered late, along with that record. The
+ * binary trace has a tick beyond @c INT_MAX and a truncated final record,
+ * both skipped as malformed.
+ */
+static void checkTraces() {
+    struct Expected {
+        int tick;
+        uint32_t src;
+        uint32_t dst;
+        int processTime;
+        char jobType;
+    };
+    const uint32_t SRC = 0xCB007105u, DST = 0xC6336407u;  // 203.0.113.5, 198.51.100.7
+
+    auto le = [](std::string& bytes, uint64_t value, int size) {
+        for (int i = 0; i < size; i++) {
+            bytes += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    };
+    auto record = [&](std::string& bytes, uint32_t tick, uint32_t src, uint32_t dst, uint16_t time, char type) {
+        le(bytes, tick, 4);
+        le(bytes, src, 4);
+        le(bytes, dst, 4);
+        le(bytes, time, 2);
+        bytes += type;
+        bytes += '\0';
+    };
+
+    std::string binary = "LBTRACE1";
+    record(binary, 2, SRC, DST, 7, 'P');
+    record(binary, 0x80000000u, SRC, DST, 7, 'P');
+    record(binary, 7, DST, SRC, 300, 'S');
+    binary += std::string(6, '\0');
+
+    struct Trace {
+        const char* name;
+        std::string contents;
+        std::vector<Expected> expected;
+        uint64_t malformed;
+    };
+    const Trace traces[] = {
+        {"trace/jsonl",
+         "{\"tick\": 3, \"src\": \"203.0.113.5\", \"dst\": \"198.51.100.7\", \"time\": 7, \"type\": \"P\"}\n"
+         "\n"
+         "{\"type\": \"S\", \"time\": 2, \"dst\": 3325256711, \"src\": 3405803781, \"tick\": 3, \"note\": \"x\", \"id\": 4}\n"
+         "{\"tick\": 5, \"src\": \"203.0.113.999\", \"dst\": \"198.51.100.7\", \"time\": 7, \"type\": \"P\"}\n"
+         "{\"tick\": 8, \"src\": \"198.51.100.7\", \"dst\": \"203.0.113.5\", \"time\": 4, \"type\": \"P\"}\r\n"
+         "{\"tick\": 6, \"src\": 1, \"dst\": 2, \"time\": 9, \"type\": \"S\"}",
+         {{3, SRC, DST, 7, 'P'}, {3, SRC, DST, 2, 'S'}, {8, DST, SRC, 4, 'P'}, {8, 1, 2, 9, 'S'}},
+         1},
+        {"trace/binary", binary, {{2, SRC, DST, 7, 'P'}, {7, DST, SRC, 300, 'S'}}, 2},
+    };
+
+    for (const Trace& trace : traces) {
+        if (!selected(trace.name)) {
+            continue;
+        }
+
+        std::filesystem::path path = std::filesystem::temp_directory_path()
+                                   / ("lbcheck-" + std::string(trace.name + 6) + ".trace");
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << trace.contents;
+        }
+
+        std::vector<Expected> replayed;
+        TraceReader reader;
+        bool opened = reader.open(path.string(), false);
+        for (int tick = reader.nextArrival(0, 100); opened && tick < 100; tick = reader.nextArrival(tick + 1, 100)) {
+            std::vector<Request> burst;
+            reader.takeArrivals(tick, burst);
+            for (const Request& request : burst) {
+                replayed.push_back({tick, request.getIPin(), request.getIPout(), request.getProcessTime(), request.getJobType()});
+            }
+        }
+        std::filesystem::remove(path);
+
+        bool same = replayed.size() == trace.expected.size();
+        for (size_t i = 0; same && i < replayed.size(); i++) {
+            const Expected& a = replayed[i];
+            const Expected& b = trace.expected[i];
+            same = a.tick == b.tick && a.src == b.src && a.dst == b.dst && a.processTime == b.processTime && a.jobType == b.jobType;
+        }
+
+        if (!opened) {
+            report(trace.name, false, "could not open " + path.string());
+        } else if (!same) {
+            report(trace.name, false, "replayed " + std::to_string(replayed.size()) + " requests, not the "
+                                      + std::to_string(trace.expected.size()) + " expected on their ticks");
+        } else {
+            report(trace.name, reader.getReplayed() == replayed.size() && reader.getMalformed() == trace.malformed,
+                   std::to_string(reader.getMalformed()) + " records counted malformed, expected " + std::to_string(trace.malformed));
+        }
+    }
+}
+
+/**
+ * @brief Runs every selected check.
+ *
+ * @param argc Argument count.
+ * @param argv Substring filters.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        filters.push_back(argv[i]);
+    }
+
+    Logger logger("", LogLevel::OFF, false);
+    checkSnapshot(logger);
+    checkDispatch();
+    checkAffinity();
+    checkDrr();
+    checkSjf();
+    checkShedding();
+    checkCodel();
+    checkHistogram();
+    checkRequestQueue();
+    checkIpTable();
+    checkPrefixTrie();
+    checkRateLimits(logger);
+    checkTraces();
+    return failures == 0 ? 0 : 1;
+}
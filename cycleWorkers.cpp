@@ -0,0 +1,79 @@
+/**
+ * @file cycleWorkers.cpp
+ * @brief Implementation of the CycleWorkers class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "cycleWorkers.h"
+#include <utility>
+
+/**
+ * @brief Stores the tasks and launches a worker for each task after the first.
+ *
+ * @param tasks Per-cycle work items.
+ */
+CycleWorkers::CycleWorkers(std::vector<std::function<void()>> tasks)
+    : tasks(std::move(tasks)),
+      cycle(0),
+      remaining(0),
+      stopping(false)
+{
+    for (size_t i = 1; i < this->tasks.size(); i++) {
+        threads.emplace_back(&CycleWorkers::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Signals the workers to exit and joins them.
+ */
+CycleWorkers::~CycleWorkers() {
+    stopping.store(true, std::memory_order_release);
+    cycle.fetch_add(1, std::memory_order_acq_rel);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Releases the workers for one cycle, runs task 0, then waits.
+ */
+void CycleWorkers::runCycle() {
+    if (tasks.empty()) {
+        return;
+    }
+
+    remaining.store(threads.size(), std::memory_order_relaxed);
+    cycle.fetch_add(1, std::memory_order_release);
+
+    tasks[0]();
+
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Waits for each new cycle, runs task @p index and reports completion.
+ *
+ * @param index Task owned by this worker.
+ */
+void CycleWorkers::workerLoop(size_t index) {
+    uint64_t seen = 0;
+
+    for (;;) {
+        uint64_t current;
+        while ((current = cycle.load(std::memory_order_acquire)) == seen) {
+            std::this_thread::yield();
+        }
+        seen = current;
+
+        if (stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        tasks[index]();
+        remaining.fetch_sub(1, std::memory_order_release);
+    }
+}
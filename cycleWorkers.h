@@ -0,0 +1,73 @@
+/**
+ * @file cycleWorkers.h
+ * @brief Declaration of the CycleWorkers class.
+ *
+ * @details Defines CycleWorkers, a fixed set of threads that each run one
+ * task per simulation cycle in lock step. The Switch uses it to advance all
+ * of its LoadBalancers concurrently: the calling thread publishes a new
+ * cycle, every task runs once on its own thread, and the call returns only
+ * when all tasks have finished, which acts as the per-cycle barrier.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef CYCLEWORKERS_H
+#define CYCLEWORKERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * @class CycleWorkers
+ * @brief Runs N tasks in parallel once per call to runCycle().
+ *
+ * @details Task 0 runs on the calling thread; tasks 1..N-1 each own a
+ * dedicated worker thread. Workers wait for the cycle counter to advance,
+ * run their task, and count themselves off. Waiting is done by spinning
+ * with std::this_thread::yield(), since cycles are far too short for a
+ * condition-variable round trip to pay off.
+ */
+class CycleWorkers {
+    public:
+        /**
+         * @brief Starts one worker thread per task beyond the first.
+         * @param tasks Work to run each cycle; task @c i is always run by the same thread.
+         */
+        explicit CycleWorkers(std::vector<std::function<void()>> tasks);
+
+        /**
+         * @brief Stops and joins all worker threads.
+         */
+        ~CycleWorkers();
+
+        CycleWorkers(const CycleWorkers&) = delete;
+        CycleWorkers& operator=(const CycleWorkers&) = delete;
+
+        /**
+         * @brief Runs every task once and waits for all of them to finish.
+         *
+         * @details Memory written by the caller before the call is visible to
+         * every task, and memory written by the tasks is visible to the caller
+         * after it returns.
+         */
+        void runCycle();
+
+    private:
+        std::vector<std::function<void()>> tasks;  ///< One task per thread.
+        std::vector<std::thread> threads;          ///< Workers for tasks 1..N-1.
+        std::atomic<uint64_t> cycle;               ///< Bumped to release the workers.
+        std::atomic<size_t> remaining;             ///< Workers still running the current cycle.
+        std::atomic<bool> stopping;                ///< Set by the destructor.
+
+        /**
+         * @brief Worker thread body for task @p index.
+         * @param index Task run by this worker.
+         */
+        void workerLoop(size_t index);
+};
+
+#endif
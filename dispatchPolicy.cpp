@@ -0,0 +1,354 @@
+/**
+ * @file dispatchPolicy.cpp
+ * @brief Implementation of the built-in dispatch policies.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "dispatchPolicy.h"
+#include <climits>
+
+namespace {
+
+/**
+ * @brief Mixes a 32-bit value with MurmurHash3's finaliser.
+ * @param value Value to hash.
+ * @return Well-spread hash.
+ */
+uint32_t mix32(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x85EBCA6Bu;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35u;
+    value ^= value >> 16;
+    return value;
+}
+
+/**
+ * @brief Returns the smallest prime no less than @p value.
+ * @param value Lower bound, at least 2.
+ * @return Prime found by trial division.
+ */
+uint32_t nextPrime(uint32_t value) {
+    for (;; value++) {
+        bool prime = value >= 2;
+        for (uint32_t d = 2; prime && static_cast<uint64_t>(d) * d <= value; d++) {
+            prime = value % d != 0;
+        }
+        if (prime) {
+            return value;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Parses a policy name.
+ *
+ * @param name Policy name.
+ * @param kind Receives the parsed kind.
+ * @return @c true if recognised.
+ */
+bool parseDispatchPolicy(const std::string& name, DispatchPolicyKind& kind) {
+    if (name == "first-idle")        kind = DispatchPolicyKind::FIRST_IDLE;
+    else if (name == "least-work")   kind = DispatchPolicyKind::LEAST_WORK;
+    else if (name == "power-of-two") kind = DispatchPolicyKind::POWER_OF_TWO;
+    else if (name == "sed")          kind = DispatchPolicyKind::SHORTEST_EXPECTED_DELAY;
+    else if (name == "affinity")     kind = DispatchPolicyKind::AFFINITY;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Factory for the built-in policies.
+ *
+ * @param kind Policy to create.
+ * @param seed Seed for randomised policies (0 is replaced by 1).
+ * @return New policy instance.
+ */
+std::unique_ptr<DispatchPolicy> makeDispatchPolicy(DispatchPolicyKind kind, uint32_t seed) {
+    switch (kind) {
+        case DispatchPolicyKind::LEAST_WORK:
+            return std::unique_ptr<DispatchPolicy>(new LeastWorkPolicy());
+        case DispatchPolicyKind::POWER_OF_TWO:
+            return std::unique_ptr<DispatchPolicy>(new PowerOfTwoPolicy(seed));
+        case DispatchPolicyKind::SHORTEST_EXPECTED_DELAY:
+            return std::unique_ptr<DispatchPolicy>(new ShortestExpectedDelayPolicy());
+        case DispatchPolicyKind::AFFINITY:
+            return std::unique_ptr<DispatchPolicy>(new AffinityPolicy());
+        case DispatchPolicyKind::FIRST_IDLE:
+            break;
+    }
+    return std::unique_ptr<DispatchPolicy>(new FirstIdlePolicy());
+}
+
+// --- FirstIdlePolicy ---
+
+long FirstIdlePolicy::selectServer(const ServerPool& pool, const Request&, int) {
+    return pool.firstIdle();
+}
+
+const char* FirstIdlePolicy::name() const {
+    return "first-idle";
+}
+
+// --- LeastWorkPolicy ---
+
+/**
+ * @brief Scans every accepting server for the smallest outstanding work.
+ *
+ * @details Ties go to the lowest index, so with empty local queues an idle
+ * server always wins.
+ */
+long LeastWorkPolicy::selectServer(const ServerPool& pool, const Request&, int clockTime) {
+    long best = -1;
+    int bestWork = INT_MAX;
+    for (size_t i = 0; i < pool.slotCount(); i++) {
+        if (!pool.canAccept(i)) {
+            continue;
+        }
+        int work = pool.outstandingWork(i, clockTime);
+        if (work < bestWork) {
+            best = static_cast<long>(i);
+            bestWork = work;
+            if (work == 0) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+const char* LeastWorkPolicy::name() const {
+    return "least-work";
+}
+
+// --- PowerOfTwoPolicy ---
+
+PowerOfTwoPolicy::PowerOfTwoPolicy(uint32_t seed)
+    : state(seed != 0 ? seed : 1)
+{
+}
+
+uint32_t PowerOfTwoPolicy::next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Compares two random servers by outstanding work.
+ *
+ * @details A pair in which neither server can accept (retired slots, or
+ * busy servers with full local queues) is redrawn up to @c ROUNDS times.
+ * After that an idle server is taken from the pool's bitmap, and only if
+ * none is idle does the full scan run. The LoadBalancer only asks while
+ * some server can accept, and in that case ServerPool::hasCapacity() has
+ * just scanned the local queues too.
+ */
+long PowerOfTwoPolicy::selectServer(const ServerPool& pool, const Request& request, int clockTime) {
+    if (pool.empty()) {
+        return -1;
+    }
+
+    for (int round = 0; round < ROUNDS; round++) {
+        size_t a = next() % pool.slotCount();
+        size_t b = next() % pool.slotCount();
+        bool acceptsA = pool.canAccept(a);
+        bool acceptsB = pool.canAccept(b);
+
+        if (acceptsA && acceptsB) {
+            return static_cast<long>(pool.outstandingWork(b, clockTime) < pool.outstandingWork(a, clockTime) ? b : a);
+        }
+        if (acceptsA) return static_cast<long>(a);
+        if (acceptsB) return static_cast<long>(b);
+    }
+
+    long idle = pool.firstIdle();
+    if (idle >= 0) {
+        return idle;
+    }
+    return fallback.selectServer(pool, request, clockTime);
+}
+
+const char* PowerOfTwoPolicy::name() const {
+    return "power-of-two";
+}
+
+void PowerOfTwoPolicy::saveState(SnapshotWriter& out) const {
+    out.put(state);
+}
+
+/**
+ * @brief Resumes the random stream; a zero state would stick, so it is rejected.
+ */
+bool PowerOfTwoPolicy::restoreState(SnapshotReader& in) {
+    uint32_t restored = 0;
+    if (!in.get(restored) || restored == 0) {
+        return in.fail();
+    }
+    state = restored;
+    return true;
+}
+
+// --- ShortestExpectedDelayPolicy ---
+
+/**
+ * @brief Scans every accepting server for the smallest expected delay.
+ */
+long ShortestExpectedDelayPolicy::selectServer(const ServerPool& pool, const Request& request, int) {
+    long best = -1;
+    float bestDelay = 0.0f;
+    float fallbackMean = request.getProcessTime() > 0 ? static_cast<float>(request.getProcessTime()) : 1.0f;
+
+    for (size_t i = 0; i < pool.slotCount(); i++) {
+        if (!pool.canAccept(i)) {
+            continue;
+        }
+        float mean = pool.serviceEstimate(i) > 0.0f ? pool.serviceEstimate(i) : fallbackMean;
+        float delay = static_cast<float>(pool.outstandingRequests(i) + 1) * mean;
+        if (best < 0 || delay < bestDelay) {
+            best = static_cast<long>(i);
+            bestDelay = delay;
+        }
+    }
+    return best;
+}
+
+const char* ShortestExpectedDelayPolicy::name() const {
+    return "sed";
+}
+
+// --- AffinityPolicy ---
+
+AffinityPolicy::AffinityPolicy()
+    : tableSize(MIN_TABLE_SIZE),
+      version(0),
+      built(false)
+{
+}
+
+uint32_t AffinityPolicy::sizeFor(size_t servers) const {
+    uint64_t wanted = static_cast<uint64_t>(servers) * ENTRIES_PER_SERVER;
+    if (wanted <= tableSize && (tableSize == MIN_TABLE_SIZE || tableSize <= 4 * wanted)) {
+        return tableSize;
+    }
+    if (2 * wanted <= MIN_TABLE_SIZE) {
+        return MIN_TABLE_SIZE;
+    }
+    return nextPrime(static_cast<uint32_t>(wanted < UINT32_MAX / 4 ? 2 * wanted : UINT32_MAX / 2));
+}
+
+/**
+ * @brief Runs Maglev's population over the live slots.
+ *
+ * @details Slot @c m prefers entries offset, offset + skip, offset + 2 skip,
+ * ... (mod @c tableSize), both derived from its server id. The slots take
+ * turns claiming their next unclaimed preference until the table is full.
+ * Because @c tableSize is prime, every stride visits every entry.
+ */
+void AffinityPolicy::rebuild(const ServerPool& pool) {
+    version = pool.membershipVersion();
+    built = true;
+
+    members.clear();
+    for (size_t i = 0; i < pool.slotCount(); i++) {
+        if (pool.isLive(i)) {
+            members.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (members.empty()) {
+        table.clear();
+        return;
+    }
+
+    tableSize = sizeFor(members.size());
+    offsets.resize(members.size());
+    skips.resize(members.size());
+    cursors.assign(members.size(), 0);
+    for (size_t m = 0; m < members.size(); m++) {
+        uint32_t id = static_cast<uint32_t>(pool.getId(members[m]));
+        offsets[m] = mix32(id ^ 0x9E3779B9u) % tableSize;
+        skips[m] = mix32(id ^ 0x7F4A7C15u) % (tableSize - 1) + 1;
+    }
+
+    const uint32_t EMPTY = UINT32_MAX;
+    table.assign(static_cast<size_t>(tableSize), EMPTY);
+    uint32_t filled = 0;
+    while (filled < tableSize) {
+        for (size_t m = 0; m < members.size() && filled < tableSize; m++) {
+            uint32_t entry;
+            do {
+                entry = static_cast<uint32_t>((offsets[m] + static_cast<uint64_t>(cursors[m]++) * skips[m]) % tableSize);
+            } while (table[entry] != EMPTY);
+            table[entry] = members[m];
+            filled++;
+        }
+    }
+}
+
+/**
+ * @brief Looks up the source address's home server, then its next choices.
+ *
+ * @details With no local queues an accepting server is an idle one, so
+ * firstIdle() finds one whenever any exists. The hashed draws only matter
+ * when local queues are enabled; they mix in the tick so that an address
+ * whose draws are full tries other servers on the next cycle.
+ */
+long AffinityPolicy::selectServer(const ServerPool& pool, const Request& request, int clockTime) {
+    if (!built || version != pool.membershipVersion()) {
+        rebuild(pool);
+    }
+    if (table.empty()) {
+        return -1;
+    }
+
+    uint32_t hash = mix32(request.getIPin());
+    uint32_t entry = static_cast<uint32_t>((static_cast<uint64_t>(hash) * tableSize) >> 32);
+    for (uint32_t probe = 0; probe <= PROBES; probe++) {
+        uint32_t slot = table[entry];
+        if (pool.canAccept(slot)) {
+            return static_cast<long>(slot);
+        }
+        entry = entry + 1 < tableSize ? entry + 1 : 0;
+    }
+
+    long idle = pool.firstIdle();
+    if (idle >= 0 || pool.getLocalQueueDepth() == 0) {
+        return idle;
+    }
+    for (uint32_t draw = 0; draw < DRAWS; draw++) {
+        hash = mix32(hash ^ static_cast<uint32_t>(clockTime) ^ (draw * 0x9E3779B9u));
+        uint32_t slot = table[static_cast<uint32_t>((static_cast<uint64_t>(hash) * tableSize) >> 32)];
+        if (pool.canAccept(slot)) {
+            return static_cast<long>(slot);
+        }
+    }
+    return -1;
+}
+
+const char* AffinityPolicy::name() const {
+    return "affinity";
+}
+
+void AffinityPolicy::saveState(SnapshotWriter& out) const {
+    out.put(tableSize);
+}
+
+/**
+ * @brief Resumes with the saved table length; the table is rebuilt from the
+ *        restored pool, which gives the same entries as before the save.
+ */
+bool AffinityPolicy::restoreState(SnapshotReader& in) {
+    uint32_t restored = 0;
+    if (!in.get(restored) || restored < MIN_TABLE_SIZE || restored > UINT32_MAX / 2 + 1 || nextPrime(restored) != restored) {
+        return in.fail();
+    }
+    tableSize = restored;
+    built = false;
+    table.clear();
+    return true;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file dispatchPolicy.h
+ * @brief Declaration of the DispatchPolicy interface and its implementations.
+ *
+ * @details A DispatchPolicy decides which server in a ServerPool receives
+ * the request at the head of a LoadBalancer's queue. Policies may pick a
+ * busy server when the pool has local queues (see
+ * ServerPool::setLocalQueueDepth()), which is what lets load-aware policies
+ * differ from plain first-come, first-served dispatch.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef DISPATCHPOLICY_H
+#define DISPATCHPOLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "request.h"
+#include "serverPool.h"
+#include "snapshot.h"
+
+/**
+ * @enum DispatchPolicyKind
+ * @brief Built-in dispatch policies.
+ */
+enum class DispatchPolicyKind {
+    FIRST_IDLE,               ///< Lowest-indexed idle server (the original behaviour).
+    LEAST_WORK,               ///< Server with the least outstanding work, in cycles.
+    POWER_OF_TWO,             ///< Less loaded of two randomly sampled servers.
+    SHORTEST_EXPECTED_DELAY,  ///< Minimum (outstanding requests + 1) x mean service time.
+    AFFINITY                  ///< Server chosen by a consistent hash of the source address.
+};
+
+/**
+ * @brief Converts a policy name to a DispatchPolicyKind.
+ *
+ * @param name Policy name: @c "first-idle", @c "least-work", @c "power-of-two",
+ *             @c "sed" or @c "affinity".
+ * @param kind Receives the parsed kind on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseDispatchPolicy(const std::string& name, DispatchPolicyKind& kind);
+
+/**
+ * @class DispatchPolicy
+ * @brief Strategy interface for choosing a server for one request.
+ */
+class DispatchPolicy {
+    public:
+        virtual ~DispatchPolicy() = default;
+
+        /**
+         * @brief Picks the server that should receive @p request.
+         *
+         * @details Implementations return only servers for which
+         * ServerPool::canAccept() holds, and return -1 only when no server
+         * can accept. FirstIdlePolicy never uses local queues, so it returns
+         * -1 whenever no server is idle, and AffinityPolicy may return -1
+         * when only local queues have room and its bounded draws miss them.
+         *
+         * @param pool      Servers to choose from.
+         * @param request   Request about to be dispatched.
+         * @param clockTime Current tick.
+         * @return Slot index in @p pool, or -1 to leave the request queued.
+         */
+        virtual long selectServer(const ServerPool& pool, const Request& request, int clockTime) = 0;
+
+        /**
+         * @brief Returns the policy's configuration name.
+         * @return Name as accepted by parseDispatchPolicy().
+         */
+        virtual const char* name() const = 0;
+
+        /**
+         * @brief Writes any state the policy carries between requests.
+         * @param out Snapshot being written; stateless policies write nothing.
+         */
+        virtual void saveState(SnapshotWriter& out) const { (void)out; }
+
+        /**
+         * @brief Reads the state written by saveState().
+         * @param in Snapshot being read.
+         * @return @c false if the snapshot is malformed.
+         */
+        virtual bool restoreState(SnapshotReader& in) { (void)in; return true; }
+};
+
+/**
+ * @brief Creates a policy of the given kind.
+ *
+ * @param kind Policy to create.
+ * @param seed Seed for policies that sample randomly.
+ * @return Heap-allocated policy.
+ */
+std::unique_ptr<DispatchPolicy> makeDispatchPolicy(DispatchPolicyKind kind, uint32_t seed);
+
+/**
+ * @class FirstIdlePolicy
+ * @brief Sends each request to the lowest-indexed idle server.
+ */
+class FirstIdlePolicy : public DispatchPolicy {
+    public:
+        long selectServer(const ServerPool& pool, const Request& request, int clockTime) override;
+        const char* name() const override;
+};
+
+/**
+ * @class LeastWorkPolicy
+ * @brief Sends each request to the accepting server with the least outstanding work.
+ */
+class LeastWorkPolicy : public DispatchPolicy {
+    public:
+        long selectServer(const ServerPool& pool, const Request& request, int clockTime) override;
+        const char* name() const override;
+};
+
+/**
+ * @class PowerOfTwoPolicy
+ * @brief Samples two servers at random and picks the one with less outstanding work.
+ *
+ * @details If neither sample can accept, a fresh pair is drawn, up to
+ * four pairs. If all of them miss, the lowest-indexed idle server is taken
+ * from the idle bitmap. Only when no server is idle does the policy fall
+ * back to LeastWorkPolicy's full scan, so a request is never held back
+ * while capacity exists.
+ */
+class PowerOfTwoPolicy : public DispatchPolicy {
+    public:
+        /**
+         * @brief Constructs the policy with its own random stream.
+         * @param seed Non-zero seed for the xorshift generator.
+         */
+        explicit PowerOfTwoPolicy(uint32_t seed);
+
+        long selectServer(const ServerPool& pool, const Request& request, int clockTime) override;
+        const char* name() const override;
+        void saveState(SnapshotWriter& out) const override;
+        bool restoreState(SnapshotReader& in) override;
+
+    private:
+        static const int ROUNDS = 4;  ///< Pairs drawn before giving up on sampling.
+
+        uint32_t state;            ///< xorshift32 state.
+        LeastWorkPolicy fallback;  ///< Used when no sample accepts and no server is idle.
+
+        /**
+         * @brief Advances the xorshift32 generator.
+         * @return Next pseudo-random value.
+         */
+        uint32_t next();
+};
+
+/**
+ * @class ShortestExpectedDelayPolicy
+ * @brief Minimises (outstanding requests + 1) x the server's mean service time.
+ *
+ * @details Each server's mean is the running average of the processing
+ * times (Request::getProcessTime()) it has been assigned; a server with no
+ * history is rated at the incoming request's own processing time.
+ */
+class ShortestExpectedDelayPolicy : public DispatchPolicy {
+    public:
+        long selectServer(const ServerPool& pool, const Request& request, int clockTime) override;
+        const char* name() const override;
+};
+
+/**
+ * @class AffinityPolicy
+ * @brief Sends every request from one source address to the same server while
+ *        that server stays in the pool.
+ *
+ * @details The policy keeps a Maglev lookup table whose entries each name a
+ * live slot, filled so that every server owns an almost equal share.
+ * Request::getIPin() is hashed to one entry in O(1). The table is rebuilt
+ * only when ServerPool::membershipVersion() changes, i.e. after a scaling
+ * step. Each server's preference order depends only on its id, so adding or
+ * removing one of N servers moves about 1/N of the addresses and leaves the
+ * rest where they were.
+ *
+ * The table holds about @c ENTRIES_PER_SERVER entries per server, and never
+ * fewer than @c MIN_TABLE_SIZE. Its length is a prime and is only changed
+ * when the pool outgrows it or shrinks well below it, since a new length
+ * reshuffles every address; a new length leaves room for the pool to double.
+ *
+ * If the home server cannot accept, the next few table entries are tried,
+ * which gives each address a stable second choice. Failing those, the
+ * request goes to the first idle server, and then to a few hashed draws
+ * that can find room in a local queue. Every step is O(1), so under heavy
+ * load a request may be left queued for a cycle even though a local queue
+ * elsewhere has room. Affinity holds best with local queues
+ * (ServerPool::setLocalQueueDepth()), which let a busy home server keep
+ * taking its clients' requests.
+ */
+class AffinityPolicy : public DispatchPolicy {
+    public:
+        /**
+         * @brief Constructs the policy with an empty table.
+         */
+        AffinityPolicy();
+
+        long selectServer(const ServerPool& pool, const Request& request, int clockTime) override;
+        const char* name() const override;
+
+        /**
+         * @brief Writes the table length.
+         *
+         * @details The length depends on how the pool has grown and shrunk,
+         * so it is the one piece of state the pool cannot reproduce; the
+         * table itself is rebuilt from it on the next request.
+         *
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const override;
+
+        /**
+         * @brief Restores the table length and schedules a rebuild.
+         * @param in Snapshot being read.
+         * @return @c false if the length is not a prime of at least @c MIN_TABLE_SIZE.
+         */
+        bool restoreState(SnapshotReader& in) override;
+
+    private:
+        static const uint32_t MIN_TABLE_SIZE = 4093;   ///< Smallest table length (prime).
+        static const uint32_t ENTRIES_PER_SERVER = 100; ///< Target share of each server, in entries.
+        static const uint32_t PROBES = 4;              ///< Table entries tried after the home server.
+        static const uint32_t DRAWS = 4;               ///< Hashed entries tried when no server is idle.
+
+        std::vector<uint32_t> table;   ///< Slot owning each entry; empty while the pool is.
+        uint32_t tableSize;            ///< Prime length the table is built with.
+        std::vector<uint32_t> offsets; ///< Scratch: each live slot's first preferred entry.
+        std::vector<uint32_t> skips;   ///< Scratch: each live slot's preference stride.
+        std::vector<uint32_t> cursors; ///< Scratch: preferences each live slot has used.
+        std::vector<uint32_t> members; ///< Scratch: live slots, in slot order.
+        uint64_t version;              ///< Membership version the table was built for.
+        bool built;                    ///< Whether @c table matches @c version.
+
+        /**
+         * @brief Refills the table from the pool's live servers.
+         * @param pool Servers to distribute the entries among.
+         */
+        void rebuild(const ServerPool& pool);
+
+        /**
+         * @brief Picks the table length for @p servers live servers.
+         *
+         * @details Keeps the current length while it gives each server
+         * between @c ENTRIES_PER_SERVER and four times that many entries,
+         * and otherwise picks one that gives each server twice that many.
+         *
+         * @param servers Live server count.
+         * @return Prime table length.
+         */
+        uint32_t sizeFor(size_t servers) const;
+};
+
+#endif
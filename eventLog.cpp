@@ -0,0 +1,371 @@
+/**
+ * @file eventLog.cpp
+ * @brief Implementation of EventChannel, EventLog and EventLogReader.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "eventLog.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'L', 'B', 'E', 'V', 'E', 'N', 'T', '1'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+const uint8_t BLOCK_CHANNEL = 1;
+const uint8_t BLOCK_LABEL = 2;
+const uint8_t BLOCK_RECORDS = 3;
+
+const uint32_t MAX_LABELS = 1u << 24;  ///< Sanity bound on rule indices read back.
+
+/**
+ * @struct BlockHeader
+ * @brief Prefix of every block after the file header.
+ */
+struct BlockHeader {
+    uint8_t kind;      ///< BLOCK_CHANNEL, BLOCK_LABEL or BLOCK_RECORDS.
+    uint8_t reserved;  ///< Zero.
+    uint16_t channel;  ///< Channel the block belongs to.
+    uint32_t length;   ///< Payload bytes, or records for BLOCK_RECORDS.
+};
+static_assert(sizeof(BlockHeader) == 8, "BlockHeader must stay 8 bytes");
+
+/**
+ * @brief Rounds @p bytes up to a multiple of 8.
+ * @param bytes Payload size.
+ * @return Padded size.
+ */
+size_t padded(size_t bytes) {
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+} // namespace
+
+/**
+ * @brief Returns the CSV name of an event type.
+ * @param type Event type.
+ * @return Lower-case name.
+ */
+const char* eventTypeName(EventType type) {
+    switch (type) {
+        case EventType::CYCLE:               return "cycle";
+        case EventType::SERVER_ALLOCATED:    return "server_allocated";
+        case EventType::SERVER_DEALLOCATED:  return "server_deallocated";
+        case EventType::NO_IDLE_SERVER:      return "no_idle_server";
+        case EventType::SERVER_PROVISIONING: return "server_provisioning";
+        case EventType::BLOCKED_RANGE:       return "blocked_range";
+        case EventType::BLOCKED_BAN:         return "blocked_ban";
+        case EventType::DOS_DETECTED:        return "dos_detected";
+        case EventType::BANS_EXPIRED:        return "bans_expired";
+        case EventType::RATE_WINDOW_RESET:   return "rate_window_reset";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Constructs an empty channel with its buffer allocated.
+ * @param log Destination log.
+ * @param id  Channel number.
+ */
+EventChannel::EventChannel(EventLog& log, uint16_t id)
+    : log(log),
+      id(id),
+      buffer(new EventRecord[CAPACITY]),
+      used(0)
+{
+}
+
+/**
+ * @brief Writes the buffered records as one RECORDS block.
+ */
+void EventChannel::flush() {
+    if (used == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        if (log.accepting) {
+            log.writeBlock(BLOCK_RECORDS, id, static_cast<uint32_t>(used), buffer.get(), used * sizeof(EventRecord));
+        }
+        log.flushedRecords += used;
+    }
+    used = 0;
+}
+
+/**
+ * @brief Constructs a closed log.
+ */
+EventLog::EventLog() : flushedRecords(0), accepting(false) {}
+
+/**
+ * @brief Flushes and closes the file.
+ */
+EventLog::~EventLog() {
+    close();
+}
+
+/**
+ * @brief Creates the file and writes its header.
+ * @param path Destination file.
+ * @return @c true on success.
+ */
+bool EventLog::open(const std::string& path) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    uint32_t recordSize = sizeof(EventRecord);
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(&BYTE_ORDER_MARK), sizeof(BYTE_ORDER_MARK));
+    file.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+    channels.clear();
+    flushedRecords = 0;
+    accepting = static_cast<bool>(file);
+    return accepting;
+}
+
+/**
+ * @brief Reports whether records are accepted.
+ * @return @c accepting.
+ */
+bool EventLog::isOpen() const {
+    return accepting;
+}
+
+/**
+ * @brief Creates the next channel and writes its CHANNEL block.
+ * @param name Producer name.
+ * @return New channel, or @c nullptr when closed.
+ */
+EventChannel* EventLog::addChannel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!accepting) {
+        return nullptr;
+    }
+    uint16_t id = static_cast<uint16_t>(channels.size());
+    channels.emplace_back(new EventChannel(*this, id));
+    writeBlock(BLOCK_CHANNEL, id, static_cast<uint32_t>(name.size()), name.data(), name.size());
+    return channels.back().get();
+}
+
+/**
+ * @brief Writes a LABEL block for rule @p index.
+ * @param index Rule index.
+ * @param label Rule text.
+ */
+void EventLog::addLabel(uint32_t index, const std::string& label) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!accepting) {
+        return;
+    }
+    std::string payload(sizeof(index), '\0');
+    std::memcpy(&payload[0], &index, sizeof(index));
+    payload += label;
+    writeBlock(BLOCK_LABEL, 0, static_cast<uint32_t>(payload.size()), payload.data(), payload.size());
+}
+
+/**
+ * @brief Flushes every channel, then closes the file.
+ *
+ * @details Channels stay allocated, so producers still holding one can keep
+ * calling record(); their records are counted but no longer written.
+ *
+ * @return @c true if every write succeeded.
+ */
+bool EventLog::close() {
+    for (std::unique_ptr<EventChannel>& channel : channels) {
+        channel->flush();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) {
+        return true;
+    }
+    file.flush();
+    bool ok = static_cast<bool>(file);
+    file.close();
+    accepting = false;
+    return ok;
+}
+
+/**
+ * @brief Returns the records written plus those still buffered.
+ * @return Record count.
+ */
+uint64_t EventLog::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t count = flushedRecords;
+    for (const std::unique_ptr<EventChannel>& channel : channels) {
+        count += channel->used;
+    }
+    return count;
+}
+
+/**
+ * @brief Writes a block header and its padded payload.
+ *
+ * @param kind    Block kind.
+ * @param channel Channel number.
+ * @param length  Length field.
+ * @param payload Payload bytes.
+ * @param bytes   Payload size.
+ */
+void EventLog::writeBlock(uint8_t kind, uint16_t channel, uint32_t length, const void* payload, size_t bytes) {
+    static const char zeros[8] = {};
+    BlockHeader header = {kind, 0, channel, length};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(static_cast<const char*>(payload), static_cast<std::streamsize>(bytes));
+    file.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+}
+
+/**
+ * @brief Constructs a reader with no file.
+ */
+EventLogReader::EventLogReader() : data(nullptr), length(0) {}
+
+/**
+ * @brief Releases the mapping.
+ */
+EventLogReader::~EventLogReader() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+/**
+ * @brief Maps @p path read-only and walks its blocks once.
+ *
+ * @param path  Event-log file.
+ * @param error Receives the reason on failure.
+ * @return @c true on success.
+ */
+bool EventLogReader::open(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open '" + path + "'";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 16) {
+        ::close(fd);
+        error = "'" + path + "' is not an event log";
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map '" + path + "'";
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapping);
+    length = size;
+
+    uint32_t byteOrder = 0;
+    uint32_t recordSize = 0;
+    std::memcpy(&byteOrder, data + 8, sizeof(byteOrder));
+    std::memcpy(&recordSize, data + 12, sizeof(recordSize));
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "'" + path + "' is not an event log";
+        return false;
+    }
+    if (byteOrder != BYTE_ORDER_MARK || recordSize != sizeof(EventRecord)) {
+        error = "'" + path + "' was written with a different byte order or record layout";
+        return false;
+    }
+
+    size_t pos = 16;
+    while (pos + sizeof(BlockHeader) <= length) {
+        BlockHeader header;
+        std::memcpy(&header, data + pos, sizeof(header));
+        pos += sizeof(header);
+
+        size_t bytes = header.length;
+        if (header.kind == BLOCK_RECORDS) {
+            bytes *= sizeof(EventRecord);
+        }
+        if (bytes > length - pos) {
+            error = "'" + path + "' is truncated at byte " + std::to_string(pos - sizeof(header));
+            return false;
+        }
+
+        const char* payload = data + pos;
+        if (header.kind == BLOCK_CHANNEL) {
+            channelAt(header.channel).name.assign(payload, bytes);
+        } else if (header.kind == BLOCK_LABEL && bytes >= sizeof(uint32_t)) {
+            uint32_t index = 0;
+            std::memcpy(&index, payload, sizeof(index));
+            if (index >= MAX_LABELS) {
+                error = "'" + path + "' has a corrupt rule label";
+                return false;
+            }
+            if (index >= labels.size()) {
+                labels.resize(index + 1);
+            }
+            labels[index].assign(payload + sizeof(index), bytes - sizeof(index));
+        } else if (header.kind == BLOCK_RECORDS && header.length > 0) {
+            Span span = {reinterpret_cast<const EventRecord*>(payload), header.length};
+            channelAt(header.channel).spans.push_back(span);
+        }
+        pos += padded(bytes);
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the number of channels seen.
+ * @return Channel count.
+ */
+size_t EventLogReader::channelCount() const {
+    return channels.size();
+}
+
+/**
+ * @brief Returns a channel's name.
+ * @param channel Channel number (less than channelCount()).
+ * @return Name.
+ */
+const std::string& EventLogReader::channelName(size_t channel) const {
+    return channels[channel].name;
+}
+
+/**
+ * @brief Returns a channel's record spans.
+ * @param channel Channel number (less than channelCount()).
+ * @return Spans in file order.
+ */
+const std::vector<EventLogReader::Span>& EventLogReader::channelSpans(size_t channel) const {
+    return channels[channel].spans;
+}
+
+/**
+ * @brief Returns a rule label.
+ * @param index Rule index.
+ * @return Label, or an empty string.
+ */
+const std::string& EventLogReader::ruleLabel(uint32_t index) const {
+    static const std::string none;
+    return index < labels.size() ? labels[index] : none;
+}
+
+/**
+ * @brief Returns the entry for @p channel, adding empty entries up to it.
+ * @param channel Channel number.
+ * @return Channel entry.
+ */
+EventLogReader::Channel& EventLogReader::channelAt(size_t channel) {
+    if (channel >= channels.size()) {
+        channels.resize(channel + 1);
+    }
+    return channels[channel];
+}
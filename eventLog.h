@@ -0,0 +1,317 @@
+/**
+ * @file eventLog.h
+ * @brief Declaration of the binary EventLog, its per-producer EventChannels
+ *        and the EventLogReader used by the lbdecode tool.
+ *
+ * @details The per-cycle progress, scaling and firewall lines of the text
+ * log are several lines of formatted text per balancer per cycle. With an
+ * event log attached (setting <tt>Event Log: &lt;path&gt;</tt>) those events
+ * are instead appended as fixed 24-byte EventRecords, and the text log keeps
+ * only the configuration header and end-of-run reports. @c lbdecode renders
+ * the records back into the text-log lines or into CSV.
+ *
+ * Each producer (the Firewall and every LoadBalancer) owns an EventChannel:
+ * a private buffer of records it fills without synchronisation, so balancers
+ * running on parallel workers never contend. A full buffer is written to the
+ * file as one block under the log's mutex.
+ *
+ * <b>File format</b> — host byte order, which the header records:
+ * @code
+ * header: char magic[8] = "LBEVENT1" | uint32 0x01020304 | uint32 record size (24)
+ * block:  uint8 kind | uint8 reserved | uint16 channel | uint32 length | payload
+ * @endcode
+ * A @c CHANNEL block names a channel (@c length name bytes), a @c LABEL block
+ * gives a firewall rule's text (@c length bytes: uint32 rule index, then the
+ * label), and a @c RECORDS block holds @c length EventRecords of one channel.
+ * Payloads are zero-padded to a multiple of 8 bytes, so every record in a
+ * mapped file is naturally aligned. Within a channel, records are in
+ * non-decreasing cycle order.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @enum EventType
+ * @brief What an EventRecord describes, and so what its fields hold.
+ */
+enum class EventType : uint8_t {
+    CYCLE = 1,            ///< A balancer's cycle: @c server active servers, @c queueDepth queue after dispatch, @c srcIp arrivals.
+    SERVER_ALLOCATED,     ///< @c server joined the pool.
+    SERVER_DEALLOCATED,   ///< @c server was retired.
+    NO_IDLE_SERVER,       ///< A scale-down found no idle server to retire.
+    SERVER_PROVISIONING,  ///< A server was requested; @c server is the tick it will be ready.
+    BLOCKED_RANGE,        ///< Request dropped by static rule @c server; @c srcIp / @c dstIp are its addresses.
+    BLOCKED_BAN,          ///< Request dropped because @c srcIp is banned.
+    DOS_DETECTED,         ///< @c srcIp exceeded the rate limit of @c server requests per window and was banned.
+    BANS_EXPIRED,         ///< @c server bans were lifted.
+    RATE_WINDOW_RESET     ///< The fixed rate-limit window restarted.
+};
+
+/**
+ * @brief Returns the lower-case name of @p type, as used in CSV output.
+ * @param type Event type.
+ * @return Name, or @c "unknown".
+ */
+const char* eventTypeName(EventType type);
+
+/**
+ * @struct EventRecord
+ * @brief One logged event; fields unused by its type are zero.
+ */
+struct EventRecord {
+    uint32_t cycle;       ///< Clock tick of the event.
+    uint16_t channel;     ///< Producing channel (firewall or load balancer).
+    uint8_t type;         ///< EventType.
+    uint8_t reserved;     ///< Zero.
+    uint32_t server;      ///< Server id, or the type's count or tick.
+    uint32_t queueDepth;  ///< Queue length, for CYCLE records.
+    uint32_t srcIp;       ///< Packed source address, or for CYCLE records the arrival count.
+    uint32_t dstIp;       ///< Packed destination address.
+};
+static_assert(sizeof(EventRecord) == 24, "EventRecord must stay 24 bytes");
+
+class EventLog;
+
+/**
+ * @class EventChannel
+ * @brief One producer's buffered stream of records into an EventLog.
+ *
+ * @details Not thread-safe: each channel must be fed by one thread at a time.
+ */
+class EventChannel {
+    public:
+        static const size_t CAPACITY = 4096;  ///< Records buffered before a block is written.
+
+        /**
+         * @brief Appends a record, writing the buffer out first if it is full.
+         *
+         * @param type       Event type.
+         * @param cycle      Clock tick.
+         * @param server     Server id or count; see EventType.
+         * @param queueDepth Queue length, for CYCLE records.
+         * @param srcIp      Source address or arrival count.
+         * @param dstIp      Destination address.
+         */
+        void record(EventType type, int cycle, uint32_t server = 0, uint32_t queueDepth = 0,
+                    uint32_t srcIp = 0, uint32_t dstIp = 0);
+
+        /**
+         * @brief Writes the buffered records to the log as one block.
+         */
+        void flush();
+
+    private:
+        friend class EventLog;
+
+        EventLog& log;                          ///< Destination log.
+        uint16_t id;                            ///< Channel number in the file.
+        std::unique_ptr<EventRecord[]> buffer;  ///< @c CAPACITY records.
+        size_t used;                            ///< Records in @c buffer.
+
+        /**
+         * @brief Constructs an empty channel.
+         * @param log Destination log.
+         * @param id  Channel number.
+         */
+        EventChannel(EventLog& log, uint16_t id);
+};
+
+/**
+ * @class EventLog
+ * @brief Binary event-log file shared by any number of EventChannels.
+ */
+class EventLog {
+    public:
+        /**
+         * @brief Constructs a closed log.
+         */
+        EventLog();
+
+        /**
+         * @brief Flushes every channel and closes the file.
+         */
+        ~EventLog();
+
+        EventLog(const EventLog&) = delete;
+        EventLog& operator=(const EventLog&) = delete;
+
+        /**
+         * @brief Creates (truncating) @p path and writes the file header.
+         * @param path Destination file.
+         * @return @c false if the file could not be created.
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Reports whether open() succeeded and close() has not been called.
+         * @return @c true while records can be written.
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Adds a channel and records its name in the file.
+         *
+         * @param name Producer name, e.g. @c "firewall" or a balancer's job class.
+         * @return Channel owned by the log, valid until the log is destroyed;
+         *         @c nullptr if the log is not open.
+         */
+        EventChannel* addChannel(const std::string& name);
+
+        /**
+         * @brief Records the text of firewall rule @p index for BLOCKED_RANGE records.
+         * @param index Rule index.
+         * @param label Rule text, e.g. @c "10.0.0.0/8".
+         */
+        void addLabel(uint32_t index, const std::string& label);
+
+        /**
+         * @brief Flushes every channel and closes the file.
+         * @return @c false if any write failed.
+         */
+        bool close();
+
+        /**
+         * @brief Returns the number of records written or buffered so far.
+         * @return Record count.
+         */
+        uint64_t getRecordCount() const;
+
+    private:
+        friend class EventChannel;
+
+        std::ofstream file;                                   ///< Destination file.
+        std::vector<std::unique_ptr<EventChannel>> channels;  ///< Channels, by id.
+        uint64_t flushedRecords;                              ///< Records already in the file.
+        bool accepting;                                       ///< Whether records are accepted.
+        mutable std::mutex mutex;                             ///< Serialises block writes.
+
+        /**
+         * @brief Writes one block; the caller holds @c mutex.
+         *
+         * @param kind    Block kind.
+         * @param channel Channel number.
+         * @param length  Value of the block's length field.
+         * @param payload Payload bytes.
+         * @param bytes   Payload size, padded to 8 on write.
+         */
+        void writeBlock(uint8_t kind, uint16_t channel, uint32_t length, const void* payload, size_t bytes);
+};
+
+/**
+ * @class EventLogReader
+ * @brief Read-only, memory-mapped view of an event-log file.
+ *
+ * @details Records are not copied: each channel's records are exposed as
+ * spans of the mapping, in file order.
+ */
+class EventLogReader {
+    public:
+        /**
+         * @struct Span
+         * @brief A run of consecutive records of one channel.
+         */
+        struct Span {
+            const EventRecord* records;  ///< First record, inside the mapping.
+            size_t count;                ///< Number of records.
+        };
+
+        /**
+         * @brief Constructs a reader with no file.
+         */
+        EventLogReader();
+
+        /**
+         * @brief Releases the mapping, if any.
+         */
+        ~EventLogReader();
+
+        EventLogReader(const EventLogReader&) = delete;
+        EventLogReader& operator=(const EventLogReader&) = delete;
+
+        /**
+         * @brief Maps @p path and indexes its blocks.
+         * @param path  Event-log file.
+         * @param error Receives a description of the problem on failure.
+         * @return @c false if the file cannot be read or is not a valid event log.
+         */
+        bool open(const std::string& path, std::string& error);
+
+        /**
+         * @brief Returns the number of channels.
+         * @return Channel count.
+         */
+        size_t channelCount() const;
+
+        /**
+         * @brief Returns the name of channel @p channel.
+         * @param channel Channel number.
+         * @return Name, or an empty string if the channel was never named.
+         */
+        const std::string& channelName(size_t channel) const;
+
+        /**
+         * @brief Returns the record spans of channel @p channel, in file order.
+         * @param channel Channel number.
+         * @return Spans of the channel's records.
+         */
+        const std::vector<Span>& channelSpans(size_t channel) const;
+
+        /**
+         * @brief Returns the text of firewall rule @p index.
+         * @param index Rule index.
+         * @return Label, or an empty string if unknown.
+         */
+        const std::string& ruleLabel(uint32_t index) const;
+
+    private:
+        /**
+         * @struct Channel
+         * @brief Everything the file says about one channel.
+         */
+        struct Channel {
+            std::string name;         ///< From its CHANNEL block.
+            std::vector<Span> spans;  ///< From its RECORDS blocks.
+        };
+
+        const char* data;               ///< Start of the mapping, or @c nullptr.
+        size_t length;                  ///< Size of the mapping.
+        std::vector<Channel> channels;  ///< Indexed by channel number.
+        std::vector<std::string> labels; ///< Rule labels, by index.
+
+        /**
+         * @brief Returns channel @p channel, growing the table if needed.
+         * @param channel Channel number.
+         * @return The channel's entry.
+         */
+        Channel& channelAt(size_t channel);
+};
+
+inline void EventChannel::record(EventType type, int cycle, uint32_t server, uint32_t queueDepth,
+                                 uint32_t srcIp, uint32_t dstIp) {
+    if (used == CAPACITY) {
+        flush();
+    }
+    EventRecord& entry = buffer[used++];
+    entry.cycle = static_cast<uint32_t>(cycle);
+    entry.channel = id;
+    entry.type = static_cast<uint8_t>(type);
+    entry.reserved = 0;
+    entry.server = server;
+    entry.queueDepth = queueDepth;
+    entry.srcIp = srcIp;
+    entry.dstIp = dstIp;
+}
+
+#endif
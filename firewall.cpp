@@ -12,8 +12,11 @@
 
 #include "firewall.h"
 #include <iostream>
-#include <sstream>
+#include <charconv>
 #include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /**
  * @brief Constructs a Firewall with the given DoS thresholds.
@@ -25,34 +28,68 @@ Firewall::Firewall(int dosRateLimit, int dosWindowSize) {
     this->dosRateLimit  = dosRateLimit;
     this->dosWindowSize = dosWindowSize;
     this->totalBlocked  = 0;
+    this->banDuration   = 0;
+    this->lastBanPurge  = 0;
+    this->lastRateWindow = 0;
+    this->rateLimitMode = RateLimitMode::FIXED_WINDOW;
+    this->eventLog = nullptr;
+    this->events = nullptr;
+}
+
+/**
+ * @brief Selects the rate-limiting algorithm and discards old rate state.
+ *
+ * @param mode The algorithm to use from now on.
+ */
+void Firewall::setRateLimitMode(RateLimitMode mode) {
+    rateLimitMode = mode;
+    ipRequestCount.clear();
+}
+
+/**
+ * @brief Sets the lifetime of DoS auto-bans.
+ *
+ * @param cycles Ban length in clock cycles; values <= 0 make bans permanent.
+ */
+void Firewall::setBanDuration(int cycles) {
+    banDuration = cycles > 0 ? cycles : 0;
 }
 
 /**
  * @brief Converts a dotted-decimal IPv4 string to a 32-bit unsigned integer.
  *
- * @details Splits on '.' and packs each octet into the result with bit shifts.
- * Returns 0 if the string cannot be parsed.
+ * @details Walks the characters once, accumulating each octet's digits and
+ * shifting completed octets into the result. Any empty or over-long octet,
+ * value above 255, stray character, or octet count other than four is a
+ * parse failure.
  *
- * @param ip Dotted-decimal string (e.g. "10.0.1.55").
- * @return   32-bit packed representation, MSB = first octet.
+ * @param ip  Dotted-decimal text (e.g. "10.0.1.55").
+ * @param out Receives the packed representation, MSB = first octet.
+ * @return    @c true on success; @c false if @p ip is malformed.
  */
-unsigned int Firewall::ipToUint(const std::string& ip) const {
+bool Firewall::ipToUint(std::string_view ip, unsigned int& out) {
     unsigned int result = 0;
-    std::stringstream ss(ip);
-    std::string octet;
-    int shift = 24;
+    unsigned int octet  = 0;
+    int digits = 0;
+    int octets = 0;
 
-    while (std::getline(ss, octet, '.') && shift >= 0) {
-        try {
-            unsigned int val = std::stoul(octet);
-            if (val > 255) return 0;          // invalid octet
-            result |= (val << shift);
-        } catch (...) {
-            return 0;
+    for (char c : ip) {
+        if (c >= '0' && c <= '9') {
+            octet = octet * 10 + static_cast<unsigned int>(c - '0');
+            if (++digits > 3 || octet > 255) return false;
+        } else if (c == '.') {
+            if (digits == 0 || ++octets > 3) return false;
+            result = (result << 8) | octet;
+            octet  = 0;
+            digits = 0;
+        } else {
+            return false;
         }
-        shift -= 8;
     }
-    return result;
+
+    if (digits == 0 || octets != 3) return false;
+    out = (result << 8) | octet;
+    return true;
 }
 
 /**
@@ -62,33 +99,100 @@ unsigned int Firewall::ipToUint(const std::string& ip) const {
  * the subnet mask: prefix bits set from the MSB, remaining bits cleared.
  * A prefix of 32 blocks exactly one host; a prefix of 0 blocks everything.
  *
- * @param cidr CIDR notation string such as @c "192.168.0.0/16".
+ * @param cidr     CIDR notation string such as @c "192.168.0.0/16".
+ * @param announce Whether to print a confirmation line.
+ */
+void Firewall::blockRange(const std::string& cidr, bool announce) {
+    if (addRange(cidr, true) && announce) {
+        std::cout << "[Firewall] Blocked range added: " << cidr << std::endl;
+    }
+}
+
+/**
+ * @brief Reads a block-list file and registers every range it contains.
+ *
+ * @details Leading and trailing whitespace is trimmed from each line. Entries
+ * without a '/' are treated as single hosts. Invalid entries produce a
+ * warning; both invalid and duplicate entries are skipped without aborting
+ * the load and are counted in the summary line.
+ *
+ * @param path     Path of the block-list file.
+ * @param announce Whether to print the summary line.
+ * @return Number of ranges added, or -1 if the file could not be opened.
  */
-void Firewall::blockRange(const std::string& cidr) {
+int Firewall::loadBlockList(const std::string& path, bool announce) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "[Firewall] WARNING: could not open block list '" << path << "' — skipping." << std::endl;
+        return -1;
+    }
+
+    int added = 0;
+    int skipped = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        size_t last = line.find_last_not_of(" \t\r");
+        std::string entry = line.substr(first, last - first + 1);
+        if (entry.find('/') == std::string::npos) {
+            entry += "/32";
+        }
+
+        if (addRange(entry, false))
+            added++;
+        else
+            skipped++;
+    }
+
+    if (announce) {
+        std::cout << "[Firewall] Loaded " << added << " blocked ranges from " << path;
+        if (skipped > 0) {
+            std::cout << " (" << skipped << " skipped)";
+        }
+        std::cout << std::endl;
+    }
+    return added;
+}
+
+/**
+ * @brief Parses a CIDR string and registers it in the range list and trie.
+ *
+ * @param cidr            CIDR notation string such as @c "192.168.0.0/16".
+ * @param warnOnDuplicate Whether to print a warning for an already-present range.
+ * @return @c true if the range was added; @c false otherwise.
+ */
+bool Firewall::addRange(const std::string& cidr, bool warnOnDuplicate) {
     // Split on '/'
     size_t slash = cidr.find('/');
     if (slash == std::string::npos) {
         std::cerr << "[Firewall] WARNING: invalid CIDR '" << cidr << "' — skipping." << std::endl;
-        return;
+        return false;
     }
 
-    std::string ipPart     = cidr.substr(0, slash);
-    std::string prefixPart = cidr.substr(slash + 1);
+    std::string_view ipPart     = std::string_view(cidr).substr(0, slash);
+    std::string_view prefixPart = std::string_view(cidr).substr(slash + 1);
 
     int prefix = 0;
-    try {
-        prefix = std::stoi(prefixPart);
-    } catch (...) {
+    const char* prefixEnd = prefixPart.data() + prefixPart.size();
+    std::from_chars_result parsed = std::from_chars(prefixPart.data(), prefixEnd, prefix);
+    if (prefixPart.empty() || parsed.ec != std::errc() || parsed.ptr != prefixEnd) {
         std::cerr << "[Firewall] WARNING: invalid prefix in '" << cidr << "' — skipping." << std::endl;
-        return;
+        return false;
     }
 
     if (prefix < 0 || prefix > 32) {
         std::cerr << "[Firewall] WARNING: prefix out of range in '" << cidr << "' — skipping." << std::endl;
-        return;
+        return false;
     }
 
-    unsigned int network = ipToUint(ipPart);
+    unsigned int network = 0;
+    if (!ipToUint(ipPart, network)) {
+        std::cerr << "[Firewall] WARNING: invalid address in '" << cidr << "' — skipping." << std::endl;
+        return false;
+    }
     // Build mask: prefix 1-bits from the MSB
     unsigned int mask = (prefix == 0) ? 0u : (~0u << (32 - prefix));
 
@@ -97,111 +201,441 @@ void Firewall::blockRange(const std::string& cidr) {
     range.mask    = mask;
     range.label   = cidr;
 
+    if (!rangeIndex.insert(range.network, prefix, static_cast<int>(blockedRanges.size()))) {
+        if (warnOnDuplicate) {
+            std::cerr << "[Firewall] WARNING: duplicate range '" << cidr << "' — skipping." << std::endl;
+        }
+        return false;
+    }
+
+    if (eventLog != nullptr) {
+        eventLog->addLabel(static_cast<uint32_t>(blockedRanges.size()), range.label);
+    }
     blockedRanges.push_back(range);
-    std::cout << "[Firewall] Blocked range added: " << cidr << std::endl;
+    rangeNetworks.push_back(range.network);
+    rangeMasks.push_back(range.mask);
+    return true;
+}
+
+/**
+ * @brief Finds the longest blocked range that covers a packed IP.
+ *
+ * @param ip Packed source IP to test.
+ * @return   The matching range, or @c nullptr if none matches.
+ */
+const IpRange* Firewall::matchBlockedRange(unsigned int ip) const {
+    int index = rangeIndex.lookup(ip);
+    return index < 0 ? nullptr : &blockedRanges[index];
+}
+
+/**
+ * @brief Builds the range-hit bitmap for the gathered burst.
+ *
+ * @details The vector path takes sixteen addresses (four registers) per
+ * step, so each range's broadcast mask and network serve four compares;
+ * the per-register hit masks are OR-reduced over all ranges and their sign
+ * bits packed into the bitmap with @c movemask. Blocks start on multiples
+ * of sixteen, so a step never straddles a bitmap word. The tail, and
+ * builds without SSE2, use the same AND-compare in scalar form.
+ */
+void Firewall::markBlockedSources() {
+    size_t count = sourceBatch.size();
+    rangeHits.assign((count + 63) / 64, 0);
+    if (blockedRanges.empty()) {
+        return;
+    }
+
+    const uint32_t* ips = sourceBatch.data();
+    if (blockedRanges.size() > VECTOR_RANGE_LIMIT) {
+        for (size_t i = 0; i < count; i++) {
+            if (rangeIndex.lookup(ips[i]) >= 0) {
+                rangeHits[i / 64] |= 1ull << (i % 64);
+            }
+        }
+        return;
+    }
+
+    size_t ranges = blockedRanges.size();
+    const uint32_t* networks = rangeNetworks.data();
+    const uint32_t* masks = rangeMasks.data();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= count; i += 16) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(ips + i);
+        __m128i a = _mm_loadu_si128(block);
+        __m128i b = _mm_loadu_si128(block + 1);
+        __m128i c = _mm_loadu_si128(block + 2);
+        __m128i d = _mm_loadu_si128(block + 3);
+        __m128i hitA = _mm_setzero_si128();
+        __m128i hitB = _mm_setzero_si128();
+        __m128i hitC = _mm_setzero_si128();
+        __m128i hitD = _mm_setzero_si128();
+
+        for (size_t r = 0; r < ranges; r++) {
+            __m128i mask = _mm_set1_epi32(static_cast<int>(masks[r]));
+            __m128i network = _mm_set1_epi32(static_cast<int>(networks[r]));
+            hitA = _mm_or_si128(hitA, _mm_cmpeq_epi32(_mm_and_si128(a, mask), network));
+            hitB = _mm_or_si128(hitB, _mm_cmpeq_epi32(_mm_and_si128(b, mask), network));
+            hitC = _mm_or_si128(hitC, _mm_cmpeq_epi32(_mm_and_si128(c, mask), network));
+            hitD = _mm_or_si128(hitD, _mm_cmpeq_epi32(_mm_and_si128(d, mask), network));
+        }
+
+        uint64_t bits = static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hitA)))
+                      | static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hitB))) << 4
+                      | static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hitC))) << 8
+                      | static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(hitD))) << 12;
+        rangeHits[i / 64] |= bits << (i % 64);
+    }
+#endif
+
+    for (; i < count; i++) {
+        bool hit = false;
+        for (size_t r = 0; r < ranges; r++) {
+            hit |= (ips[i] & masks[r]) == networks[r];
+        }
+        if (hit) {
+            rangeHits[i / 64] |= 1ull << (i % 64);
+        }
+    }
+}
+
+/**
+ * @brief Tests whether an IP holds an unexpired DoS auto-ban.
+ *
+ * @param ip        Packed source IP to test.
+ * @param clockTime Current simulation clock tick.
+ * @return          @c true if banned and the ban has not yet expired.
+ */
+bool Firewall::isAutoBlocked(unsigned int ip, int clockTime) const {
+    const int* bannedAt = autoBlockedIps.find(ip);
+    if (bannedAt == nullptr) {
+        return false;
+    }
+    return banDuration == 0 || clockTime - *bannedAt < banDuration;
+}
+
+/**
+ * @brief Drops bans that have outlived @c banDuration.
+ *
+ * @details Deletes the expired entries in place; called at most once per
+ * @c banDuration cycles so the cost is amortised across many requests.
+ *
+ * @param clockTime Current simulation clock tick.
+ * @param logger    Logger for recording the purge.
+ */
+void Firewall::purgeExpiredBans(int clockTime, Logger& logger) {
+    size_t expired = autoBlockedIps.eraseIf([&](unsigned int, int bannedAt) {
+        return clockTime - bannedAt >= banDuration;
+    });
+    lastBanPurge = clockTime;
+
+    if (expired > 0 && events != nullptr) {
+        events->record(EventType::BANS_EXPIRED, clockTime, static_cast<uint32_t>(expired));
+    } else if (expired > 0) {
+        LOG_COLOR(logger, LogLevel::INFO, RED) << "[Firewall] " << expired << " DoS bans expired at clock " << clockTime;
+    }
 }
 
 /**
- * @brief Tests whether a dotted-decimal IP falls within any blocked range.
+ * @brief Counts a request from @p ip and checks it against the active limit.
  *
- * @param ip Source IP string to test.
- * @return   @c true if at least one range matches.
+ * @details Performs a single table lookup per request. Windowed state is
+ * rolled forward lazily when a source is next seen, so quiet sources cost
+ * nothing between requests.
+ *
+ * @param ip        Packed source IP.
+ * @param clockTime Current simulation clock tick.
+ * @return          @c true if this request exceeds the limit.
  */
-bool Firewall::isInBlockedRange(const std::string& ip) const {
-    unsigned int ipInt = ipToUint(ip);
-    for (const IpRange& range : blockedRanges) {
-        if ((ipInt & range.mask) == range.network) {
-            return true;
+bool Firewall::exceedsRateLimit(unsigned int ip, int clockTime) {
+    int window = dosWindowSize > 0 ? clockTime / dosWindowSize : 0;
+    RateCounter fresh = {window, 0, 0, clockTime, static_cast<float>(dosRateLimit)};
+    RateCounter& counter = ipRequestCount.findOrInsert(ip, fresh);
+
+    switch (rateLimitMode) {
+        case RateLimitMode::FIXED_WINDOW:
+            return ++counter.current > dosRateLimit;
+
+        case RateLimitMode::SLIDING_WINDOW: {
+            if (counter.window != window) {
+                counter.previous = (counter.window == window - 1) ? counter.current : 0;
+                counter.current  = 0;
+                counter.window   = window;
+            }
+            counter.current++;
+            if (dosWindowSize <= 0) {
+                return counter.current > dosRateLimit;
+            }
+
+            // previous * (remaining overlap / window) + current > limit, in integers
+            long long elapsed  = clockTime - static_cast<long long>(window) * dosWindowSize;
+            long long weighted = counter.previous * (dosWindowSize - elapsed)
+                               + static_cast<long long>(counter.current) * dosWindowSize;
+            return weighted > static_cast<long long>(dosRateLimit) * dosWindowSize;
+        }
+
+        case RateLimitMode::TOKEN_BUCKET: {
+            if (dosWindowSize > 0) {
+                float refill = static_cast<float>(clockTime - counter.lastRefill)
+                             * dosRateLimit / dosWindowSize;
+                counter.tokens = std::min(static_cast<float>(dosRateLimit), counter.tokens + refill);
+            }
+            counter.lastRefill = clockTime;
+            if (counter.tokens < 1.0f) {
+                return true;
+            }
+            counter.tokens -= 1.0f;
+            return false;
         }
     }
     return false;
 }
 
 /**
- * @brief Tests whether an IP has been auto-blocked by the DoS detector.
+ * @brief Resets or prunes per-IP rate state at a window boundary.
  *
- * @param ip Source IP string to test.
- * @return   @c true if found in @c autoBlockedIps.
+ * @details In fixed-window mode every counter restarts, so the table is
+ * cleared in place (its capacity is kept, so there is no rehash when the
+ * next burst arrives). The continuous modes already roll each entry forward
+ * when its source is next seen, so they only drop entries that have gone
+ * quiet long enough to be indistinguishable from a new source, deleting
+ * them in place without reallocating or rehashing the table.
+ *
+ * @param clockTime Current simulation clock tick.
+ * @param logger    Logger receiving the window-reset notice.
  */
-bool Firewall::isAutoBlocked(const std::string& ip) const {
-    return std::find(autoBlockedIps.begin(), autoBlockedIps.end(), ip)
-           != autoBlockedIps.end();
+void Firewall::resetRateWindow(int clockTime, Logger& logger) {
+    int window = clockTime / dosWindowSize;
+
+    switch (rateLimitMode) {
+        case RateLimitMode::FIXED_WINDOW:
+            if (events != nullptr) {
+                events->record(EventType::RATE_WINDOW_RESET, clockTime);
+            } else {
+                LOG_COLOR(logger, LogLevel::DEBUG, RED) << "[Firewall] DoS window reset at clock " << clockTime;
+            }
+            ipRequestCount.clear();
+            break;
+
+        case RateLimitMode::SLIDING_WINDOW:
+            ipRequestCount.eraseIf([&](unsigned int, const RateCounter& counter) {
+                return counter.window < window - 1;
+            });
+            break;
+
+        case RateLimitMode::TOKEN_BUCKET:
+            ipRequestCount.eraseIf([&](unsigned int, const RateCounter& counter) {
+                return clockTime - counter.lastRefill >= dosWindowSize;
+            });
+            break;
+    }
 }
 
 /**
- * @brief Filters incoming requests, dropping blocked or rate-exceeded sources.
+ * @brief Filters incoming requests in place, dropping blocked or rate-exceeded sources.
+ *
+ * @details Processing order:
+ *  -# If @c clockTime falls in a new DoS window, reset or prune the
+ *     per-IP rate state (auto-blocked IPs remain blocked), and purge expired
+ *     bans when due.
+ *  -# Gather the burst's source IPs and mark those in a static blocked
+ *     range with markBlockedSources().
+ *
+ * Then, per request in arrival order:
+ *  -# Drop if the range bitmap flags it.
+ *  -# Drop if the source IP holds an unexpired auto-ban.
+ *  -# Record the request in the source's rate state; if it now exceeds the
+ *     limit for the active RateLimitMode, auto-block the IP (re-banning it if
+ *     an earlier ban expired) and drop this request.
+ *  -# Otherwise keep the request, moving it down over any dropped ones.
  *
- * @details Processing order per request:
- *  -# If @c clockTime is the start of a new DoS window, reset all per-IP counters
- *     (auto-blocked IPs remain blocked permanently).
- *  -# Drop if the source IP is in a static blocked range.
- *  -# Drop if the source IP was previously auto-blocked.
- *  -# Increment the per-IP request counter; if it now exceeds @c dosRateLimit,
- *     auto-block the IP and drop this request.
- *  -# Otherwise allow the request through.
+ * The stateful rate checks stay sequential so that bans and log lines
+ * come out exactly as they would one request at a time.
  *
- * @param requests  Raw burst of incoming requests for this cycle.
+ * @param requests  Burst of incoming requests for this cycle; compacted to
+ *                  the requests that passed all firewall checks.
  * @param clockTime Current simulation clock tick.
- * @param logFile   Open log stream for recording block events.
- * @return          Vector of requests that passed all firewall checks.
+ * @param logger    Logger for recording block events.
  */
-std::vector<Request> Firewall::filterRequests(const std::vector<Request>& requests,
-                                               int clockTime,
-                                               std::ofstream& logFile) {
-    // Reset per-IP counters at the start of each new window
-    if (dosWindowSize > 0 && clockTime % dosWindowSize == 0 && clockTime != 0) {
-        std::cout << RED << "[Firewall] DoS window reset at clock " << clockTime << RESET << std::endl;
-        logFile   << "[Firewall] DoS window reset at clock " << clockTime << std::endl;
-        ipRequestCount.clear();
+void Firewall::filterRequests(std::vector<Request>& requests, int clockTime, Logger& logger) {
+    // Reset or prune per-IP rate state on the first call in each new window.
+    // Comparing window indices rather than testing for the boundary tick keeps
+    // this correct when the event-driven engine skips the boundary itself.
+    if (dosWindowSize > 0 && clockTime / dosWindowSize != lastRateWindow) {
+        lastRateWindow = clockTime / dosWindowSize;
+        resetRateWindow(clockTime, logger);
     }
 
-    std::vector<Request> allowed;
+    if (banDuration > 0 && clockTime - lastBanPurge >= banDuration) {
+        purgeExpiredBans(clockTime, logger);
+    }
 
-    for (const Request& req : requests) {
-        const std::string& srcIp = req.getIPin();
+    sourceBatch.resize(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+        sourceBatch[i] = requests[i].getIPin();
+    }
+    markBlockedSources();
+
+    size_t kept = 0;
+    uint64_t rangeBlocked = 0;
+    uint64_t banBlocked = 0;
+    uint64_t rateBlocked = 0;
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Request& req = requests[i];
+        unsigned int srcIp = sourceBatch[i];
 
         // --- Check 1: static blocked range ---
-        if (isInBlockedRange(srcIp)) {
-            std::cout << RED << "[Firewall] BLOCKED (range)  src=" << srcIp
-                      << "  dst=" << req.getIPout() << RESET << std::endl;
-            logFile   << "[Firewall] BLOCKED (range)  src=" << srcIp
-                      << "  dst=" << req.getIPout() << std::endl;
+        if (rangeHits[i / 64] & (1ull << (i % 64))) {
+            const IpRange* range = matchBlockedRange(srcIp);
+            if (events != nullptr) {
+                events->record(EventType::BLOCKED_RANGE, clockTime, static_cast<uint32_t>(range - blockedRanges.data()),
+                               0, srcIp, req.getIPout());
+            } else {
+                LOG_COLOR(logger, LogLevel::INFO, RED) << "[Firewall] BLOCKED (range)  src=" << formatIP(srcIp)
+                                                       << "  dst=" << formatIP(req.getIPout())
+                                                       << "  rule=" << range->label;
+            }
             totalBlocked++;
+            rangeBlocked++;
             continue;
         }
 
         // --- Check 2: previously auto-blocked IP ---
-        if (isAutoBlocked(srcIp)) {
-            std::cout << RED << "[Firewall] BLOCKED (DoS ban) src=" << srcIp
-                      << "  dst=" << req.getIPout() << RESET << std::endl;
-            logFile   << "[Firewall] BLOCKED (DoS ban) src=" << srcIp
-                      << "  dst=" << req.getIPout() << std::endl;
+        if (isAutoBlocked(srcIp, clockTime)) {
+            if (events != nullptr) {
+                events->record(EventType::BLOCKED_BAN, clockTime, 0, 0, srcIp, req.getIPout());
+            } else {
+                LOG_COLOR(logger, LogLevel::INFO, RED) << "[Firewall] BLOCKED (DoS ban) src=" << formatIP(srcIp)
+                                                       << "  dst=" << formatIP(req.getIPout());
+            }
             totalBlocked++;
+            banBlocked++;
             continue;
         }
 
         // --- Check 3: rate limiting ---
-        ipRequestCount[srcIp]++;
-        if (ipRequestCount[srcIp] > dosRateLimit) {
-            // First time this IP trips the limit — auto-block and log
-            if (ipRequestCount[srcIp] == dosRateLimit + 1) {
-                autoBlockedIps.push_back(srcIp);
-                std::cout << RED << "[Firewall] DoS DETECTED — auto-blocked src=" << srcIp
-                          << "  (exceeded " << dosRateLimit
-                          << " requests/window)" << RESET << std::endl;
-                logFile   << "[Firewall] DoS DETECTED — auto-blocked src=" << srcIp
-                          << "  (exceeded " << dosRateLimit
-                          << " requests/window)" << std::endl;
+        if (exceedsRateLimit(srcIp, clockTime)) {
+            // The IP is not currently banned (checked above), so it has just
+            // tripped the limit — auto-block and log
+            autoBlockedIps.insert(srcIp, clockTime);
+            if (events != nullptr) {
+                events->record(EventType::DOS_DETECTED, clockTime, static_cast<uint32_t>(dosRateLimit), 0, srcIp, req.getIPout());
+            } else {
+                LOG_COLOR(logger, LogLevel::WARN, RED) << "[Firewall] DoS DETECTED — auto-blocked src=" << formatIP(srcIp)
+                                                       << "  (exceeded " << dosRateLimit
+                                                       << " requests/window)";
             }
             totalBlocked++;
+            rateBlocked++;
             continue;
         }
 
         // Request passed all checks
-        allowed.push_back(req);
+        if (kept != i) {
+            requests[kept] = req;
+        }
+        kept++;
     }
 
-    return allowed;
+    rangeDrops.add(rangeBlocked);
+    banDrops.add(banBlocked);
+    rateLimitDrops.add(rateBlocked);
+    passedRequests.add(kept);
+    bannedSources.set(static_cast<int64_t>(autoBlockedIps.size()));
+
+    requests.resize(kept);
+}
+
+/**
+ * @brief Creates the drop counters, one series per reason, and the ban gauge.
+ * @param registry Registry receiving the series.
+ */
+void Firewall::setMetrics(MetricsRegistry& registry) {
+    const char* help = "Requests dropped by the firewall.";
+    rangeDrops = registry.counter("firewall_dropped_total", help, "reason=\"range\"");
+    banDrops = registry.counter("firewall_dropped_total", help, "reason=\"dos_ban\"");
+    rateLimitDrops = registry.counter("firewall_dropped_total", help, "reason=\"rate_limit\"");
+    passedRequests = registry.counter("firewall_passed_total", "Requests allowed through the firewall.");
+    bannedSources = registry.gauge("firewall_banned_sources", "Source addresses on the auto-block list.");
+}
+
+/**
+ * @brief Opens the firewall's channel and writes the labels of the ranges so far.
+ * @param log Event log receiving the firewall's events.
+ */
+void Firewall::setEventLog(EventLog& log) {
+    eventLog = &log;
+    events = log.addChannel("firewall");
+    for (size_t i = 0; i < blockedRanges.size(); i++) {
+        log.addLabel(static_cast<uint32_t>(i), blockedRanges[i].label);
+    }
+}
+
+/**
+ * @brief Writes both IP tables as parallel key and value arrays.
+ * @param out Snapshot being written.
+ */
+void Firewall::saveState(SnapshotWriter& out) const {
+    std::vector<uint32_t> sources;
+    std::vector<RateCounter> counters;
+    ipRequestCount.forEach([&](uint32_t ip, const RateCounter& counter) {
+        sources.push_back(ip);
+        counters.push_back(counter);
+    });
+    std::vector<uint32_t> banned;
+    std::vector<int> bannedAt;
+    autoBlockedIps.forEach([&](uint32_t ip, int tick) {
+        banned.push_back(ip);
+        bannedAt.push_back(tick);
+    });
+
+    out.putTag("FWLL");
+    out.put(rateLimitMode);
+    out.putArray(sources);
+    out.putArray(counters);
+    out.putArray(banned);
+    out.putArray(bannedAt);
+    out.put(totalBlocked);
+    out.put(lastBanPurge);
+    out.put(lastRateWindow);
+}
+
+/**
+ * @brief Reads the arrays written by saveState() and rebuilds both tables.
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool Firewall::restoreState(SnapshotReader& in) {
+    RateLimitMode savedMode = rateLimitMode;
+    std::vector<uint32_t> sources;
+    std::vector<RateCounter> counters;
+    std::vector<uint32_t> banned;
+    std::vector<int> bannedAt;
+    int blocked = 0;
+    int banPurge = 0;
+    int rateWindow = 0;
+    if (!in.expectTag("FWLL") || !in.get(savedMode) || !in.getArray(sources) || !in.getArray(counters)
+        || !in.getArray(banned) || !in.getArray(bannedAt) || !in.get(blocked) || !in.get(banPurge)
+        || !in.get(rateWindow) || sources.size() != counters.size() || banned.size() != bannedAt.size()) {
+        return in.fail();
+    }
+
+    ipRequestCount.clear();
+    if (savedMode == rateLimitMode) {
+        for (size_t i = 0; i < sources.size(); i++) {
+            ipRequestCount.insert(sources[i], counters[i]);
+        }
+    }
+    autoBlockedIps.clear();
+    for (size_t i = 0; i < banned.size(); i++) {
+        autoBlockedIps.insert(banned[i], bannedAt[i]);
+    }
+    totalBlocked = blocked;
+    lastBanPurge = banPurge;
+    lastRateWindow = rateWindow;
+    bannedSources.set(static_cast<int64_t>(autoBlockedIps.size()));
+    return true;
 }
 
 /**
@@ -215,13 +649,11 @@ int Firewall::getTotalBlocked() const {
 /**
  * @brief Logs all currently registered blocked IP ranges.
  *
- * @param logFile Open output stream for logging.
+ * @param logger Logger receiving the listing.
  */
-void Firewall::printBlockedRanges(std::ofstream& logFile) const {
-    std::cout << RED << "[Firewall] Blocked IP ranges (" << blockedRanges.size() << "):" << RESET << std::endl;
-    logFile   << "[Firewall] Blocked IP ranges (" << blockedRanges.size() << "):" << std::endl;
+void Firewall::printBlockedRanges(Logger& logger) const {
+    LOG_COLOR(logger, LogLevel::INFO, RED) << "[Firewall] Blocked IP ranges (" << blockedRanges.size() << "):";
     for (const IpRange& r : blockedRanges) {
-        std::cout << "  " << r.label << std::endl;
-        logFile   << "  " << r.label << std::endl;
+        LOG(logger, LogLevel::INFO) << "  " << r.label;
     }
 }
\ No newline at end of file
@@ -6,11 +6,13 @@
  * the Switch and the LoadBalancer instances. It provides two layers of protection:
  *
  *  1. **Static IP range blocking** — Administrators can manually add CIDR-style
- *     IP ranges (e.g., "192.168.1.0/24") that are permanently blocked.
+ *     IP ranges (e.g., "192.168.1.0/24") that are permanently blocked, either
+ *     one at a time or by bulk-loading a block-list file.
  *
  *  2. **Dynamic DoS detection** — Tracks how many requests each source IP has
  *     submitted within a rolling time window. If a single IP exceeds the
- *     configured rate limit, it is automatically added to the block list.
+ *     configured rate limit, it is automatically added to the block list,
+ *     either permanently or for a configurable number of cycles.
  *
  * Every request passes through isBlocked() before being forwarded to a
  * LoadBalancer. Blocked requests are dropped and logged.
@@ -22,12 +24,19 @@
 #ifndef FIREWALL_H
 #define FIREWALL_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <fstream>
 #include "request.h"
+#include "prefixTrie.h"
+#include "ipTable.h"
 #include "utils.h"
+#include "logger.h"
+#include "metrics.h"
+#include "eventLog.h"
+#include "snapshot.h"
 
 /**
  * @struct IpRange
@@ -42,24 +51,73 @@ struct IpRange {
     std::string label;    ///< Human-readable CIDR string (e.g. "10.0.0.0/8") for logging.
 };
 
+/**
+ * @enum RateLimitMode
+ * @brief Algorithm used by the Firewall to decide when a source exceeds its rate.
+ */
+enum class RateLimitMode {
+    FIXED_WINDOW,    ///< Count per window; all counters reset at each window boundary.
+    SLIDING_WINDOW,  ///< Weighted blend of the previous and current window counts.
+    TOKEN_BUCKET     ///< Bucket of @c dosRateLimit tokens refilled continuously over a window.
+};
+
+/**
+ * @struct RateCounter
+ * @brief Per-source rate-limiter state stored in the Firewall's IpTable.
+ *
+ * @details The fields used depend on the active RateLimitMode: the windowed
+ * modes use @c window, @c current and @c previous; the token bucket uses
+ * @c tokens and @c lastRefill.
+ */
+struct RateCounter {
+    int window;      ///< Index of the window that @c current counts (clockTime / dosWindowSize).
+    int current;     ///< Requests seen in @c window.
+    int previous;    ///< Requests seen in the window before @c window (sliding mode).
+    int lastRefill;  ///< Clock tick at which @c tokens was last topped up.
+    float tokens;    ///< Tokens currently available (token-bucket mode).
+};
+
 /**
  * @class Firewall
  * @brief Filters incoming requests by IP range and per-IP request rate.
  *
  * @details Instantiated once inside the Switch. On each clock cycle the Switch
  * calls filterRequests() with the raw burst of new requests; the Firewall
- * returns only those that are allowed to proceed to the LoadBalancers.
+ * compacts the burst in place so that only the requests allowed to proceed
+ * to the LoadBalancers remain.
  *
  * ### Blocked-range check
- * Each source IP is converted to a 32-bit integer and tested against every
- * registered IpRange via `(ip & mask) == network`. If any range matches,
- * the request is dropped.
+ * The burst's packed source IPs are first gathered into a contiguous array
+ * and tested as a batch, producing a selection bitmap with one bit per
+ * request that falls in any blocked range. With up to
+ * @c VECTOR_RANGE_LIMIT ranges the test is vectorised: each range's mask
+ * and network are broadcast once per block of addresses and compared
+ * against four addresses per SSE2 instruction. Larger block lists are
+ * tested through a PrefixTrie holding every registered IpRange, whose
+ * lookup walks at most 32 nodes however many ranges are loaded. Only the
+ * flagged requests consult the trie again, for the longest matching range
+ * whose label is logged when the request is dropped.
  *
  * ### DoS rate-limit check
- * A per-IP counter tracks how many requests that IP has sent during the current
- * window of @c dosWindowSize clock cycles. Once the counter exceeds
- * @c dosRateLimit the IP is auto-blocked for the remainder of the simulation
- * and logged as a DoS source.
+ * Per-IP RateCounter entries, held in a flat IpTable keyed on the packed
+ * address, track each source's recent request rate. Three algorithms are
+ * available (see RateLimitMode):
+ *  - **Fixed window** (default) counts requests per window of @c dosWindowSize
+ *    cycles and resets every counter at each window boundary.
+ *  - **Sliding window** estimates the count over the last @c dosWindowSize
+ *    cycles by weighting the previous window's count by how much of it still
+ *    overlaps, which closes the 2x burst that straddles a fixed-window reset.
+ *  - **Token bucket** lets each source hold up to @c dosRateLimit tokens,
+ *    refilled at @c dosRateLimit per @c dosWindowSize cycles; a request with
+ *    no token available exceeds the limit.
+ *
+ * Once a source exceeds the limit the IP is auto-blocked and logged as a DoS
+ * source. Bans are
+ * held in an open-addressing IpTable keyed on the packed address, so checking
+ * a source against thousands of bans costs a single hash probe. By default a
+ * ban lasts for the remainder of the simulation; setBanDuration() makes bans
+ * expire, and expired entries are purged periodically so the table does not
+ * grow without bound.
  */
 class Firewall {
 public:
@@ -79,32 +137,65 @@ public:
      * @details Parses the CIDR string into an IpRange and stores it internally.
      * All future requests whose source IP falls within this range will be dropped.
      *
-     * @param cidr A CIDR notation string such as @c "192.168.1.0/24".
+     * @param cidr     A CIDR notation string such as @c "192.168.1.0/24".
+     * @param announce Whether to print a line confirming the new range.
+     *
+     * @note Passing an invalid or duplicate CIDR string prints a warning and
+     *       skips the entry.
+     */
+    void blockRange(const std::string& cidr, bool announce = true);
+
+    /**
+     * @brief Bulk-loads static blocked ranges from a text file.
+     *
+     * @details The file holds one entry per line, either a CIDR string or a
+     * bare address (treated as a /32). Blank lines and lines starting with
+     * @c '#' are ignored. Individual ranges and duplicates are not echoed; a
+     * single summary line is printed instead.
+     *
+     * @param path     Path of the block-list file.
+     * @param announce Whether to print the summary line.
+     * @return Number of ranges added, or -1 if the file could not be opened.
+     */
+    int loadBlockList(const std::string& path, bool announce = true);
+
+    /**
+     * @brief Sets how long a DoS auto-ban stays in force.
+     *
+     * @param cycles Ban length in clock cycles; 0 (the default) makes bans
+     *               permanent. Applies to existing bans as well as new ones.
+     */
+    void setBanDuration(int cycles);
+
+    /**
+     * @brief Selects the rate-limiting algorithm.
+     *
+     * @details Switching modes discards all per-IP rate state; existing bans
+     * are unaffected.
      *
-     * @note Passing an invalid CIDR string prints a warning and skips the entry.
+     * @param mode The algorithm to use from now on.
      */
-    void blockRange(const std::string& cidr);
+    void setRateLimitMode(RateLimitMode mode);
 
     /**
-     * @brief Filters a vector of requests, dropping any that are blocked.
+     * @brief Filters a burst of requests in place, dropping any that are blocked.
      *
-     * @details For each request in @p requests:
-     *  -# The source IP is checked against all static blocked ranges.
+     * @details The whole burst is first tested against the static blocked
+     * ranges as a batch. Then, for each request in @p requests, in order:
+     *  -# Requests flagged by the range test are dropped.
      *  -# The per-IP request counter for this window is incremented; if it
      *     exceeds @c dosRateLimit the IP is auto-blocked and the request dropped.
-     *  -# Passing requests are appended to the returned vector.
+     *  -# Passing requests are moved down over the dropped ones.
      *
-     * At the start of each new DoS window (determined by @p clockTime), all
+     * On the first call in each new DoS window (determined by @p clockTime), all
      * per-IP counters are reset.
      *
-     * @param requests  The raw incoming requests to filter.
+     * @param requests  The raw incoming requests; on return only those that
+     *                  passed filtering remain, in their original order.
      * @param clockTime The current simulation clock tick (used for window resets).
-     * @param logFile   Open output stream; blocked events are written here.
-     * @return          A vector containing only the requests that passed filtering.
+     * @param logger    Logger receiving block events.
      */
-    std::vector<Request> filterRequests(const std::vector<Request>& requests,
-                                        int clockTime,
-                                        std::ofstream& logFile);
+    void filterRequests(std::vector<Request>& requests, int clockTime, Logger& logger);
 
     /**
      * @brief Returns the total number of requests blocked since construction.
@@ -113,56 +204,186 @@ public:
     int getTotalBlocked() const;
 
     /**
-     * @brief Prints all currently blocked IP ranges to stdout and the log file.
-     * @param logFile Open output stream for logging.
+     * @brief Logs all currently blocked IP ranges.
+     * @param logger Logger receiving the listing.
+     */
+    void printBlockedRanges(Logger& logger) const;
+
+    /**
+     * @brief Registers the firewall's series in @p registry.
+     *
+     * @details Drops are counted by reason (@c range, @c dos_ban and
+     * @c rate_limit) alongside passed requests, once per filtered burst; a
+     * gauge tracks how many sources are currently banned.
+     *
+     * @param registry Registry that must outlive the firewall.
      */
-    void printBlockedRanges(std::ofstream& logFile) const;
+    void setMetrics(MetricsRegistry& registry);
+
+    /**
+     * @brief Sends block, ban and rate-window events to @p log instead of the text log.
+     *
+     * @details The labels of the blocked ranges, current and future, are
+     * written to the log so a decoder can name the rule behind each
+     * BLOCKED_RANGE record.
+     *
+     * @param log Open event log that must outlive the firewall.
+     */
+    void setEventLog(EventLog& log);
+
+    /**
+     * @brief Writes the per-source rate state, the active bans and the drop total to @p out.
+     *
+     * @details The blocked ranges, rate limit and ban duration are
+     * configuration and are not written.
+     *
+     * @param out Snapshot being written.
+     */
+    void saveState(SnapshotWriter& out) const;
+
+    /**
+     * @brief Replaces the rate state and bans with those read from @p in.
+     *
+     * @details If the snapshot was taken under a different rate-limit mode,
+     * its per-source counters mean something else and are dropped; bans are
+     * kept either way.
+     *
+     * @param in Snapshot positioned where saveState() wrote.
+     * @return @c false if the snapshot is malformed.
+     */
+    bool restoreState(SnapshotReader& in);
+
+    /**
+     * @brief Converts a dotted-decimal IPv4 string to a 32-bit unsigned integer.
+     *
+     * @details Accepts exactly four decimal octets of one to three digits, each
+     * in [0, 255], separated by single dots and with nothing before or after.
+     * Parsing is done in place: no allocation and no exceptions.
+     *
+     * @param ip  Text such as @c "192.168.1.100".
+     * @param out Receives the packed address (MSB = first octet) on success;
+     *            left unchanged on failure.
+     * @return    @c true if @p ip is a well-formed address. Unlike a 0 sentinel,
+     *            this lets @c "0.0.0.0" parse successfully.
+     */
+    static bool ipToUint(std::string_view ip, unsigned int& out);
 
 private:
+    /**
+     * @brief Largest block list tested with vector compares.
+     *
+     * @details The vector test costs one compare per range per four
+     * addresses, so past this point the trie's bounded walk is cheaper.
+     */
+    static constexpr size_t VECTOR_RANGE_LIMIT = 64;
+
     std::vector<IpRange> blockedRanges; ///< Statically configured blocked subnets.
+    PrefixTrie rangeIndex;              ///< Maps prefixes to indices into @c blockedRanges.
+    std::vector<uint32_t> rangeNetworks; ///< Network of each blocked range, parallel to @c blockedRanges.
+    std::vector<uint32_t> rangeMasks;    ///< Mask of each blocked range, parallel to @c blockedRanges.
+
+    std::vector<uint32_t> sourceBatch;  ///< Scratch: packed source IPs of the current burst.
+    std::vector<uint64_t> rangeHits;    ///< Scratch: selection bitmap, bit @c i set if request @c i is range-blocked.
 
     /**
-     * @brief Maps a source IP string to its request count in the current window.
+     * @brief Maps a packed source IP to its rate-limiter state.
      *
-     * Entries are reset every @c dosWindowSize clock cycles.
+     * In fixed-window mode the table is cleared every @c dosWindowSize clock
+     * cycles; in the other modes idle entries are pruned at the same cadence.
      */
-    std::unordered_map<std::string, int> ipRequestCount;
+    IpTable<RateCounter> ipRequestCount;
+
+    RateLimitMode rateLimitMode;  ///< Active rate-limiting algorithm.
 
     /**
-     * @brief Set of IPs that have been auto-blocked due to DoS detection.
+     * @brief Maps each auto-blocked IP to the clock tick at which it was banned.
      *
-     * Once an IP is in this set it is blocked for the life of the simulation,
-     * even after window resets.
+     * Bans survive window resets. When @c banDuration is positive, entries
+     * older than that are treated as lifted and are purged periodically.
      */
-    std::vector<std::string> autoBlockedIps;
+    IpTable<int> autoBlockedIps;
 
     int dosRateLimit;   ///< Max requests per IP per window before auto-blocking.
     int dosWindowSize;  ///< Clock cycles per rate-limit window.
     int totalBlocked;   ///< Running total of all dropped requests.
+    int banDuration;    ///< Cycles an auto-ban lasts; 0 means permanent.
+
+    Counter rangeDrops;      ///< Requests dropped by a static range.
+    Counter banDrops;        ///< Requests dropped because their source is banned.
+    Counter rateLimitDrops;  ///< Requests that tripped the rate limit.
+    Counter passedRequests;  ///< Requests let through.
+    Gauge bannedSources;     ///< Sources currently auto-blocked.
+    EventLog* eventLog;      ///< Log that receives rule labels, or @c nullptr.
+    EventChannel* events;    ///< Binary event channel, or @c nullptr to log text.
+    int lastBanPurge;   ///< Clock tick of the most recent expired-ban purge.
+    int lastRateWindow; ///< Index of the rate window the per-IP state belongs to.
 
     /**
-     * @brief Converts a dotted-decimal IPv4 string to a 32-bit unsigned integer.
+     * @brief Parses a CIDR string and registers it as a blocked range.
+     *
+     * @param cidr             CIDR notation string such as @c "192.168.1.0/24".
+     * @param warnOnDuplicate  Whether an already-registered range prints a warning.
+     * @return @c true if the range was added; @c false if it was invalid or
+     *         already present.
+     */
+    bool addRange(const std::string& cidr, bool warnOnDuplicate);
+
+    /**
+     * @brief Finds the most specific blocked range covering @p ip.
+     *
+     * @param ip Packed IPv4 address to test.
+     * @return   Pointer to the longest matching range, or @c nullptr if the IP
+     *           is not covered by any blocked range.
+     */
+    const IpRange* matchBlockedRange(unsigned int ip) const;
+
+    /**
+     * @brief Tests every address in @c sourceBatch against the blocked ranges.
      *
-     * @param ip A string such as @c "192.168.1.100".
-     * @return   The IP address packed into a @c uint32_t, or 0 on parse failure.
+     * @details Fills @c rangeHits with one bit per address, set if the
+     * address falls in any blocked range. Uses SSE2 compares when the block
+     * list is no longer than @c VECTOR_RANGE_LIMIT and the trie otherwise.
      */
-    unsigned int ipToUint(const std::string& ip) const;
+    void markBlockedSources();
 
     /**
-     * @brief Tests whether @p ip falls inside any registered blocked range.
+     * @brief Tests whether @p ip is currently auto-blocked by DoS detection.
      *
-     * @param ip Dotted-decimal IPv4 string to test.
-     * @return   @c true if the IP is covered by at least one blocked range.
+     * @param ip        Packed IPv4 address to test.
+     * @param clockTime Current simulation clock tick, used to honour ban expiry.
+     * @return          @c true if the IP holds an unexpired ban.
      */
-    bool isInBlockedRange(const std::string& ip) const;
+    bool isAutoBlocked(unsigned int ip, int clockTime) const;
 
     /**
-     * @brief Tests whether @p ip has been auto-blocked by DoS detection.
+     * @brief Removes expired bans from @c autoBlockedIps.
+     *
+     * @param clockTime Current simulation clock tick.
+     * @param logger    Logger; the purge is logged if it removed anything.
+     */
+    void purgeExpiredBans(int clockTime, Logger& logger);
+
+    /**
+     * @brief Records one request from @p ip and tests it against the rate limit.
+     *
+     * @param ip        Packed source IP.
+     * @param clockTime Current simulation clock tick.
+     * @return          @c true if the request exceeds the limit for the active mode.
+     */
+    bool exceedsRateLimit(unsigned int ip, int clockTime);
+
+    /**
+     * @brief Drops rate state that no longer affects any decision.
+     *
+     * @details Called at each window boundary. Fixed-window mode clears the
+     * table (and logs the reset); sliding-window mode drops entries whose
+     * counts are more than one window old; token-bucket mode drops entries
+     * whose bucket has had a full window to refill.
      *
-     * @param ip Dotted-decimal IPv4 string to test.
-     * @return   @c true if the IP appears in @c autoBlockedIps.
+     * @param clockTime Current simulation clock tick.
+     * @param logger    Logger receiving the window-reset notice.
      */
-    bool isAutoBlocked(const std::string& ip) const;
+    void resetRateWindow(int clockTime, Logger& logger);
 };
 
 #endif
\ No newline at end of file
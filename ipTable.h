@@ -0,0 +1,279 @@
+/**
+ * @file ipTable.h
+ * @brief Declaration and implementation of the IpTable flat hash map.
+ *
+ * @details Defines IpTable, an open-addressing hash table keyed on packed
+ * 32-bit IPv4 addresses. The Firewall uses it wherever it needs per-source
+ * state, so membership tests cost a hash and a short linear probe instead of
+ * a scan or a node-based map lookup.
+ *
+ * Being a class template, the whole implementation lives in this header.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef IPTABLE_H
+#define IPTABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class IpTable
+ * @brief Open-addressing hash map from packed IPv4 addresses to @p Value.
+ *
+ * @details Slots live in a single power-of-two sized vector and collisions are
+ * resolved by linear probing. Keys are hashed with Fibonacci (multiplicative)
+ * hashing, which spreads sequential addresses well. The table doubles when it
+ * becomes half full, and erase() uses backward-shift deletion so lookups never
+ * have to step over tombstones.
+ *
+ * @tparam Value Copyable type stored for each address.
+ */
+template <typename Value>
+class IpTable {
+    public:
+        /**
+         * @brief Constructs an empty table.
+         *
+         * @param initialCapacity Requested number of slots; rounded up to a power
+         *                        of two (minimum 16).
+         */
+        explicit IpTable(size_t initialCapacity = 16) {
+            size_t capacity = 16;
+            while (capacity < initialCapacity) {
+                capacity <<= 1;
+            }
+            reset(capacity);
+        }
+
+        /**
+         * @brief Looks up the value stored for @p ip.
+         * @param ip Packed IPv4 address.
+         * @return Pointer to the stored value, or @c nullptr if absent.
+         */
+        Value* find(uint32_t ip) {
+            size_t i = locate(ip);
+            return slots[i].used ? &slots[i].value : nullptr;
+        }
+
+        /**
+         * @brief Looks up the value stored for @p ip (read-only).
+         * @param ip Packed IPv4 address.
+         * @return Pointer to the stored value, or @c nullptr if absent.
+         */
+        const Value* find(uint32_t ip) const {
+            size_t i = locate(ip);
+            return slots[i].used ? &slots[i].value : nullptr;
+        }
+
+        /**
+         * @brief Returns the value for @p ip, inserting @p initial if absent.
+         *
+         * @details The returned reference stays valid until the next insertion,
+         * which may grow and rehash the table.
+         *
+         * @param ip      Packed IPv4 address.
+         * @param initial Value stored when @p ip is not yet present.
+         * @return Reference to the (possibly new) value.
+         */
+        Value& findOrInsert(uint32_t ip, const Value& initial) {
+            if ((count + 1) * 2 > slots.size()) {
+                grow();
+            }
+
+            size_t i = locate(ip);
+            if (!slots[i].used) {
+                slots[i].key   = ip;
+                slots[i].used  = true;
+                slots[i].value = initial;
+                count++;
+            }
+            return slots[i].value;
+        }
+
+        /**
+         * @brief Stores @p value for @p ip, replacing any existing value.
+         * @param ip    Packed IPv4 address.
+         * @param value Value to store.
+         */
+        void insert(uint32_t ip, const Value& value) {
+            findOrInsert(ip, value) = value;
+        }
+
+        /**
+         * @brief Removes @p ip from the table.
+         *
+         * @details Later entries of the same probe run are shifted back into the
+         * freed slot so the table never contains tombstones.
+         *
+         * @param ip Packed IPv4 address.
+         * @return @c true if an entry was removed.
+         */
+        bool erase(uint32_t ip) {
+            size_t hole = locate(ip);
+            if (!slots[hole].used) {
+                return false;
+            }
+            eraseAt(hole);
+            return true;
+        }
+
+        /**
+         * @brief Removes every entry for which @p predicate returns @c true.
+         *
+         * @details Deletes in place with the same backward shift as erase(),
+         * so the bucket array is neither reallocated nor rehashed. After a
+         * removal the slot is examined again, since an entry from later in
+         * the probe run may have moved into it; entries that wrap round
+         * into already-visited slots were tested before and are tested
+         * again harmlessly.
+         *
+         * @param predicate Callable taking @c (uint32_t ip, const Value&).
+         * @return Number of entries removed.
+         */
+        template <typename Predicate>
+        size_t eraseIf(Predicate predicate) {
+            size_t removed = 0;
+            for (size_t i = 0; i < slots.size(); ) {
+                if (slots[i].used && predicate(slots[i].key, slots[i].value)) {
+                    eraseAt(i);
+                    removed++;
+                } else {
+                    i++;
+                }
+            }
+            return removed;
+        }
+
+        /**
+         * @brief Calls @p visitor for every entry in the table.
+         * @param visitor Callable taking @c (uint32_t ip, const Value&).
+         */
+        template <typename Visitor>
+        void forEach(Visitor visitor) const {
+            for (const Slot& slot : slots) {
+                if (slot.used) {
+                    visitor(slot.key, slot.value);
+                }
+            }
+        }
+
+        /**
+         * @brief Removes all entries while keeping the current capacity.
+         */
+        void clear() {
+            for (Slot& slot : slots) {
+                slot.used = false;
+            }
+            count = 0;
+        }
+
+        /**
+         * @brief Returns the number of stored entries.
+         * @return Entry count.
+         */
+        size_t size() const {
+            return count;
+        }
+
+    private:
+        /**
+         * @struct Slot
+         * @brief One bucket of the table.
+         */
+        struct Slot {
+            uint32_t key;  ///< Packed IPv4 address.
+            bool used;     ///< Whether this slot currently holds an entry.
+            Value value;   ///< Value associated with @c key.
+        };
+
+        std::vector<Slot> slots;  ///< Bucket array; size is always a power of two.
+        size_t count;             ///< Number of occupied slots.
+        int shift;                ///< 32 - log2(slots.size()), used by hash().
+
+        /**
+         * @brief Maps an address to its home slot with Fibonacci hashing.
+         * @param ip Packed IPv4 address.
+         * @return Slot index in [0, slots.size()).
+         */
+        size_t hash(uint32_t ip) const {
+            return static_cast<size_t>((ip * 2654435769u) >> shift);
+        }
+
+        /**
+         * @brief Finds the slot holding @p ip, or the empty slot ending its probe run.
+         * @param ip Packed IPv4 address.
+         * @return Slot index.
+         */
+        size_t locate(uint32_t ip) const {
+            size_t mask = slots.size() - 1;
+            size_t i = hash(ip);
+            while (slots[i].used && slots[i].key != ip) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        /**
+         * @brief Empties the occupied slot @p hole by backward-shift deletion.
+         * @param hole Index of the slot to free.
+         */
+        void eraseAt(size_t hole) {
+            size_t mask = slots.size() - 1;
+            size_t next = (hole + 1) & mask;
+            while (slots[next].used) {
+                size_t home = hash(slots[next].key);
+                // Move the entry back unless its home lies cyclically in (hole, next].
+                if (((next - home) & mask) >= ((next - hole) & mask)) {
+                    slots[hole] = slots[next];
+                    hole = next;
+                }
+                next = (next + 1) & mask;
+            }
+
+            slots[hole].used = false;
+            count--;
+        }
+
+        /**
+         * @brief Inserts a slot known to be absent, without growth checks.
+         * @param slot Occupied slot to copy in.
+         */
+        void place(const Slot& slot) {
+            size_t i = locate(slot.key);
+            slots[i] = slot;
+            count++;
+        }
+
+        /**
+         * @brief Replaces the bucket array with @p capacity empty slots.
+         * @param capacity New power-of-two slot count.
+         */
+        void reset(size_t capacity) {
+            slots.assign(capacity, Slot{0, false, Value()});
+            count = 0;
+            shift = 32;
+            while ((static_cast<size_t>(1) << (32 - shift)) < capacity) {
+                shift--;
+            }
+        }
+
+        /**
+         * @brief Doubles the capacity and rehashes every entry.
+         */
+        void grow() {
+            std::vector<Slot> old;
+            old.swap(slots);
+            reset(old.size() * 2);
+            for (const Slot& slot : old) {
+                if (slot.used) {
+                    place(slot);
+                }
+            }
+        }
+};
+
+#endif
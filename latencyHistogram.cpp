@@ -0,0 +1,166 @@
+/**
+ * @file latencyHistogram.cpp
+ * @brief Implementation of the LatencyHistogram class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "latencyHistogram.h"
+#include <cmath>
+
+/**
+ * @brief Allocates one bucket per representable value range.
+ *
+ * @details A 31-bit value has its top bit at position 30 or below, giving
+ * shifts 0 through 30 - SUB_BUCKET_BITS; shift @c s ends at index
+ * <tt>s * 64 + 127</tt>.
+ */
+LatencyHistogram::LatencyHistogram()
+    : counts((31 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS, 0),
+      total(0),
+      sum(0),
+      maxValue(0)
+{
+}
+
+/**
+ * @brief Computes the bucket of @p value.
+ *
+ * @details With @c s = max(0, msb - SUB_BUCKET_BITS), the value's top
+ * SUB_BUCKET_BITS + 1 bits <tt>value >> s</tt> lie in [64, 128) once
+ * @c s > 0, so <tt>s * 64 + (value >> s)</tt> places consecutive ranges next
+ * to each other without gaps.
+ *
+ * @param value Value to map.
+ * @return Bucket index.
+ */
+size_t LatencyHistogram::bucketIndex(uint32_t value) {
+    int msb = value == 0 ? 0 : 31 - __builtin_clz(value);
+    int shift = msb > SUB_BUCKET_BITS ? msb - SUB_BUCKET_BITS : 0;
+    return static_cast<size_t>(shift) * SUB_BUCKETS + (value >> shift);
+}
+
+/**
+ * @brief Inverts bucketIndex() to the bucket's largest member.
+ * @param index Bucket index.
+ * @return Highest value mapping to @p index.
+ */
+uint32_t LatencyHistogram::bucketHighest(size_t index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return static_cast<uint32_t>(index);
+    }
+    size_t shift = index / SUB_BUCKETS - 1;
+    uint64_t mantissa = index - shift * SUB_BUCKETS;
+    return static_cast<uint32_t>(((mantissa + 1) << shift) - 1);
+}
+
+/**
+ * @brief Counts one value.
+ * @param value Duration in cycles.
+ */
+void LatencyHistogram::record(int value) {
+    if (value < 0) {
+        value = 0;
+    }
+    counts[bucketIndex(static_cast<uint32_t>(value))]++;
+    total++;
+    sum += static_cast<uint64_t>(value);
+    if (value > maxValue) {
+        maxValue = value;
+    }
+}
+
+/**
+ * @brief Adds another histogram's counts bucket by bucket.
+ * @param other Histogram to merge.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    if (other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+}
+
+/**
+ * @brief Returns the number of recorded values.
+ * @return Total count.
+ */
+uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+/**
+ * @brief Returns the mean recorded value.
+ * @return Exact mean, or 0 if empty.
+ */
+double LatencyHistogram::mean() const {
+    return total == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(total);
+}
+
+/**
+ * @brief Returns the largest recorded value.
+ * @return Maximum, or 0 if empty.
+ */
+int LatencyHistogram::max() const {
+    return maxValue;
+}
+
+/**
+ * @brief Walks the cumulative counts to the bucket holding the requested rank.
+ *
+ * @param percentile Percentile in [0, 100].
+ * @return Highest value of that bucket, capped at the recorded maximum.
+ */
+int LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+    if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint32_t highest = bucketHighest(i);
+            return highest < static_cast<uint32_t>(maxValue) ? static_cast<int>(highest) : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * @brief Writes the bucket array followed by the count, sum and maximum.
+ * @param out Snapshot being written.
+ */
+void LatencyHistogram::saveState(SnapshotWriter& out) const {
+    out.putArray(counts);
+    out.put(total);
+    out.put(sum);
+    out.put(maxValue);
+}
+
+/**
+ * @brief Reads the values written by saveState().
+ * @param in Snapshot being read.
+ * @return @c false if the bucket layout differs from this build's.
+ */
+bool LatencyHistogram::restoreState(SnapshotReader& in) {
+    std::vector<uint64_t> restored;
+    if (!in.getArray(restored) || restored.size() != counts.size()) {
+        return in.fail();
+    }
+    counts.swap(restored);
+    return in.get(total) && in.get(sum) && in.get(maxValue);
+}
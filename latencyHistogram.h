@@ -0,0 +1,113 @@
+/**
+ * @file latencyHistogram.h
+ * @brief Declaration of the LatencyHistogram class.
+ *
+ * @details Defines LatencyHistogram, a fixed-size log-linear histogram in the
+ * style of HdrHistogram. Values below 128 get a bucket each; above that every
+ * power-of-two range is split into 64 equal sub-buckets, so any recorded
+ * value is reported to within 1/64 (about 1.6%) of its true size. Recording
+ * is a couple of shifts and an increment, with no allocation after
+ * construction.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "snapshot.h"
+
+/**
+ * @class LatencyHistogram
+ * @brief Counts non-negative durations, in clock cycles, into log-linear buckets.
+ */
+class LatencyHistogram {
+    public:
+        /**
+         * @brief Constructs an empty histogram covering [0, INT32_MAX].
+         */
+        LatencyHistogram();
+
+        /**
+         * @brief Adds one value to the histogram.
+         * @param value Duration in cycles; negative values are recorded as 0.
+         */
+        void record(int value);
+
+        /**
+         * @brief Adds every count of @p other to this histogram.
+         * @param other Histogram to merge in.
+         */
+        void merge(const LatencyHistogram& other);
+
+        /**
+         * @brief Returns the number of recorded values.
+         * @return Total count.
+         */
+        uint64_t count() const;
+
+        /**
+         * @brief Returns the exact mean of the recorded values.
+         * @return Mean, or 0 if empty.
+         */
+        double mean() const;
+
+        /**
+         * @brief Returns the exact largest recorded value.
+         * @return Maximum, or 0 if empty.
+         */
+        int max() const;
+
+        /**
+         * @brief Returns the value at or below which @p percentile percent of the values fall.
+         *
+         * @details The result is the highest value belonging to the bucket that
+         * holds the requested rank, so it never understates the true figure.
+         *
+         * @param percentile Percentile in [0, 100], e.g. 99.9.
+         * @return Value at the percentile, or 0 if empty.
+         */
+        int percentile(double percentile) const;
+
+        /**
+         * @brief Writes the bucket counts and totals to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the recorded values with the state read from @p in.
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        static const int SUB_BUCKET_BITS = 6;                   ///< log2 of the sub-buckets per power of two.
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;    ///< Sub-buckets per power of two.
+
+        std::vector<uint64_t> counts;  ///< Bucket counts, indexed by bucketIndex().
+        uint64_t total;                ///< Number of recorded values.
+        uint64_t sum;                  ///< Sum of recorded values, for mean().
+        int maxValue;                  ///< Largest recorded value.
+
+        /**
+         * @brief Maps a value to its bucket.
+         * @param value Non-negative value.
+         * @return Index into @c counts.
+         */
+        static size_t bucketIndex(uint32_t value);
+
+        /**
+         * @brief Returns the largest value that maps to a bucket.
+         * @param index Index into @c counts.
+         * @return Upper bound of the bucket, inclusive.
+         */
+        static uint32_t bucketHighest(size_t index);
+};
+
+#endif
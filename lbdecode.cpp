@@ -0,0 +1,336 @@
+/**
+ * @file lbdecode.cpp
+ * @brief Offline decoder for binary event logs written with the "Event Log" setting.
+ *
+ * @details Usage:
+ * @code
+ * lbdecode [--csv] [--level debug|info|warn] <event log>
+ * @endcode
+ * By default the records are rendered as the per-cycle, scaling and firewall
+ * lines the text log would have contained, in the same order: for each
+ * cycle, the firewall's lines first, then each load balancer's in
+ * registration order. @c --level drops lines below a level, as the
+ * @c "Log Level" setting does. @c --csv instead prints one row per record:
+ * @code
+ * cycle,source,event,server_id,active_servers,queue_depth,arrivals,src_ip,dst_ip,rule,value
+ * @endcode
+ * where @c value is the ready tick of a provisioning event, the rate limit
+ * of a DoS detection and the number of bans lifted by an expiry. Output goes
+ * to stdout.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "eventLog.h"
+#include "logger.h"
+#include "utils.h"
+
+namespace {
+
+/**
+ * @class ChannelCursor
+ * @brief Walks one channel's records across its spans.
+ */
+class ChannelCursor {
+    public:
+        /**
+         * @brief Positions the cursor on the first record of @p spans.
+         * @param spans Spans of one channel, in file order.
+         */
+        explicit ChannelCursor(const std::vector<EventLogReader::Span>& spans) : spans(&spans), span(0), offset(0) {}
+
+        /**
+         * @brief Reports whether records remain.
+         * @return @c true at the end of the channel.
+         */
+        bool done() const { return span == spans->size(); }
+
+        /**
+         * @brief Returns the current record.
+         * @return Record; only valid while !done().
+         */
+        const EventRecord& current() const { return (*spans)[span].records[offset]; }
+
+        /**
+         * @brief Advances to the next record.
+         */
+        void next() {
+            if (++offset == (*spans)[span].count) {
+                span++;
+                offset = 0;
+            }
+        }
+
+    private:
+        const std::vector<EventLogReader::Span>* spans;  ///< Channel's spans.
+        size_t span;                                     ///< Current span.
+        size_t offset;                                   ///< Record within the span.
+};
+
+/**
+ * @class Renderer
+ * @brief Formats records into a buffer that is written to stdout in large chunks.
+ */
+class Renderer {
+    public:
+        /**
+         * @brief Constructs a renderer.
+         * @param reader Source of channel names and rule labels.
+         * @param csv    Whether to write CSV rather than log text.
+         * @param level  Lowest level of log-text lines to keep.
+         */
+        Renderer(const EventLogReader& reader, bool csv, LogLevel level) : reader(reader), csv(csv), level(level) {
+            if (csv) {
+                out += "cycle,source,event,server_id,active_servers,queue_depth,arrivals,src_ip,dst_ip,rule,value\n";
+            }
+        }
+
+        /**
+         * @brief Writes whatever is still buffered.
+         */
+        ~Renderer() { flush(); }
+
+        /**
+         * @brief Renders the records one channel produced on one cycle.
+         *
+         * @details In log-text mode a group with a CYCLE record is framed by
+         * the balancer's "Running cycle" and "End of cycle" lines.
+         *
+         * @param group Records of the group, in order.
+         */
+        void renderGroup(const std::vector<const EventRecord*>& group) {
+            if (csv) {
+                for (const EventRecord* record : group) {
+                    renderCsv(*record);
+                }
+                return;
+            }
+
+            const EventRecord* cycle = nullptr;
+            for (const EventRecord* record : group) {
+                if (static_cast<EventType>(record->type) == EventType::CYCLE) {
+                    cycle = record;
+                    break;
+                }
+            }
+            const std::string& name = reader.channelName(group.front()->channel);
+            if (cycle != nullptr && keeps(LogLevel::DEBUG)) {
+                out += "Load Balancer " + name + " - Running cycle at clock time: " + std::to_string(cycle->cycle) + "\n";
+                out += "Generated " + std::to_string(cycle->srcIp) + " new requests.\n";
+            }
+            for (const EventRecord* record : group) {
+                renderText(*record);
+            }
+            if (cycle != nullptr && keeps(LogLevel::DEBUG)) {
+                out += "End of cycle for Load Balancer " + name + "\n\n";
+            }
+            if (out.size() >= FLUSH_SIZE) {
+                flush();
+            }
+        }
+
+    private:
+        static const size_t FLUSH_SIZE = 1 << 16;  ///< Buffer size that triggers a write.
+
+        const EventLogReader& reader;  ///< Names and labels.
+        bool csv;                      ///< Output format.
+        LogLevel level;                ///< Log-text threshold.
+        std::string out;               ///< Pending output.
+
+        /**
+         * @brief Reports whether log-text lines at @p lineLevel are kept.
+         * @param lineLevel Level the line had in the text log.
+         * @return @c true if it is at or above the threshold.
+         */
+        bool keeps(LogLevel lineLevel) const { return lineLevel >= level; }
+
+        /**
+         * @brief Appends the log-text line of one record, if its level is kept.
+         * @param record Record to render.
+         */
+        void renderText(const EventRecord& record) {
+            switch (static_cast<EventType>(record.type)) {
+                case EventType::CYCLE:
+                    if (keeps(LogLevel::DEBUG))
+                        out += "Queue Size: " + std::to_string(record.queueDepth) + ", Active Servers: " + std::to_string(record.server) + "\n";
+                    break;
+                case EventType::SERVER_ALLOCATED:
+                    if (keeps(LogLevel::INFO))
+                        out += "Allocated new server with ID: " + std::to_string(record.server) + "\n";
+                    break;
+                case EventType::SERVER_DEALLOCATED:
+                    if (keeps(LogLevel::INFO))
+                        out += "Deallocated server with ID: " + std::to_string(record.server) + "\n";
+                    break;
+                case EventType::NO_IDLE_SERVER:
+                    if (keeps(LogLevel::INFO))
+                        out += "No servers available for deallocation.\n";
+                    break;
+                case EventType::SERVER_PROVISIONING:
+                    if (keeps(LogLevel::INFO))
+                        out += "Provisioning new server, ready at clock time: " + std::to_string(record.server) + "\n";
+                    break;
+                case EventType::BLOCKED_RANGE:
+                    if (keeps(LogLevel::INFO))
+                        out += "[Firewall] BLOCKED (range)  src=" + formatIP(record.srcIp) + "  dst=" + formatIP(record.dstIp)
+                               + "  rule=" + reader.ruleLabel(record.server) + "\n";
+                    break;
+                case EventType::BLOCKED_BAN:
+                    if (keeps(LogLevel::INFO))
+                        out += "[Firewall] BLOCKED (DoS ban) src=" + formatIP(record.srcIp) + "  dst=" + formatIP(record.dstIp) + "\n";
+                    break;
+                case EventType::DOS_DETECTED:
+                    if (keeps(LogLevel::WARN))
+                        out += "[Firewall] DoS DETECTED — auto-blocked src=" + formatIP(record.srcIp)
+                               + "  (exceeded " + std::to_string(record.server) + " requests/window)\n";
+                    break;
+                case EventType::BANS_EXPIRED:
+                    if (keeps(LogLevel::INFO))
+                        out += "[Firewall] " + std::to_string(record.server) + " DoS bans expired at clock " + std::to_string(record.cycle) + "\n";
+                    break;
+                case EventType::RATE_WINDOW_RESET:
+                    if (keeps(LogLevel::DEBUG))
+                        out += "[Firewall] DoS window reset at clock " + std::to_string(record.cycle) + "\n";
+                    break;
+            }
+        }
+
+        /**
+         * @brief Appends the CSV row of one record.
+         * @param record Record to render.
+         */
+        void renderCsv(const EventRecord& record) {
+            EventType type = static_cast<EventType>(record.type);
+            out += std::to_string(record.cycle) + "," + reader.channelName(record.channel) + "," + eventTypeName(type) + ",";
+
+            std::string serverId, activeServers, queueDepth, arrivals, srcIp, dstIp, rule, value;
+            switch (type) {
+                case EventType::CYCLE:
+                    activeServers = std::to_string(record.server);
+                    queueDepth = std::to_string(record.queueDepth);
+                    arrivals = std::to_string(record.srcIp);
+                    break;
+                case EventType::SERVER_ALLOCATED:
+                case EventType::SERVER_DEALLOCATED:
+                    serverId = std::to_string(record.server);
+                    break;
+                case EventType::SERVER_PROVISIONING:
+                case EventType::BANS_EXPIRED:
+                    value = std::to_string(record.server);
+                    break;
+                case EventType::BLOCKED_RANGE:
+                    rule = reader.ruleLabel(record.server);
+                    srcIp = formatIP(record.srcIp);
+                    dstIp = formatIP(record.dstIp);
+                    break;
+                case EventType::DOS_DETECTED:
+                    value = std::to_string(record.server);
+                    srcIp = formatIP(record.srcIp);
+                    dstIp = formatIP(record.dstIp);
+                    break;
+                case EventType::BLOCKED_BAN:
+                    srcIp = formatIP(record.srcIp);
+                    dstIp = formatIP(record.dstIp);
+                    break;
+                case EventType::NO_IDLE_SERVER:
+                case EventType::RATE_WINDOW_RESET:
+                    break;
+            }
+            out += serverId + "," + activeServers + "," + queueDepth + "," + arrivals + ","
+                   + srcIp + "," + dstIp + "," + rule + "," + value + "\n";
+        }
+
+        /**
+         * @brief Writes the buffer to stdout and empties it.
+         */
+        void flush() {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+};
+
+/**
+ * @brief Prints the usage line.
+ */
+void printUsage() {
+    std::cerr << "Usage: lbdecode [--csv] [--level debug|info|warn] <event log>" << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Decodes the event log named on the command line.
+ *
+ * @details Channels are merged by cycle; on equal cycles the lower channel
+ * number goes first, which reproduces the Switch's firewall-then-balancers
+ * order. Each channel's records for one cycle are rendered as a group.
+ *
+ * @param argc Argument count.
+ * @param argv Arguments.
+ * @return 0 on success, 1 on a usage or file error.
+ */
+int main(int argc, char* argv[]) {
+    bool csv = false;
+    LogLevel level = LogLevel::DEBUG;
+    std::string path;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            if (!parseLogLevel(argv[++i], level)) {
+                printUsage();
+                return 1;
+            }
+        } else if (path.empty() && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    EventLogReader reader;
+    std::string error;
+    if (!reader.open(path, error)) {
+        std::cerr << "ERROR: " << error << std::endl;
+        return 1;
+    }
+
+    std::vector<ChannelCursor> cursors;
+    for (size_t c = 0; c < reader.channelCount(); c++) {
+        cursors.emplace_back(reader.channelSpans(c));
+    }
+
+    Renderer renderer(reader, csv, level);
+    std::vector<const EventRecord*> group;
+    for (;;) {
+        ChannelCursor* next = nullptr;
+        for (ChannelCursor& cursor : cursors) {
+            if (!cursor.done() && (next == nullptr || cursor.current().cycle < next->current().cycle)) {
+                next = &cursor;
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+
+        uint32_t cycle = next->current().cycle;
+        group.clear();
+        while (!next->done() && next->current().cycle == cycle) {
+            group.push_back(&next->current());
+            next->next();
+        }
+        renderer.renderGroup(group);
+    }
+    return 0;
+}
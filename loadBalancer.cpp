@@ -10,12 +10,19 @@
  */
 
 #include "loadBalancer.h"
-#include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <climits>
+#include <utility>
 
 /**
  * @brief Constructs a LoadBalancer with the supplied initial state.
  *
+ * @details Requests already in @p requestQueue are stamped as enqueued at
+ * tick 0; requests already running on @p webServers count as enqueued and
+ * dispatched at tick 0. The queued requests also seed the predictive
+ * scaler's service-time estimate.
+ *
  * @param requestQueue   Pre-populated queue of requests to begin processing.
  * @param webServers     Initial set of web server instances.
  * @param name           Single character identifying this load balancer ('P' or 'S').
@@ -29,138 +36,777 @@ LoadBalancer::LoadBalancer(std::queue<Request> requestQueue,
                            int minThreshold, 
                            int maxThreshold, 
                            int cooldownTime) {
-    this->requestQueue = requestQueue;
-    this->webServers = webServers;
+    for (size_t i = requestQueue.size(); i > 0; i--) {
+        Request request = requestQueue.front();
+        requestQueue.pop();
+        request.markEnqueued(0);
+        scaler.observeService(request.getProcessTime());
+        this->requestQueue.push(request);
+    }
     this->name = name;
     this->clockTime = 0;
     this->minThreshold = minThreshold;
     this->maxThreshold = maxThreshold;
     this->cooldownTime = cooldownTime;
+    this->completionWheel.resize(WHEEL_SIZE);
+    this->pendingCompletions = 0;
+    this->policy = makeDispatchPolicy(DispatchPolicyKind::FIRST_IDLE, 1);
+    this->scalingMode = ScalingMode::THRESHOLD;
+    this->warmUpTime = 0;
+    this->lastObservedTick = -1;
+    this->serverCycles = 0;
+    this->nextServerId = 0;
+    this->serverIdStride = 1;
+    this->events = nullptr;
+
+    servers.reserve(2 * webServers.size());
+    for (const WebServer& server : webServers) {
+        size_t index = servers.add(server.getId());
+        if (server.getId() >= nextServerId) {
+            nextServerId = server.getId() + 1;
+        }
+        if (!server.isReady()) {
+            sendRequest(server.getCurrentRequest(), index, server.getTimeRemaining());
+        }
+    }
+    this->peakServers = servers.size();
 }
 
 /**
  * @brief Runs one full clock cycle of the load balancer simulation.
  *
  * @details The cycle proceeds in the following order:
- *  -# All requests in @p newRequests are pushed onto the internal queue.
- *  -# Each idle server is given the next request from the front of the queue.
- *  -# Every server's update() method is called to decrement processing timers.
+ *  -# All requests in @p newRequests are appended to the internal queue in
+ *     one bulk copy, subject to the queue capacity and shedding policy; with
+ *     CoDel the head of the queue is then checked for stale requests.
+ *  -# Requests are taken from the front of the queue and handed to the
+ *     server the DispatchPolicy picks (by default the lowest-indexed idle
+ *     server, found through the pool's idle bitmap); a busy pick receives the
+ *     request in its local queue. Without local queues, every request that
+ *     an idle server can take is dequeued in one bulk copy first.
+ *  -# Servers whose requests finish on this tick are taken from the
+ *     completion wheel and marked idle again.
  *  -# If the current clock time is a multiple of @c cooldownTime, the queue
  *     depth is compared against the scaled thresholds to decide whether to
- *     allocate or deallocate a server.
+ *     allocate or deallocate a server; in ScalingMode::PREDICTIVE the pool
+ *     is instead resized to the scaler's recommendation.
  *  -# The clock counter is incremented.
  *
  * @param newRequests Pointer to a vector of requests produced this cycle;
- *                    elements are popped from the back and pushed to the queue.
- * @param logFile     Open output file stream used for persistent event logging.
+ *                    they are appended to the queue in order and the vector
+ *                    is cleared.
+ * @param logger      Logger used for progress and scaling events.
+ * @return Number of requests still waiting in the queue.
  */
-int LoadBalancer::runCycle(std::vector<Request> *newRequests, std::ofstream& logFile) {
-    std::cout << "Load Balancer " << name << " - Running cycle at clock time: " << clockTime << std::endl;
-    logFile << "Load Balancer " << name << " - Running cycle at clock time: " << clockTime << std::endl;
+int LoadBalancer::runCycle(std::vector<Request> *newRequests, Logger& logger) {
+    size_t arrivals = newRequests->size();
+    if (events == nullptr) {
+        LOG(logger, LogLevel::DEBUG) << "Load Balancer " << name << " - Running cycle at clock time: " << clockTime;
+        LOG_COLOR(logger, LogLevel::DEBUG, BLUE) << "Generated " << arrivals << " new requests.";
+    }
+    metrics.arrived.add(arrivals);
 
-    std::cout << BLUE << "Generated " << newRequests->size() << " new requests." << RESET << std::endl;
-    logFile << "Generated " << newRequests->size() << " new requests." << std::endl;
-    while (!newRequests->empty()) {
-        requestQueue.push(newRequests->front());
-        newRequests->pop_back();
+    activateWarmServers(logger);
+    serverCycles += provisionedServers();
+
+    if (scalingMode == ScalingMode::PREDICTIVE) {
+        scaler.observeIdle(clockTime - lastObservedTick - 1);
+        scaler.observeArrivals(static_cast<int>(newRequests->size()));
+        for (const Request& request : *newRequests) {
+            scaler.observeService(request.getProcessTime());
+        }
+        lastObservedTick = clockTime;
+    }
+
+    for (Request& request : *newRequests) {
+        request.markEnqueued(clockTime);
     }
+    shedder.admit(requestQueue, *newRequests);
+    newRequests->clear();
+    shedder.shedStale(requestQueue, clockTime);
 
-    for (WebServer &server: this->webServers) {
-        if (requestQueue.empty()) {
-            break;
+    if (servers.getLocalQueueDepth() == 0) {
+        // Every request goes to an idle server, and the policy always finds
+        // one while any is left, so all that fit leave the queue at once.
+        dispatchBatch.resize(std::min(requestQueue.size(), servers.idleCount()));
+        requestQueue.dequeue(dispatchBatch.data(), dispatchBatch.size());
+        for (const Request& request : dispatchBatch) {
+            long index = policy->selectServer(servers, request, clockTime);
+            sendRequest(request, static_cast<size_t>(index), request.getProcessTime());
         }
+    } else {
+        // Only consult the policy when some server can accept, so randomised
+        // policies draw the same numbers whether or not idle ticks are skipped.
+        while (!requestQueue.empty() && servers.hasCapacity()) {
+            const Request& head = requestQueue.front();
+            long index = policy->selectServer(servers, head, clockTime);
+            if (index < 0) {
+                break;
+            }
 
-        if (server.isReady()) {
-            Request request = requestQueue.front();
+            if (servers.isIdle(index))
+                sendRequest(head, static_cast<size_t>(index), head.getProcessTime());
+            else
+                servers.pushLocal(static_cast<size_t>(index), head);
             requestQueue.pop();
-            sendRequest(request, server.getId());
         }
     }
 
-    std::cout << YELLOW << "Queue Size: " << requestQueue.size() << ", Active Servers: " << webServers.size()<< RESET << std::endl;
-    logFile << "Queue Size: " << requestQueue.size() << ", Active Servers: " << webServers.size() << std::endl;
-
-    for (WebServer &server: this->webServers) {
-        server.update();
+    if (events != nullptr) {
+        events->record(EventType::CYCLE, clockTime, static_cast<uint32_t>(servers.size()),
+                       static_cast<uint32_t>(requestQueue.size()), static_cast<uint32_t>(arrivals));
+    } else {
+        LOG_COLOR(logger, LogLevel::DEBUG, YELLOW) << "Queue Size: " << requestQueue.size() << ", Active Servers: " << servers.size();
     }
 
+    completeDueServers();
+
     if (clockTime % cooldownTime == 0) {
-        if (requestQueue.size() < minThreshold*webServers.size())
-            deallocateServer(logFile);
-        else if (requestQueue.size() > maxThreshold*webServers.size())
-            allocateServer(logFile);
+        size_t pending = requestQueue.size() + servers.localQueuedTotal();
+        if (scalingMode == ScalingMode::PREDICTIVE)
+            resizePool(scaler.recommend(provisionedServers(), pending), logger);
+        else if (pending < minThreshold*servers.size())
+            deallocateServer(logger);
+        else if (pending > maxThreshold*provisionedServers())
+            provisionServer(logger);
     }
 
+    publishMetrics();
     clockTime++;
 
-    std::cout << "End of cycle for Load Balancer " << name << std::endl << std::endl;
-    logFile << "End of cycle for Load Balancer " << name << std::endl << std::endl;
-    logFile.flush();
+    if (events == nullptr) {
+        LOG(logger, LogLevel::DEBUG) << "End of cycle for Load Balancer " << name << "\n";
+    }
 
-    return requestQueue.size();
+    return getQueueSize();
 }
 
 /**
- * @brief Dispatches a request to the identified server.
+ * @brief Dispatches a request to the server in pool slot @p index.
  *
- * @details Searches @c webServers for a server whose ID matches @p serverId
- * and whose isReady() returns @c true. If found, processRequest() is called.
+ * @details Schedules the server's completion on the wheel. A request taking
+ * @c p cycles that starts on tick @c t frees its server during tick
+ * @c t+p-1 (zero-length requests behave like one-cycle requests), matching
+ * the tick on which the old per-cycle update() countdown reached zero.
  *
  * @param request  The Request to dispatch.
- * @param serverId The integer ID of the target server.
- * @return @c true if the request was dispatched successfully; @c false if no
- *         matching ready server was found.
- */
-bool LoadBalancer::sendRequest(const Request& request, int serverId) {
-    for (WebServer &server: this->webServers) {
-        if (server.getId() == serverId && server.isReady()) {
-            server.processRequest(request);
-            return true;
+ * @param index    Slot of the target server in @c servers.
+ * @param duration Cycles the request will occupy the server.
+ * @return @c true if the request was dispatched successfully; @c false if the
+ *         slot is out of range or its server is busy.
+ */
+bool LoadBalancer::sendRequest(const Request& request, size_t index, int duration) {
+    if (index >= servers.slotCount() || !servers.isIdle(index)) {
+        return false;
+    }
+
+    startRequest(request, index, clockTime, duration);
+    return true;
+}
+
+/**
+ * @brief Marks a server busy and files its completion on the wheel.
+ *
+ * @details Stamps the dispatch tick on the server's copy of the request and
+ * records its wait; a request that was never enqueued has no wait.
+ *
+ * @param request   Request to start.
+ * @param index     Slot of the server.
+ * @param startTick Tick on which processing begins.
+ * @param duration  Cycles the request occupies the server.
+ */
+void LoadBalancer::startRequest(const Request& request, size_t index, int startTick, int duration) {
+    if (duration < 1) {
+        duration = 1;
+    }
+    int tick = startTick + duration - 1;
+    Request started = request;
+    if (started.getEnqueueTick() < 0) {
+        started.markEnqueued(startTick);
+    }
+    started.markDispatched(startTick);
+    waitTimes.record(startTick - started.getEnqueueTick());
+    servers.assign(index, started, tick);
+    completionWheel[tick & (WHEEL_SIZE - 1)].push_back({servers.handle(index), tick});
+    pendingCompletions++;
+}
+
+/**
+ * @brief Marks idle every server whose completion falls on @c clockTime.
+ *
+ * @details The slot is compacted in place: due entries are applied and
+ * dropped, entries for a later lap of the wheel are kept. Each finished
+ * request's service and sojourn times are recorded as it is released. A freed server
+ * with work in its local queue starts the oldest entry on the next tick,
+ * which is when a server freed now could first be dispatched to anyway.
+ * Those restarts are applied after the scan because they may land in this
+ * same wheel slot. An entry whose handle no longer resolves is dropped.
+ */
+void LoadBalancer::completeDueServers() {
+    std::vector<Completion>& slot = completionWheel[clockTime & (WHEEL_SIZE - 1)];
+    size_t kept = 0;
+    finishedServers.clear();
+    for (size_t i = 0; i < slot.size(); i++) {
+        if (slot[i].tick == clockTime) {
+            pendingCompletions--;
+            long server = servers.resolve(slot[i].server);
+            if (server < 0) {
+                continue;
+            }
+            const Request& done = servers.getRequest(server);
+            serviceTimes.record(clockTime - done.getDispatchTick() + 1);
+            sojournTimes.record(clockTime - done.getEnqueueTick() + 1);
+            if (!classSojournTimes.empty()) {
+                classSojournTimes[requestQueue.classOf(done)].record(clockTime - done.getEnqueueTick() + 1);
+            }
+            servers.release(server);
+            finishedServers.push_back(static_cast<uint32_t>(server));
+        } else {
+            slot[kept++] = slot[i];
+        }
+    }
+    slot.resize(kept);
+
+    if (servers.localQueuedTotal() > 0) {
+        Request next;
+        for (uint32_t server : finishedServers) {
+            if (servers.popLocal(server, next)) {
+                startRequest(next, server, clockTime + 1, next.getProcessTime());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Scans the wheel forward from @c clockTime for the next completion.
+ *
+ * @details Walks at most one lap of slots, stopping at the first slot holding
+ * an entry due on that very tick. Entries for later laps are tracked as a
+ * fallback minimum.
+ *
+ * @return Earliest pending completion tick, or @c INT_MAX if the wheel is empty.
+ */
+int LoadBalancer::nextCompletionTick() const {
+    int earliest = INT_MAX;
+    if (pendingCompletions == 0) {
+        return earliest;
+    }
+
+    for (int offset = 0; offset < WHEEL_SIZE; offset++) {
+        int tick = clockTime + offset;
+        for (const Completion& completion : completionWheel[tick & (WHEEL_SIZE - 1)]) {
+            if (completion.tick == tick) {
+                return tick;
+            }
+            if (completion.tick < earliest) {
+                earliest = completion.tick;
+            }
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief Computes the next tick on which runCycle() would have any effect.
+ *
+ * @details With no new arrivals, the queue and pool only change through
+ * dispatch (possible right now if work and an idle server coexist),
+ * completions, a warming server becoming ready, the auto-scaling check, and,
+ * under CoDel, every tick while requests are queued.
+ * The threshold check is only an event if, with the queue and pool as they
+ * are now, it would act. The predictive check depends on estimates that
+ * decay every tick, so each one is treated as an event.
+ *
+ * @return Earliest tick at which a cycle changes state, or @c INT_MAX.
+ */
+int LoadBalancer::nextEventTick() const {
+    if ((!requestQueue.empty() && servers.hasCapacity()) || shedder.needsEveryTick(requestQueue)) {
+        return clockTime;
+    }
+
+    int next = nextCompletionTick();
+    if (!warmingServers.empty() && warmingServers.front() < next) {
+        next = warmingServers.front();
+    }
+
+    size_t pending = requestQueue.size() + servers.localQueuedTotal();
+    bool wouldScale = scalingMode == ScalingMode::PREDICTIVE
+                   || pending < minThreshold*servers.size()
+                   || pending > maxThreshold*provisionedServers();
+    if (wouldScale) {
+        int scaleTick = (clockTime + cooldownTime - 1) / cooldownTime * cooldownTime;
+        if (scaleTick < next) {
+            next = scaleTick;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Sets the clock to @p tick, skipping cycles known to be no-ops.
+ *
+ * @details The skipped cycles still consume the provisioned servers, which
+ * cannot change before @p tick.
+ *
+ * @param tick New clock value.
+ */
+void LoadBalancer::advanceTo(int tick) {
+    if (tick > clockTime) {
+        serverCycles += static_cast<uint64_t>(tick - clockTime) * provisionedServers();
+    }
+    clockTime = tick;
+}
+
+/**
+ * @brief Returns the number of requests waiting to start.
+ * @return Shared queue length plus all local queue lengths.
+ */
+int LoadBalancer::getQueueSize() const {
+    return static_cast<int>(requestQueue.size() + servers.localQueuedTotal());
+}
+
+/**
+ * @brief Replaces the dispatch policy.
+ * @param policy New policy; ignored if null.
+ */
+void LoadBalancer::setDispatchPolicy(std::unique_ptr<DispatchPolicy> policy) {
+    if (policy) {
+        this->policy = std::move(policy);
+    }
+}
+
+/**
+ * @brief Sets the depth of every server's local queue.
+ * @param depth Requests each local queue can hold (0 disables them).
+ */
+void LoadBalancer::setLocalQueueDepth(size_t depth) {
+    servers.setLocalQueueDepth(depth);
+}
+
+/**
+ * @brief Configures the autoscaler.
+ *
+ * @param mode       Scaling algorithm.
+ * @param targetWait Target queueing delay for ScalingMode::PREDICTIVE.
+ * @param warmUpTime Cycles before a requested server joins the pool (0 = immediately).
+ * @param maxServers Pool size limit for ScalingMode::PREDICTIVE.
+ */
+void LoadBalancer::setScaling(ScalingMode mode, int targetWait, int warmUpTime, size_t maxServers) {
+    scalingMode = mode;
+    scaler.setTargetWait(targetWait);
+    scaler.setMaxServers(maxServers);
+    this->warmUpTime = warmUpTime > 0 ? warmUpTime : 0;
+}
+
+/**
+ * @brief Configures queue capacity and load shedding.
+ *
+ * @param policy        Shedding policy.
+ * @param capacity      Queue bound (0 = unbounded).
+ * @param codelTarget   CoDel target sojourn time.
+ * @param codelInterval CoDel interval.
+ */
+void LoadBalancer::setAdmissionControl(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval) {
+    shedder.configure(policy, capacity, codelTarget, codelInterval);
+}
+
+/**
+ * @brief Configures the request queue's discipline and priority classes.
+ *
+ * @param discipline Queue discipline.
+ * @param cutoffs    Class bounds on processing time.
+ * @param weights    DRR weights.
+ * @param quantum    DRR quantum.
+ */
+void LoadBalancer::setQueueDiscipline(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum) {
+    requestQueue.configure(discipline, cutoffs, weights, quantum);
+    classSojournTimes.assign(requestQueue.classCount() > 1 ? requestQueue.classCount() : 0, LatencyHistogram());
+}
+
+/**
+ * @brief Returns the request queue.
+ * @return @c requestQueue.
+ */
+const SchedulingQueue& LoadBalancer::getRequestQueue() const {
+    return requestQueue;
+}
+
+/**
+ * @brief Returns the queue's free capacity.
+ * @return Headroom, or @c SIZE_MAX if unbounded.
+ */
+size_t LoadBalancer::getHeadroom() const {
+    return shedder.headroom(requestQueue);
+}
+
+/**
+ * @brief Returns the shedding counters.
+ * @return Drop counts by cause.
+ */
+const ShedCounts& LoadBalancer::getShedCounts() const {
+    return shedder.getCounts();
+}
+
+/**
+ * @brief Returns the number of servers in the pool.
+ * @return Server count.
+ */
+size_t LoadBalancer::getServerCount() const {
+    return servers.size();
+}
+
+/**
+ * @brief Collects a handle for each live slot.
+ * @return Handles in slot order.
+ */
+std::vector<ServerHandle> LoadBalancer::getServerHandles() const {
+    std::vector<ServerHandle> handles;
+    handles.reserve(servers.size());
+    for (size_t i = 0; i < servers.slotCount(); i++) {
+        if (servers.isLive(i)) {
+            handles.push_back(servers.handle(i));
         }
     }
-    return false;
+    return handles;
 }
 
 /**
- * @brief Provisions a new WebServer and appends it to the active pool.
+ * @brief Returns a snapshot of one pooled server.
  *
- * @details The new server receives an ID equal to the current @c clockTime,
- * which provides a rough timestamp of when it was created.
+ * @param handle Server to inspect.
+ * @return WebServer view of the server at the current clock.
+ */
+WebServer LoadBalancer::getServer(ServerHandle handle) const {
+    long index = servers.resolve(handle);
+    if (index < 0) {
+        return WebServer(-1);
+    }
+    return servers.view(static_cast<size_t>(index), clockTime);
+}
+
+/**
+ * @brief Sets the id sequence for allocated servers.
+ *
+ * @param first  Next id.
+ * @param stride Step between ids; values below 1 are raised to 1.
+ */
+void LoadBalancer::setServerIdSequence(int first, int stride) {
+    nextServerId = first;
+    serverIdStride = stride > 0 ? stride : 1;
+}
+
+/**
+ * @brief Returns the wait-time histogram.
+ * @return Enqueue-to-dispatch delays of started requests.
+ */
+const LatencyHistogram& LoadBalancer::getWaitTimes() const {
+    return waitTimes;
+}
+
+/**
+ * @brief Returns the service-time histogram.
+ * @return Dispatch-to-completion times of finished requests.
+ */
+const LatencyHistogram& LoadBalancer::getServiceTimes() const {
+    return serviceTimes;
+}
+
+/**
+ * @brief Returns the sojourn-time histogram.
+ * @return Enqueue-to-completion times of finished requests.
+ */
+const LatencyHistogram& LoadBalancer::getSojournTimes() const {
+    return sojournTimes;
+}
+
+/**
+ * @brief Returns the per-class sojourn-time histograms.
+ * @return @c classSojournTimes.
+ */
+const std::vector<LatencyHistogram>& LoadBalancer::getClassSojournTimes() const {
+    return classSojournTimes;
+}
+
+/**
+ * @brief Returns the consumed server-cycles.
+ * @return Provisioned servers summed over elapsed cycles.
+ */
+uint64_t LoadBalancer::getServerCycles() const {
+    return serverCycles;
+}
+
+/**
+ * @brief Returns the peak provisioned pool size.
+ * @return Largest server count seen.
+ */
+size_t LoadBalancer::getPeakServers() const {
+    return peakServers;
+}
+
+/**
+ * @brief Provisions a new server and appends it to the pool.
  *
- * @param logFile Open output file stream; the allocation event is written here.
- * @return Pointer to the newly created WebServer inside the @c webServers vector.
+ * @details The new server takes the next id of the balancer's sequence, so
+ * ids stay unique within and, via setServerIdSequence(), across balancers.
  *
- * @warning The returned pointer may be invalidated if @c webServers is subsequently
- *          modified (e.g., by another allocation that triggers a reallocation).
+ * @param logger Logger receiving the allocation event.
+ * @return Slot index of the new server.
  */
-WebServer* LoadBalancer::allocateServer(std::ofstream& logFile) {
-    webServers.push_back(WebServer(clockTime));
-    std::cout << GREEN << "Allocated new server with ID: " << webServers.back().getId() << RESET << std::endl;
-    logFile << "Allocated new server with ID: " << webServers.back().getId() << std::endl;
-    return &webServers.back();
+size_t LoadBalancer::allocateServer(Logger& logger) {
+    size_t index = servers.add(nextServerId);
+    nextServerId += serverIdStride;
+    if (events != nullptr) {
+        events->record(EventType::SERVER_ALLOCATED, clockTime, static_cast<uint32_t>(servers.getId(index)));
+    } else {
+        LOG_COLOR(logger, LogLevel::INFO, GREEN) << "Allocated new server with ID: " << servers.getId(index);
+    }
+    return index;
 }
 
 /**
- * @brief Removes the first idle server found in the active pool.
+ * @brief Removes the first idle server found in the pool.
  *
- * @details Iterates through @c webServers and erases the first entry whose
- * isReady() returns @c true. If no idle server exists, logs a notice and
- * returns without modifying the pool.
+ * @details Retires the lowest-indexed idle server. Its slot is tombstoned,
+ * so no other server moves and the completion wheel is left untouched. If
+ * no idle server exists, logs a notice and returns without modifying the
+ * pool.
  *
- * @param logFile Open output file stream; the deallocation event is written here.
+ * @param logger Logger receiving the deallocation event.
  */
-void LoadBalancer::deallocateServer(std::ofstream& logFile) {
-    if (!webServers.empty()) {
-        for (unsigned int i = 0; i < webServers.size(); i++) {
-            if (webServers[i].isReady()) {
-                std::cout << CYAN << "Deallocated server with ID: " << webServers[i].getId() << RESET << std::endl;
-                logFile << "Deallocated server with ID: " << webServers[i].getId() << std::endl;
-                webServers.erase(webServers.begin() + i);
-                return;
+void LoadBalancer::deallocateServer(Logger& logger) {
+    if (!servers.empty()) {
+        long index = servers.firstIdle();
+        if (index >= 0) {
+            if (events != nullptr) {
+                events->record(EventType::SERVER_DEALLOCATED, clockTime, static_cast<uint32_t>(servers.getId(index)));
+            } else {
+                LOG_COLOR(logger, LogLevel::INFO, CYAN) << "Deallocated server with ID: " << servers.getId(index);
             }
+            servers.retire(index);
+            metrics.scaleDowns.add();
+            return;
+        }
+
+        if (events != nullptr) {
+            events->record(EventType::NO_IDLE_SERVER, clockTime);
+        } else {
+            LOG_COLOR(logger, LogLevel::INFO, CYAN) << "No servers available for deallocation.";
+        }
+    }
+}
+
+/**
+ * @brief Allocates a server now, or queues it to join after the warm-up time.
+ * @param logger Logger receiving the event.
+ */
+void LoadBalancer::provisionServer(Logger& logger) {
+    if (warmUpTime == 0) {
+        allocateServer(logger);
+    } else {
+        warmingServers.push_back(clockTime + warmUpTime);
+        if (events != nullptr) {
+            events->record(EventType::SERVER_PROVISIONING, clockTime, static_cast<uint32_t>(warmingServers.back()));
+        } else {
+            LOG_COLOR(logger, LogLevel::INFO, GREEN) << "Provisioning new server, ready at clock time: " << warmingServers.back();
+        }
+    }
+    metrics.scaleUps.add();
+    if (provisionedServers() > peakServers) {
+        peakServers = provisionedServers();
+    }
+}
+
+/**
+ * @brief Moves every warming server that is ready into the pool.
+ * @param logger Logger receiving the allocations.
+ */
+void LoadBalancer::activateWarmServers(Logger& logger) {
+    while (!warmingServers.empty() && warmingServers.front() <= clockTime) {
+        warmingServers.pop_front();
+        allocateServer(logger);
+    }
+}
+
+/**
+ * @brief Provisions or releases servers until @p target are provisioned.
+ *
+ * @param target Desired provisioned server count.
+ * @param logger Logger receiving the events.
+ */
+void LoadBalancer::resizePool(size_t target, Logger& logger) {
+    while (provisionedServers() < target) {
+        provisionServer(logger);
+    }
+    while (provisionedServers() > target && !warmingServers.empty()) {
+        warmingServers.pop_back();
+        metrics.scaleDowns.add();
+    }
+    while (provisionedServers() > target && servers.firstIdle() >= 0) {
+        deallocateServer(logger);
+    }
+}
+
+/**
+ * @brief Counts active and warming servers.
+ * @return Provisioned server count.
+ */
+size_t LoadBalancer::provisionedServers() const {
+    return servers.size() + warmingServers.size();
+}
+
+/**
+ * @brief Creates the balancer's series with an @c lb label of its name.
+ * @param registry Registry receiving the series.
+ */
+void LoadBalancer::setMetrics(MetricsRegistry& registry) {
+    std::string label = std::string("lb=\"") + name + "\"";
+    metrics.arrived = registry.counter("lb_arrivals_total", "Requests delivered to the load balancer.", label);
+    metrics.dispatched = registry.counter("lb_dispatched_total", "Requests started on a server.", label);
+    metrics.completed = registry.counter("lb_completed_total", "Requests that finished processing.", label);
+    metrics.shed = registry.counter("lb_shed_total", "Requests discarded by admission control.", label);
+    metrics.scaleUps = registry.counter("lb_scale_ups_total", "Servers provisioned by the autoscaler.", label);
+    metrics.scaleDowns = registry.counter("lb_scale_downs_total", "Servers released by the autoscaler.", label);
+    metrics.queueDepth = registry.gauge("lb_queue_depth", "Requests waiting to start.", label);
+    metrics.poolSize = registry.gauge("lb_servers", "Servers provisioned, including those warming up.", label);
+    publishMetrics();
+}
+
+/**
+ * @brief Opens a channel named after the balancer in @p log.
+ * @param log Event log receiving the balancer's events.
+ */
+void LoadBalancer::setEventLog(EventLog& log) {
+    events = log.addChannel(std::string(1, name));
+}
+
+/**
+ * @brief Publishes the growth of the histogram and shed tallies since the last call.
+ *
+ * @details The histograms already count every dispatch and completion, so
+ * the per-request paths need no extra work; the counters advance by one
+ * delta per cycle.
+ */
+void LoadBalancer::publishMetrics() {
+    uint64_t dispatched = waitTimes.count();
+    uint64_t completed = sojournTimes.count();
+    uint64_t shed = shedder.getCounts().total();
+    metrics.dispatched.add(dispatched - metrics.dispatchedSeen);
+    metrics.completed.add(completed - metrics.completedSeen);
+    metrics.shed.add(shed - metrics.shedSeen);
+    metrics.dispatchedSeen = dispatched;
+    metrics.completedSeen = completed;
+    metrics.shedSeen = shed;
+    metrics.queueDepth.set(getQueueSize());
+    metrics.poolSize.set(static_cast<int64_t>(provisionedServers()));
+}
+
+/**
+ * @brief Writes each component in turn, the completion wheel flattened in slot order.
+ * @param out Snapshot being written.
+ */
+void LoadBalancer::saveState(SnapshotWriter& out) const {
+    out.putTag("LBAL");
+    out.put(name);
+    out.put(clockTime);
+    requestQueue.saveState(out);
+    shedder.saveState(out);
+    servers.saveState(out);
+
+    SnapshotWriter policyState;
+    policy->saveState(policyState);
+    out.putString(policy->name());
+    out.putBlob(policyState);
+
+    std::vector<Completion> wheel;
+    wheel.reserve(pendingCompletions);
+    for (const std::vector<Completion>& slot : completionWheel) {
+        wheel.insert(wheel.end(), slot.begin(), slot.end());
+    }
+    out.putArray(wheel);
+
+    waitTimes.saveState(out);
+    serviceTimes.saveState(out);
+    sojournTimes.saveState(out);
+    out.put(static_cast<uint64_t>(classSojournTimes.size()));
+    for (const LatencyHistogram& histogram : classSojournTimes) {
+        histogram.saveState(out);
+    }
+    scaler.saveState(out);
+    out.put(lastObservedTick);
+    out.putArray(std::vector<int>(warmingServers.begin(), warmingServers.end()));
+    out.put(serverCycles);
+    out.put(static_cast<uint64_t>(peakServers));
+    out.put(nextServerId);
+    out.put(serverIdStride);
+}
+
+/**
+ * @brief Reads the sections written by saveState() in the same order.
+ *
+ * @details Each completion goes back into the wheel slot of its tick, so
+ * entries that shared a slot keep their relative order.
+ *
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool LoadBalancer::restoreState(SnapshotReader& in) {
+    char savedName = 0;
+    int savedClock = 0;
+    if (!in.expectTag("LBAL") || !in.get(savedName) || savedName != name || !in.get(savedClock)) {
+        return in.fail();
+    }
+    if (!requestQueue.restoreState(in) || !shedder.restoreState(in) || !servers.restoreState(in)) {
+        return in.fail();
+    }
+
+    std::string policyName;
+    SnapshotReader policyState;
+    if (!in.getString(policyName) || !in.getBlob(policyState)) {
+        return false;
+    }
+    if (policyName == policy->name() && !policy->restoreState(policyState)) {
+        return in.fail();
+    }
+
+    std::vector<Completion> wheel;
+    if (!in.getArray(wheel)) {
+        return false;
+    }
+    for (std::vector<Completion>& slot : completionWheel) {
+        slot.clear();
+    }
+    for (const Completion& completion : wheel) {
+        completionWheel[completion.tick & (WHEEL_SIZE - 1)].push_back(completion);
+    }
+    pendingCompletions = wheel.size();
+
+    uint64_t classes = 0;
+    if (!waitTimes.restoreState(in) || !serviceTimes.restoreState(in) || !sojournTimes.restoreState(in) || !in.get(classes)) {
+        return in.fail();
+    }
+    // Per-class histograms only carry over if the number of classes matches.
+    std::vector<LatencyHistogram> classHistograms(static_cast<size_t>(std::min<uint64_t>(classes, in.remaining())));
+    for (LatencyHistogram& histogram : classHistograms) {
+        if (!histogram.restoreState(in)) {
+            return in.fail();
         }
+    }
+    if (classHistograms.size() != classes) {
+        return in.fail();
+    }
+    if (classHistograms.size() == classSojournTimes.size()) {
+        classSojournTimes = std::move(classHistograms);
+    }
 
-        std::cout << CYAN << "No servers available for deallocation." << RESET << std::endl;
-        logFile << "No servers available for deallocation." << std::endl;
+    std::vector<int> warming;
+    uint64_t peak = 0;
+    if (!scaler.restoreState(in) || !in.get(lastObservedTick) || !in.getArray(warming)
+        || !in.get(serverCycles) || !in.get(peak) || !in.get(nextServerId) || !in.get(serverIdStride)) {
+        return in.fail();
     }
+    warmingServers.assign(warming.begin(), warming.end());
+    peakServers = static_cast<size_t>(peak);
+    clockTime = savedClock;
+    return true;
 }
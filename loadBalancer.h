@@ -5,7 +5,7 @@
  * @details Defines LoadBalancer, which manages a pool of WebServer instances
  * and a queue of incoming Requests. Each call to runCycle() advances the
  * simulation by one clock tick: new requests are enqueued, available servers
- * receive requests from the queue, all servers are updated, and the server
+ * receive requests from the queue, servers finishing this tick are freed, and the server
  * pool is dynamically scaled based on configurable threshold parameters.
  *
  * @author Load Balancer Project
@@ -15,25 +15,45 @@
 #ifndef LOADBALANCER_H
 #define LOADBALANCER_H
 
+#include <cstdint>
+#include <deque>
 #include <queue>
 #include <vector>
-#include <fstream>
 #include "request.h"
+#include "schedulingQueue.h"
+#include "loadShedder.h"
 #include "webServer.h"
+#include "serverPool.h"
+#include "dispatchPolicy.h"
+#include "latencyHistogram.h"
+#include "metrics.h"
+#include "eventLog.h"
+#include "predictiveScaler.h"
+#include <memory>
 #include "utils.h"
+#include "logger.h"
 
 /**
  * @class LoadBalancer
  * @brief Distributes incoming network requests across a dynamic pool of web servers.
  *
- * @details A LoadBalancer owns a request queue and a vector of WebServer objects.
+ * @details A LoadBalancer owns a request queue and a ServerPool of servers.
  * It is identified by a single character name (e.g., 'P' or 'S'). On each clock
  * cycle it:
  *  -# Accepts newly generated requests and pushes them onto its queue.
- *  -# Dispatches queued requests to idle servers (first-come, first-served).
- *  -# Calls update() on every server to advance their processing timers.
+ *  -# Dispatches queued requests in arrival order to the servers chosen by its
+ *     DispatchPolicy (by default the first idle server, found through a bitmap
+ *     of idle server slots).
+ *  -# Frees the servers whose requests finish on this tick, found through a
+ *     timing wheel of completion ticks (busy servers cost nothing per cycle).
  *  -# Periodically evaluates the queue length relative to the server count and
- *     allocates or deallocates servers to maintain balance.
+ *     allocates or deallocates servers to maintain balance, or, in
+ *     ScalingMode::PREDICTIVE, resizes the pool in one step to the size its
+ *     PredictiveScaler recommends.
+ *
+ * Every request is stamped with the tick it was enqueued and dispatched; on
+ * completion its wait, service and sojourn times are added to per-balancer
+ * LatencyHistograms.
  */
 class LoadBalancer {
     public:
@@ -58,19 +78,293 @@ class LoadBalancer {
          * @brief Executes a single clock cycle of the load balancer.
          *
          * @details Enqueues all requests in @p newRequests, dispatches work to
-         * available servers, updates server states, and (every @c cooldownTime
-         * cycles) auto-scales the server pool. Progress is logged to both
-         * stdout and @p logFile.
+         * available servers, frees servers whose requests finish, and (every @c cooldownTime
+         * cycles) auto-scales the server pool. Per-cycle progress is logged at
+         * LogLevel::DEBUG and scaling events at LogLevel::INFO.
          *
          * @param newRequests Pointer to a vector of requests generated this cycle
          *                    (vector is consumed during the call).
-         * @param logFile     Reference to an open output stream for persistent logging.
+         * @param logger      Logger receiving progress and scaling events.
+         * @return Number of requests still waiting in the queue.
+         */
+        int runCycle(std::vector<Request> *newRequests, Logger& logger);
+
+        /**
+         * @brief Finds the earliest tick on which a cycle would change any state.
+         *
+         * @details A cycle with no new requests does something only if a queued
+         * request can be dispatched, a server completes, or the auto-scaling
+         * check will allocate or deallocate a server. Every tick before the
+         * returned one can be skipped with advanceTo() without changing the
+         * outcome of the simulation.
+         *
+         * @return Earliest such tick (at least the current clock), or @c INT_MAX
+         *         if the balancer is quiescent until new requests arrive.
+         */
+        int nextEventTick() const;
+
+        /**
+         * @brief Moves the clock forward over cycles that would have had no effect.
+         *
+         * @param tick New clock value; must not exceed nextEventTick().
+         */
+        void advanceTo(int tick);
+
+        /**
+         * @brief Returns the number of requests waiting to start.
+         * @return Shared queue length plus the servers' local queue lengths.
+         */
+        int getQueueSize() const;
+
+        /**
+         * @brief Replaces the policy that picks a server for each request.
+         * @param policy New policy (the default is FirstIdlePolicy).
+         */
+        void setDispatchPolicy(std::unique_ptr<DispatchPolicy> policy);
+
+        /**
+         * @brief Gives every server a local queue of @p depth requests.
+         *
+         * @details With local queues a policy may commit work to a busy server;
+         * the server starts it as soon as its current request finishes. Call
+         * before the simulation starts.
+         *
+         * @param depth Capacity of each local queue (0 disables them).
+         */
+        void setLocalQueueDepth(size_t depth);
+
+        /**
+         * @brief Configures the autoscaler.
+         *
+         * @details With a warm-up time, a server requested by either scaling
+         * mode only joins the pool @p warmUpTime cycles later; it still counts
+         * as provisioned (and towards getServerCycles()) while warming up.
+         *
+         * @param mode       Scaling algorithm (the default is ScalingMode::THRESHOLD).
+         * @param targetWait Queueing delay, in cycles, the predictive mode sizes for.
+         * @param warmUpTime Cycles between requesting a server and it taking work.
+         * @param maxServers Largest pool the predictive mode provisions.
+         */
+        void setScaling(ScalingMode mode, int targetWait, int warmUpTime, size_t maxServers);
+
+        /**
+         * @brief Bounds the request queue and selects how excess load is shed.
+         *
+         * @param policy        Shedding policy.
+         * @param capacity      Maximum queue length (0 = unbounded, the default).
+         * @param codelTarget   Head sojourn time, in cycles, CoDel tolerates.
+         * @param codelInterval Cycles above target before CoDel starts dropping.
+         */
+        void setAdmissionControl(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval);
+
+        /**
+         * @brief Selects the order in which queued requests are dispatched.
+         *
+         * @details With more than one priority class, sojourn times are also
+         * recorded per class (see getClassSojournTimes()). Call before the
+         * simulation starts.
+         *
+         * @param discipline Queue discipline (the default is QueueDiscipline::FIFO).
+         * @param cutoffs    Processing-time bounds of all but the last priority class.
+         * @param weights    DRR weight of each class.
+         * @param quantum    Processing time a class of weight 1 earns per DRR turn.
+         */
+        void setQueueDiscipline(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum);
+
+        /**
+         * @brief Returns the queue of requests awaiting dispatch.
+         * @return Queue, for its discipline and priority classes.
+         */
+        const SchedulingQueue& getRequestQueue() const;
+
+        /**
+         * @brief Returns how many more requests the queue accepts without shedding.
+         *
+         * @details The Switch reads this before each cycle as the balancer's
+         * backpressure signal.
+         *
+         * @return Free queue capacity, or @c SIZE_MAX if unbounded.
+         */
+        size_t getHeadroom() const;
+
+        /**
+         * @brief Returns the requests shed by admission control so far.
+         * @return Drop counts by cause.
+         */
+        const ShedCounts& getShedCounts() const;
+
+        /**
+         * @brief Returns the number of servers currently in the pool.
+         * @return Server count.
+         */
+        size_t getServerCount() const;
+
+        /**
+         * @brief Returns handles to every server currently in the pool.
+         * @return One handle per live server, in slot order.
+         */
+        std::vector<ServerHandle> getServerHandles() const;
+
+        /**
+         * @brief Returns a WebServer view of one pooled server.
+         *
+         * @param handle Handle from getServerHandles().
+         * @return Snapshot of the server's id, request and remaining time, or
+         *         a server with id -1 if the handle is stale.
+         */
+        WebServer getServer(ServerHandle handle) const;
+
+        /**
+         * @brief Sets the ids given to servers allocated from now on.
+         *
+         * @details Ids run @p first, @p first + @p stride, ... so balancers
+         * given the same stride and distinct offsets never hand out the same
+         * id. By default ids continue from one past the largest initial id.
+         *
+         * @param first  Id of the next allocated server.
+         * @param stride Step between consecutive ids (at least 1).
+         */
+        void setServerIdSequence(int first, int stride);
+
+        /**
+         * @brief Returns the distribution of queueing delays of started requests.
+         * @return Cycles from enqueue to dispatch.
+         */
+        const LatencyHistogram& getWaitTimes() const;
+
+        /**
+         * @brief Returns the distribution of service times of completed requests.
+         * @return Cycles from dispatch to completion, inclusive.
+         */
+        const LatencyHistogram& getServiceTimes() const;
+
+        /**
+         * @brief Returns the distribution of sojourn times of completed requests.
+         * @return Cycles from enqueue to completion, inclusive.
+         */
+        const LatencyHistogram& getSojournTimes() const;
+
+        /**
+         * @brief Returns the sojourn-time distribution of each priority class.
+         * @return One histogram per class, or none while there is only one class.
+         */
+        const std::vector<LatencyHistogram>& getClassSojournTimes() const;
+
+        /**
+         * @brief Returns the total provisioned capacity consumed so far.
+         * @return Sum over elapsed cycles of the servers provisioned in each.
+         */
+        uint64_t getServerCycles() const;
+
+        /**
+         * @brief Returns the largest number of servers provisioned at once.
+         * @return Peak pool size, including servers warming up.
+         */
+        size_t getPeakServers() const;
+
+        /**
+         * @brief Registers this balancer's series, labelled with its name, in @p registry.
+         *
+         * @details Counters (arrivals, dispatches, completions, shed requests,
+         * scale-ups and scale-downs) are advanced once per cycle from the
+         * balancer's own tallies; the queue-depth and pool-size gauges are set
+         * at the end of each cycle.
+         *
+         * @param registry Registry that must outlive the balancer.
+         */
+        void setMetrics(MetricsRegistry& registry);
+
+        /**
+         * @brief Sends this balancer's per-cycle and scaling events to @p log
+         *        instead of the text log.
+         *
+         * @details One CYCLE record per cycle replaces the progress lines;
+         * allocation, deallocation and provisioning each get a record of
+         * their own.
+         *
+         * @param log Open event log that must outlive the balancer.
+         */
+        void setEventLog(EventLog& log);
+
+        /**
+         * @brief Writes the balancer's run state to @p out.
+         *
+         * @details Covers the queue, shedder, server pool, dispatch policy,
+         * completion wheel, histograms, scaler and clock. Configuration
+         * (thresholds, cooldown, scaling mode, warm-up) is not written; the
+         * restoring run supplies its own.
+         *
+         * @param out Snapshot being written.
          */
-        int runCycle(std::vector<Request> *newRequests, std::ofstream& logFile);
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the run state with the one read from @p in.
+         *
+         * @details A policy's state is restored only if the snapshot was
+         * written with the same policy; otherwise the configured policy keeps
+         * its fresh state.
+         *
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed or names another balancer.
+         */
+        bool restoreState(SnapshotReader& in);
 
     private:
-        std::queue<Request> requestQueue;   ///< Queue of pending requests awaiting dispatch.
-        std::vector<WebServer> webServers;  ///< Active pool of web server instances.
+        SchedulingQueue requestQueue;       ///< Queue of pending requests awaiting dispatch.
+        LoadShedder shedder;                ///< Bounds @c requestQueue and sheds excess load.
+        std::vector<Request> dispatchBatch; ///< Scratch for requests dequeued in bulk.
+        ServerPool servers;                 ///< Active pool of servers (structure of arrays).
+        std::unique_ptr<DispatchPolicy> policy; ///< Chooses the server for each request.
+
+        /**
+         * @struct Completion
+         * @brief A busy server and the tick on which its request finishes.
+         */
+        struct Completion {
+            ServerHandle server;  ///< Server in @c servers.
+            int tick;             ///< Clock time whose cycle frees the server.
+        };
+
+        static const int WHEEL_SIZE = 1024;                   ///< Wheel slots (power of two).
+        std::vector<std::vector<Completion>> completionWheel; ///< Slot @c tick % WHEEL_SIZE holds completions due then.
+        size_t pendingCompletions;                            ///< Entries currently on the wheel.
+        std::vector<uint32_t> finishedServers;                ///< Scratch list for completeDueServers().
+
+        LatencyHistogram waitTimes;     ///< Enqueue-to-dispatch delays.
+        LatencyHistogram serviceTimes;  ///< Dispatch-to-completion times.
+        LatencyHistogram sojournTimes;  ///< Enqueue-to-completion times.
+        std::vector<LatencyHistogram> classSojournTimes; ///< Sojourn times per priority class.
+
+        ScalingMode scalingMode;          ///< Autoscaling algorithm.
+        PredictiveScaler scaler;          ///< Load estimates for ScalingMode::PREDICTIVE.
+        int warmUpTime;                   ///< Cycles before a requested server takes work.
+        int lastObservedTick;             ///< Last tick fed to @c scaler.
+        std::deque<int> warmingServers;   ///< Ready ticks of servers still warming up, oldest first.
+        uint64_t serverCycles;            ///< Provisioned servers summed over elapsed cycles.
+        size_t peakServers;               ///< Largest provisioned pool so far.
+        int nextServerId;                 ///< Id for the next allocated server.
+        int serverIdStride;               ///< Step between allocated ids.
+
+        /**
+         * @struct MetricHandles
+         * @brief Registry handles plus the tallies already published through them.
+         */
+        struct MetricHandles {
+            Counter arrived;           ///< Requests handed to runCycle().
+            Counter dispatched;        ///< Requests started on a server.
+            Counter completed;         ///< Requests finished.
+            Counter shed;              ///< Requests discarded by the shedder.
+            Counter scaleUps;          ///< Servers provisioned.
+            Counter scaleDowns;        ///< Servers retired or cancelled while warming.
+            Gauge queueDepth;          ///< Requests waiting, after the cycle.
+            Gauge poolSize;            ///< Provisioned servers, after the cycle.
+            uint64_t dispatchedSeen = 0; ///< @c waitTimes count already added to @c dispatched.
+            uint64_t completedSeen = 0;  ///< @c sojournTimes count already added to @c completed.
+            uint64_t shedSeen = 0;       ///< Shed total already added to @c shed.
+        };
+        MetricHandles metrics;            ///< Inert until setMetrics().
+        EventChannel* events;             ///< Binary event channel, or @c nullptr to log text.
 
         char name;          ///< Single-character identifier for this load balancer.
         int clockTime;      ///< Current simulation clock value (incremented each cycle).
@@ -79,38 +373,99 @@ class LoadBalancer {
         int cooldownTime;   ///< Cycles between auto-scaling checks.
 
         /**
-         * @brief Sends a request directly to the server with the given ID.
+         * @brief Sends a request directly to the server in the given pool slot.
          *
-         * @details Searches the server pool for a server matching @p serverId that
-         * is currently ready, and calls processRequest() on it.
+         * @details Marks the slot busy in @c servers and files its completion on
+         * the timing wheel.
          *
          * @param request  The request to dispatch.
-         * @param serverId The target server's unique ID.
+         * @param index    Slot of the target server in @c servers.
+         * @param duration Cycles the request occupies the server (at least one).
          * @return @c true if the request was successfully dispatched; @c false otherwise.
          */
-        bool sendRequest(const Request& request, int serverId);
+        bool sendRequest(const Request& request, size_t index, int duration);
+
+        /**
+         * @brief Assigns a request to a server and schedules its completion.
+         *
+         * @param request   Request to start.
+         * @param index     Slot of the server.
+         * @param startTick Tick on which processing begins.
+         * @param duration  Cycles the request occupies the server (at least one).
+         */
+        void startRequest(const Request& request, size_t index, int startTick, int duration);
+
+        /**
+         * @brief Frees every server whose request completes on the current tick.
+         *
+         * @details Visits only the wheel slot for @c clockTime. Entries due on a
+         * later lap of the wheel stay in the slot.
+         */
+        void completeDueServers();
+
+        /**
+         * @brief Finds the tick of the earliest pending completion.
+         * @return Smallest completion tick on the wheel, or @c INT_MAX if none.
+         */
+        int nextCompletionTick() const;
 
         /**
-         * @brief Adds a new WebServer to the active pool.
+         * @brief Adds a new server to the active pool.
          *
-         * @details Constructs a new WebServer whose ID is the current clock time
-         * and appends it to @c webServers.
+         * @details Adds an idle server, recycling a retired slot if one is
+         * free, and gives it the next id of the balancer's id sequence.
          *
-         * @param logFile Reference to the log file stream for recording the event.
-         * @return Pointer to the newly allocated WebServer.
+         * @param logger Logger for recording the event.
+         * @return Slot index of the new server.
+         */
+        size_t allocateServer(Logger& logger);
+
+        /**
+         * @brief Requests one more server, immediately or after the warm-up time.
+         * @param logger Logger for recording the event.
+         */
+        void provisionServer(Logger& logger);
+
+        /**
+         * @brief Adds to the pool every warming server whose ready tick has come.
+         * @param logger Logger for recording the allocations.
+         */
+        void activateWarmServers(Logger& logger);
+
+        /**
+         * @brief Grows or shrinks the provisioned pool towards @p target servers.
+         *
+         * @details Shrinking first cancels servers still warming up, newest
+         * first, then removes idle servers; busy servers are never removed, so
+         * the pool may stay above @p target until they finish.
+         *
+         * @param target Desired number of provisioned servers.
+         * @param logger Logger for recording the events.
+         */
+        void resizePool(size_t target, Logger& logger);
+
+        /**
+         * @brief Counts active servers plus servers warming up.
+         * @return Provisioned server count.
+         */
+        size_t provisionedServers() const;
+
+        /**
+         * @brief Adds this cycle's dispatches, completions and sheds to the
+         *        counters and updates the gauges.
          */
-        WebServer* allocateServer(std::ofstream& logFile);
+        void publishMetrics();
 
         /**
          * @brief Removes an idle WebServer from the active pool.
          *
-         * @details Finds the first ready server in the pool and removes it. If no
+         * @details Retires the lowest-indexed ready server in O(1). If no
          * server is currently idle, logs a message and returns without modifying
          * the pool.
          *
-         * @param logFile Reference to the log file stream for recording the event.
+         * @param logger Logger for recording the event.
          */
-        void deallocateServer(std::ofstream& logFile);
+        void deallocateServer(Logger& logger);
 };
 
 #endif
@@ -0,0 +1,236 @@
+/**
+ * @file loadShedder.cpp
+ * @brief Implementation of the LoadShedder class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "loadShedder.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Parses a shedding policy name.
+ *
+ * @param name   Policy name.
+ * @param policy Receives the parsed policy.
+ * @return @c true if recognised.
+ */
+bool parseSheddingPolicy(const std::string& name, SheddingPolicy& policy) {
+    if (name == "tail-drop")        policy = SheddingPolicy::TAIL_DROP;
+    else if (name == "drop-oldest") policy = SheddingPolicy::DROP_OLDEST;
+    else if (name == "codel")       policy = SheddingPolicy::CODEL;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Sums the drop counters.
+ * @return Total requests shed.
+ */
+uint64_t ShedCounts::total() const {
+    return tailDropped + oldestDropped + codelDropped;
+}
+
+/**
+ * @brief Constructs an unbounded shedder with CoDel's usual 5% target ratio.
+ */
+LoadShedder::LoadShedder()
+    : policy(SheddingPolicy::TAIL_DROP),
+      capacity(0),
+      codelTarget(5),
+      codelInterval(100),
+      firstAboveTime(-1),
+      dropping(false),
+      dropCount(0),
+      lastDropCount(0),
+      dropNext(0.0)
+{
+}
+
+/**
+ * @brief Replaces the policy and limits.
+ *
+ * @param policy        Shedding policy.
+ * @param capacity      Queue bound (0 = unbounded).
+ * @param codelTarget   CoDel target sojourn; values below 1 are raised to 1.
+ * @param codelInterval CoDel interval; values below 1 are raised to 1.
+ */
+void LoadShedder::configure(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval) {
+    this->policy = policy;
+    this->capacity = capacity;
+    this->codelTarget = codelTarget > 0 ? codelTarget : 1;
+    this->codelInterval = codelInterval > 0 ? codelInterval : 1;
+}
+
+/**
+ * @brief Returns the queue bound.
+ * @return Capacity, or 0 if unbounded.
+ */
+size_t LoadShedder::getCapacity() const {
+    return capacity;
+}
+
+/**
+ * @brief Computes the free capacity of a queue.
+ * @param queue Guarded queue.
+ * @return Requests that still fit, or @c SIZE_MAX if unbounded.
+ */
+size_t LoadShedder::headroom(const SchedulingQueue& queue) const {
+    if (capacity == 0) {
+        return SIZE_MAX;
+    }
+    return queue.size() < capacity ? capacity - queue.size() : 0;
+}
+
+/**
+ * @brief Enqueues a batch under the configured bound.
+ *
+ * @details Tail drop (and CoDel) enqueue the prefix of @p arrivals that
+ * fits. Drop-oldest evicts just enough queued requests, and if the batch
+ * alone exceeds the capacity its own oldest members, so that the newest
+ * @c capacity requests remain.
+ *
+ * @param queue    Guarded queue.
+ * @param arrivals Requests to admit.
+ */
+void LoadShedder::admit(SchedulingQueue& queue, const std::vector<Request>& arrivals) {
+    size_t room = headroom(queue);
+    if (arrivals.size() <= room) {
+        queue.enqueue(arrivals);
+        return;
+    }
+
+    if (policy != SheddingPolicy::DROP_OLDEST) {
+        queue.enqueue(arrivals.data(), room);
+        counts.tailDropped += arrivals.size() - room;
+        return;
+    }
+
+    size_t excess = arrivals.size() - room;
+    size_t evicted = queue.discard(excess);
+    size_t skipped = excess - evicted;
+    queue.enqueue(arrivals.data() + skipped, arrivals.size() - skipped);
+    counts.oldestDropped += excess;
+}
+
+/**
+ * @brief Returns how long the head request has been queued.
+ *
+ * @param queue     Non-empty queue.
+ * @param clockTime Current tick.
+ * @return Head sojourn time in cycles.
+ */
+int LoadShedder::headSojourn(const SchedulingQueue& queue, int clockTime) {
+    return clockTime - queue.front().getEnqueueTick();
+}
+
+/**
+ * @brief Applies the CoDel control law: the next drop follows after
+ *        @c interval / sqrt(dropCount).
+ * @param from Time of the current drop.
+ */
+void LoadShedder::scheduleNextDrop(double from) {
+    dropNext = from + codelInterval / std::sqrt(static_cast<double>(dropCount));
+}
+
+/**
+ * @brief One tick of CoDel (RFC 8289), with the queue head standing in for
+ *        the packet being dequeued.
+ *
+ * @details The head becomes droppable once its sojourn time has been at or
+ * above the target for a full interval. Entering the dropping state drops
+ * one request; while dropping, further requests are dropped on the control
+ * law's schedule until a head under the target is reached. A dropping
+ * state entered soon after the last one resumes its drop rate.
+ *
+ * @param queue     Guarded queue.
+ * @param clockTime Current tick.
+ */
+void LoadShedder::shedStale(SchedulingQueue& queue, int clockTime) {
+    if (policy != SheddingPolicy::CODEL) {
+        return;
+    }
+    if (queue.empty()) {
+        firstAboveTime = -1;
+        dropping = false;
+        return;
+    }
+
+    bool okToDrop = false;
+    if (headSojourn(queue, clockTime) < codelTarget) {
+        firstAboveTime = -1;
+    } else if (firstAboveTime < 0) {
+        firstAboveTime = clockTime + codelInterval;
+    } else {
+        okToDrop = clockTime >= firstAboveTime;
+    }
+
+    if (dropping) {
+        if (!okToDrop) {
+            dropping = false;
+            return;
+        }
+        while (dropping && clockTime >= dropNext) {
+            queue.pop();
+            counts.codelDropped++;
+            dropCount++;
+            if (queue.empty() || headSojourn(queue, clockTime) < codelTarget) {
+                dropping = false;
+                firstAboveTime = -1;
+            } else {
+                scheduleNextDrop(dropNext);
+            }
+        }
+    } else if (okToDrop) {
+        queue.pop();
+        counts.codelDropped++;
+        dropping = true;
+
+        uint32_t delta = dropCount - lastDropCount;
+        dropCount = delta > 1 && clockTime - dropNext < 16.0 * codelInterval ? delta : 1;
+        scheduleNextDrop(clockTime);
+        lastDropCount = dropCount;
+    }
+}
+
+/**
+ * @brief Reports whether skipping a tick could change CoDel's decisions.
+ * @param queue Guarded queue.
+ * @return @c true for CoDel with requests queued.
+ */
+bool LoadShedder::needsEveryTick(const SchedulingQueue& queue) const {
+    return policy == SheddingPolicy::CODEL && !queue.empty();
+}
+
+/**
+ * @brief Returns the drop counters.
+ * @return Counts by cause.
+ */
+const ShedCounts& LoadShedder::getCounts() const {
+    return counts;
+}
+
+/**
+ * @brief Writes the drop counters and the CoDel state machine.
+ * @param out Snapshot being written.
+ */
+void LoadShedder::saveState(SnapshotWriter& out) const {
+    out.put(counts);
+    out.put(firstAboveTime);
+    out.put(dropping);
+    out.put(dropCount);
+    out.put(lastDropCount);
+    out.put(dropNext);
+}
+
+/**
+ * @brief Reads the values written by saveState(); the policy and limits stay as configured.
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool LoadShedder::restoreState(SnapshotReader& in) {
+    return in.get(counts) && in.get(firstAboveTime) && in.get(dropping)
+        && in.get(dropCount) && in.get(lastDropCount) && in.get(dropNext);
+}
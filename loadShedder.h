@@ -0,0 +1,176 @@
+/**
+ * @file loadShedder.h
+ * @brief Declaration of the LoadShedder class.
+ *
+ * @details Defines LoadShedder, the admission control in front of a
+ * LoadBalancer's SchedulingQueue. A queue may be given a capacity, and one of
+ * three shedding policies decides what goes when it is exceeded:
+ *  - SheddingPolicy::TAIL_DROP refuses the arrivals that do not fit.
+ *  - SheddingPolicy::DROP_OLDEST admits every arrival and discards the
+ *    requests that have waited longest instead.
+ *  - SheddingPolicy::CODEL tail-drops at capacity and also runs the CoDel
+ *    control law on the head of the queue: once the head's sojourn time
+ *    has stayed above a target for a whole interval, head requests are
+ *    dropped at a rate that grows with the square root of the drop count
+ *    until the sojourn time falls back below the target.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef LOADSHEDDER_H
+#define LOADSHEDDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "request.h"
+#include "schedulingQueue.h"
+#include "snapshot.h"
+
+/**
+ * @enum SheddingPolicy
+ * @brief What a full or congested queue discards.
+ */
+enum class SheddingPolicy {
+    TAIL_DROP,    ///< Refuse arrivals beyond the capacity.
+    DROP_OLDEST,  ///< Admit arrivals and discard the oldest queued requests.
+    CODEL         ///< Tail drop at capacity plus CoDel sojourn-time drops at the head.
+};
+
+/**
+ * @brief Converts a policy name to a SheddingPolicy.
+ *
+ * @param name Policy name: @c "tail-drop", @c "drop-oldest" or @c "codel".
+ * @param policy Receives the parsed policy on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseSheddingPolicy(const std::string& name, SheddingPolicy& policy);
+
+/**
+ * @struct ShedCounts
+ * @brief Requests a LoadShedder has discarded, by cause.
+ */
+struct ShedCounts {
+    uint64_t tailDropped = 0;    ///< Arrivals refused at capacity.
+    uint64_t oldestDropped = 0;  ///< Queued requests evicted by newer arrivals.
+    uint64_t codelDropped = 0;   ///< Head requests dropped by CoDel.
+
+    /**
+     * @brief Returns the sum of all causes.
+     * @return Total requests shed.
+     */
+    uint64_t total() const;
+};
+
+/**
+ * @class LoadShedder
+ * @brief Bounds a SchedulingQueue and sheds load according to a SheddingPolicy.
+ *
+ * @details By default the capacity is 0 (unbounded) and the policy is
+ * SheddingPolicy::TAIL_DROP, so admit() simply enqueues everything.
+ */
+class LoadShedder {
+    public:
+        /**
+         * @brief Constructs an unbounded tail-drop shedder.
+         */
+        LoadShedder();
+
+        /**
+         * @brief Sets the capacity and policy.
+         *
+         * @param policy        Shedding policy.
+         * @param capacity      Maximum queue length (0 = unbounded).
+         * @param codelTarget   Sojourn time, in cycles, CoDel tolerates at the head.
+         * @param codelInterval Cycles the target may be exceeded before CoDel drops.
+         */
+        void configure(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval);
+
+        /**
+         * @brief Returns the configured capacity.
+         * @return Maximum queue length, or 0 if unbounded.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * @brief Returns the number of further requests @p queue can take without shedding.
+         * @param queue Queue guarded by this shedder.
+         * @return Free capacity, or @c SIZE_MAX if unbounded.
+         */
+        size_t headroom(const SchedulingQueue& queue) const;
+
+        /**
+         * @brief Appends @p arrivals to @p queue, shedding whatever the policy requires.
+         * @param queue    Queue guarded by this shedder.
+         * @param arrivals Requests arriving this cycle, in order.
+         */
+        void admit(SchedulingQueue& queue, const std::vector<Request>& arrivals);
+
+        /**
+         * @brief Runs one CoDel step on the head of @p queue.
+         *
+         * @details Does nothing unless the policy is SheddingPolicy::CODEL.
+         * Call once per cycle, before dispatching.
+         *
+         * @param queue     Queue guarded by this shedder.
+         * @param clockTime Current tick.
+         */
+        void shedStale(SchedulingQueue& queue, int clockTime);
+
+        /**
+         * @brief Reports whether shedStale() must run on every tick.
+         * @param queue Queue guarded by this shedder.
+         * @return @c true if CoDel is active and @p queue is not empty.
+         */
+        bool needsEveryTick(const SchedulingQueue& queue) const;
+
+        /**
+         * @brief Returns what has been shed so far.
+         * @return Drop counts by cause.
+         */
+        const ShedCounts& getCounts() const;
+
+        /**
+         * @brief Writes the drop counters and CoDel state (not the configuration) to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the counters and CoDel state with the state read from @p in.
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        SheddingPolicy policy;  ///< Active policy.
+        size_t capacity;        ///< Queue bound (0 = unbounded).
+        int codelTarget;        ///< Acceptable head sojourn time.
+        int codelInterval;      ///< Grace period above target before dropping.
+        ShedCounts counts;      ///< Drop counters.
+
+        int firstAboveTime;     ///< Tick at which an above-target head becomes droppable, or -1.
+        bool dropping;          ///< Whether CoDel is in its dropping state.
+        uint32_t dropCount;     ///< Drops in the current dropping state.
+        uint32_t lastDropCount; ///< dropCount when the last dropping state ended.
+        double dropNext;        ///< Tick of the next scheduled drop while dropping.
+
+        /**
+         * @brief Returns the head's sojourn time.
+         * @param queue     Non-empty queue.
+         * @param clockTime Current tick.
+         * @return Cycles the head request has waited.
+         */
+        static int headSojourn(const SchedulingQueue& queue, int clockTime);
+
+        /**
+         * @brief Advances the CoDel drop schedule by the control law.
+         * @param from Time of the current drop.
+         */
+        void scheduleNextDrop(double from);
+};
+
+#endif
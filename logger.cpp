@@ -0,0 +1,347 @@
+/**
+ * @file logger.cpp
+ * @brief Implementation of the Logger and LogLine classes.
+ *
+ * @details Implements allocation-free line formatting, the bounded
+ * multi-producer ring buffer (after Dmitry Vyukov's sequence-numbered
+ * design), and the background writer that batches records to the sinks.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "logger.h"
+#include "utils.h"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Parses a lower-case level name.
+ *
+ * @param name  One of "debug", "info", "warn", "error" or "off".
+ * @param level Receives the parsed level on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    if (name == "debug")      level = LogLevel::DEBUG;
+    else if (name == "info")  level = LogLevel::INFO;
+    else if (name == "warn")  level = LogLevel::WARN;
+    else if (name == "error") level = LogLevel::ERROR;
+    else if (name == "off")   level = LogLevel::OFF;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Starts an empty line destined for @p logger.
+ *
+ * @param logger   Destination Logger.
+ * @param level    Severity of the line.
+ * @param color    Console colour prefix.
+ * @param fileOnly Whether to skip the console sink.
+ */
+LogLine::LogLine(Logger& logger, LogLevel level, const char* color, bool fileOnly)
+    : logger(logger)
+{
+    record.color    = color;
+    record.level    = level;
+    record.fileOnly = fileOnly;
+    record.length   = 0;
+}
+
+/**
+ * @brief Hands the completed record to the Logger's ring buffer.
+ */
+LogLine::~LogLine() {
+    logger.submit(record);
+}
+
+/**
+ * @brief Appends bytes to the record, silently truncating overlong lines.
+ *
+ * @param data Bytes to append.
+ * @param size Number of bytes.
+ */
+void LogLine::append(const char* data, size_t size) {
+    size_t room = LogRecord::TEXT_CAPACITY - record.length;
+    if (size > room) {
+        size = room;
+    }
+    std::memcpy(record.text + record.length, data, size);
+    record.length = static_cast<uint16_t>(record.length + size);
+}
+
+// Stream operators: each appends the text form of its argument.
+
+LogLine& LogLine::operator<<(const char* text) {
+    append(text, std::strlen(text));
+    return *this;
+}
+
+LogLine& LogLine::operator<<(const std::string& text) {
+    append(text.data(), text.size());
+    return *this;
+}
+
+LogLine& LogLine::operator<<(std::string_view text) {
+    append(text.data(), text.size());
+    return *this;
+}
+
+LogLine& LogLine::operator<<(char c) {
+    append(&c, 1);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(int value) {
+    return *this << static_cast<long long>(value);
+}
+
+LogLine& LogLine::operator<<(long value) {
+    return *this << static_cast<long long>(value);
+}
+
+LogLine& LogLine::operator<<(long long value) {
+    char buf[24];
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value);
+    append(buf, result.ptr - buf);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(unsigned int value) {
+    return *this << static_cast<unsigned long long>(value);
+}
+
+LogLine& LogLine::operator<<(unsigned long value) {
+    return *this << static_cast<unsigned long long>(value);
+}
+
+LogLine& LogLine::operator<<(unsigned long long value) {
+    char buf[24];
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value);
+    append(buf, result.ptr - buf);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(double value) {
+    char buf[64];
+    std::to_chars_result result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 2);
+    append(buf, result.ptr - buf);
+    return *this;
+}
+
+/**
+ * @brief Opens the file sink, initialises the ring and starts the writer.
+ *
+ * @param path    Log file path (truncated); empty disables the file sink.
+ * @param level   Minimum recorded level.
+ * @param console Whether to echo lines to stdout.
+ */
+Logger::Logger(const std::string& path, LogLevel level, bool console)
+    : cells(new Cell[RING_CAPACITY]),
+      enqueuePos(0),
+      dequeuePos(0),
+      written(0),
+      level(static_cast<int>(level)),
+      console(console),
+      stopping(false)
+{
+    for (size_t i = 0; i < RING_CAPACITY; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    if (!path.empty()) {
+        file.open(path, std::ios::out | std::ios::trunc);
+        if (!file) {
+            std::cerr << "WARNING: could not open log file '" << path << "' — file logging disabled." << std::endl;
+        }
+    }
+
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+/**
+ * @brief Drains the ring, then stops and joins the writer thread.
+ */
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wakeWriter.notify_one();
+    writer.join();
+}
+
+/**
+ * @brief Tests a level against the current threshold.
+ * @param level Severity to test.
+ * @return @c true if lines at @p level are recorded.
+ */
+bool Logger::isEnabled(LogLevel level) const {
+    return isCompiledIn(level)
+        && static_cast<int>(level) >= this->level.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the minimum recorded level.
+ * @param level New threshold.
+ */
+void Logger::setLevel(LogLevel level) {
+    this->level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Turns the stdout sink on or off.
+ * @param enabled Whether lines are echoed to stdout.
+ */
+void Logger::setConsole(bool enabled) {
+    console.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Creates a LogLine bound to this logger.
+ *
+ * @param level    Severity of the line.
+ * @param color    Console colour prefix.
+ * @param fileOnly Whether to skip the console sink.
+ * @return The new line builder.
+ */
+LogLine Logger::line(LogLevel level, const char* color, bool fileOnly) {
+    return LogLine(*this, level, color, fileOnly);
+}
+
+/**
+ * @brief Waits until the writer has caught up with every line submitted so far.
+ */
+void Logger::flush() {
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeWriter.notify_one();
+    while (written.load(std::memory_order_acquire) < target) {
+        drained.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief Claims a ring slot, copies the record in and publishes it.
+ *
+ * @details A slot whose sequence equals the claimed position is free; the
+ * producer that wins the compare-and-swap on @c enqueuePos owns it. A slot
+ * whose sequence lags the position means the ring is full, so the producer
+ * yields until the writer releases it.
+ *
+ * @param record Completed line.
+ */
+void Logger::submit(const LogRecord& record) {
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;) {
+        cell = &cells[pos & (RING_CAPACITY - 1)];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            std::this_thread::yield();
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = record;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Writer thread body.
+ *
+ * @details Writes batches back to back while records are available and
+ * naps briefly when the ring is empty. After the destructor sets
+ * @c stopping, one final empty batch confirms the ring is drained.
+ */
+void Logger::writerLoop() {
+    std::string fileBuffer;
+    std::string consoleBuffer;
+
+    for (;;) {
+        bool stop = stopping.load();
+        size_t count = writeBatch(fileBuffer, consoleBuffer);
+
+        if (count == 0) {
+            if (stop) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeWriter.wait_for(lock, std::chrono::milliseconds(2));
+        }
+    }
+}
+
+/**
+ * @brief Consumes up to BATCH_SIZE published records and writes them out.
+ *
+ * @details Records are appended to one buffer per sink (console lines get
+ * their colour prefix and a reset suffix), then each buffer is written and
+ * flushed once.
+ *
+ * @param fileBuffer    Scratch buffer for the file sink (reused across calls).
+ * @param consoleBuffer Scratch buffer for stdout (reused across calls).
+ * @return Number of records consumed.
+ */
+size_t Logger::writeBatch(std::string& fileBuffer, std::string& consoleBuffer) {
+    fileBuffer.clear();
+    consoleBuffer.clear();
+    bool toConsole = console.load(std::memory_order_relaxed);
+    size_t count = 0;
+
+    while (count < BATCH_SIZE) {
+        Cell& cell = cells[dequeuePos & (RING_CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+
+        const LogRecord& record = cell.record;
+        if (file.is_open()) {
+            fileBuffer.append(record.text, record.length);
+            fileBuffer.push_back('\n');
+        }
+        if (toConsole && !record.fileOnly) {
+            bool colored = record.color[0] != '\0';
+            consoleBuffer.append(record.color);
+            consoleBuffer.append(record.text, record.length);
+            if (colored) {
+                consoleBuffer.append(RESET);
+            }
+            consoleBuffer.push_back('\n');
+        }
+
+        cell.sequence.store(dequeuePos + RING_CAPACITY, std::memory_order_release);
+        dequeuePos++;
+        count++;
+    }
+
+    if (count > 0) {
+        if (!fileBuffer.empty()) {
+            file.write(fileBuffer.data(), static_cast<std::streamsize>(fileBuffer.size()));
+            file.flush();
+        }
+        if (!consoleBuffer.empty()) {
+            std::fwrite(consoleBuffer.data(), 1, consoleBuffer.size(), stdout);
+            std::fflush(stdout);
+        }
+
+        written.fetch_add(count, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        drained.notify_all();
+    }
+
+    return count;
+}
@@ -0,0 +1,302 @@
+/**
+ * @file logger.h
+ * @brief Declaration of the asynchronous Logger used by every simulation component.
+ *
+ * @details Defines Logger, LogLine and the LOG macros. Call sites format a
+ * line into a fixed-size record on their own stack and hand it to a bounded,
+ * lock-free ring buffer; a background writer thread drains the ring in
+ * batches and writes each batch to the log file and (optionally, in colour)
+ * to stdout with a single call per sink. Nothing is flushed per line.
+ *
+ * Each line carries a LogLevel. Lines below the logger's level are skipped
+ * before any formatting happens, so per-cycle chatter can be switched off
+ * at runtime for long runs. Levels below @c LB_MIN_LOG_LEVEL are removed at
+ * compile time instead: their LOG statements are discarded by
+ * <tt>if constexpr</tt> and generate no code at all.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log line, in increasing order.
+ */
+enum class LogLevel {
+    DEBUG,  ///< Per-cycle progress chatter.
+    INFO,   ///< Notable events such as scaling decisions and dropped requests.
+    WARN,   ///< Conditions that deserve attention, e.g. DoS detection.
+    ERROR,  ///< Failures.
+    OFF     ///< Used only as a threshold: suppresses every line.
+};
+
+/**
+ * @brief Converts a level name ("debug", "info", "warn", "error", "off") to a LogLevel.
+ *
+ * @param name  Lower-case level name.
+ * @param level Receives the parsed level on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+/**
+ * @def LB_MIN_LOG_LEVEL
+ * @brief Lowest LogLevel compiled into the program, as its numeric value.
+ *
+ * @details 0 (the default) keeps every level; 1 drops DEBUG lines, 2 also
+ * INFO, and so on up to 4, which compiles out all logging. Set it with e.g.
+ * @c -DLB_MIN_LOG_LEVEL=1; the release build targets do.
+ */
+#ifndef LB_MIN_LOG_LEVEL
+#define LB_MIN_LOG_LEVEL 0
+#endif
+
+/// Lowest level for which LOG statements are compiled.
+constexpr LogLevel COMPILED_LOG_LEVEL = static_cast<LogLevel>(LB_MIN_LOG_LEVEL);
+
+/**
+ * @brief Reports whether lines at @p level survive compilation.
+ * @param level Severity to test.
+ * @return @c true if @p level is at or above @c COMPILED_LOG_LEVEL.
+ */
+constexpr bool isCompiledIn(LogLevel level) {
+    return level != LogLevel::OFF && level >= COMPILED_LOG_LEVEL;
+}
+
+/**
+ * @struct LogRecord
+ * @brief One formatted line as it travels through the ring buffer.
+ */
+struct LogRecord {
+    static const int TEXT_CAPACITY = 232;  ///< Longer lines are truncated.
+
+    const char* color;         ///< ANSI colour prefix for the console, or "" for none.
+    LogLevel level;            ///< Severity of the line.
+    bool fileOnly;             ///< If set, the line is not echoed to stdout.
+    uint16_t length;           ///< Number of valid bytes in @c text.
+    char text[TEXT_CAPACITY];  ///< Line text without the trailing newline.
+};
+
+class Logger;
+
+/**
+ * @class LogLine
+ * @brief Stream-style builder for a single log line.
+ *
+ * @details Values are appended into the embedded LogRecord without any heap
+ * allocation; the finished record is submitted to the Logger when the
+ * LogLine is destroyed, i.e. at the end of the full expression when used
+ * through the LOG macros.
+ */
+class LogLine {
+    public:
+        /**
+         * @brief Starts a line for @p logger.
+         *
+         * @param logger   Destination Logger.
+         * @param level    Severity of the line.
+         * @param color    ANSI colour prefix used on the console ("" for none).
+         * @param fileOnly If @c true the line is written to the log file only.
+         */
+        LogLine(Logger& logger, LogLevel level, const char* color, bool fileOnly);
+
+        /**
+         * @brief Submits the finished line to the Logger.
+         */
+        ~LogLine();
+
+        LogLine(const LogLine&) = delete;
+        LogLine& operator=(const LogLine&) = delete;
+
+        /** @brief Appends a C string. */
+        LogLine& operator<<(const char* text);
+        /** @brief Appends a string. */
+        LogLine& operator<<(const std::string& text);
+        /** @brief Appends a string view. */
+        LogLine& operator<<(std::string_view text);
+        /** @brief Appends a single character. */
+        LogLine& operator<<(char c);
+        /** @brief Appends a signed integer in decimal. */
+        LogLine& operator<<(int value);
+        /** @brief Appends a signed integer in decimal. */
+        LogLine& operator<<(long value);
+        /** @brief Appends a signed integer in decimal. */
+        LogLine& operator<<(long long value);
+        /** @brief Appends an unsigned integer in decimal. */
+        LogLine& operator<<(unsigned int value);
+        /** @brief Appends an unsigned integer in decimal. */
+        LogLine& operator<<(unsigned long value);
+        /** @brief Appends an unsigned integer in decimal. */
+        LogLine& operator<<(unsigned long long value);
+        /** @brief Appends a floating-point value with two decimal places. */
+        LogLine& operator<<(double value);
+
+    private:
+        Logger& logger;    ///< Destination of the finished record.
+        LogRecord record;  ///< Line being built.
+
+        /**
+         * @brief Appends raw bytes, truncating at the record capacity.
+         * @param data Bytes to append.
+         * @param size Number of bytes.
+         */
+        void append(const char* data, size_t size);
+};
+
+/**
+ * @class Logger
+ * @brief Asynchronous, batched, level-filtered log writer.
+ *
+ * @details Producers (any thread) claim a slot in a bounded multi-producer
+ * ring buffer with a single compare-and-swap, copy their record in and
+ * publish it by bumping the slot's sequence number. A single background
+ * thread consumes records in order, concatenates up to a batch-worth of
+ * lines per sink, and issues one write per sink per batch. If the ring is
+ * full, producers yield until the writer frees a slot, so lines are never
+ * dropped.
+ *
+ * Destroying the Logger drains all outstanding records and joins the writer.
+ */
+class Logger {
+    public:
+        /**
+         * @brief Opens the log file and starts the background writer thread.
+         *
+         * @param path    Log file path; truncated on open. An empty path
+         *                disables the file sink.
+         * @param level   Minimum level that is recorded.
+         * @param console Whether lines are also echoed to stdout.
+         */
+        Logger(const std::string& path, LogLevel level = LogLevel::DEBUG, bool console = true);
+
+        /**
+         * @brief Writes any outstanding lines and stops the writer thread.
+         */
+        ~Logger();
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        /**
+         * @brief Reports whether lines at @p level are currently recorded.
+         * @param level Severity to test.
+         * @return @c true if @p level is compiled in and at or above the
+         *         configured threshold.
+         */
+        bool isEnabled(LogLevel level) const;
+
+        /**
+         * @brief Changes the minimum recorded level.
+         * @param level New threshold.
+         */
+        void setLevel(LogLevel level);
+
+        /**
+         * @brief Enables or disables echoing lines to stdout.
+         * @param enabled @c true to write to the console as well as the file.
+         */
+        void setConsole(bool enabled);
+
+        /**
+         * @brief Starts a new line; prefer the LOG macros, which skip disabled levels.
+         *
+         * @param level    Severity of the line.
+         * @param color    ANSI colour prefix used on the console.
+         * @param fileOnly If @c true the line is written to the log file only.
+         * @return A LogLine that submits itself when destroyed.
+         */
+        LogLine line(LogLevel level, const char* color = "", bool fileOnly = false);
+
+        /**
+         * @brief Blocks until every line submitted before the call has been written.
+         */
+        void flush();
+
+    private:
+        friend class LogLine;
+
+        /**
+         * @struct Cell
+         * @brief One ring-buffer slot with its publication sequence number.
+         */
+        struct Cell {
+            std::atomic<uint64_t> sequence;  ///< Slot state for the ring protocol.
+            LogRecord record;                ///< Payload.
+        };
+
+        static const size_t RING_CAPACITY = 8192;  ///< Slots in the ring (power of two).
+        static const size_t BATCH_SIZE    = 512;   ///< Max records written per batch.
+
+        std::unique_ptr<Cell[]> cells;       ///< Ring storage.
+        std::atomic<uint64_t> enqueuePos;    ///< Next slot producers will claim.
+        uint64_t dequeuePos;                 ///< Next slot the writer will consume.
+        std::atomic<uint64_t> written;       ///< Records fully written by the writer.
+
+        std::atomic<int> level;              ///< Current threshold, as an int.
+        std::atomic<bool> console;           ///< Whether stdout is a sink.
+        std::atomic<bool> stopping;          ///< Set by the destructor to end the writer.
+
+        std::ofstream file;                  ///< File sink (may be closed).
+        std::mutex wakeMutex;                ///< Guards the condition variables below.
+        std::condition_variable wakeWriter;  ///< Signalled on flush and shutdown.
+        std::condition_variable drained;     ///< Signalled after each written batch.
+        std::thread writer;                  ///< Background writer thread.
+
+        /**
+         * @brief Copies @p record into the ring, waiting for space if necessary.
+         * @param record Finished line.
+         */
+        void submit(const LogRecord& record);
+
+        /**
+         * @brief Background loop: drain, format and write batches until stopped.
+         */
+        void writerLoop();
+
+        /**
+         * @brief Moves up to BATCH_SIZE records out of the ring and writes them.
+         * @param fileBuffer    Scratch buffer for the file sink.
+         * @param consoleBuffer Scratch buffer for stdout.
+         * @return Number of records written.
+         */
+        size_t writeBatch(std::string& fileBuffer, std::string& consoleBuffer);
+};
+
+/**
+ * @brief Logs a console-and-file line at @p level if that level is enabled.
+ *
+ * @details Expands to an if/else so the streamed operands are not evaluated
+ * when the level is disabled. @p level must be a constant: levels that are
+ * not compiled in (see isCompiledIn()) are discarded by the
+ * <tt>if constexpr</tt>, taking the formatting code with them.
+ * Usage: @code LOG(logger, LogLevel::INFO) << "x=" << x; @endcode
+ */
+#define LOG(logger, level) \
+    if constexpr (!isCompiledIn(level)) {} else if (!(logger).isEnabled(level)) {} else (logger).line(level)
+
+/**
+ * @brief Like LOG, but the console copy of the line is wrapped in @p color.
+ */
+#define LOG_COLOR(logger, level, color) \
+    if constexpr (!isCompiledIn(level)) {} else if (!(logger).isEnabled(level)) {} else (logger).line(level, color)
+
+/**
+ * @brief Like LOG, but the line is written to the log file only.
+ */
+#define LOG_FILE(logger, level) \
+    if constexpr (!isCompiledIn(level)) {} else if (!(logger).isEnabled(level)) {} else (logger).line(level, "", true)
+
+#endif
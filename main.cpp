@@ -3,9 +3,11 @@
  * @brief Entry point for the load balancer simulation.
  *
  * @details Reads simulation parameters from a configuration file
- * (@c config.txt), initializes the request queues and web server pools,
- * constructs the Switch, and runs the simulation for the configured number
- * of clock cycles.
+ * (@c config.txt) and runs one simulation with them (see runSimulation()),
+ * or, if the file contains @c "Sweep ..." settings, a parallel parameter
+ * sweep that writes a CSV summary instead (see SweepRunner). A
+ * @c "Frontend Listen" setting instead runs the Firewall in front of real
+ * TCP backends (see NetworkFrontend).
  *
  * <b>Configuration file format (config.txt):</b>
  * @code
@@ -17,101 +19,118 @@
  * maxProcessingTime: <int>
  * @endcode
  *
- * Each load balancer starts with @c initialServers servers and a pre-filled
+ * The six settings above are read positionally. Any further lines are
+ * optional @c "Key: value" settings:
+ *  - @c "Blocklist File" — path of a block-list file loaded into the Firewall.
+ *  - @c "Ban Duration"   — cycles a DoS auto-ban lasts (0 = permanent).
+ *  - @c "Rate Limit Mode" — @c fixed (default), @c sliding or @c token.
+ *  - @c "Log Level"      — @c debug (default), @c info, @c warn, @c error or @c off.
+ *  - @c "Console Output" — @c on (default) or @c off to keep stdout quiet.
+ *  - @c "Simulation Mode" — @c tick (default) or @c event to skip idle cycles.
+ *  - @c "Parallel Load Balancers" — @c on to run each balancer on its own thread.
+ *  - @c "Job Classes"    — job-type characters, one load balancer each
+ *    (default @c "P,S"); commas and spaces are ignored.
+ *  - @c "Dispatch Policy" — @c first-idle (default), @c least-work,
+ *    @c power-of-two, @c sed or @c affinity (consistent hash of the source
+ *    address).
+ *  - @c "Local Queue Depth" — requests each server may queue behind its current one (default 0, at most 65535).
+ *  - @c "Scaling Mode"   — @c threshold (default) or @c predictive to size the pool
+ *    from arrival-rate and service-time estimates.
+ *  - @c "Target Wait"    — queueing delay, in cycles, the predictive scaler sizes for (default 20).
+ *  - @c "Max Servers"    — largest pool the predictive scaler provisions per load balancer (default 1000).
+ *  - @c "Scale-Up Warm-Up" — cycles before a newly requested server takes work (default 0).
+ *  - @c "Queue Capacity" — maximum requests waiting in each load balancer (default 0 = unbounded).
+ *  - @c "Shedding Policy" — @c tail-drop (default), @c drop-oldest or @c codel.
+ *  - @c "CoDel Target" / @c "CoDel Interval" — CoDel's sojourn target and interval in cycles (default 5 / 100).
+ *  - @c "Backpressure"   — @c off (default), @c reject or @c reroute requests a full balancer has no room for.
+ *  - @c "Queue Discipline" — @c fifo (default), @c drr (deficit round robin over priority
+ *    classes) or @c sjf (shortest processing time first).
+ *  - @c "Priority Cutoffs" — processing-time bounds of the priority classes, e.g. @c 3,7
+ *    (default: half the Max Processing Time); @c "Class Weights" — their DRR weights (default 1 each);
+ *    @c "DRR Quantum" — cycles a weight-1 class earns per turn (default: the Max Processing Time).
+ *  - @c "Trace File"     — JSONL or binary trace to replay instead of generating traffic
+ *    (see TraceReader for the formats).
+ *  - @c "Random Seed"    — seed of the traffic generator (default 1).
+ *  - @c "Arrival Process" — @c bernoulli (default), @c poisson or @c mmpp.
+ *  - @c "Arrival Rate"   — mean requests per tick for @c poisson, and in the calm state of
+ *    @c mmpp (default 4.1).
+ *  - @c "Burst Rate" / @c "Calm Length" / @c "Burst Length" — the @c mmpp burst-state rate and
+ *    mean spell lengths in ticks (default 20.5 / 180 / 20).
+ *  - @c "Process Time Distribution" — @c uniform (default) or @c pareto with the same mean.
+ *  - @c "Pareto Shape"   — tail index of the Pareto process times (default 1.5).
+ *  - @c "Metrics File"   — Prometheus text file rewritten every @c "Metrics Interval" cycles
+ *    (default 10000) and at the end of the run.
+ *  - @c "Metrics Port"   — serve the same metrics at http://127.0.0.1:<port>/metrics while running.
+ *  - @c "Event Log"      — write per-cycle, scaling and firewall events to this binary file
+ *    instead of the text log; decode it with @c lbdecode (see eventLog.h for the format).
+ *  - @c "Snapshot Save" / @c "Snapshot Load" — write the full simulation state to this file
+ *    after the run / resume from it before the run (see snapshot.h for the format).
+ *  - @c "Frontend Listen" / @c "Frontend Backends" — @c [class=][address:]port lists of
+ *    listening sockets and backends; selects front-end mode (see runFrontend()).
+ *  - @c "Frontend Tick" / @c "Frontend Health Retry" / @c "Frontend Duration" — milliseconds
+ *    per firewall tick (default 10), milliseconds a failed backend is skipped (default 1000)
+ *    and seconds to run (default 0, until interrupted).
+ *  - @c "Sweep Initial Servers" / @c "Sweep Min Threshold" / @c "Sweep Max Threshold" /
+ *    @c "Sweep Cooldown Time" / @c "Sweep Arrival Rate" — values to sweep, e.g. @c "50..80:10";
+ *    any of these selects sweep mode.
+ *  - @c "Sweep Seeds" / @c "Sweep Threads" / @c "Sweep Output" — replicates per combination
+ *    (default 1), worker threads (default one per core) and CSV path (default @c sweep.csv).
+ *
+ * Each load balancer (one per job class) starts with @c initialServers servers and a pre-filled
  * queue of @c initialServers * 100 requests. New requests may arrive randomly
- * during the run managed by the Switch.
+ * during the run managed by the Switch. When a trace is replayed the queues
+ * start empty and every request comes from the trace.
  *
  * @author Load Balancer Project
  * @date 2025
  *
- * @return 0 on successful completion.
+ * @return 0 on successful completion, 1 if the configuration or sweep could not be read.
  */
 
-#include <queue>
-#include <vector>
 #include <iostream>
-#include "switch.h"
+#include <map>
+#include <string>
+#include "logger.h"
+#include "networkFrontend.h"
+#include "simulation.h"
+#include "sweepRunner.h"
 
 /**
  * @brief Program entry point.
  *
- * @details Performs the following initialization steps:
- *  -# Opens the log file and configuration file.
- *  -# Parses each configuration parameter by extracting the value after ':'.
- *  -# Creates @c initialServers WebServer objects for each load balancer.
- *  -# Populates each balancer's initial queue with @c initialServers*100 requests
- *     whose processing times are uniformly random in [1, maxProcessingTime].
- *  -# Constructs and runs the Switch for @c clockCycles ticks.
+ * @details Reads @c config.txt, then either hands it to a SweepRunner or
+ * starts the Logger with the configured level and console setting and runs
+ * a single simulation, or the network front end, that logs to
+ * @c loadBalancer.log.
  *
  * @return 0 on success.
  */
 int main() {
-    std::queue<Request> requestQueue_P;
-    std::queue<Request> requestQueue_S;
-    std::vector<WebServer> webServers_P;
-    std::vector<WebServer> webServers_S;
-
-    std::ofstream logFile("loadBalancer.log", std::ios::out | std::ios::trunc);
-    std::ifstream configFile("config.txt");
-    
-    std::string intialServersLine, minThresholdLine, maxThresholdLine, cooldownTimeLine, maxProcessingTimeLine, clockCyclesLine;
-    
-    std::getline(configFile, intialServersLine);
-    int initialServers = std::stoi(intialServersLine.substr(intialServersLine.find(":") + 1));
-    logFile << "Initial Servers: " << initialServers << std::endl;
-
-    std::getline(configFile, clockCyclesLine);
-    int clockCycles = std::stoi(clockCyclesLine.substr(clockCyclesLine.find(":") + 1));
-    logFile << "Clock Cycles: " << clockCycles << std::endl;
-
-    std::getline(configFile, minThresholdLine);
-    int minThreshold = std::stoi(minThresholdLine.substr(minThresholdLine.find(":") + 1));
-    logFile << "Min Threshold: " << minThreshold << std::endl;
-
-    std::getline(configFile, maxThresholdLine);
-    int maxThreshold = std::stoi(maxThresholdLine.substr(maxThresholdLine.find(":") + 1));
-    logFile << "Max Threshold: " << maxThreshold << std::endl;
-
-    std::getline(configFile, cooldownTimeLine);
-    int cooldownTime = std::stoi(cooldownTimeLine.substr(cooldownTimeLine.find(":") + 1));
-    logFile << "Cooldown Time: " << cooldownTime << std::endl;
-
-    std::getline(configFile, maxProcessingTimeLine);
-    int maxProcessingTime = std::stoi(maxProcessingTimeLine.substr(maxProcessingTimeLine.find(":") + 1));
-    logFile << "Max Processing Time: " << maxProcessingTime << std::endl;
-
-    logFile << std::endl;
-
-    for (int i = 0; i < initialServers; i++) {
-        webServers_P.push_back(WebServer(i));
-        webServers_S.push_back(WebServer(i + initialServers));
+    SimulationConfig config;
+    if (!readSimulationConfig("config.txt", config)) {
+        return 1;
     }
 
-    for (int i = 0; i < initialServers*100; i++) {
-        int processTime = rand() % maxProcessingTime + 1;
-        char jobType = 'P';
-        Request newRequest = Request(processTime, jobType);
-        requestQueue_P.push(newRequest);
+    if (SweepRunner::isSweep(config)) {
+        SweepRunner sweep(config);
+        return sweep.run() ? 0 : 1;
     }
 
-    for (int i = 0; i < initialServers*100; i++) {
-        int processTime = rand() % maxProcessingTime + 1;
-        char jobType = 'S';
-        Request newRequest = Request(processTime, jobType);
-        requestQueue_S.push(newRequest);
+    std::map<std::string, std::string>& settings = config.settings;
+    LogLevel logLevel = LogLevel::DEBUG;
+    if (settings.count("Log Level") && !parseLogLevel(settings["Log Level"], logLevel)) {
+        std::cerr << "WARNING: unknown Log Level '" << settings["Log Level"] << "' — using debug." << std::endl;
+    } else if (settings.count("Log Level") && logLevel != LogLevel::OFF && !isCompiledIn(logLevel)) {
+        std::cerr << "WARNING: Log Level '" << settings["Log Level"] << "' is compiled out of this build (LB_MIN_LOG_LEVEL="
+                  << LB_MIN_LOG_LEVEL << ") — only higher levels are logged." << std::endl;
     }
+    bool consoleOutput = !(settings.count("Console Output") && settings["Console Output"] == "off");
 
-    logFile << "Initial processing request queue populated with " << requestQueue_P.size() << " requests" << std::endl;
-    logFile << "Initial streaming request queue populated with " << requestQueue_S.size() << " requests" << std::endl;
-    logFile << std::endl;
-    logFile << "Initial processing servers available: " << webServers_P.size() << std::endl;
-    logFile << "Initial streaming servers available: " << webServers_S.size() << std::endl;
-    logFile << std::endl;
-    logFile << "Request processing time is uniformly random in the range [1, " << maxProcessingTime << "] clock cycles" << std::endl;
-    logFile << std::endl;
-
-    Switch switch_(requestQueue_P, requestQueue_S, webServers_P, webServers_S, minThreshold, maxThreshold, cooldownTime, maxProcessingTime);
-    switch_.run(clockCycles, logFile);
+    Logger logger("loadBalancer.log", logLevel, consoleOutput);
+    if (NetworkFrontend::isFrontend(config)) {
+        return runFrontend(config, logger) ? 0 : 1;
+    }
+    runSimulation(config, logger);
 
     return 0;
 }
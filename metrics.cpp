@@ -0,0 +1,139 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the MetricsRegistry class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @brief Allocates and zeroes the shards and gauge slots.
+ */
+MetricsRegistry::MetricsRegistry()
+    : shards(new Shard[SHARD_COUNT]),
+      gauges(new PaddedGauge[MAX_SERIES]),
+      counterCount(0),
+      gaugeCount(0)
+{
+    for (size_t s = 0; s < SHARD_COUNT; s++) {
+        for (std::atomic<uint64_t>& count : shards[s].counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < MAX_SERIES; i++) {
+        gauges[i].value.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Claims the next counter slot for a new series.
+ *
+ * @param name   Metric name.
+ * @param help   Description.
+ * @param labels Label text.
+ * @return Handle to the series.
+ */
+Counter MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (counterCount == MAX_SERIES) {
+        std::cerr << "WARNING: metrics registry full — counter '" << name << "' is not recorded." << std::endl;
+        return Counter();
+    }
+    series.push_back({familyFor(name, help, false), labels, false, counterCount});
+    return Counter(this, counterCount++);
+}
+
+/**
+ * @brief Claims the next gauge slot for a new series.
+ *
+ * @param name   Metric name.
+ * @param help   Description.
+ * @param labels Label text.
+ * @return Handle to the series.
+ */
+Gauge MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (gaugeCount == MAX_SERIES) {
+        std::cerr << "WARNING: metrics registry full — gauge '" << name << "' is not recorded." << std::endl;
+        return Gauge();
+    }
+    series.push_back({familyFor(name, help, true), labels, true, gaugeCount});
+    return Gauge(&gauges[gaugeCount++].value);
+}
+
+/**
+ * @brief Emits each family's HELP and TYPE lines followed by its series.
+ *
+ * @details Counter values are the sum of every shard's partial count.
+ *
+ * @return Exposition text.
+ */
+std::string MetricsRegistry::exposition() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream text;
+    for (size_t f = 0; f < families.size(); f++) {
+        const Family& family = families[f];
+        text << "# HELP " << family.name << ' ' << family.help << '\n'
+             << "# TYPE " << family.name << ' ' << (family.isGauge ? "gauge" : "counter") << '\n';
+        for (const Series& entry : series) {
+            if (entry.family != f) {
+                continue;
+            }
+            text << family.name;
+            if (!entry.labels.empty()) {
+                text << '{' << entry.labels << '}';
+            }
+            if (entry.isGauge) {
+                text << ' ' << gauges[entry.slot].value.load(std::memory_order_relaxed) << '\n';
+            } else {
+                uint64_t total = 0;
+                for (size_t s = 0; s < SHARD_COUNT; s++) {
+                    total += shards[s].counts[entry.slot].load(std::memory_order_relaxed);
+                }
+                text << ' ' << total << '\n';
+            }
+        }
+    }
+    return text.str();
+}
+
+/**
+ * @brief Writes the exposition to a temporary file and renames it over @p path.
+ * @param path Destination file.
+ * @return @c true on success.
+ */
+bool MetricsRegistry::writeFile(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+        file << exposition();
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Looks up a family by name, appending it if absent.
+ *
+ * @param name    Metric name.
+ * @param help    Description for a new family.
+ * @param isGauge Type of a new family.
+ * @return Family index.
+ */
+size_t MetricsRegistry::familyFor(const std::string& name, const std::string& help, bool isGauge) {
+    for (size_t f = 0; f < families.size(); f++) {
+        if (families[f].name == name) {
+            return f;
+        }
+    }
+    families.push_back({name, help, isGauge});
+    return families.size() - 1;
+}
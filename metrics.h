@@ -0,0 +1,247 @@
+/**
+ * @file metrics.h
+ * @brief Declaration of MetricsRegistry and its Counter and Gauge handles.
+ *
+ * @details The registry holds numeric time series that the Switch, its
+ * Firewall and its LoadBalancers update as they run, and renders them in the
+ * Prometheus text exposition format on demand (see MetricsServer for the
+ * HTTP endpoint and Switch::setMetricsExport() for periodic files).
+ *
+ * Counters are sharded: each thread adds to its own cache-line-aligned
+ * shard, picked once per thread, so parallel load balancers never contend
+ * on a counter; a read sums the shards. Gauges have a single owner and are
+ * each padded to a cache line instead. Updates are relaxed atomic
+ * operations, so a reader on another thread sees recent, not necessarily
+ * simultaneous, values.
+ *
+ * Handles obtained from a registry stay valid for its lifetime. A
+ * default-constructed handle is inert, so components can update their
+ * metrics unconditionally whether or not a registry is attached.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class MetricsRegistry;
+
+/**
+ * @class Counter
+ * @brief Handle to a monotonically increasing, sharded counter.
+ */
+class Counter {
+    public:
+        /**
+         * @brief Constructs an inert handle; add() does nothing.
+         */
+        Counter();
+
+        /**
+         * @brief Adds @p amount to the calling thread's shard of the counter.
+         * @param amount Increment.
+         */
+        void add(uint64_t amount = 1) const;
+
+    private:
+        friend class MetricsRegistry;
+
+        MetricsRegistry* registry;  ///< Owning registry, or @c nullptr if inert.
+        size_t index;               ///< Series index within the registry.
+
+        /**
+         * @brief Constructs a handle to series @p index of @p registry.
+         * @param registry Owning registry.
+         * @param index    Series index.
+         */
+        Counter(MetricsRegistry* registry, size_t index);
+};
+
+/**
+ * @class Gauge
+ * @brief Handle to a value that is set rather than accumulated.
+ */
+class Gauge {
+    public:
+        /**
+         * @brief Constructs an inert handle; set() does nothing.
+         */
+        Gauge();
+
+        /**
+         * @brief Replaces the gauge's value.
+         * @param value New value.
+         */
+        void set(int64_t value) const;
+
+    private:
+        friend class MetricsRegistry;
+
+        std::atomic<int64_t>* cell;  ///< The gauge's padded storage, or @c nullptr if inert.
+
+        /**
+         * @brief Constructs a handle to @p cell.
+         * @param cell Gauge storage.
+         */
+        explicit Gauge(std::atomic<int64_t>* cell);
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Fixed-capacity set of counter and gauge series with Prometheus text export.
+ *
+ * @details Series are grouped into families by name, one family per
+ * metric, each series distinguished by its labels. Registration and export
+ * take a mutex; updates through the handles are lock-free.
+ */
+class MetricsRegistry {
+    public:
+        static const size_t SHARD_COUNT = 16;  ///< Counter shards; threads beyond this share shards.
+        static const size_t MAX_SERIES = 256;  ///< Counters, and separately gauges, per registry.
+
+        /**
+         * @brief Constructs an empty registry with zeroed storage.
+         */
+        MetricsRegistry();
+
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        /**
+         * @brief Registers a counter series.
+         *
+         * @param name   Metric name, e.g. @c "lb_dispatched_total".
+         * @param help   One-line description for the @c # HELP line.
+         * @param labels Label text without braces, e.g. @c "lb=\"P\"", or empty.
+         * @return Handle to the series; inert (after a warning) if the registry is full.
+         */
+        Counter counter(const std::string& name, const std::string& help, const std::string& labels = "");
+
+        /**
+         * @brief Registers a gauge series.
+         *
+         * @param name   Metric name.
+         * @param help   One-line description.
+         * @param labels Label text without braces, or empty.
+         * @return Handle to the series; inert (after a warning) if the registry is full.
+         */
+        Gauge gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+
+        /**
+         * @brief Renders every series in the Prometheus text format, version 0.0.4.
+         * @return Exposition text, families in registration order.
+         */
+        std::string exposition() const;
+
+        /**
+         * @brief Writes exposition() to @p path, replacing it atomically.
+         *
+         * @details The text goes to @c path.tmp first and is then renamed, so
+         * a scraper or textfile collector never reads a partial file.
+         *
+         * @param path Destination file.
+         * @return @c false if the file could not be written.
+         */
+        bool writeFile(const std::string& path) const;
+
+    private:
+        friend class Counter;
+
+        /**
+         * @struct Shard
+         * @brief One thread group's copy of every counter, on its own cache lines.
+         */
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> counts[MAX_SERIES];  ///< Partial sums, by series index.
+        };
+
+        /**
+         * @struct PaddedGauge
+         * @brief One gauge value alone on a cache line.
+         */
+        struct alignas(64) PaddedGauge {
+            std::atomic<int64_t> value;  ///< Current value.
+        };
+
+        /**
+         * @struct Series
+         * @brief Metadata of one registered series.
+         */
+        struct Series {
+            size_t family;       ///< Index into @c families.
+            std::string labels;  ///< Label text without braces.
+            bool isGauge;        ///< Whether @c slot indexes @c gauges rather than the shards.
+            size_t slot;         ///< Storage index.
+        };
+
+        /**
+         * @struct Family
+         * @brief Name, help text and type shared by a metric's series.
+         */
+        struct Family {
+            std::string name;  ///< Metric name.
+            std::string help;  ///< Description.
+            bool isGauge;      ///< Prometheus type: gauge or counter.
+        };
+
+        std::unique_ptr<Shard[]> shards;        ///< Counter storage, @c SHARD_COUNT shards.
+        std::unique_ptr<PaddedGauge[]> gauges;  ///< Gauge storage, @c MAX_SERIES slots.
+        size_t counterCount;                    ///< Counter slots in use.
+        size_t gaugeCount;                      ///< Gauge slots in use.
+        std::vector<Family> families;           ///< Metric families, in registration order.
+        std::vector<Series> series;             ///< All series, in registration order.
+        mutable std::mutex mutex;               ///< Guards registration and export.
+
+        /**
+         * @brief Returns the family named @p name, creating it if needed.
+         *
+         * @param name    Metric name.
+         * @param help    Description, used if the family is new.
+         * @param isGauge Type, used if the family is new.
+         * @return Index into @c families.
+         */
+        size_t familyFor(const std::string& name, const std::string& help, bool isGauge);
+
+        /**
+         * @brief Returns the calling thread's shard, assigned round-robin on first use.
+         * @return Shard index in [0, SHARD_COUNT).
+         */
+        static size_t threadShard();
+};
+
+inline size_t MetricsRegistry::threadShard() {
+    static std::atomic<size_t> nextShard(0);
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return shard;
+}
+
+inline Counter::Counter() : registry(nullptr), index(0) {}
+
+inline Counter::Counter(MetricsRegistry* registry, size_t index) : registry(registry), index(index) {}
+
+inline void Counter::add(uint64_t amount) const {
+    if (registry != nullptr) {
+        registry->shards[MetricsRegistry::threadShard()].counts[index].fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+inline Gauge::Gauge() : cell(nullptr) {}
+
+inline Gauge::Gauge(std::atomic<int64_t>* cell) : cell(cell) {}
+
+inline void Gauge::set(int64_t value) const {
+    if (cell != nullptr) {
+        cell->store(value, std::memory_order_relaxed);
+    }
+}
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file metricsServer.cpp
+ * @brief Implementation of the MetricsServer class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "metricsServer.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/// Longest the accept loop waits before rechecking @c stopping, in milliseconds.
+static const int POLL_INTERVAL_MS = 100;
+
+/// Longest a client may take to send its request line, in milliseconds.
+static const int REQUEST_TIMEOUT_MS = 1000;
+
+/**
+ * @brief Constructs a server with no socket.
+ */
+MetricsServer::MetricsServer()
+    : listenFd(-1),
+      port(0),
+      registry(nullptr),
+      stopping(false)
+{
+}
+
+/**
+ * @brief Stops the server thread and closes the socket.
+ */
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+/**
+ * @brief Creates, binds and listens on the loopback socket, then starts the thread.
+ *
+ * @param port     TCP port in [0, 65535]; 0 picks a free one.
+ * @param registry Registry to serve.
+ * @return @c true if the server is running.
+ */
+bool MetricsServer::start(int port, const MetricsRegistry& registry) {
+    stop();
+
+    if (port < 0 || port > 65535) {
+        std::cerr << "WARNING: Metrics Port " << port << " is outside 0-65535 — metrics endpoint disabled." << std::endl;
+        return false;
+    }
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "WARNING: could not create metrics socket — metrics endpoint disabled." << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    socklen_t length = sizeof(address);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 8) != 0 ||
+            getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        std::cerr << "WARNING: could not listen on 127.0.0.1:" << port << " — metrics endpoint disabled." << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    this->port = ntohs(address.sin_port);
+    this->registry = &registry;
+    stopping.store(false);
+    thread = std::thread(&MetricsServer::serveLoop, this);
+    return true;
+}
+
+/**
+ * @brief Signals the thread, waits for it and closes the socket.
+ */
+void MetricsServer::stop() {
+    if (thread.joinable()) {
+        stopping.store(true);
+        thread.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+    port = 0;
+}
+
+/**
+ * @brief Returns the bound port.
+ * @return @c port.
+ */
+int MetricsServer::getPort() const {
+    return port;
+}
+
+/**
+ * @brief Polls the listening socket so that stop() is noticed promptly.
+ */
+void MetricsServer::serveLoop() {
+    while (!stopping.load()) {
+        pollfd waiting = {listenFd, POLLIN, 0};
+        if (poll(&waiting, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(listenFd, nullptr, nullptr);
+        if (client >= 0) {
+            handle(client);
+            close(client);
+        }
+    }
+}
+
+/**
+ * @brief Reads the request line and answers with the exposition or a 404.
+ *
+ * @details Only the request line matters, so reading stops at the first
+ * newline or after the timeout; headers are not parsed.
+ *
+ * @param fd Connected socket.
+ */
+void MetricsServer::handle(int fd) {
+    std::string request;
+    char buffer[1024];
+    while (request.find('\n') == std::string::npos && request.size() < 8192) {
+        pollfd readable = {fd, POLLIN, 0};
+        if (poll(&readable, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            return;
+        }
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    bool found = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0;
+    std::string body = found ? registry->exposition() : "not found\n";
+    std::string response = std::string(found ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n")
+        + "Content-Type: text/plain; version=0.0.4\r\n"
+        + "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        + "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file metricsServer.h
+ * @brief Declaration of MetricsServer, a minimal HTTP endpoint for a MetricsRegistry.
+ *
+ * @details The server listens on 127.0.0.1 and answers @c GET @c /metrics
+ * (or @c /) with the registry's Prometheus exposition; any other path gets
+ * a 404. It runs on one background thread, serves one connection at a time
+ * and closes each connection after the response (HTTP/1.0), which is all a
+ * Prometheus scraper or @c curl needs.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <atomic>
+#include <thread>
+#include "metrics.h"
+
+/**
+ * @class MetricsServer
+ * @brief Background HTTP server exposing one MetricsRegistry.
+ */
+class MetricsServer {
+    public:
+        /**
+         * @brief Constructs a stopped server.
+         */
+        MetricsServer();
+
+        /**
+         * @brief Stops the server if it is running.
+         */
+        ~MetricsServer();
+
+        MetricsServer(const MetricsServer&) = delete;
+        MetricsServer& operator=(const MetricsServer&) = delete;
+
+        /**
+         * @brief Binds to 127.0.0.1:@p port and starts serving @p registry.
+         *
+         * @param port     TCP port; 0 picks a free one (see getPort()).
+         * @param registry Registry to expose; must outlive the server.
+         * @return @c false (after printing a warning) if @p port is outside
+         *         0-65535 or the socket could not be set up.
+         */
+        bool start(int port, const MetricsRegistry& registry);
+
+        /**
+         * @brief Stops accepting connections and joins the server thread.
+         */
+        void stop();
+
+        /**
+         * @brief Returns the port the server is bound to.
+         * @return Port number, or 0 if not running.
+         */
+        int getPort() const;
+
+    private:
+        int listenFd;                       ///< Listening socket, or -1.
+        int port;                           ///< Bound port.
+        const MetricsRegistry* registry;    ///< Registry being served.
+        std::atomic<bool> stopping;         ///< Set by stop() to end serveLoop().
+        std::thread thread;                 ///< Runs serveLoop().
+
+        /**
+         * @brief Accepts and answers connections until @c stopping is set.
+         */
+        void serveLoop();
+
+        /**
+         * @brief Reads one request from @p fd and writes the response.
+         * @param fd Connected socket.
+         */
+        void handle(int fd);
+};
+
+#endif
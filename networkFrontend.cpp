@@ -0,0 +1,884 @@
+/**
+ * @file networkFrontend.cpp
+ * @brief Implementation of NetworkFrontend and runFrontend().
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "networkFrontend.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <charconv>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include "utils.h"
+
+namespace {
+
+/// Longest run() waits for events before rechecking @c stopping, in milliseconds.
+const int POLL_INTERVAL_MS = 100;
+
+/// Events fetched per epoll_wait().
+const int EVENT_BATCH = 64;
+
+/// Bytes moved into a pipe per splice(); the default pipe capacity.
+const size_t PIPE_CHUNK = 65536;
+
+/// Milliseconds a listener is left unwatched after accept4() runs out of descriptors.
+const int ACCEPT_PAUSE_MS = 100;
+
+/// Connections one backend may have in flight; one busy slot plus a full local queue.
+const size_t BACKEND_CONNECTION_LIMIT = 4096;
+
+/// Marks the epoll tag of a listening socket; otherwise the tag is (slot << 1) | backend side.
+const uint64_t LISTENER_TAG = 1ull << 63;
+
+/// Front end stopped by the SIGINT / SIGTERM handler.
+NetworkFrontend* activeFrontend = nullptr;
+
+/**
+ * @brief Stops the running front end.
+ */
+void stopFrontend(int) {
+    if (activeFrontend != nullptr) {
+        activeFrontend->stop();
+    }
+}
+
+/**
+ * @brief Returns a monotonic clock reading in milliseconds.
+ * @return Milliseconds since an arbitrary epoch.
+ */
+int64_t monotonicMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Closes @p fd if it is open and sets it to -1.
+ * @param fd Descriptor to close.
+ */
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * @brief Parses one @c "[class=][address:]port" entry of a front-end setting.
+ *
+ * @param entry          Entry text, trimmed.
+ * @param defaultAddress Address used when the entry has none.
+ * @param jobClass       Receives the class; left alone when the entry has none.
+ * @param address        Receives the packed address.
+ * @param port           Receives the port.
+ * @return @c false if the entry is malformed.
+ */
+bool parseEndpoint(std::string_view entry, uint32_t defaultAddress, char& jobClass, uint32_t& address, uint16_t& port) {
+    if (entry.size() > 2 && entry[1] == '=') {
+        jobClass = entry[0];
+        entry.remove_prefix(2);
+    }
+    address = defaultAddress;
+    size_t colon = entry.rfind(':');
+    if (colon != std::string_view::npos) {
+        unsigned int parsed = 0;
+        if (!Firewall::ipToUint(entry.substr(0, colon), parsed)) {
+            return false;
+        }
+        address = parsed;
+        entry.remove_prefix(colon + 1);
+    }
+    unsigned int value = 0;
+    auto result = std::from_chars(entry.data(), entry.data() + entry.size(), value);
+    if (result.ec != std::errc() || result.ptr != entry.data() + entry.size() || value > 65535) {
+        return false;
+    }
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+/**
+ * @brief Splits a comma-separated setting into trimmed, non-empty entries.
+ * @param text Setting value.
+ * @return Entries in order.
+ */
+std::vector<std::string> splitEntries(const std::string& text) {
+    std::vector<std::string> entries;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) {
+            comma = text.size();
+        }
+        std::string entry = text.substr(start, comma - start);
+        size_t first = entry.find_first_not_of(" \t");
+        if (first != std::string::npos) {
+            entries.push_back(entry.substr(first, entry.find_last_not_of(" \t") - first + 1));
+        }
+        start = comma + 1;
+    }
+    return entries;
+}
+
+} // namespace
+
+/**
+ * @brief Checks for the @c "Frontend Listen" setting.
+ * @param config Parsed configuration.
+ * @return @c true if present.
+ */
+bool NetworkFrontend::isFrontend(const SimulationConfig& config) {
+    return config.settings.count("Frontend Listen") > 0;
+}
+
+/**
+ * @brief Constructs a front end with no sockets.
+ *
+ * @param firewall    Admission control.
+ * @param tickMillis  Milliseconds per firewall tick.
+ * @param healthRetry Milliseconds a failed backend stays down.
+ * @param policy      Dispatch policy of every class.
+ */
+NetworkFrontend::NetworkFrontend(Firewall& firewall, int tickMillis, int healthRetry, DispatchPolicyKind policy)
+    : firewall(firewall),
+      tickMillis(tickMillis > 0 ? tickMillis : 1),
+      healthRetry(healthRetry > 0 ? healthRetry : 0),
+      policyKind(policy),
+      epollFd(-1),
+      stopping(false),
+      startTime(monotonicMillis()),
+      accepted(0),
+      blocked(0),
+      proxied(0),
+      unserved(0)
+{
+}
+
+/**
+ * @brief Closes every connection, listener and the epoll set.
+ */
+NetworkFrontend::~NetworkFrontend() {
+    for (size_t slot = 0; slot < connections.size(); slot++) {
+        if (connections[slot]) {
+            closeConnection(slot);
+        }
+    }
+    for (Pending& waiting : pending) {
+        closeFd(waiting.fd);
+    }
+    for (Listener& listener : listeners) {
+        closeFd(listener.fd);
+    }
+    closeFd(epollFd);
+}
+
+/**
+ * @brief Creates, binds and listens on a nonblocking socket.
+ *
+ * @param jobClass Class of its connections.
+ * @param address  Packed address to bind.
+ * @param port     TCP port, or 0.
+ * @return Bound port, or 0.
+ */
+int NetworkFrontend::listen(char jobClass, uint32_t address, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "WARNING: could not create a front-end socket — skipping " << formatIP(address) << ":" << port << "." << std::endl;
+        return 0;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in bound;
+    std::memset(&bound, 0, sizeof(bound));
+    bound.sin_family = AF_INET;
+    bound.sin_addr.s_addr = htonl(address);
+    bound.sin_port = htons(port);
+    socklen_t length = sizeof(bound);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&bound), sizeof(bound)) != 0 || ::listen(fd, SOMAXCONN) != 0 ||
+            getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &length) != 0) {
+        std::cerr << "WARNING: could not listen on " << formatIP(address) << ":" << port << " — skipping this listener." << std::endl;
+        close(fd);
+        return 0;
+    }
+    listeners.push_back({fd, jobClass, false, 0, false});
+    return ntohs(bound.sin_port);
+}
+
+/**
+ * @brief Appends a backend handle, up and idle, and adds it to its class's pool.
+ *
+ * @details The first backend of a class creates the class's pool and
+ * policy, seeded per class as the Switch seeds its load balancers. The
+ * backend's index is its server id, so affinity depends only on the order
+ * of the Frontend Backends entries.
+ *
+ * @param jobClass Class it serves.
+ * @param address  Packed address.
+ * @param port     TCP port.
+ */
+void NetworkFrontend::addBackend(char jobClass, uint32_t address, uint16_t port) {
+    size_t pool = 0;
+    while (pool < pools.size() && pools[pool].jobClass != jobClass) {
+        pool++;
+    }
+    if (pool == pools.size()) {
+        pools.emplace_back();
+        pools.back().jobClass = jobClass;
+        pools.back().servers.setLocalQueueDepth(BACKEND_CONNECTION_LIMIT - 1);
+        pools.back().policy = makeDispatchPolicy(policyKind, 0x9E3779B9u ^ static_cast<unsigned char>(jobClass));
+    }
+
+    size_t index = backends.size();
+    ClassPool& classPool = pools[pool];
+    size_t slot = classPool.servers.add(static_cast<int>(index));
+    if (classPool.backendOf.size() <= slot) {
+        classPool.backendOf.resize(slot + 1);
+    }
+    classPool.backendOf[slot] = index;
+
+    Backend backend = {WebServer(static_cast<int>(index)), jobClass, pool, static_cast<long>(slot), 0, 0, 0};
+    backend.server.setBackend(address, port);
+    backends.push_back(backend);
+}
+
+/**
+ * @brief Runs the event loop.
+ *
+ * @details Each wake-up handles the ready sockets, then sends the
+ * connections accepted during it through the firewall as one burst. Slots
+ * closed during a wake-up are only reused after it, so a later event in the
+ * same batch cannot reach a connection that took over the slot.
+ *
+ * SIGPIPE is ignored for the rest of the process: splice() cannot suppress
+ * it per call, and a client that disconnects mid-response must only end its
+ * own connection.
+ *
+ * @param durationMillis Run length, or 0 or less for no limit.
+ * @param logger         Logger for the firewall.
+ * @return @c true once the loop has ended.
+ */
+bool NetworkFrontend::run(int64_t durationMillis, Logger& logger) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        std::cerr << "ERROR: could not create the front end's epoll set." << std::endl;
+        return false;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    for (size_t i = 0; i < listeners.size(); i++) {
+        watchListener(i);
+    }
+
+    startTime = monotonicMillis();
+    epoll_event events[EVENT_BATCH];
+    while (!stopping.load()) {
+        int timeout = POLL_INTERVAL_MS;
+        if (durationMillis > 0) {
+            int64_t left = durationMillis - elapsed();
+            if (left <= 0) {
+                break;
+            }
+            timeout = static_cast<int>(std::min<int64_t>(timeout, left));
+        }
+
+        int ready = epoll_wait(epollFd, events, EVENT_BATCH, timeout);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag & LISTENER_TAG) {
+                acceptAll(static_cast<size_t>(tag & ~LISTENER_TAG));
+                continue;
+            }
+            size_t slot = static_cast<size_t>(tag >> 1);
+            if (slot >= connections.size() || !connections[slot]) {
+                continue;
+            }
+            if ((tag & 1) && connections[slot]->connecting) {
+                finishConnect(slot);
+            } else {
+                pump(slot);
+            }
+        }
+        admitPending(logger);
+        resumeListeners();
+        freeSlots.insert(freeSlots.end(), closedSlots.begin(), closedSlots.end());
+        closedSlots.clear();
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the stop flag.
+ */
+void NetworkFrontend::stop() {
+    stopping.store(true);
+}
+
+/**
+ * @brief Logs the connection totals, each backend and the firewall summary.
+ * @param logger Logger receiving the report.
+ */
+void NetworkFrontend::report(Logger& logger) const {
+    LOG_FILE(logger, LogLevel::INFO) << "\nFront end stopped after " << elapsed() / 1000.0 << " s. Connections accepted: " << accepted
+                                     << ", blocked: " << blocked << ", proxied: " << proxied << ", unserved: " << unserved;
+    for (const Backend& backend : backends) {
+        LOG_FILE(logger, LogLevel::INFO) << "Backend " << backend.server.getId() << " (" << jobClassName(backend.jobClass) << ") "
+                                         << formatIP(backend.server.getAddress()) << ":" << backend.server.getPort() << ": "
+                                         << backend.served << " connections, " << backend.failed << " failed connects, "
+                                         << (backend.server.isHealthy() ? "up" : "down");
+    }
+    LOG_COLOR(logger, LogLevel::INFO, RED) << "\n[Firewall] Front end stopped. Total requests blocked: " << firewall.getTotalBlocked();
+    firewall.printBlockedRanges(logger);
+}
+
+/**
+ * @brief Accepts until the backlog is empty, queueing each connection for the firewall.
+ *
+ * @details A connection aborted before it was accepted is skipped. Any
+ * other failure (typically EMFILE or ENFILE) pauses the listener.
+ *
+ * @param index Readable listener.
+ */
+void NetworkFrontend::acceptAll(size_t index) {
+    Listener& listener = listeners[index];
+    for (;;) {
+        sockaddr_in peer;
+        socklen_t length = sizeof(peer);
+        int fd = accept4(listener.fd, reinterpret_cast<sockaddr*>(&peer), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (!listener.warned) {
+                std::cerr << "WARNING: front end could not accept a connection (" << std::strerror(errno)
+                          << ") — pausing the listener." << std::endl;
+                listener.warned = true;
+            }
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, listener.fd, nullptr);
+            listener.watched = false;
+            listener.resumeAt = elapsed() + ACCEPT_PAUSE_MS;
+            return;
+        }
+        listener.warned = false;
+        sockaddr_in local;
+        length = sizeof(local);
+        uint32_t destination = getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length) == 0 ? ntohl(local.sin_addr.s_addr) : 0;
+        accepted++;
+        pending.push_back({fd, Request(ntohl(peer.sin_addr.s_addr), destination, 1, listener.jobClass)});
+    }
+}
+
+/**
+ * @brief Registers a listener for readability.
+ * @param index Index in @c listeners.
+ */
+void NetworkFrontend::watchListener(size_t index) {
+    epoll_event interest;
+    interest.events = EPOLLIN;
+    interest.data.u64 = LISTENER_TAG | index;
+    listeners[index].watched = epoll_ctl(epollFd, EPOLL_CTL_ADD, listeners[index].fd, &interest) == 0;
+}
+
+/**
+ * @brief Re-arms paused listeners once their pause has ended.
+ *
+ * @details Connections closed meanwhile may have freed descriptors; if not,
+ * the next accept4() fails again and pauses the listener for another
+ * @c ACCEPT_PAUSE_MS without a second warning.
+ */
+void NetworkFrontend::resumeListeners() {
+    int64_t now = elapsed();
+    for (size_t i = 0; i < listeners.size(); i++) {
+        if (!listeners[i].watched && now >= listeners[i].resumeAt) {
+            watchListener(i);
+        }
+    }
+}
+
+/**
+ * @brief Runs the pending connections through the firewall as one burst.
+ *
+ * @details The firewall compacts the burst in order, and its verdicts depend
+ * only on a request's source: for any one source, the connections that pass
+ * are the first ones of that source in the burst. Walking the accepted
+ * connections and matching the next survivor by source therefore recovers
+ * exactly which connections passed.
+ *
+ * @param logger Logger for the firewall's events.
+ */
+void NetworkFrontend::admitPending(Logger& logger) {
+    if (pending.empty()) {
+        return;
+    }
+    burst.clear();
+    for (const Pending& waiting : pending) {
+        burst.push_back(waiting.request);
+    }
+    firewall.filterRequests(burst, static_cast<int>(elapsed() / tickMillis), logger);
+
+    size_t kept = 0;
+    for (Pending& waiting : pending) {
+        if (kept < burst.size() && burst[kept].getIPin() == waiting.request.getIPin()) {
+            kept++;
+            long slot = openConnection(waiting.fd, waiting.request);
+            if (slot >= 0) {
+                connectBackend(static_cast<size_t>(slot));
+            } else {
+                unserved++;
+                close(waiting.fd);
+            }
+        } else {
+            blocked++;
+            close(waiting.fd);
+        }
+    }
+    pending.clear();
+}
+
+/**
+ * @brief Creates both pipes and stores the connection in a free slot.
+ * @param client  Client socket.
+ * @param request Request describing the connection.
+ * @return Slot index, or -1.
+ */
+long NetworkFrontend::openConnection(int client, const Request& request) {
+    std::unique_ptr<Connection> connection(new Connection());
+    if (pipe2(connection->upstream, O_NONBLOCK | O_CLOEXEC) != 0 || pipe2(connection->downstream, O_NONBLOCK | O_CLOEXEC) != 0) {
+        for (int& fd : connection->upstream) closeFd(fd);
+        for (int& fd : connection->downstream) closeFd(fd);
+        return -1;
+    }
+    connection->client = client;
+    connection->request = request;
+
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        connections[slot] = std::move(connection);
+    } else {
+        slot = connections.size();
+        connections.push_back(std::move(connection));
+    }
+    return static_cast<long>(slot);
+}
+
+/**
+ * @brief Restores backends that are due, then consults the class's policy.
+ *
+ * @details The pool has no clock of its own: each connection is one unit
+ * of work that stays outstanding until it closes, so the policies are
+ * called at tick 0.
+ *
+ * @param request Request describing the connection.
+ * @return Backend index, or -1.
+ */
+long NetworkFrontend::chooseBackend(const Request& request) {
+    size_t pool = 0;
+    while (pool < pools.size() && pools[pool].jobClass != request.getJobType()) {
+        pool++;
+    }
+    if (pool == pools.size()) {
+        return -1;
+    }
+
+    ClassPool& classPool = pools[pool];
+    int64_t now = elapsed();
+    for (size_t i = 0; i < classPool.down.size();) {
+        Backend& backend = backends[classPool.down[i]];
+        if (now < backend.retryAt) {
+            i++;
+            continue;
+        }
+        size_t slot = classPool.servers.add(backend.server.getId());
+        if (classPool.backendOf.size() <= slot) {
+            classPool.backendOf.resize(slot + 1);
+        }
+        classPool.backendOf[slot] = classPool.down[i];
+        backend.slot = static_cast<long>(slot);
+        syncOccupancy(backend);
+        classPool.down[i] = classPool.down.back();
+        classPool.down.pop_back();
+    }
+
+    if (!classPool.servers.hasCapacity()) {
+        return -1;
+    }
+    long slot = classPool.policy->selectServer(classPool.servers, request, 0);
+    if (slot < 0) {
+        slot = fallback.selectServer(classPool.servers, request, 0);
+    }
+    return slot < 0 ? -1 : static_cast<long>(classPool.backendOf[static_cast<size_t>(slot)]);
+}
+
+/**
+ * @brief Adds or removes pool entries until they match the in-flight count.
+ *
+ * @details The first connection makes the slot busy and later ones queue
+ * behind it, so the slot can accept work until the backend reaches
+ * @c BACKEND_CONNECTION_LIMIT connections. Beyond the limit only the
+ * WebServer's count grows.
+ *
+ * @param backend Backend to update; nothing happens while it is down.
+ */
+void NetworkFrontend::syncOccupancy(Backend& backend) {
+    if (backend.slot < 0) {
+        return;
+    }
+    ServerPool& servers = pools[backend.pool].servers;
+    size_t slot = static_cast<size_t>(backend.slot);
+    int wanted = std::min(backend.server.getInFlight(), static_cast<int>(BACKEND_CONNECTION_LIMIT));
+    Request connection(0, 0, 1, backend.jobClass);
+
+    while (servers.outstandingRequests(slot) < wanted) {
+        if (servers.isIdle(slot))
+            servers.assign(slot, connection, 0);
+        else
+            servers.pushLocal(slot, connection);
+    }
+    while (servers.outstandingRequests(slot) > wanted) {
+        if (!servers.popLocal(slot, connection))
+            servers.release(slot);
+    }
+}
+
+/**
+ * @brief Takes a backend out of its class's pool until its retry time.
+ * @param index Index in @c backends.
+ */
+void NetworkFrontend::retireBackend(size_t index) {
+    Backend& backend = backends[index];
+    if (backend.slot < 0) {
+        return;
+    }
+    ClassPool& classPool = pools[backend.pool];
+    classPool.servers.retire(static_cast<size_t>(backend.slot));
+    classPool.down.push_back(index);
+    backend.slot = -1;
+}
+
+/**
+ * @brief Tries backends until a connect is under way or none is left.
+ *
+ * @details Each connection tries at most as many backends as there are,
+ * so one whose retry time has passed again cannot make it loop.
+ *
+ * @param slot Connection slot.
+ * @return @c true if a connect succeeded or is in progress.
+ */
+bool NetworkFrontend::connectBackend(size_t slot) {
+    Connection& connection = *connections[slot];
+    while (connection.attempts < backends.size()) {
+        long target = chooseBackend(connection.request);
+        if (target < 0) {
+            break;
+        }
+        connection.attempts++;
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            break;
+        }
+
+        Backend& backend = backends[target];
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(backend.server.getAddress());
+        address.sin_port = htons(backend.server.getPort());
+        connection.backend = fd;
+        connection.target = target;
+        backend.server.openConnection();
+        syncOccupancy(backend);
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            connection.connecting = true;
+            finishConnect(slot);
+            return true;
+        }
+        if (errno == EINPROGRESS) {
+            connection.connecting = true;
+            watch(fd, (static_cast<uint64_t>(slot) << 1) | 1, connection.backendEvents, EPOLLOUT);
+            return true;
+        }
+        backendFailed(connection);
+        closeFd(connection.backend);
+    }
+    unserved++;
+    closeConnection(slot);
+    return false;
+}
+
+/**
+ * @brief Checks the connect's result and either starts relaying or tries the next backend.
+ * @param slot Connection slot.
+ */
+void NetworkFrontend::finishConnect(size_t slot) {
+    Connection& connection = *connections[slot];
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(connection.backend, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        watch(connection.backend, (static_cast<uint64_t>(slot) << 1) | 1, connection.backendEvents, 0);
+        backendFailed(connection);
+        closeFd(connection.backend);
+        connection.connecting = false;
+        connectBackend(slot);
+        return;
+    }
+
+    Backend& backend = backends[connection.target];
+    backend.server.setHealthy(true);
+    backend.served++;
+    proxied++;
+    connection.connecting = false;
+    pump(slot);
+}
+
+/**
+ * @brief Relays in both directions, propagates half-closes and re-arms epoll.
+ *
+ * @details A direction reads from its source only while its pipe is empty
+ * and waits for the destination to become writable while it is not, so
+ * each direction holds at most one pipe's worth of data.
+ *
+ * @param slot Connection slot.
+ */
+void NetworkFrontend::pump(size_t slot) {
+    Connection& connection = *connections[slot];
+    if (!relay(connection.client, connection.upstream, connection.backend, connection.upstreamBytes, connection.clientDone) ||
+            !relay(connection.backend, connection.downstream, connection.client, connection.downstreamBytes, connection.backendDone)) {
+        closeConnection(slot);
+        return;
+    }
+    if (connection.clientDone && connection.upstreamBytes == 0 && !connection.upstreamShut) {
+        shutdown(connection.backend, SHUT_WR);
+        connection.upstreamShut = true;
+    }
+    if (connection.backendDone && connection.downstreamBytes == 0 && !connection.downstreamShut) {
+        shutdown(connection.client, SHUT_WR);
+        connection.downstreamShut = true;
+    }
+    if (connection.upstreamShut && connection.downstreamShut) {
+        closeConnection(slot);
+        return;
+    }
+
+    const uint32_t in = EPOLLIN;
+    const uint32_t out = EPOLLOUT;
+    uint32_t clientWanted = (!connection.clientDone && connection.upstreamBytes == 0 ? in : 0)
+                            | (connection.downstreamBytes > 0 ? out : 0);
+    uint32_t backendWanted = (!connection.backendDone && connection.downstreamBytes == 0 ? in : 0)
+                             | (connection.upstreamBytes > 0 ? out : 0);
+    watch(connection.client, static_cast<uint64_t>(slot) << 1, connection.clientEvents, clientWanted);
+    watch(connection.backend, (static_cast<uint64_t>(slot) << 1) | 1, connection.backendEvents, backendWanted);
+}
+
+/**
+ * @brief Moves one direction's bytes with splice(), never blocking.
+ *
+ * @param from  Source socket.
+ * @param pipe  Pipe between the sockets.
+ * @param to    Destination socket.
+ * @param bytes Bytes in the pipe.
+ * @param done  Source reached EOF.
+ * @return @c false on a socket error.
+ */
+bool NetworkFrontend::relay(int from, const int pipe[2], int to, size_t& bytes, bool& done) {
+    if (bytes == 0 && !done) {
+        ssize_t moved = splice(from, nullptr, pipe[1], nullptr, PIPE_CHUNK, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (moved > 0) {
+            bytes = static_cast<size_t>(moved);
+        } else if (moved == 0) {
+            done = true;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+    }
+    while (bytes > 0) {
+        ssize_t moved = splice(pipe[0], nullptr, to, nullptr, bytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (moved > 0) {
+            bytes -= static_cast<size_t>(moved);
+        } else if (moved < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Adds, modifies or deletes @p fd's registration so it matches @p wanted.
+ *
+ * @param fd      Socket, or -1 to do nothing.
+ * @param tag     Event tag.
+ * @param current Registered events; updated.
+ * @param wanted  Events wanted.
+ */
+void NetworkFrontend::watch(int fd, uint64_t tag, uint32_t& current, uint32_t wanted) {
+    if (fd < 0 || wanted == current) {
+        return;
+    }
+    epoll_event interest;
+    interest.events = wanted;
+    interest.data.u64 = tag;
+    int operation = current == 0 ? EPOLL_CTL_ADD : wanted == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+    epoll_ctl(epollFd, operation, fd, &interest);
+    current = wanted;
+}
+
+/**
+ * @brief Releases a connection; closing its sockets also drops them from the epoll set.
+ * @param slot Connection slot.
+ */
+void NetworkFrontend::closeConnection(size_t slot) {
+    Connection& connection = *connections[slot];
+    if (connection.target >= 0) {
+        Backend& backend = backends[connection.target];
+        backend.server.closeConnection();
+        syncOccupancy(backend);
+    }
+    closeFd(connection.client);
+    closeFd(connection.backend);
+    for (int& fd : connection.upstream) closeFd(fd);
+    for (int& fd : connection.downstream) closeFd(fd);
+    connections[slot].reset();
+    closedSlots.push_back(static_cast<uint32_t>(slot));
+}
+
+/**
+ * @brief Marks the connection's backend down, retires it from its pool and
+ *        detaches the connection from it.
+ * @param connection Connection whose connect failed.
+ */
+void NetworkFrontend::backendFailed(Connection& connection) {
+    Backend& backend = backends[connection.target];
+    backend.server.closeConnection();
+    backend.server.setHealthy(false);
+    backend.retryAt = elapsed() + healthRetry;
+    backend.failed++;
+    retireBackend(static_cast<size_t>(connection.target));
+    connection.target = -1;
+}
+
+/**
+ * @brief Returns milliseconds since run() started.
+ * @return Elapsed time.
+ */
+int64_t NetworkFrontend::elapsed() const {
+    return monotonicMillis() - startTime;
+}
+
+/**
+ * @brief Builds the Firewall and NetworkFrontend from the settings and runs them.
+ *
+ * @details Settings:
+ *  - @c "Frontend Listen" — comma-separated @c [class=][address:]port entries;
+ *    the class defaults to @c P and the address to 127.0.0.1.
+ *  - @c "Frontend Backends" — comma-separated @c [class=]address:port entries.
+ *  - @c "Frontend Tick" — milliseconds per firewall tick (default 10).
+ *  - @c "Frontend Health Retry" — milliseconds a failed backend is skipped (default 1000).
+ *  - @c "Frontend Duration" — seconds to run (default 0, until interrupted).
+ *  - @c "Dispatch Policy" — how each connection's backend is picked, as for
+ *    a load balancer (default @c least-work, the fewest open connections).
+ *
+ * readSimulationConfig() has already dropped any of the numeric settings
+ * that did not parse, so they take their defaults here.
+ *
+ * The firewall gets the @c "Blocklist File", @c "Ban Duration" and
+ * @c "Rate Limit Mode" settings but not the simulation's built-in RFC-1918
+ * ranges, since real clients often connect from private networks.
+ *
+ * @param config Parsed configuration.
+ * @param logger Logger for the firewall and the report.
+ * @return @c false if nothing could be served.
+ */
+bool runFrontend(const SimulationConfig& config, Logger& logger) {
+    const std::map<std::string, std::string>& settings = config.settings;
+    int tick = settings.count("Frontend Tick") ? std::stoi(settings.at("Frontend Tick")) : 10;
+    if (tick <= 0) {
+        std::cerr << "WARNING: Frontend Tick must be positive — using 10." << std::endl;
+        tick = 10;
+    }
+    int retry = settings.count("Frontend Health Retry") ? std::stoi(settings.at("Frontend Health Retry")) : 1000;
+    double duration = settings.count("Frontend Duration") ? std::stod(settings.at("Frontend Duration")) : 0.0;
+
+    DispatchPolicyKind policy = DispatchPolicyKind::LEAST_WORK;
+    if (settings.count("Dispatch Policy") && !parseDispatchPolicy(settings.at("Dispatch Policy"), policy)) {
+        std::cerr << "WARNING: unknown Dispatch Policy '" << settings.at("Dispatch Policy") << "' — using least-work." << std::endl;
+    }
+
+    Firewall firewall(5, 20);
+    configureFirewall(firewall, config, std::cerr);
+    NetworkFrontend frontend(firewall, tick, retry, policy);
+
+    const uint32_t loopback = 0x7F000001;
+    size_t listenerCount = 0;
+    for (const std::string& entry : splitEntries(settings.at("Frontend Listen"))) {
+        char jobClass = 'P';
+        uint32_t address = 0;
+        uint16_t port = 0;
+        if (!parseEndpoint(entry, loopback, jobClass, address, port)) {
+            std::cerr << "WARNING: invalid Frontend Listen entry '" << entry << "' — ignoring it." << std::endl;
+            continue;
+        }
+        int bound = frontend.listen(jobClass, address, port);
+        if (bound > 0) {
+            listenerCount++;
+            LOG(logger, LogLevel::INFO) << "[Frontend] Listening on " << formatIP(address) << ":" << bound << " for " << jobClassName(jobClass);
+        }
+    }
+
+    size_t backendCount = 0;
+    if (settings.count("Frontend Backends")) {
+        for (const std::string& entry : splitEntries(settings.at("Frontend Backends"))) {
+            char jobClass = 'P';
+            uint32_t address = 0;
+            uint16_t port = 0;
+            if (!parseEndpoint(entry, 0, jobClass, address, port) || entry.find(':') == std::string::npos || port == 0) {
+                std::cerr << "WARNING: invalid Frontend Backends entry '" << entry << "' — ignoring it." << std::endl;
+                continue;
+            }
+            frontend.addBackend(jobClass, address, port);
+            LOG(logger, LogLevel::INFO) << "[Frontend] Backend " << backendCount++ << " for " << jobClassName(jobClass) << ": "
+                                        << formatIP(address) << ":" << port;
+        }
+    }
+    if (listenerCount == 0) {
+        std::cerr << "ERROR: the front end could not listen on any Frontend Listen entry." << std::endl;
+        return false;
+    }
+    if (backendCount == 0) {
+        std::cerr << "ERROR: the front end needs at least one Frontend Backends entry." << std::endl;
+        return false;
+    }
+
+    activeFrontend = &frontend;
+    std::signal(SIGINT, stopFrontend);
+    std::signal(SIGTERM, stopFrontend);
+    bool ran = frontend.run(static_cast<int64_t>(duration * 1000.0), logger);
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    activeFrontend = nullptr;
+
+    if (ran) {
+        frontend.report(logger);
+    }
+    return ran;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file networkFrontend.h
+ * @brief Declaration of NetworkFrontend, a TCP proxy that puts the Firewall
+ *        in front of real backend servers.
+ *
+ * @details The front end runs the simulation's admission pipeline on live
+ * traffic. Each listening port serves one job class. Every accepted
+ * connection becomes a Request carrying the peer's packed address as its
+ * source and the listener's address as its destination. The connections
+ * accepted in one wake-up go through Firewall::filterRequests() as one
+ * burst, so bans, rate limits and block lists behave as they do in a
+ * simulated cycle. A connection that passes is proxied to a backend of its
+ * class chosen by the configured DispatchPolicy, exactly as a LoadBalancer
+ * picks a server. Each class keeps a ServerPool whose live slots are its
+ * backends that are up. A slot is busy while its backend has a connection
+ * in flight, and every further connection sits in the slot's local queue,
+ * so outstandingRequests() is the backend's open-connection count and
+ * every policy sees each connection as one unit of work. Each backend is
+ * also a WebServer handle (see WebServer::setBackend()) holding its health
+ * and in-flight count.
+ *
+ * The data plane is a single thread on one nonblocking, level-triggered
+ * epoll set. Bytes move between the client and backend sockets through a
+ * pair of pipes with splice(2), so the payload stays in the kernel. A
+ * backend whose connect fails is retired from its class's pool for
+ * @c healthRetry milliseconds and then added back. The connection being
+ * set up moves on to the backend the policy picks next.
+ *
+ * The firewall's clock is wall time divided into ticks of @c tickMillis
+ * milliseconds. @c "Ban Duration" and the rate-limit window are counted in
+ * these ticks.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef NETWORKFRONTEND_H
+#define NETWORKFRONTEND_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "dispatchPolicy.h"
+#include "firewall.h"
+#include "logger.h"
+#include "request.h"
+#include "serverPool.h"
+#include "simulation.h"
+#include "webServer.h"
+
+/**
+ * @class NetworkFrontend
+ * @brief Epoll-driven TCP proxy that admits connections through a Firewall.
+ */
+class NetworkFrontend {
+    public:
+        /**
+         * @brief Returns whether @p config asks for the front end.
+         * @param config Parsed configuration.
+         * @return @c true if a @c "Frontend Listen" setting is present.
+         */
+        static bool isFrontend(const SimulationConfig& config);
+
+        /**
+         * @brief Constructs a front end with no listeners or backends.
+         *
+         * @param firewall    Firewall that admits connections; must outlive the front end.
+         * @param tickMillis  Milliseconds per firewall tick.
+         * @param healthRetry Milliseconds a failed backend is skipped before it is retried.
+         * @param policy      Policy that picks each connection's backend.
+         */
+        NetworkFrontend(Firewall& firewall, int tickMillis, int healthRetry,
+                        DispatchPolicyKind policy = DispatchPolicyKind::LEAST_WORK);
+
+        /**
+         * @brief Closes every socket and pipe.
+         */
+        ~NetworkFrontend();
+
+        NetworkFrontend(const NetworkFrontend&) = delete;
+        NetworkFrontend& operator=(const NetworkFrontend&) = delete;
+
+        /**
+         * @brief Listens on @p address:@p port for connections of @p jobClass.
+         *
+         * @param jobClass Job-type byte given to the connections' Requests.
+         * @param address  Packed IPv4 address to bind.
+         * @param port     TCP port; 0 picks a free one.
+         * @return Bound port, or 0 (after printing a warning) on failure.
+         */
+        int listen(char jobClass, uint32_t address, uint16_t port);
+
+        /**
+         * @brief Adds a backend for @p jobClass.
+         * @param jobClass Job class the backend serves.
+         * @param address  Packed IPv4 address.
+         * @param port     TCP port.
+         */
+        void addBackend(char jobClass, uint32_t address, uint16_t port);
+
+        /**
+         * @brief Proxies connections until stop() is called or @p durationMillis elapse.
+         *
+         * @param durationMillis Run length; 0 or less runs until stop().
+         * @param logger         Logger for the firewall's events and the report.
+         * @return @c false if the epoll set could not be created.
+         */
+        bool run(int64_t durationMillis, Logger& logger);
+
+        /**
+         * @brief Asks run() to return; safe to call from a signal handler.
+         */
+        void stop();
+
+        /**
+         * @brief Logs connection totals and each backend's state.
+         * @param logger Logger receiving the report.
+         */
+        void report(Logger& logger) const;
+
+    private:
+        /**
+         * @struct Listener
+         * @brief One listening socket and the job class it serves.
+         */
+        struct Listener {
+            int fd;              ///< Listening socket.
+            char jobClass;       ///< Class of its connections.
+            bool watched;        ///< Whether it is in the epoll set.
+            int64_t resumeAt;    ///< While unwatched: time (ms) to watch it again.
+            bool warned;         ///< An accept failure has been reported since the last success.
+        };
+
+        /**
+         * @struct Backend
+         * @brief A backend handle plus the front end's bookkeeping for it.
+         */
+        struct Backend {
+            WebServer server;  ///< Address, health and in-flight count.
+            char jobClass;     ///< Class it serves.
+            size_t pool;       ///< Index of its class in @c pools.
+            long slot;         ///< Slot in the class's pool, or -1 while down.
+            int64_t retryAt;   ///< While down: time (ms) after which it may be tried again.
+            uint64_t served;   ///< Connections it accepted.
+            uint64_t failed;   ///< Connection attempts that failed.
+        };
+
+        /**
+         * @struct ClassPool
+         * @brief The backends of one class as the DispatchPolicy sees them.
+         */
+        struct ClassPool {
+            char jobClass;                          ///< Class served.
+            ServerPool servers;                     ///< One live slot per backend that is up.
+            std::vector<size_t> backendOf;          ///< Backend index of each slot.
+            std::vector<size_t> down;               ///< Backends retired until their retry time.
+            std::unique_ptr<DispatchPolicy> policy; ///< Picks a slot for each connection.
+        };
+
+        /**
+         * @struct Pending
+         * @brief An accepted connection waiting for the firewall's verdict.
+         */
+        struct Pending {
+            int fd;           ///< Client socket.
+            Request request;  ///< Request describing it.
+        };
+
+        /**
+         * @struct Connection
+         * @brief A client being proxied to a backend.
+         */
+        struct Connection {
+            int client = -1;              ///< Client socket.
+            int backend = -1;             ///< Backend socket, or -1 before a connect.
+            int upstream[2] = {-1, -1};   ///< Pipe from client to backend.
+            int downstream[2] = {-1, -1}; ///< Pipe from backend to client.
+            size_t upstreamBytes = 0;     ///< Bytes waiting in @c upstream.
+            size_t downstreamBytes = 0;   ///< Bytes waiting in @c downstream.
+            bool connecting = false;      ///< Whether the backend connect is in progress.
+            bool clientDone = false;      ///< Client sent EOF.
+            bool backendDone = false;     ///< Backend sent EOF.
+            bool upstreamShut = false;    ///< Backend write side shut down.
+            bool downstreamShut = false;  ///< Client write side shut down.
+            long target = -1;             ///< Index in @c backends, or -1.
+            Request request;              ///< Request describing it, for choosing the next backend.
+            size_t attempts = 0;          ///< Backends tried so far.
+            uint32_t clientEvents = 0;    ///< Events registered for @c client.
+            uint32_t backendEvents = 0;   ///< Events registered for @c backend.
+        };
+
+        Firewall& firewall;                    ///< Admission control.
+        int tickMillis;                        ///< Milliseconds per firewall tick.
+        int healthRetry;                       ///< Milliseconds a failed backend stays down.
+        DispatchPolicyKind policyKind;         ///< Policy given to each class's pool.
+        int epollFd;                           ///< Epoll set, or -1.
+        std::atomic<bool> stopping;            ///< Set by stop().
+        std::vector<Listener> listeners;       ///< Listening sockets.
+        std::vector<Backend> backends;         ///< Backends of every class.
+        std::vector<ClassPool> pools;          ///< One pool per class with backends.
+        LeastWorkPolicy fallback;              ///< Used when the policy leaves a connection waiting.
+        std::vector<Pending> pending;          ///< Accepted, not yet filtered.
+        std::vector<Request> burst;            ///< Scratch: requests handed to the firewall.
+        std::vector<std::unique_ptr<Connection>> connections; ///< Slots; @c nullptr when free.
+        std::vector<uint32_t> freeSlots;       ///< Free slots in @c connections.
+        std::vector<uint32_t> closedSlots;     ///< Slots freed during the current wake-up.
+        int64_t startTime;                     ///< Monotonic time (ms) run() started.
+
+        uint64_t accepted;   ///< Connections accepted.
+        uint64_t blocked;    ///< Connections the firewall dropped.
+        uint64_t proxied;    ///< Connections handed to a backend.
+        uint64_t unserved;   ///< Connections closed because no backend was up.
+
+        /**
+         * @brief Accepts every connection waiting on one listener.
+         *
+         * @details When accept4() fails for lack of descriptors or memory
+         * the connection stays in the backlog, so the level-triggered
+         * listener would wake every epoll_wait() at once. The listener is
+         * instead taken out of the epoll set for @c ACCEPT_PAUSE_MS and
+         * the failure reported once; resumeListeners() puts it back.
+         *
+         * @param index Index in @c listeners of the readable listener.
+         */
+        void acceptAll(size_t index);
+
+        /**
+         * @brief Adds a listener to the epoll set.
+         * @param index Index in @c listeners.
+         */
+        void watchListener(size_t index);
+
+        /**
+         * @brief Watches again every listener whose pause has ended.
+         */
+        void resumeListeners();
+
+        /**
+         * @brief Filters the accepted connections and starts proxying the survivors.
+         * @param logger Logger for the firewall's events.
+         */
+        void admitPending(Logger& logger);
+
+        /**
+         * @brief Allocates a connection slot for @p client.
+         * @param client  Client socket.
+         * @param request Request describing the connection.
+         * @return Slot index, or -1 if its pipes could not be created.
+         */
+        long openConnection(int client, const Request& request);
+
+        /**
+         * @brief Asks the class's DispatchPolicy for a backend for @p request.
+         *
+         * @details Backends whose retry time has passed rejoin the pool
+         * first. A connection cannot wait in a queue, so if the policy
+         * leaves it waiting (first-idle with every backend busy, or an
+         * affinity miss) the backend with the fewest connections is taken.
+         *
+         * @param request Request describing the connection.
+         * @return Index in @c backends, or -1 if none is up or all are at
+         *         the connection limit.
+         */
+        long chooseBackend(const Request& request);
+
+        /**
+         * @brief Makes the backend's pool slot hold one entry per connection in flight.
+         * @param backend Backend whose in-flight count changed.
+         */
+        void syncOccupancy(Backend& backend);
+
+        /**
+         * @brief Retires a backend's slot until its retry time.
+         * @param index Index in @c backends.
+         */
+        void retireBackend(size_t index);
+
+        /**
+         * @brief Starts a nonblocking connect from a slot to its next backend.
+         * @param slot Connection slot.
+         * @return @c false if no backend could be tried; the connection is then closed.
+         */
+        bool connectBackend(size_t slot);
+
+        /**
+         * @brief Completes or fails a connect that has become writable.
+         * @param slot Connection slot.
+         */
+        void finishConnect(size_t slot);
+
+        /**
+         * @brief Moves whatever bytes can move in both directions, then
+         *        updates the slot's epoll interests or closes it.
+         * @param slot Connection slot.
+         */
+        void pump(size_t slot);
+
+        /**
+         * @brief Splices from @p from into @p pipe and on to @p to.
+         *
+         * @param from  Source socket.
+         * @param pipe  Pipe between them.
+         * @param to    Destination socket.
+         * @param bytes Bytes waiting in the pipe; updated.
+         * @param done  Set when @p from reaches EOF.
+         * @return @c false on a socket error.
+         */
+        bool relay(int from, const int pipe[2], int to, size_t& bytes, bool& done);
+
+        /**
+         * @brief Registers, changes or removes an fd's epoll interests.
+         *
+         * @param fd      Socket.
+         * @param tag     Value reported with its events.
+         * @param current Events registered now; updated.
+         * @param wanted  Events to register.
+         */
+        void watch(int fd, uint64_t tag, uint32_t& current, uint32_t wanted);
+
+        /**
+         * @brief Closes a connection's sockets and pipes and frees its slot.
+         * @param slot Connection slot.
+         */
+        void closeConnection(size_t slot);
+
+        /**
+         * @brief Marks the target of a failed connect down until the retry time.
+         * @param connection Connection whose connect failed.
+         */
+        void backendFailed(Connection& connection);
+
+        /**
+         * @brief Returns milliseconds since run() started.
+         * @return Elapsed time.
+         */
+        int64_t elapsed() const;
+};
+
+/**
+ * @brief Sets up a NetworkFrontend from the @c "Frontend ..." settings and runs it.
+ *
+ * @details Installs SIGINT and SIGTERM handlers that stop the front end, so
+ * an interrupted run still writes its report.
+ *
+ * @param config Parsed configuration.
+ * @param logger Logger for the firewall's events and the report.
+ * @return @c false if no listener or backend could be set up.
+ */
+bool runFrontend(const SimulationConfig& config, Logger& logger);
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file predictiveScaler.cpp
+ * @brief Implementation of the PredictiveScaler class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "predictiveScaler.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Parses a scaling mode name.
+ *
+ * @param name Mode name.
+ * @param mode Receives the parsed mode.
+ * @return @c true if recognised.
+ */
+bool parseScalingMode(const std::string& name, ScalingMode& mode) {
+    if (name == "threshold")       mode = ScalingMode::THRESHOLD;
+    else if (name == "predictive") mode = ScalingMode::PREDICTIVE;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Constructs a scaler with zeroed estimates.
+ * @param targetWait Target queueing delay in cycles.
+ * @param maxServers Pool size limit.
+ */
+PredictiveScaler::PredictiveScaler(int targetWait, size_t maxServers)
+    : targetWait(targetWait > 0 ? targetWait : 1),
+      maxServers(maxServers > 0 ? maxServers : 1),
+      arrivalRate(0.0),
+      serviceMean(1.0),
+      serviceSeen(false)
+{
+}
+
+/**
+ * @brief Sets the target queueing delay.
+ * @param targetWait Delay in cycles; values below 1 are raised to 1.
+ */
+void PredictiveScaler::setTargetWait(int targetWait) {
+    this->targetWait = targetWait > 0 ? targetWait : 1;
+}
+
+/**
+ * @brief Sets the pool size limit.
+ * @param maxServers Limit; 0 is raised to 1.
+ */
+void PredictiveScaler::setMaxServers(size_t maxServers) {
+    this->maxServers = maxServers > 0 ? maxServers : 1;
+}
+
+/**
+ * @brief Updates the service-time EWMA, seeding it with the first sample.
+ * @param processTime Processing time of one request.
+ */
+void PredictiveScaler::observeService(int processTime) {
+    double sample = processTime > 1 ? processTime : 1;
+    if (!serviceSeen) {
+        serviceMean = sample;
+        serviceSeen = true;
+    } else {
+        serviceMean = (1.0 - SERVICE_ALPHA) * serviceMean + SERVICE_ALPHA * sample;
+    }
+}
+
+/**
+ * @brief Updates the arrival-rate EWMA with one tick's count.
+ * @param arrivals Requests that arrived on the tick.
+ */
+void PredictiveScaler::observeArrivals(int arrivals) {
+    arrivalRate = (1.0 - RATE_ALPHA) * arrivalRate + RATE_ALPHA * arrivals;
+}
+
+/**
+ * @brief Decays the arrival-rate EWMA by @p ticks empty ticks at once.
+ * @param ticks Number of empty ticks.
+ */
+void PredictiveScaler::observeIdle(int ticks) {
+    if (ticks > 0) {
+        arrivalRate *= std::pow(1.0 - RATE_ALPHA, ticks);
+    }
+}
+
+/**
+ * @brief Sizes the pool for the offered load plus the excess backlog.
+ *
+ * @details The steady-state term is @c λ·S / ρ. By Little's law a queue of
+ * @c λ·W requests already implies a wait of about @c W, so only the backlog
+ * above that needs extra servers, enough to drain its work within @c W.
+ *
+ * @param pending Requests waiting to start.
+ * @return Recommended servers, clamped to [1, maxServers].
+ */
+size_t PredictiveScaler::targetServers(size_t pending) const {
+    double steady = arrivalRate * serviceMean / UTILISATION;
+    double tolerated = arrivalRate * targetWait;
+    double excess = static_cast<double>(pending) - tolerated;
+    double drain = excess > 0.0 ? excess * serviceMean / targetWait : 0.0;
+
+    double target = std::ceil(steady + drain);
+    if (target < 1.0) {
+        return 1;
+    }
+    return target >= static_cast<double>(maxServers) ? maxServers : static_cast<size_t>(target);
+}
+
+/**
+ * @brief Returns the target size, damped against shrinking.
+ *
+ * @param current Servers currently provisioned.
+ * @param pending Requests waiting to start.
+ * @return Servers to provision.
+ */
+size_t PredictiveScaler::recommend(size_t current, size_t pending) const {
+    size_t target = targetServers(pending);
+    if (target >= current) {
+        return std::min(target, std::max<size_t>(current * MAX_GROWTH, 1));
+    }
+    if (static_cast<double>(target) < (1.0 - SHRINK_BAND) * static_cast<double>(current)) {
+        return target;
+    }
+    return current;
+}
+
+/**
+ * @brief Returns the arrival-rate estimate.
+ * @return Requests per tick.
+ */
+double PredictiveScaler::getArrivalRate() const {
+    return arrivalRate;
+}
+
+/**
+ * @brief Returns the service-time estimate.
+ * @return Cycles per request.
+ */
+double PredictiveScaler::getServiceMean() const {
+    return serviceMean;
+}
+
+/**
+ * @brief Writes the two estimates and whether a service time has been seen.
+ * @param out Snapshot being written.
+ */
+void PredictiveScaler::saveState(SnapshotWriter& out) const {
+    out.put(arrivalRate);
+    out.put(serviceMean);
+    out.put(serviceSeen);
+}
+
+/**
+ * @brief Reads the values written by saveState(); the target wait stays as configured.
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool PredictiveScaler::restoreState(SnapshotReader& in) {
+    return in.get(arrivalRate) && in.get(serviceMean) && in.get(serviceSeen);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file predictiveScaler.h
+ * @brief Declaration of the PredictiveScaler class.
+ *
+ * @details The threshold autoscaler adds or removes one server per cooldown
+ * period, so it lags far behind a burst and then oscillates around its
+ * thresholds. PredictiveScaler instead estimates the arrival rate and mean
+ * service time with exponentially weighted moving averages and sizes the
+ * pool in one step:
+ *  - @c λ·S / ρ servers carry the offered load at utilisation @c ρ, and
+ *  - by Little's law a queue of @c λ·W requests waits about @c W cycles, so
+ *    any backlog beyond that gets enough extra servers to drain within @c W.
+ *
+ * Shrinking is damped by a hysteresis band, so the pool only contracts once
+ * the target has fallen clearly below the current size rather than every
+ * time a burst has been served. Growth is bounded too: the target never
+ * exceeds a configured maximum, and one step at most doubles the pool, so a
+ * sudden backlog cannot provision thousands of servers at once.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef PREDICTIVESCALER_H
+#define PREDICTIVESCALER_H
+
+#include <cstddef>
+#include <string>
+#include "snapshot.h"
+
+/**
+ * @enum ScalingMode
+ * @brief Autoscaling algorithms available to a LoadBalancer.
+ */
+enum class ScalingMode {
+    THRESHOLD,   ///< One server per cooldown period when the queue leaves [min, max] x servers.
+    PREDICTIVE   ///< Jump straight to the size PredictiveScaler computes.
+};
+
+/**
+ * @brief Converts a mode name to a ScalingMode.
+ *
+ * @param name Mode name: @c "threshold" or @c "predictive".
+ * @param mode Receives the parsed mode on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseScalingMode(const std::string& name, ScalingMode& mode);
+
+/**
+ * @class PredictiveScaler
+ * @brief Estimates load from observed traffic and recommends a pool size.
+ */
+class PredictiveScaler {
+    public:
+        /**
+         * @brief Constructs a scaler with no observations.
+         * @param targetWait Queueing delay, in cycles, the pool is sized for.
+         * @param maxServers Largest pool the scaler recommends.
+         */
+        explicit PredictiveScaler(int targetWait = 20, size_t maxServers = 1000);
+
+        /**
+         * @brief Sets the queueing delay the pool is sized for.
+         * @param targetWait Target wait in cycles (at least 1).
+         */
+        void setTargetWait(int targetWait);
+
+        /**
+         * @brief Sets the largest pool targetServers() may recommend.
+         * @param maxServers Server limit (at least 1).
+         */
+        void setMaxServers(size_t maxServers);
+
+        /**
+         * @brief Folds one request's processing time into the service estimate.
+         * @param processTime Cycles the request will occupy a server.
+         */
+        void observeService(int processTime);
+
+        /**
+         * @brief Folds one tick's arrival count into the rate estimate.
+         * @param arrivals Requests that arrived on the tick.
+         */
+        void observeArrivals(int arrivals);
+
+        /**
+         * @brief Decays the rate estimate over ticks on which nothing arrived.
+         *
+         * @details Equivalent to @p ticks calls of observeArrivals(0), up to
+         * rounding.
+         *
+         * @param ticks Number of empty ticks.
+         */
+        void observeIdle(int ticks);
+
+        /**
+         * @brief Computes the pool size that meets the target wait.
+         * @param pending Requests waiting to start.
+         * @return Recommended number of servers, between 1 and the maximum.
+         */
+        size_t targetServers(size_t pending) const;
+
+        /**
+         * @brief Applies hysteresis to targetServers().
+         *
+         * @details Growth is immediate but limited to @c MAX_GROWTH times
+         * @p current per step. A smaller pool is only recommended once the
+         * target is below @c (1 - SHRINK_BAND) of @p current.
+         *
+         * @param current Servers currently provisioned.
+         * @param pending Requests waiting to start.
+         * @return Servers to provision; equal to @p current to hold steady.
+         */
+        size_t recommend(size_t current, size_t pending) const;
+
+        /**
+         * @brief Returns the smoothed arrival rate.
+         * @return Requests per cycle.
+         */
+        double getArrivalRate() const;
+
+        /**
+         * @brief Returns the smoothed service time.
+         * @return Mean cycles per request (1 before any observation).
+         */
+        double getServiceMean() const;
+
+        /**
+         * @brief Writes the arrival-rate and service-time estimates to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the estimates with the state read from @p in.
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        static constexpr double RATE_ALPHA = 0.01;        ///< EWMA weight of each tick's arrivals.
+        static constexpr double SERVICE_ALPHA = 0.05;     ///< EWMA weight of each request's processing time.
+        static constexpr double UTILISATION = 0.95;       ///< Target busy fraction for the steady-state term.
+        static constexpr double SHRINK_BAND = 0.1;        ///< Fraction below the current size the target must reach to shrink.
+        static constexpr size_t MAX_GROWTH = 2;           ///< Largest factor by which one step may grow the pool.
+
+        int targetWait;       ///< Queueing delay to size for, in cycles.
+        size_t maxServers;    ///< Upper bound on the recommended pool size.
+        double arrivalRate;   ///< EWMA of arrivals per tick.
+        double serviceMean;   ///< EWMA of processing time per request.
+        bool serviceSeen;     ///< Set once observeService() has been called.
+};
+
+#endif
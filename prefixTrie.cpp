@@ -0,0 +1,86 @@
+/**
+ * @file prefixTrie.cpp
+ * @brief Implementation of the PrefixTrie class.
+ *
+ * @details Implements prefix insertion and longest-prefix-match lookup for
+ * the binary IPv4 trie used by the Firewall.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "prefixTrie.h"
+
+/**
+ * @brief Constructs an empty trie with a single root node.
+ *
+ * @details The root stands for the zero-length prefix. Child index 0 can
+ * double as the "absent" marker because no node ever points back at the root.
+ */
+PrefixTrie::PrefixTrie() {
+    nodes.push_back(Node{{0, 0}, -1});
+    prefixCount = 0;
+}
+
+/**
+ * @brief Inserts a prefix, creating intermediate nodes as required.
+ *
+ * @param network      Network address; host bits are ignored.
+ * @param prefixLength Prefix length in [0, 32].
+ * @param value        Value to store at the prefix's terminal node.
+ * @return @c true on insertion; @c false on duplicate or invalid length.
+ */
+bool PrefixTrie::insert(uint32_t network, int prefixLength, int value) {
+    if (prefixLength < 0 || prefixLength > 32 || value < 0) {
+        return false;
+    }
+
+    int32_t node = 0;
+    for (int depth = 0; depth < prefixLength; depth++) {
+        int bit = (network >> (31 - depth)) & 1u;
+        if (nodes[node].child[bit] == 0) {
+            nodes.push_back(Node{{0, 0}, -1});
+            nodes[node].child[bit] = static_cast<int32_t>(nodes.size() - 1);
+        }
+        node = nodes[node].child[bit];
+    }
+
+    if (nodes[node].value >= 0) {
+        return false;
+    }
+
+    nodes[node].value = value;
+    prefixCount++;
+    return true;
+}
+
+/**
+ * @brief Walks the trie along @p ip and returns the deepest value seen.
+ *
+ * @param ip Packed IPv4 address.
+ * @return Value of the longest matching prefix, or -1 if nothing matches.
+ */
+int PrefixTrie::lookup(uint32_t ip) const {
+    int32_t node = 0;
+    int match = nodes[0].value;
+
+    for (int depth = 0; depth < 32; depth++) {
+        node = nodes[node].child[(ip >> (31 - depth)) & 1u];
+        if (node == 0) {
+            break;
+        }
+        if (nodes[node].value >= 0) {
+            match = nodes[node].value;
+        }
+    }
+
+    return match;
+}
+
+/**
+ * @brief Returns the number of registered prefixes.
+ * @return The prefix count.
+ */
+int PrefixTrie::size() const {
+    return prefixCount;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file prefixTrie.h
+ * @brief Declaration of the PrefixTrie class used for longest-prefix matching.
+ *
+ * @details Defines PrefixTrie, a binary trie over IPv4 prefixes. The Firewall
+ * uses it to match a packed source address against its static block list in
+ * at most 32 steps, regardless of how many ranges are registered.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef PREFIXTRIE_H
+#define PREFIXTRIE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class PrefixTrie
+ * @brief Maps IPv4 prefixes to integer values with longest-prefix-match lookup.
+ *
+ * @details Nodes are stored contiguously in a vector and refer to their
+ * children by index, so the whole trie is a single allocation that grows
+ * geometrically. Each node corresponds to one bit of the address, taken from
+ * the most significant bit down; a node carrying a value marks the end of a
+ * registered prefix. A lookup walks the address bits and remembers the last
+ * value it passed, which is the longest matching prefix.
+ */
+class PrefixTrie {
+    public:
+        /**
+         * @brief Constructs an empty trie containing only the root node.
+         */
+        PrefixTrie();
+
+        /**
+         * @brief Registers a prefix and associates a value with it.
+         *
+         * @param network      Network address, packed with MSB = first octet.
+         *                     Bits beyond @p prefixLength are ignored.
+         * @param prefixLength Number of leading bits that form the prefix, in [0, 32].
+         * @param value        Non-negative value returned by lookup() for matches.
+         * @return @c true if the prefix was added; @c false if it was already present
+         *         (the existing value is kept) or @p prefixLength is out of range.
+         */
+        bool insert(uint32_t network, int prefixLength, int value);
+
+        /**
+         * @brief Finds the value of the longest registered prefix covering @p ip.
+         *
+         * @param ip Packed IPv4 address to match.
+         * @return The associated value, or -1 if no prefix matches.
+         */
+        int lookup(uint32_t ip) const;
+
+        /**
+         * @brief Returns the number of prefixes registered in the trie.
+         * @return Count of successful insert() calls since construction.
+         */
+        int size() const;
+
+    private:
+        /**
+         * @struct Node
+         * @brief A single bit position in the trie.
+         */
+        struct Node {
+            int32_t child[2];  ///< Indices of the 0- and 1-branch children, or 0 when absent.
+            int32_t value;     ///< Value of the prefix ending here, or -1 if none.
+        };
+
+        std::vector<Node> nodes;  ///< Node storage; index 0 is the root.
+        int prefixCount;          ///< Number of registered prefixes.
+};
+
+#endif
@@ -3,74 +3,62 @@
  * @brief Implementation of the Request class.
  *
  * @details Implements all member functions of the Request class, including
- * constructors, accessors, and the private IP address generator.
+ * constructors and accessors.
  *
  * @author Load Balancer Project
  * @date 2025
  */
 
 #include "request.h"
-#include <cstdlib>
 
 /**
  * @brief Default constructor. Initializes an empty, placeholder request.
  *
- * Sets IP addresses to empty strings, processTime to 0, and jobType to 'P'.
+ * Sets IP addresses to 0.0.0.0, processTime to 0, and jobType to 'P'.
  */
 Request::Request() {
-    IPin = "";
-    IPout = "";
+    IPin = 0;
+    IPout = 0;
     processTime = 0;
     jobType = 'P';
+    enqueueTick = -1;
+    dispatchTick = -1;
 }
 
 /**
- * @brief Parameterized constructor. Builds a request with random IPs.
+ * @brief Constructs a request with explicit addresses.
  *
+ * @param IPin        Packed source address.
+ * @param IPout       Packed destination address.
  * @param processTime The number of clock cycles this request will take to process.
- * @param jobType The category of the job ('P' for primary, 'S' for secondary).
+ * @param jobType     The category of the job.
  */
-Request::Request(int processTime, char jobType) {
-    this->IPin = generateIP();
-    this->IPout = generateIP();
-    this->processTime = processTime;
+Request::Request(uint32_t IPin, uint32_t IPout, int processTime, char jobType) {
+    this->IPin = IPin;
+    this->IPout = IPout;
+    if (processTime < 0)
+        processTime = 0;
+    else if (processTime > UINT16_MAX)
+        processTime = UINT16_MAX;
+    this->processTime = static_cast<uint16_t>(processTime);
     this->jobType = jobType;
-}
-
-/**
- * @brief Generates a random IPv4 address string.
- *
- * @details Produces a dotted-decimal string by generating four random integers
- * each in the range [0, 255] and joining them with '.' separators.
- *
- * @return A randomly generated IPv4 address as a std::string.
- */
-std::string Request::generateIP() {
-    std::string IP = "";
-
-    for (int i = 0; i < 4; i++) {
-        IP += std::to_string(rand() % 256);
-        if (i < 3) {
-            IP += ".";
-        }
-    }
-
-    return IP;
+    this->enqueueTick = -1;
+    this->dispatchTick = -1;
 }
 
 /**
  * @brief Returns the source IP address.
- * @return The IPin field as a const std::string reference.
+ * @return The packed IPin field.
  */
-std::string Request::getIPin() const {
+uint32_t Request::getIPin() const {
     return IPin;
 }
 
 /**
  * @brief Returns the destination IP address.
- * @return The IPout field as a const std::string reference.
+ * @return The packed IPout field.
  */
-std::string Request::getIPout() const {
+uint32_t Request::getIPout() const {
     return IPout;
 }
 
@@ -89,3 +77,35 @@ int Request::getProcessTime() const {
 char Request::getJobType() const {
     return jobType;
 }
+
+/**
+ * @brief Stores the arrival tick.
+ * @param tick Clock time at which the request was queued.
+ */
+void Request::markEnqueued(int tick) {
+    enqueueTick = tick;
+}
+
+/**
+ * @brief Stores the dispatch tick.
+ * @param tick Clock time at which a server began processing the request.
+ */
+void Request::markDispatched(int tick) {
+    dispatchTick = tick;
+}
+
+/**
+ * @brief Returns the arrival tick.
+ * @return The enqueueTick field.
+ */
+int Request::getEnqueueTick() const {
+    return enqueueTick;
+}
+
+/**
+ * @brief Returns the dispatch tick.
+ * @return The dispatchTick field.
+ */
+int Request::getDispatchTick() const {
+    return dispatchTick;
+}
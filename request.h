@@ -7,6 +7,10 @@
  * carries source and destination IP addresses, an estimated processing
  * time, and a job type identifier.
  *
+ * Requests are compact, trivially copyable records: both addresses are kept
+ * packed into 32-bit integers and are only rendered as dotted-decimal text
+ * when a log line actually needs them (see formatIP() in utils.h).
+ *
  * @author Load Balancer Project
  * @date 2025
  */
@@ -14,46 +18,58 @@
 #ifndef REQUEST_H
 #define REQUEST_H
 
-#include <string>
+#include <cstdint>
 
 /**
  * @class Request
  * @brief Represents a single network request to be handled by a web server.
  *
  * @details A Request object encapsulates all information needed to route and
- * process a network request, including randomly generated source/destination
+ * process a network request, including its source/destination
  * IP addresses, the number of clock cycles required to process it, and the
  * job type ('P' for primary, 'S' for secondary).
+ *
+ * IP addresses are stored packed with the first octet in the most significant
+ * byte, so "10.0.0.1" is held as @c 0x0A000001.
+ *
+ * A request also carries the ticks at which a LoadBalancer enqueued and
+ * dispatched it, so its wait and sojourn times can be measured on completion.
  */
 class Request {
     public:
         /**
          * @brief Default constructor. Creates an empty request.
          *
-         * Initializes IP addresses to empty strings, processTime to 0,
+         * Initializes IP addresses to 0.0.0.0, processTime to 0,
          * and jobType to 'P'.
          */
         Request();
 
         /**
-         * @brief Parameterized constructor. Creates a request with generated IPs.
+         * @brief Creates a request with the given addresses.
+         *
+         * @details Generated requests get their addresses from a
+         * TrafficGenerator; replayed ones from the trace.
          *
-         * @param processTime Number of clock cycles required to process this request.
-         * @param jobType Character identifying the job type ('P' for primary, 'S' for secondary).
+         * @param IPin        Source address, packed with MSB = first octet.
+         * @param IPout       Destination address, packed with MSB = first octet.
+         * @param processTime Number of clock cycles required to process this request
+         *                    (clamped to the range [0, 65535]).
+         * @param jobType     Character identifying the job type.
          */
-        Request(int processTime, char jobType);
+        Request(uint32_t IPin, uint32_t IPout, int processTime, char jobType);
 
         /**
          * @brief Returns the source (input) IP address of the request.
-         * @return A string in dotted-decimal IPv4 format (e.g., "192.168.1.1").
+         * @return The address packed into 32 bits, MSB = first octet.
          */
-        std::string getIPin() const;
+        uint32_t getIPin() const;
 
         /**
          * @brief Returns the destination (output) IP address of the request.
-         * @return A string in dotted-decimal IPv4 format (e.g., "10.0.0.1").
+         * @return The address packed into 32 bits, MSB = first octet.
          */
-        std::string getIPout() const;
+        uint32_t getIPout() const;
 
         /**
          * @brief Returns the number of clock cycles needed to process this request.
@@ -67,17 +83,39 @@ class Request {
          */
         char getJobType() const;
 
-    private:
-        std::string IPin;     ///< Source IP address (randomly generated).
-        std::string IPout;    ///< Destination IP address (randomly generated).
-        int processTime;      ///< Processing time in clock cycles.
-        char jobType;         ///< Job type identifier ('P' or 'S').
+        /**
+         * @brief Records the tick at which the request entered a load balancer's queue.
+         * @param tick Clock time of arrival.
+         */
+        void markEnqueued(int tick);
+
+        /**
+         * @brief Records the tick at which a server started processing the request.
+         * @param tick Clock time of dispatch.
+         */
+        void markDispatched(int tick);
+
+        /**
+         * @brief Returns the tick recorded by markEnqueued().
+         * @return Arrival tick, or -1 if never enqueued.
+         */
+        int getEnqueueTick() const;
 
         /**
-         * @brief Generates a random IPv4 address string.
-         * @return A string in dotted-decimal format with each octet in [0, 255].
+         * @brief Returns the tick recorded by markDispatched().
+         * @return Dispatch tick, or -1 if never dispatched.
          */
-        std::string generateIP();
+        int getDispatchTick() const;
+
+    private:
+        uint32_t IPin;         ///< Source IP address (packed).
+        uint32_t IPout;        ///< Destination IP address (packed).
+        uint16_t processTime;  ///< Processing time in clock cycles.
+        char jobType;          ///< Job type identifier ('P' or 'S').
+        int32_t enqueueTick;   ///< Tick the request joined a queue (-1 if not yet).
+        int32_t dispatchTick;  ///< Tick the request started on a server (-1 if not yet).
 };
 
+static_assert(sizeof(Request) <= 20, "Request is expected to stay a compact 20-byte record");
+
 #endif
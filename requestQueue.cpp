@@ -0,0 +1,191 @@
+/**
+ * @file requestQueue.cpp
+ * @brief Implementation of the RequestQueue class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "requestQueue.h"
+#include <algorithm>
+
+/**
+ * @brief Allocates the initial ring.
+ * @param capacity Capacity hint; at least one slot is allocated.
+ */
+RequestQueue::RequestQueue(size_t capacity)
+    : head(0),
+      count(0)
+{
+    size_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+    ring.resize(slots);
+}
+
+/**
+ * @brief Returns the number of queued requests.
+ * @return Queue length.
+ */
+size_t RequestQueue::size() const {
+    return count;
+}
+
+/**
+ * @brief Reports whether the queue is empty.
+ * @return @c true if nothing is queued.
+ */
+bool RequestQueue::empty() const {
+    return count == 0;
+}
+
+/**
+ * @brief Returns the ring size.
+ * @return Capacity.
+ */
+size_t RequestQueue::capacity() const {
+    return ring.size();
+}
+
+/**
+ * @brief Returns the oldest request.
+ * @return Front of the queue.
+ */
+const Request& RequestQueue::front() const {
+    return ring[head];
+}
+
+/**
+ * @brief Returns the request at a queue position.
+ * @param index Position from the front.
+ * @return Queued request.
+ */
+const Request& RequestQueue::at(size_t index) const {
+    return ring[(head + index) & (ring.size() - 1)];
+}
+
+/**
+ * @brief Appends one request.
+ * @param request Request to append.
+ */
+void RequestQueue::push(const Request& request) {
+    if (count == ring.size()) {
+        grow(count + 1);
+    }
+    ring[(head + count) & (ring.size() - 1)] = request;
+    count++;
+}
+
+/**
+ * @brief Drops the oldest request.
+ */
+void RequestQueue::pop() {
+    head = (head + 1) & (ring.size() - 1);
+    count--;
+}
+
+/**
+ * @brief Copies a batch in at the tail, splitting it at the wrap point.
+ *
+ * @param requests First request to append.
+ * @param n        Number of requests.
+ */
+void RequestQueue::enqueue(const Request* requests, size_t n) {
+    if (count + n > ring.size()) {
+        grow(count + n);
+    }
+
+    size_t mask = ring.size() - 1;
+    size_t tail = (head + count) & mask;
+    size_t first = std::min(n, ring.size() - tail);
+    std::copy(requests, requests + first, ring.begin() + tail);
+    std::copy(requests + first, requests + n, ring.begin());
+    count += n;
+}
+
+/**
+ * @brief Appends a vector's contents.
+ * @param requests Requests to append.
+ */
+void RequestQueue::enqueue(const std::vector<Request>& requests) {
+    enqueue(requests.data(), requests.size());
+}
+
+/**
+ * @brief Copies a batch out from the head, splitting it at the wrap point.
+ *
+ * @param out      Destination.
+ * @param maxCount Maximum number to remove.
+ * @return Number removed.
+ */
+size_t RequestQueue::dequeue(Request* out, size_t maxCount) {
+    size_t n = std::min(maxCount, count);
+
+    size_t first = std::min(n, ring.size() - head);
+    std::copy(ring.begin() + head, ring.begin() + head + first, out);
+    std::copy(ring.begin(), ring.begin() + (n - first), out + first);
+
+    head = (head + n) & (ring.size() - 1);
+    count -= n;
+    return n;
+}
+
+/**
+ * @brief Advances the head past the oldest requests.
+ * @param maxCount Maximum number to remove.
+ * @return Number removed.
+ */
+size_t RequestQueue::discard(size_t maxCount) {
+    size_t n = std::min(maxCount, count);
+    head = (head + n) & (ring.size() - 1);
+    count -= n;
+    return n;
+}
+
+/**
+ * @brief Reallocates to a larger power of two and unwraps the contents.
+ * @param needed Minimum capacity.
+ */
+void RequestQueue::grow(size_t needed) {
+    size_t slots = ring.size();
+    while (slots < needed) {
+        slots <<= 1;
+    }
+
+    std::vector<Request> larger(slots);
+    size_t first = std::min(count, ring.size() - head);
+    std::copy(ring.begin() + head, ring.begin() + head + first, larger.begin());
+    std::copy(ring.begin(), ring.begin() + (count - first), larger.begin() + first);
+
+    ring.swap(larger);
+    head = 0;
+}
+
+/**
+ * @brief Writes the queued requests as two arrays: up to the end of the ring, then the wrapped part.
+ * @param out Snapshot being written.
+ */
+void RequestQueue::saveState(SnapshotWriter& out) const {
+    size_t first = std::min(count, ring.size() - head);
+    out.putArray(ring.data() + head, first);
+    out.putArray(ring.data(), count - first);
+}
+
+/**
+ * @brief Empties the queue and appends both arrays written by saveState().
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool RequestQueue::restoreState(SnapshotReader& in) {
+    std::vector<Request> first;
+    std::vector<Request> wrapped;
+    if (!in.getArray(first) || !in.getArray(wrapped)) {
+        return false;
+    }
+    head = 0;
+    count = 0;
+    enqueue(first);
+    enqueue(wrapped);
+    return true;
+}
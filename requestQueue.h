@@ -0,0 +1,137 @@
+/**
+ * @file requestQueue.h
+ * @brief Declaration of the RequestQueue class.
+ *
+ * @details Defines RequestQueue, the FIFO of Requests waiting in a
+ * LoadBalancer. It is a single contiguous ring whose capacity is always a
+ * power of two, so wrapping is a mask rather than a division, and a whole
+ * batch moves in or out with at most two block copies (one either side of
+ * the wrap point). Request is trivially copyable, so those copies compile
+ * down to memmove.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef REQUESTQUEUE_H
+#define REQUESTQUEUE_H
+
+#include <cstddef>
+#include <vector>
+#include "request.h"
+#include "snapshot.h"
+
+/**
+ * @class RequestQueue
+ * @brief Growable power-of-two ring buffer of Requests with bulk operations.
+ */
+class RequestQueue {
+    public:
+        /**
+         * @brief Constructs an empty queue.
+         * @param capacity Initial capacity hint, rounded up to a power of two.
+         */
+        explicit RequestQueue(size_t capacity = 16);
+
+        /**
+         * @brief Returns the number of queued requests.
+         * @return Queue length.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Reports whether the queue is empty.
+         * @return @c true if size() is zero.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Returns the current capacity.
+         * @return Slots in the ring (a power of two).
+         */
+        size_t capacity() const;
+
+        /**
+         * @brief Returns the oldest request.
+         * @return Reference valid until the next modification; the queue must not be empty.
+         */
+        const Request& front() const;
+
+        /**
+         * @brief Returns the request @p index places behind the front.
+         * @param index Position in [0, size()).
+         * @return Reference valid until the next modification.
+         */
+        const Request& at(size_t index) const;
+
+        /**
+         * @brief Appends one request, growing the ring if full.
+         * @param request Request to append.
+         */
+        void push(const Request& request);
+
+        /**
+         * @brief Removes the oldest request; the queue must not be empty.
+         */
+        void pop();
+
+        /**
+         * @brief Appends @p n requests in order with at most two block copies.
+         *
+         * @param requests First request to append.
+         * @param n        Number of requests.
+         */
+        void enqueue(const Request* requests, size_t n);
+
+        /**
+         * @brief Appends every request of @p requests in order.
+         * @param requests Requests to append.
+         */
+        void enqueue(const std::vector<Request>& requests);
+
+        /**
+         * @brief Removes up to @p maxCount of the oldest requests with at most two block copies.
+         *
+         * @param out      Receives the requests in FIFO order; must have room for @p maxCount.
+         * @param maxCount Maximum number to remove.
+         * @return Number actually removed.
+         */
+        size_t dequeue(Request* out, size_t maxCount);
+
+        /**
+         * @brief Removes up to @p maxCount of the oldest requests without copying them.
+         * @param maxCount Maximum number to remove.
+         * @return Number actually removed.
+         */
+        size_t discard(size_t maxCount);
+
+        /**
+         * @brief Writes the queued requests, oldest first, to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the queue's contents with the state read from @p in.
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        std::vector<Request> ring;  ///< Storage; its size is the capacity.
+        size_t head;                ///< Ring index of the oldest request.
+        size_t count;               ///< Number of queued requests.
+
+        /**
+         * @brief Grows the ring to the next power of two holding @p needed requests.
+         *
+         * @details The queued requests are unwrapped to the start of the new
+         * storage.
+         *
+         * @param needed Minimum capacity.
+         */
+        void grow(size_t needed);
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file rng.h
+ * @brief Declaration of Rng, the simulation's seedable pseudo-random generator.
+ *
+ * @details Rng is xoshiro256** (Blackman and Vigna): 256 bits of state, a
+ * handful of shifts, rotates and one multiply per 64-bit output, and good
+ * statistical quality. Each instance is an independent stream, so
+ * generators on different threads never share state. Streams derived from
+ * one seed are made non-overlapping with the generator's jump function,
+ * which advances it by 2^128 outputs.
+ *
+ * The member functions are defined in this header so that draws inline
+ * into the traffic generator's loops.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+/**
+ * @class Rng
+ * @brief xoshiro256** pseudo-random number generator.
+ */
+class Rng {
+    public:
+        /**
+         * @brief Seeds the generator.
+         *
+         * @details The state is filled from @p seed with splitmix64, then
+         * jumped @p stream times, so every (seed, stream) pair gives a
+         * distinct, non-overlapping sequence.
+         *
+         * @param seed   Any value, including 0.
+         * @param stream Stream number within the seed.
+         */
+        explicit Rng(uint64_t seed = 1, uint64_t stream = 0);
+
+        /**
+         * @brief Returns the next 64 random bits.
+         * @return Uniform value over all of @c uint64_t.
+         */
+        uint64_t next();
+
+        /**
+         * @brief Returns a uniform integer below @p bound without modulo bias.
+         *
+         * @details Lemire's multiply-and-shift; the rejection step is taken
+         * with probability below @p bound / 2^32.
+         *
+         * @param bound Exclusive upper bound; must be positive.
+         * @return Value in [0, @p bound).
+         */
+        uint32_t below(uint32_t bound);
+
+        /**
+         * @brief Returns a uniform double in [0, 1) with 53 random bits.
+         * @return Uniform value.
+         */
+        double uniform();
+
+        /**
+         * @brief Returns a uniform double in (0, 1], safe to pass to @c log.
+         * @return Uniform value.
+         */
+        double uniformPositive();
+
+        /**
+         * @brief Advances the generator by 2^128 outputs.
+         */
+        void jump();
+
+    private:
+        uint64_t state[4];  ///< xoshiro256 state; never all zero.
+
+        /**
+         * @brief Rotates @p x left by @p k bits.
+         * @param x Value.
+         * @param k Shift in [1, 63].
+         * @return Rotated value.
+         */
+        static uint64_t rotl(uint64_t x, int k);
+};
+
+inline Rng::Rng(uint64_t seed, uint64_t stream) {
+    uint64_t mix = seed;
+    for (uint64_t& word : state) {
+        uint64_t z = (mix += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        word = z ^ (z >> 31);
+    }
+    for (uint64_t i = 0; i < stream; i++) {
+        jump();
+    }
+}
+
+inline uint64_t Rng::rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t Rng::next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+}
+
+inline uint32_t Rng::below(uint32_t bound) {
+    uint64_t product = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = (next() >> 32) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+inline double Rng::uniform() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+inline double Rng::uniformPositive() {
+    return static_cast<double>((next() >> 11) + 1) * 0x1.0p-53;
+}
+
+inline void Rng::jump() {
+    static const uint64_t JUMP[4] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                     0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (uint64_t word : JUMP) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & (1ull << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    jumped[i] ^= state[i];
+                }
+            }
+            next();
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        state[i] = jumped[i];
+    }
+}
+
+#endif
@@ -0,0 +1,447 @@
+/**
+ * @file schedulingQueue.cpp
+ * @brief Implementation of the SchedulingQueue class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "schedulingQueue.h"
+#include <algorithm>
+
+/**
+ * @brief Parses a queue discipline name.
+ *
+ * @param name       Discipline name.
+ * @param discipline Receives the parsed discipline.
+ * @return @c true if recognised.
+ */
+bool parseQueueDiscipline(const std::string& name, QueueDiscipline& discipline) {
+    if (name == "fifo")     discipline = QueueDiscipline::FIFO;
+    else if (name == "drr") discipline = QueueDiscipline::DRR;
+    else if (name == "sjf") discipline = QueueDiscipline::SJF;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Constructs an empty FIFO queue.
+ */
+SchedulingQueue::SchedulingQueue()
+    : discipline(QueueDiscipline::FIFO),
+      weights(1, 1),
+      quantum(1),
+      rings(1),
+      count(0),
+      current(0),
+      occupied(0)
+{
+}
+
+/**
+ * @brief Replaces the discipline and classes, keeping the queued requests.
+ *
+ * @param discipline Discipline to use.
+ * @param cutoffs    Class bounds; sorted and de-duplicated here.
+ * @param weights    DRR weights, one per class.
+ * @param quantum    DRR quantum; values below 1 are raised to 1.
+ */
+void SchedulingQueue::configure(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum) {
+    std::vector<Request> queued = drain();
+
+    this->discipline = discipline;
+    this->cutoffs = cutoffs;
+    std::sort(this->cutoffs.begin(), this->cutoffs.end());
+    this->cutoffs.erase(std::unique(this->cutoffs.begin(), this->cutoffs.end()), this->cutoffs.end());
+    this->weights.assign(classCount(), 1);
+    for (size_t k = 0; k < this->weights.size() && k < weights.size(); k++) {
+        if (weights[k] > 0) {
+            this->weights[k] = weights[k];
+        }
+    }
+    this->quantum = quantum > 0 ? quantum : 1;
+
+    size_t ringCount = 1;
+    if (discipline == QueueDiscipline::DRR)
+        ringCount = classCount();
+    else if (discipline == QueueDiscipline::SJF)
+        ringCount = SJF_BUCKETS;
+    rings.assign(ringCount, RequestQueue());
+    deficits.assign(discipline == QueueDiscipline::DRR ? ringCount : 0, 0);
+    count = 0;
+    current = 0;
+    occupied = 0;
+    enqueue(queued);
+}
+
+/**
+ * @brief Returns the discipline.
+ * @return @c discipline.
+ */
+QueueDiscipline SchedulingQueue::getDiscipline() const {
+    return discipline;
+}
+
+/**
+ * @brief Returns the number of classes.
+ * @return Cutoffs plus one.
+ */
+size_t SchedulingQueue::classCount() const {
+    return cutoffs.size() + 1;
+}
+
+/**
+ * @brief Finds the first class whose cutoff covers the request's processing time.
+ * @param request Request to classify.
+ * @return Class index.
+ */
+size_t SchedulingQueue::classOf(const Request& request) const {
+    size_t k = 0;
+    while (k < cutoffs.size() && request.getProcessTime() > cutoffs[k]) {
+        k++;
+    }
+    return k;
+}
+
+/**
+ * @brief Returns a class's cutoff.
+ * @param index Class index.
+ * @return Cutoff, or -1 for the last class.
+ */
+int SchedulingQueue::classCutoff(size_t index) const {
+    return index < cutoffs.size() ? cutoffs[index] : -1;
+}
+
+/**
+ * @brief Returns the number of queued requests.
+ * @return Queue length.
+ */
+size_t SchedulingQueue::size() const {
+    return count;
+}
+
+/**
+ * @brief Reports whether the queue is empty.
+ * @return @c true if nothing is queued.
+ */
+bool SchedulingQueue::empty() const {
+    return count == 0;
+}
+
+/**
+ * @brief Returns the head of the selected ring.
+ * @return Next request to release.
+ */
+const Request& SchedulingQueue::front() const {
+    return rings[current].front();
+}
+
+/**
+ * @brief Files one request.
+ *
+ * @details A DRR queue that was empty gives the arriving class a fresh
+ * turn. Arrivals into a busy DRR queue never pre-empt the class whose turn
+ * it is. In SJF a shorter arrival becomes the new front.
+ *
+ * @param request Request to queue.
+ */
+void SchedulingQueue::push(const Request& request) {
+    if (discipline == QueueDiscipline::FIFO) {
+        rings[0].push(request);
+        count++;
+        return;
+    }
+
+    size_t ring = ringOf(request);
+    bool wasEmpty = count == 0;
+    rings[ring].push(request);
+    count++;
+    if (discipline == QueueDiscipline::SJF) {
+        occupied |= uint64_t(1) << ring;
+        if (wasEmpty || ring < current) {
+            current = ring;
+        }
+    } else if (wasEmpty) {
+        current = ring;
+        deficits[ring] = static_cast<int64_t>(weights[ring]) * quantum;
+        select();
+    }
+}
+
+/**
+ * @brief Releases the front request and charges it to its class.
+ */
+void SchedulingQueue::pop() {
+    if (discipline == QueueDiscipline::FIFO) {
+        rings[0].pop();
+        count--;
+        return;
+    }
+
+    RequestQueue& ring = rings[current];
+    if (discipline == QueueDiscipline::DRR) {
+        deficits[current] -= costOf(ring.front());
+    }
+    ring.pop();
+    count--;
+    if (ring.empty()) {
+        if (discipline == QueueDiscipline::DRR)
+            deficits[current] = 0;
+        else
+            occupied &= ~(uint64_t(1) << current);
+    }
+    if (count > 0) {
+        select();
+    }
+}
+
+/**
+ * @brief Queues a block of requests.
+ *
+ * @param requests First request.
+ * @param count    Number of requests.
+ */
+void SchedulingQueue::enqueue(const Request* requests, size_t count) {
+    if (discipline == QueueDiscipline::FIFO) {
+        rings[0].enqueue(requests, count);
+        this->count += count;
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        push(requests[i]);
+    }
+}
+
+/**
+ * @brief Queues every request of a vector.
+ * @param requests Requests to queue.
+ */
+void SchedulingQueue::enqueue(const std::vector<Request>& requests) {
+    enqueue(requests.data(), requests.size());
+}
+
+/**
+ * @brief Releases up to @p count requests.
+ *
+ * @param out   Destination buffer.
+ * @param count Maximum number to remove.
+ * @return Number removed.
+ */
+size_t SchedulingQueue::dequeue(Request* out, size_t count) {
+    if (discipline == QueueDiscipline::FIFO) {
+        size_t taken = rings[0].dequeue(out, count);
+        this->count -= taken;
+        return taken;
+    }
+    size_t taken = 0;
+    while (taken < count && !empty()) {
+        out[taken++] = front();
+        pop();
+    }
+    return taken;
+}
+
+/**
+ * @brief Evicts the oldest requests one at a time.
+ *
+ * @details Each ring is in arrival order, so the oldest request overall is
+ * the oldest of the ring heads. Evictions are not charged to a DRR class.
+ *
+ * @param count Maximum number to remove.
+ * @return Number removed.
+ */
+size_t SchedulingQueue::discard(size_t count) {
+    if (discipline == QueueDiscipline::FIFO) {
+        size_t removed = rings[0].discard(count);
+        this->count -= removed;
+        return removed;
+    }
+
+    size_t removed = 0;
+    while (removed < count && !empty()) {
+        size_t oldest = rings.size();
+        for (size_t r = 0; r < rings.size(); r++) {
+            if (!rings[r].empty() && (oldest == rings.size()
+                                      || rings[r].front().getEnqueueTick() < rings[oldest].front().getEnqueueTick())) {
+                oldest = r;
+            }
+        }
+        rings[oldest].pop();
+        this->count--;
+        removed++;
+        if (rings[oldest].empty()) {
+            if (discipline == QueueDiscipline::DRR)
+                deficits[oldest] = 0;
+            else
+                occupied &= ~(uint64_t(1) << oldest);
+        }
+    }
+    if (!empty()) {
+        select();
+    }
+    return removed;
+}
+
+/**
+ * @brief Writes the configuration, the scheduler state and each ring.
+ * @param out Snapshot being written.
+ */
+void SchedulingQueue::saveState(SnapshotWriter& out) const {
+    out.putTag("SCHQ");
+    out.put(static_cast<uint32_t>(discipline));
+    out.put(quantum);
+    out.putArray(cutoffs);
+    out.putArray(weights);
+    out.put(static_cast<uint64_t>(current));
+    out.putArray(deficits);
+    out.put(static_cast<uint64_t>(rings.size()));
+    for (const RequestQueue& ring : rings) {
+        ring.saveState(out);
+    }
+}
+
+/**
+ * @brief Reads the rings back, re-filing them if the configuration has changed.
+ * @param in Snapshot being read.
+ * @return @c true on success; the queue is unchanged on failure.
+ */
+bool SchedulingQueue::restoreState(SnapshotReader& in) {
+    uint32_t savedDiscipline = 0;
+    int savedQuantum = 0;
+    std::vector<int> savedCutoffs;
+    std::vector<int> savedWeights;
+    uint64_t savedCurrent = 0;
+    std::vector<int64_t> savedDeficits;
+    uint64_t ringCount = 0;
+    in.expectTag("SCHQ");
+    in.get(savedDiscipline);
+    in.get(savedQuantum);
+    in.getArray(savedCutoffs);
+    in.getArray(savedWeights);
+    in.get(savedCurrent);
+    in.getArray(savedDeficits);
+    in.get(ringCount);
+    if (!in.ok() || ringCount == 0 || ringCount > in.remaining()) {
+        return in.fail();
+    }
+
+    std::vector<RequestQueue> saved(static_cast<size_t>(ringCount));
+    size_t total = 0;
+    for (RequestQueue& ring : saved) {
+        if (!ring.restoreState(in)) {
+            return false;
+        }
+        total += ring.size();
+    }
+    if (savedCurrent >= ringCount || (total > 0 && saved[static_cast<size_t>(savedCurrent)].empty())) {
+        return in.fail();
+    }
+
+    if (savedDiscipline == static_cast<uint32_t>(discipline) && savedQuantum == quantum && savedCutoffs == cutoffs
+        && savedWeights == weights && saved.size() == rings.size() && savedDeficits.size() == deficits.size()) {
+        rings = std::move(saved);
+        deficits = std::move(savedDeficits);
+        current = static_cast<size_t>(savedCurrent);
+        count = total;
+        occupied = 0;
+        if (discipline == QueueDiscipline::SJF) {
+            for (size_t r = 0; r < rings.size(); r++) {
+                if (!rings[r].empty()) {
+                    occupied |= uint64_t(1) << r;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<Request> queued;
+    queued.reserve(total);
+    for (RequestQueue& ring : saved) {
+        for (; !ring.empty(); ring.pop()) {
+            queued.push_back(ring.front());
+        }
+    }
+    std::stable_sort(queued.begin(), queued.end(), [](const Request& a, const Request& b) {
+        return a.getEnqueueTick() < b.getEnqueueTick();
+    });
+    rings.assign(rings.size(), RequestQueue());
+    deficits.assign(deficits.size(), 0);
+    count = 0;
+    current = 0;
+    occupied = 0;
+    enqueue(queued);
+    return true;
+}
+
+/**
+ * @brief Maps a request to its ring under the active discipline.
+ * @param request Request to file.
+ * @return Ring index.
+ */
+size_t SchedulingQueue::ringOf(const Request& request) const {
+    if (discipline == QueueDiscipline::DRR) {
+        return classOf(request);
+    }
+    if (discipline == QueueDiscipline::SJF) {
+        int time = request.getProcessTime();
+        if (time < SJF_EXACT) {
+            return static_cast<size_t>(time);
+        }
+        size_t octave = 0;
+        while ((time >> (octave + 1)) != 0) {
+            octave++;
+        }
+        return static_cast<size_t>(SJF_EXACT) + octave - 5;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the DRR charge for one request.
+ * @param request Request.
+ * @return Its processing time, or 1 for a zero-length request.
+ */
+int64_t SchedulingQueue::costOf(const Request& request) {
+    return std::max(request.getProcessTime(), 1);
+}
+
+/**
+ * @brief Points @c current at the ring to release from next.
+ *
+ * @details DRR: while the current class is empty or its head costs more
+ * than its credit, the turn passes to the next class, which earns its
+ * weight times the quantum. An empty class loses its credit, as in
+ * Shreedhar and Varghese's algorithm.
+ */
+void SchedulingQueue::select() {
+    if (discipline == QueueDiscipline::SJF) {
+        current = static_cast<size_t>(__builtin_ctzll(occupied));
+        return;
+    }
+    if (discipline != QueueDiscipline::DRR) {
+        return;
+    }
+    for (;;) {
+        if (!rings[current].empty()) {
+            if (costOf(rings[current].front()) <= deficits[current]) {
+                return;
+            }
+        } else {
+            deficits[current] = 0;
+        }
+        current = current + 1 < rings.size() ? current + 1 : 0;
+        if (!rings[current].empty()) {
+            deficits[current] += static_cast<int64_t>(weights[current]) * quantum;
+        }
+    }
+}
+
+/**
+ * @brief Releases everything, in order, into a vector.
+ * @return Former contents.
+ */
+std::vector<Request> SchedulingQueue::drain() {
+    std::vector<Request> queued(count);
+    dequeue(queued.data(), queued.size());
+    return queued;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file schedulingQueue.h
+ * @brief Declaration of the SchedulingQueue class, the multi-level queue in
+ *        front of a LoadBalancer's servers.
+ *
+ * @details A SchedulingQueue decides which waiting request is dispatched
+ * next. Requests are sorted into priority classes by their processing time
+ * (Request::getProcessTime()): class @c k holds the requests whose time is
+ * at most cutoff @c k, and the last class holds the rest. There are three
+ * disciplines:
+ *  - QueueDiscipline::FIFO — one ring in arrival order (the original
+ *    behaviour). The classes are only used for reporting.
+ *  - QueueDiscipline::DRR — one ring per class, served by deficit round
+ *    robin. Each turn a class earns its weight times the quantum, in
+ *    cycles of processing time, and dispatches requests while the head
+ *    fits. Classes therefore share the servers' time in proportion to their
+ *    weights, however long the requests in the other classes are.
+ *  - QueueDiscipline::SJF — shortest job first over buckets of processing
+ *    time. Times below 32 cycles get a bucket each and longer ones one
+ *    bucket per power of two, so a 64-bit occupancy mask finds the shortest
+ *    waiting job in O(1). Ties, and jobs sharing a bucket, go in arrival
+ *    order. Long jobs can starve while shorter ones keep arriving.
+ *
+ * Every ring is a RequestQueue. With FIFO every operation forwards to the
+ * single ring, so the default costs one branch.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef SCHEDULINGQUEUE_H
+#define SCHEDULINGQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "request.h"
+#include "requestQueue.h"
+#include "snapshot.h"
+
+/**
+ * @enum QueueDiscipline
+ * @brief Order in which a SchedulingQueue releases requests.
+ */
+enum class QueueDiscipline {
+    FIFO,  ///< Arrival order.
+    DRR,   ///< Deficit round robin over the priority classes.
+    SJF    ///< Shortest processing time first.
+};
+
+/**
+ * @brief Converts a discipline name to a QueueDiscipline.
+ *
+ * @param name       Discipline name: @c "fifo", @c "drr" or @c "sjf".
+ * @param discipline Receives the parsed discipline on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseQueueDiscipline(const std::string& name, QueueDiscipline& discipline);
+
+/**
+ * @class SchedulingQueue
+ * @brief Queue of waiting requests that releases them in the order of a QueueDiscipline.
+ *
+ * @details front() is the request the discipline dispatches next; it stays
+ * the same until the queue is modified. discard() removes the requests
+ * that have waited longest, whatever their class.
+ */
+class SchedulingQueue {
+    public:
+        /**
+         * @brief Constructs an empty FIFO queue with one class.
+         */
+        SchedulingQueue();
+
+        /**
+         * @brief Sets the discipline and the priority classes.
+         *
+         * @details Requests already queued are re-filed in the order the old
+         * discipline would have released them.
+         *
+         * @param discipline Discipline to use.
+         * @param cutoffs    Ascending processing-time bounds of all but the last class.
+         * @param weights    DRR weight of each class; missing or non-positive weights count as 1.
+         * @param quantum    Processing time, in cycles, a class of weight 1 earns per DRR turn.
+         */
+        void configure(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum);
+
+        /**
+         * @brief Returns the active discipline.
+         * @return Discipline.
+         */
+        QueueDiscipline getDiscipline() const;
+
+        /**
+         * @brief Returns the number of priority classes.
+         * @return One more than the number of cutoffs.
+         */
+        size_t classCount() const;
+
+        /**
+         * @brief Returns the priority class of @p request.
+         * @param request Request to classify.
+         * @return Class in [0, classCount()).
+         */
+        size_t classOf(const Request& request) const;
+
+        /**
+         * @brief Returns the processing-time bound of class @p index.
+         * @param index Class in [0, classCount()).
+         * @return Cutoff, or -1 for the last class, which is unbounded.
+         */
+        int classCutoff(size_t index) const;
+
+        /**
+         * @brief Returns the number of queued requests.
+         * @return Queue length over all classes.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Reports whether the queue is empty.
+         * @return @c true if size() is zero.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Returns the request the discipline releases next.
+         * @return Reference valid until the next modification; the queue must not be empty.
+         */
+        const Request& front() const;
+
+        /**
+         * @brief Queues one request.
+         * @param request Request to queue.
+         */
+        void push(const Request& request);
+
+        /**
+         * @brief Removes front(); the queue must not be empty.
+         */
+        void pop();
+
+        /**
+         * @brief Queues @p count requests in order.
+         *
+         * @param requests First request to queue.
+         * @param count    Number of requests.
+         */
+        void enqueue(const Request* requests, size_t count);
+
+        /**
+         * @brief Queues every request of @p requests in order.
+         * @param requests Requests to queue.
+         */
+        void enqueue(const std::vector<Request>& requests);
+
+        /**
+         * @brief Removes up to @p count requests in release order.
+         *
+         * @param out   Receives the requests; must have room for @p count.
+         * @param count Maximum number to remove.
+         * @return Number actually removed.
+         */
+        size_t dequeue(Request* out, size_t count);
+
+        /**
+         * @brief Removes up to @p count of the requests that have waited longest.
+         *
+         * @details Ages are compared by Request::getEnqueueTick(); ties go to
+         * the lowest class.
+         *
+         * @param count Maximum number to remove.
+         * @return Number actually removed.
+         */
+        size_t discard(size_t count);
+
+        /**
+         * @brief Writes the configuration, the DRR state and every ring to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the contents with the state read from @p in.
+         *
+         * @details The configuration stays as configured. If the snapshot was
+         * written under another configuration, its requests are re-filed in
+         * enqueue order and the DRR state starts afresh.
+         *
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        static const int SJF_EXACT = 32;       ///< Processing times below this get a bucket each.
+        static const size_t SJF_BUCKETS = 43;  ///< Buckets covering every time up to 65535.
+
+        QueueDiscipline discipline;       ///< Active discipline.
+        std::vector<int> cutoffs;         ///< Upper processing-time bound of each class but the last.
+        std::vector<int> weights;         ///< DRR weight of each class.
+        int quantum;                      ///< DRR quantum per unit of weight.
+        std::vector<RequestQueue> rings;  ///< FIFO: one; DRR: one per class; SJF: one per bucket.
+        size_t count;                     ///< Requests in all rings.
+        size_t current;                   ///< Ring holding front() while not empty.
+        std::vector<int64_t> deficits;    ///< DRR: credit of each class, in cycles.
+        uint64_t occupied;                ///< SJF: bit @c b is set while bucket @c b is not empty.
+
+        /**
+         * @brief Returns the ring @p request is filed in.
+         * @param request Request to file.
+         * @return Ring index.
+         */
+        size_t ringOf(const Request& request) const;
+
+        /**
+         * @brief Returns how much of a DRR class's credit a request uses.
+         * @param request Request at the head of a class.
+         * @return Processing time, at least 1.
+         */
+        static int64_t costOf(const Request& request);
+
+        /**
+         * @brief Moves @c current to the ring whose head is released next.
+         *
+         * @details DRR passes the turn on while the current class's head
+         * does not fit its credit; SJF takes the lowest occupied bucket.
+         * The queue must not be empty.
+         */
+        void select();
+
+        /**
+         * @brief Removes every request in release order.
+         * @return The removed requests.
+         */
+        std::vector<Request> drain();
+};
+
+#endif
@@ -0,0 +1,536 @@
+/**
+ * @file serverPool.cpp
+ * @brief Implementation of the ServerPool class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "serverPool.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Sets or clears bit @p index of a word bitmap, growing it if needed.
+ *
+ * @param bits  Bitmap to update.
+ * @param index Bit to change.
+ * @param value New state of the bit.
+ */
+void setBit(std::vector<uint64_t>& bits, size_t index, bool value) {
+    size_t word = index / 64;
+    uint64_t bit = static_cast<uint64_t>(1) << (index % 64);
+    if (word >= bits.size()) {
+        bits.resize(word + 1, 0);
+    }
+    if (value) {
+        bits[word] |= bit;
+    } else {
+        bits[word] &= ~bit;
+    }
+}
+
+}
+
+/**
+ * @brief Constructs an empty pool.
+ */
+ServerPool::ServerPool()
+    : liveCount(0),
+      membership(0),
+      localDepth(0),
+      localTotal(0)
+{
+}
+
+/**
+ * @brief Returns the number of live servers.
+ * @return Server count.
+ */
+size_t ServerPool::size() const {
+    return liveCount;
+}
+
+/**
+ * @brief Returns the number of slots.
+ * @return Live plus retired slots.
+ */
+size_t ServerPool::slotCount() const {
+    return ids.size();
+}
+
+/**
+ * @brief Reports whether the pool is empty.
+ * @return @c true if there are no live servers.
+ */
+bool ServerPool::empty() const {
+    return liveCount == 0;
+}
+
+/**
+ * @brief Places an idle server in a recycled or new slot.
+ *
+ * @details A recycled slot keeps its local ring storage and starts with a
+ * fresh service-time average, so scale-up after a scale-down allocates
+ * nothing.
+ *
+ * @param id Server identifier.
+ * @return Slot index of the new server.
+ */
+size_t ServerPool::add(int id) {
+    size_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = appendSlot();
+    }
+    ids[index] = id;
+    serviceMeans[index] = 0.0f;
+    setLive(index, true);
+    setIdle(index, true);
+    liveCount++;
+    membership++;
+    return index;
+}
+
+/**
+ * @brief Tombstones one slot and queues it for reuse.
+ *
+ * @details Clearing the idle and live bits is enough to hide the slot from
+ * every search; the generation bump invalidates outstanding handles.
+ *
+ * @param index Slot to retire.
+ */
+void ServerPool::retire(size_t index) {
+    localTotal -= localCount[index];
+    localCount[index] = 0;
+    localHead[index] = 0;
+    queuedWork[index] = 0;
+    generations[index]++;
+    setIdle(index, false);
+    setLive(index, false);
+    freeSlots.push_back(static_cast<uint32_t>(index));
+    liveCount--;
+    membership++;
+}
+
+/**
+ * @brief Appends free slots until @p slots exist.
+ *
+ * @details The new slots are pushed so that the lowest-indexed one is
+ * recycled first.
+ *
+ * @param slots Minimum slot count.
+ */
+void ServerPool::reserve(size_t slots) {
+    size_t first = ids.size();
+    if (slots <= first) {
+        return;
+    }
+    for (size_t i = first; i < slots; i++) {
+        appendSlot();
+    }
+    for (size_t i = slots; i > first; i--) {
+        freeSlots.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+/**
+ * @brief Tests one slot's live bit.
+ * @param index Slot to test.
+ * @return @c true if a server occupies the slot.
+ */
+bool ServerPool::isLive(size_t index) const {
+    return index / 64 < liveBits.size() && ((liveBits[index / 64] >> (index % 64)) & 1);
+}
+
+/**
+ * @brief Returns the membership version.
+ * @return @c membership.
+ */
+uint64_t ServerPool::membershipVersion() const {
+    return membership;
+}
+
+/**
+ * @brief Pairs a slot with its current generation.
+ * @param index Slot of a live server.
+ * @return Handle to the server.
+ */
+ServerHandle ServerPool::handle(size_t index) const {
+    return {static_cast<uint32_t>(index), generations[index]};
+}
+
+/**
+ * @brief Checks a handle's generation against its slot's.
+ * @param handle Handle to resolve.
+ * @return Slot index, or -1 if stale.
+ */
+long ServerPool::resolve(ServerHandle handle) const {
+    if (handle.slot >= ids.size() || generations[handle.slot] != handle.generation || !isLive(handle.slot)) {
+        return -1;
+    }
+    return static_cast<long>(handle.slot);
+}
+
+/**
+ * @brief Scans the idle bitmap a word at a time for the first set bit.
+ * @return Lowest idle slot, or -1 if none.
+ */
+long ServerPool::firstIdle() const {
+    for (size_t word = 0; word < idleBits.size(); word++) {
+        if (idleBits[word] != 0) {
+            return static_cast<long>(word * 64 + __builtin_ctzll(idleBits[word]));
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Counts the idle servers a word at a time.
+ * @return Population count of the idle bitmap.
+ */
+size_t ServerPool::idleCount() const {
+    size_t idle = 0;
+    for (uint64_t word : idleBits) {
+        idle += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return idle;
+}
+
+/**
+ * @brief Tests one slot's idle bit.
+ * @param index Slot to test.
+ * @return @c true if idle.
+ */
+bool ServerPool::isIdle(size_t index) const {
+    return index / 64 < idleBits.size() && ((idleBits[index / 64] >> (index % 64)) & 1);
+}
+
+/**
+ * @brief Returns the id stored in slot @p index.
+ * @param index Slot to read.
+ * @return Server identifier.
+ */
+int ServerPool::getId(size_t index) const {
+    return ids[index];
+}
+
+/**
+ * @brief Starts a request on an idle server.
+ *
+ * @param index          Slot of the server.
+ * @param request        Request to process.
+ * @param completionTick Tick during which it finishes.
+ */
+void ServerPool::assign(size_t index, const Request& request, int completionTick) {
+    inFlight[index] = request;
+    completionTicks[index] = completionTick;
+    float duration = static_cast<float>(request.getProcessTime());
+    serviceMeans[index] = serviceMeans[index] == 0.0f ? duration : 0.8f * serviceMeans[index] + 0.2f * duration;
+    setIdle(index, false);
+}
+
+/**
+ * @brief Returns a busy server to the idle set.
+ * @param index Slot to release.
+ */
+void ServerPool::release(size_t index) {
+    setIdle(index, true);
+}
+
+/**
+ * @brief Materialises one slot as a WebServer.
+ *
+ * @details A busy server whose request completes during tick @c c has
+ * <tt>c - clockTime + 1</tt> cycles left at the start of @p clockTime.
+ *
+ * @param index     Slot to inspect.
+ * @param clockTime Current tick.
+ * @return Snapshot of the server.
+ */
+WebServer ServerPool::view(size_t index, int clockTime) const {
+    if (isIdle(index)) {
+        return WebServer(ids[index]);
+    }
+    return WebServer(ids[index], inFlight[index], completionTicks[index] - clockTime + 1);
+}
+
+/**
+ * @brief Returns the in-flight request of one slot.
+ * @param index Slot to read.
+ * @return Request most recently assigned to the slot.
+ */
+const Request& ServerPool::getRequest(size_t index) const {
+    return inFlight[index];
+}
+
+/**
+ * @brief Resizes the local queue storage.
+ * @param depth New capacity of each local queue, clamped to @c MAX_LOCAL_QUEUE_DEPTH.
+ */
+void ServerPool::setLocalQueueDepth(size_t depth) {
+    localDepth = std::min(depth, MAX_LOCAL_QUEUE_DEPTH);
+    localRing.assign(ids.size() * localDepth, Request());
+    std::fill(localHead.begin(), localHead.end(), 0);
+    std::fill(localCount.begin(), localCount.end(), 0);
+    std::fill(queuedWork.begin(), queuedWork.end(), 0);
+    localTotal = 0;
+}
+
+/**
+ * @brief Returns the local queue capacity.
+ * @return Requests each local queue can hold.
+ */
+size_t ServerPool::getLocalQueueDepth() const {
+    return localDepth;
+}
+
+/**
+ * @brief Tests whether one server can accept a request.
+ * @param index Slot to test.
+ * @return @c true if idle or its local queue has room.
+ */
+bool ServerPool::canAccept(size_t index) const {
+    return isIdle(index) || (localCount[index] < localDepth && isLive(index));
+}
+
+/**
+ * @brief Tests whether any server can accept a request.
+ *
+ * @details The idle bitmap answers most calls; the local queues are only
+ * scanned when every server is busy.
+ *
+ * @return @c true if some server can accept.
+ */
+bool ServerPool::hasCapacity() const {
+    if (firstIdle() >= 0) {
+        return true;
+    }
+    if (localDepth == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < localCount.size(); i++) {
+        if (localCount[i] < localDepth && isLive(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Appends to one server's local ring.
+ *
+ * @param index   Slot of the server.
+ * @param request Request to queue.
+ * @return @c true on success, @c false if full.
+ */
+bool ServerPool::pushLocal(size_t index, const Request& request) {
+    if (localCount[index] >= localDepth) {
+        return false;
+    }
+    size_t position = (localHead[index] + localCount[index]) % localDepth;
+    localRing[index * localDepth + position] = request;
+    localCount[index]++;
+    queuedWork[index] += request.getProcessTime();
+    localTotal++;
+    return true;
+}
+
+/**
+ * @brief Pops the oldest entry of one server's local ring.
+ *
+ * @param index   Slot of the server.
+ * @param request Receives the request.
+ * @return @c true on success, @c false if empty.
+ */
+bool ServerPool::popLocal(size_t index, Request& request) {
+    if (localCount[index] == 0) {
+        return false;
+    }
+    request = localRing[index * localDepth + localHead[index]];
+    localHead[index] = static_cast<uint16_t>((localHead[index] + 1) % localDepth);
+    localCount[index]--;
+    queuedWork[index] -= request.getProcessTime();
+    localTotal--;
+    return true;
+}
+
+/**
+ * @brief Returns one local queue's length.
+ * @param index Slot to read.
+ * @return Number of queued requests.
+ */
+size_t ServerPool::localQueueLength(size_t index) const {
+    return localCount[index];
+}
+
+/**
+ * @brief Returns the number of requests in all local queues.
+ * @return Total queued locally.
+ */
+size_t ServerPool::localQueuedTotal() const {
+    return localTotal;
+}
+
+/**
+ * @brief Computes the work a server must finish before it is free.
+ *
+ * @param index     Slot to read.
+ * @param clockTime Current tick.
+ * @return Remaining in-flight cycles plus queued processing times.
+ */
+int ServerPool::outstandingWork(size_t index, int clockTime) const {
+    int inFlightWork = isIdle(index) ? 0 : completionTicks[index] - clockTime + 1;
+    return inFlightWork + queuedWork[index];
+}
+
+/**
+ * @brief Counts the requests a server has committed to.
+ * @param index Slot to read.
+ * @return In-flight plus locally queued requests.
+ */
+int ServerPool::outstandingRequests(size_t index) const {
+    return (isIdle(index) ? 0 : 1) + localCount[index];
+}
+
+/**
+ * @brief Returns one server's processing-time average.
+ * @param index Slot to read.
+ * @return EWMA of assigned processing times.
+ */
+float ServerPool::serviceEstimate(size_t index) const {
+    return serviceMeans[index];
+}
+
+/**
+ * @brief Updates one slot's idle bit, growing the bitmap if needed.
+ *
+ * @param index Slot to update.
+ * @param idle  @c true to mark idle, @c false to mark busy.
+ */
+void ServerPool::setIdle(size_t index, bool idle) {
+    setBit(idleBits, index, idle);
+}
+
+/**
+ * @brief Updates one slot's live bit.
+ *
+ * @param index Slot to update.
+ * @param live  @c true while a server occupies the slot.
+ */
+void ServerPool::setLive(size_t index, bool live) {
+    setBit(liveBits, index, live);
+}
+
+/**
+ * @brief Grows every per-slot array by one free slot.
+ *
+ * @details The bitmaps are widened here too, so they always hold
+ * @c (slotCount() + 63) / 64 words and a saved pool restores unchanged.
+ *
+ * @return Index of the new slot.
+ */
+size_t ServerPool::appendSlot() {
+    size_t index = ids.size();
+    size_t words = index / 64 + 1;
+    if (liveBits.size() < words) {
+        liveBits.resize(words, 0);
+    }
+    if (idleBits.size() < words) {
+        idleBits.resize(words, 0);
+    }
+    ids.push_back(-1);
+    generations.push_back(0);
+    completionTicks.push_back(0);
+    inFlight.push_back(Request());
+    serviceMeans.push_back(0.0f);
+    localHead.push_back(0);
+    localCount.push_back(0);
+    queuedWork.push_back(0);
+    localRing.resize(localRing.size() + localDepth);
+    return index;
+}
+
+/**
+ * @brief Writes the per-slot arrays, the free list and the counters.
+ * @param out Snapshot being written.
+ */
+void ServerPool::saveState(SnapshotWriter& out) const {
+    out.put(static_cast<uint64_t>(liveCount));
+    out.put(static_cast<uint64_t>(localDepth));
+    out.put(static_cast<uint64_t>(localTotal));
+    out.putArray(ids);
+    out.putArray(generations);
+    out.putArray(liveBits);
+    out.putArray(freeSlots);
+    out.putArray(completionTicks);
+    out.putArray(idleBits);
+    out.putArray(inFlight);
+    out.putArray(serviceMeans);
+    out.putArray(localRing);
+    out.putArray(localHead);
+    out.putArray(localCount);
+    out.putArray(queuedWork);
+}
+
+/**
+ * @brief Reads the arrays written by saveState() and checks they describe one pool.
+ * @param in Snapshot being read.
+ * @return @c true on success; the pool is unchanged on failure.
+ */
+bool ServerPool::restoreState(SnapshotReader& in) {
+    uint64_t live = 0;
+    uint64_t depth = 0;
+    uint64_t total = 0;
+    ServerPool restored;
+    in.get(live);
+    in.get(depth);
+    in.get(total);
+    in.getArray(restored.ids);
+    in.getArray(restored.generations);
+    in.getArray(restored.liveBits);
+    in.getArray(restored.freeSlots);
+    in.getArray(restored.completionTicks);
+    in.getArray(restored.idleBits);
+    in.getArray(restored.inFlight);
+    in.getArray(restored.serviceMeans);
+    in.getArray(restored.localRing);
+    in.getArray(restored.localHead);
+    in.getArray(restored.localCount);
+    in.getArray(restored.queuedWork);
+    if (!in.ok()) {
+        return false;
+    }
+
+    size_t slots = restored.ids.size();
+    size_t words = (slots + 63) / 64;
+    if (live > slots || depth > MAX_LOCAL_QUEUE_DEPTH || restored.generations.size() != slots
+        || restored.liveBits.size() != words || restored.idleBits.size() != words
+        || restored.completionTicks.size() != slots || restored.inFlight.size() != slots
+        || restored.serviceMeans.size() != slots || restored.localHead.size() != slots
+        || restored.localCount.size() != slots || restored.queuedWork.size() != slots
+        || restored.localRing.size() != slots * depth || restored.freeSlots.size() > slots) {
+        return in.fail();
+    }
+    for (uint32_t slot : restored.freeSlots) {
+        if (slot >= slots) {
+            return in.fail();
+        }
+    }
+    for (size_t slot = 0; slot < slots; slot++) {
+        if (restored.localCount[slot] > depth || (depth > 0 && restored.localHead[slot] >= depth)) {
+            return in.fail();
+        }
+    }
+
+    restored.liveCount = static_cast<size_t>(live);
+    restored.localDepth = static_cast<size_t>(depth);
+    restored.localTotal = static_cast<size_t>(total);
+    restored.membership = membership + 1;
+    *this = std::move(restored);
+    return true;
+}
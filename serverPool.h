@@ -0,0 +1,343 @@
+/**
+ * @file serverPool.h
+ * @brief Declaration of the ServerPool class.
+ *
+ * @details Defines ServerPool, the structure-of-arrays store behind each
+ * LoadBalancer's servers. Server ids, completion ticks, idle bits and the
+ * in-flight requests live in separate contiguous arrays, so the hot paths
+ * (finding an idle server, marking one busy or idle) touch only the small
+ * arrays they need and never pull request payloads through the cache.
+ *
+ * Each server may also own a short local queue (a fixed-depth ring) so a
+ * DispatchPolicy can commit work to a server that is still busy.
+ *
+ * Slots are stable: retiring a server only tombstones its slot and pushes it
+ * on a free list, and the next add() recycles it, storage and all. A
+ * ServerHandle pairs a slot with the generation it was issued under, so a
+ * handle to a retired server can be detected instead of silently naming the
+ * slot's next occupant.
+ *
+ * WebServer remains the value type used to seed a pool and to inspect a
+ * single server; see ServerPool::view().
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef SERVERPOOL_H
+#define SERVERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "request.h"
+#include "snapshot.h"
+#include "webServer.h"
+
+/**
+ * @struct ServerHandle
+ * @brief Stable reference to one server in a ServerPool.
+ */
+struct ServerHandle {
+    uint32_t slot;        ///< Slot index in the pool.
+    uint32_t generation;  ///< Generation of the slot when the handle was issued.
+};
+
+/**
+ * @class ServerPool
+ * @brief Structure-of-arrays collection of simulated servers.
+ *
+ * @details Slot @c i of every array describes the same server. A live server
+ * is either idle (its bit in @c idleBits is set) or busy until a known
+ * completion tick; the owning LoadBalancer decides when that tick has been
+ * reached and calls release(). Retired slots are neither idle nor able to
+ * accept work, so loops over [0, slotCount()) that test isIdle() or
+ * canAccept() skip them naturally.
+ */
+class ServerPool {
+    public:
+        static constexpr size_t MAX_LOCAL_QUEUE_DEPTH = UINT16_MAX;  ///< Largest local queue the 16-bit counters can track.
+
+        /**
+         * @brief Constructs an empty pool.
+         */
+        ServerPool();
+
+        /**
+         * @brief Returns the number of live servers in the pool.
+         * @return Server count.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Returns the number of slots, live or retired.
+         * @return Upper bound for slot indices.
+         */
+        size_t slotCount() const;
+
+        /**
+         * @brief Reports whether the pool has no servers.
+         * @return @c true if size() is zero.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Adds an idle server with the given id.
+         *
+         * @details Recycles the most recently retired slot if there is one and
+         * only grows the arrays otherwise.
+         *
+         * @param id Server identifier.
+         * @return Slot index of the new server.
+         */
+        size_t add(int id);
+
+        /**
+         * @brief Retires the server in slot @p index in O(1).
+         *
+         * @details The slot is tombstoned and recycled by a later add(); no
+         * other slot moves. Any requests in its local queue are discarded and
+         * handles to it become stale.
+         *
+         * @param index Slot of a live server.
+         */
+        void retire(size_t index);
+
+        /**
+         * @brief Pre-builds free slots so later add() calls do not allocate.
+         * @param slots Minimum slotCount() to provide.
+         */
+        void reserve(size_t slots);
+
+        /**
+         * @brief Reports whether slot @p index holds a live server.
+         * @param index Slot to test.
+         * @return @c false for retired and never-used slots.
+         */
+        bool isLive(size_t index) const;
+
+        /**
+         * @brief Returns a counter that changes whenever the set of live servers does.
+         *
+         * @details Bumped by add(), retire() and restoreState(), so a policy
+         * that caches something derived from the membership can check it in
+         * O(1) per request.
+         *
+         * @return Membership version.
+         */
+        uint64_t membershipVersion() const;
+
+        /**
+         * @brief Issues a handle for the server in slot @p index.
+         * @param index Slot of a live server.
+         * @return Handle valid until the server is retired.
+         */
+        ServerHandle handle(size_t index) const;
+
+        /**
+         * @brief Maps a handle back to its slot.
+         * @param handle Handle from handle().
+         * @return Slot index, or -1 if the server has since been retired.
+         */
+        long resolve(ServerHandle handle) const;
+
+        /**
+         * @brief Finds the lowest-indexed idle server.
+         * @return Slot index, or -1 if every server is busy.
+         */
+        long firstIdle() const;
+
+        /**
+         * @brief Counts the idle servers.
+         * @return Number of set bits in the idle bitmap.
+         */
+        size_t idleCount() const;
+
+        /**
+         * @brief Reports whether the server in slot @p index is idle.
+         * @param index Slot to test.
+         * @return @c true if the server can accept a request.
+         */
+        bool isIdle(size_t index) const;
+
+        /**
+         * @brief Returns the id of the server in slot @p index.
+         * @param index Slot to read.
+         * @return Server identifier.
+         */
+        int getId(size_t index) const;
+
+        /**
+         * @brief Marks a server busy with @p request until @p completionTick.
+         *
+         * @param index          Slot of an idle server.
+         * @param request        Request the server starts processing.
+         * @param completionTick Tick during which the request finishes.
+         */
+        void assign(size_t index, const Request& request, int completionTick);
+
+        /**
+         * @brief Marks the server in slot @p index idle again.
+         * @param index Slot to release.
+         */
+        void release(size_t index);
+
+        /**
+         * @brief Builds a WebServer snapshot of one slot.
+         *
+         * @param index     Slot to inspect.
+         * @param clockTime Current tick, used to derive the remaining time.
+         * @return A WebServer with the slot's id, request and remaining time.
+         */
+        WebServer view(size_t index, int clockTime) const;
+
+        /**
+         * @brief Returns the request last assigned to slot @p index.
+         * @param index Slot to read; meaningful only while the server is busy.
+         * @return The in-flight request.
+         */
+        const Request& getRequest(size_t index) const;
+
+        /**
+         * @brief Sets how many requests each server's local queue can hold.
+         *
+         * @details Must be called while every local queue is empty; 0 (the
+         * default) disables local queues so only idle servers accept work.
+         *
+         * @param depth Capacity of each local queue; values above
+         *              @c MAX_LOCAL_QUEUE_DEPTH are clamped to it.
+         */
+        void setLocalQueueDepth(size_t depth);
+
+        /**
+         * @brief Returns the capacity of each local queue.
+         * @return Local queue depth.
+         */
+        size_t getLocalQueueDepth() const;
+
+        /**
+         * @brief Reports whether a server can take another request now.
+         * @param index Slot to test.
+         * @return @c true if it is idle or has room in its local queue.
+         */
+        bool canAccept(size_t index) const;
+
+        /**
+         * @brief Reports whether any server can take another request now.
+         * @return @c true if some slot satisfies canAccept().
+         */
+        bool hasCapacity() const;
+
+        /**
+         * @brief Appends a request to a busy server's local queue.
+         *
+         * @param index   Slot of the server.
+         * @param request Request to queue.
+         * @return @c false if the local queue is full.
+         */
+        bool pushLocal(size_t index, const Request& request);
+
+        /**
+         * @brief Removes the oldest request from a server's local queue.
+         *
+         * @param index   Slot of the server.
+         * @param request Receives the request.
+         * @return @c false if the local queue is empty.
+         */
+        bool popLocal(size_t index, Request& request);
+
+        /**
+         * @brief Returns the number of requests waiting in one local queue.
+         * @param index Slot to read.
+         * @return Local queue length.
+         */
+        size_t localQueueLength(size_t index) const;
+
+        /**
+         * @brief Returns the number of requests waiting in all local queues.
+         * @return Sum of the local queue lengths.
+         */
+        size_t localQueuedTotal() const;
+
+        /**
+         * @brief Returns the cycles of work a server has committed to.
+         *
+         * @param index     Slot to read.
+         * @param clockTime Current tick.
+         * @return Remaining time of the in-flight request plus the processing
+         *         times of everything in the local queue.
+         */
+        int outstandingWork(size_t index, int clockTime) const;
+
+        /**
+         * @brief Returns the number of requests a server has committed to.
+         * @param index Slot to read.
+         * @return In-flight request (0 or 1) plus the local queue length.
+         */
+        int outstandingRequests(size_t index) const;
+
+        /**
+         * @brief Returns a server's running average of assigned processing times.
+         * @param index Slot to read.
+         * @return Exponentially weighted mean, or 0 before the first assignment.
+         */
+        float serviceEstimate(size_t index) const;
+
+        /**
+         * @brief Writes every slot, the free list and the local queues to @p out.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the pool with the state read from @p in.
+         *
+         * @details The local queue depth comes from the snapshot, since the
+         * queued requests were laid out for it.
+         *
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed or its arrays disagree in length.
+         */
+        bool restoreState(SnapshotReader& in);
+
+    private:
+        std::vector<int> ids;              ///< Server identifiers.
+        std::vector<uint32_t> generations; ///< Bumped each time a slot is retired.
+        std::vector<uint64_t> liveBits;    ///< Bit i is set while slot i holds a server.
+        std::vector<uint32_t> freeSlots;   ///< Retired slots, most recent last.
+        size_t liveCount;                  ///< Number of live servers.
+        uint64_t membership;               ///< Membership version; see membershipVersion().
+        std::vector<int> completionTicks;  ///< Tick freeing each busy server (unused while idle).
+        std::vector<uint64_t> idleBits;    ///< Bit i is set while slot i is idle.
+        std::vector<Request> inFlight;     ///< Request each busy server is processing.
+        std::vector<float> serviceMeans;   ///< EWMA of processing times assigned to each server.
+
+        size_t localDepth;                 ///< Capacity of each local queue.
+        size_t localTotal;                 ///< Requests waiting in all local queues.
+        std::vector<Request> localRing;    ///< Local queues; slot i owns [i*depth, (i+1)*depth).
+        std::vector<uint16_t> localHead;   ///< Ring index of each local queue's oldest entry.
+        std::vector<uint16_t> localCount;  ///< Length of each local queue.
+        std::vector<int> queuedWork;       ///< Sum of processing times in each local queue.
+
+        /**
+         * @brief Sets or clears the idle bit for one slot.
+         * @param index Slot to update.
+         * @param idle  New state of the bit.
+         */
+        void setIdle(size_t index, bool idle);
+
+        /**
+         * @brief Sets or clears the live bit for one slot.
+         * @param index Slot to update.
+         * @param live  New state of the bit.
+         */
+        void setLive(size_t index, bool live);
+
+        /**
+         * @brief Appends one free slot to every array.
+         * @return Index of the new slot.
+         */
+        size_t appendSlot();
+};
+
+#endif
@@ -0,0 +1,515 @@
+/**
+ * @file simulation.cpp
+ * @brief Implementation of readSimulationConfig() and runSimulation().
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "simulation.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include "eventLog.h"
+#include "metricsServer.h"
+#include "snapshot.h"
+#include "switch.h"
+#include "traceReader.h"
+#include "trafficGenerator.h"
+
+/**
+ * @brief Reads the optional "Key: value" settings that follow the fixed ones.
+ *
+ * @details Keys and values are trimmed of surrounding whitespace. Lines
+ * without a ':' are ignored.
+ *
+ * @param configFile Open configuration stream positioned after the fixed settings.
+ * @return Map from setting name to its raw string value.
+ */
+static std::map<std::string, std::string> readOptionalSettings(std::ifstream& configFile) {
+    std::map<std::string, std::string> settings;
+    std::string line;
+
+    while (std::getline(configFile, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+
+        std::string key   = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+        key.erase(0, key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t\r") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        settings[key] = value;
+    }
+
+    return settings;
+}
+
+/**
+ * @brief Parses a comma-separated list of integers, e.g. @c "3,7".
+ * @param text List text; empty entries are skipped.
+ * @return The integers in order.
+ */
+static std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = std::min(text.find(',', start), text.size());
+        std::string entry = text.substr(start, comma - start);
+        if (entry.find_first_not_of(" \t") != std::string::npos) {
+            values.push_back(std::stoi(entry));
+        }
+        start = comma + 1;
+    }
+    return values;
+}
+
+/**
+ * @enum SettingType
+ * @brief Value syntax of a numeric optional setting.
+ */
+enum class SettingType {
+    INT,       ///< A whole number that fits an @c int.
+    REAL,      ///< A floating-point number.
+    SEED,      ///< A non-negative whole number that fits a @c uint64_t.
+    INT_LIST   ///< Comma-separated whole numbers, e.g. @c "3,7".
+};
+
+/**
+ * @struct NumericSetting
+ * @brief One optional setting whose value must be a number.
+ */
+struct NumericSetting {
+    const char* key;   ///< Setting name.
+    SettingType type;  ///< Expected syntax.
+};
+
+/// Every optional setting that is parsed as a number somewhere.
+static const NumericSetting NUMERIC_SETTINGS[] = {
+    {"Ban Duration", SettingType::INT},
+    {"Arrival Rate", SettingType::REAL},
+    {"Burst Rate", SettingType::REAL},
+    {"Calm Length", SettingType::REAL},
+    {"Burst Length", SettingType::REAL},
+    {"Pareto Shape", SettingType::REAL},
+    {"Random Seed", SettingType::SEED},
+    {"Local Queue Depth", SettingType::INT},
+    {"Target Wait", SettingType::INT},
+    {"Scale-Up Warm-Up", SettingType::INT},
+    {"Max Servers", SettingType::INT},
+    {"Queue Capacity", SettingType::INT},
+    {"CoDel Target", SettingType::INT},
+    {"CoDel Interval", SettingType::INT},
+    {"Priority Cutoffs", SettingType::INT_LIST},
+    {"Class Weights", SettingType::INT_LIST},
+    {"DRR Quantum", SettingType::INT},
+    {"Metrics Interval", SettingType::INT},
+    {"Metrics Port", SettingType::INT},
+    {"Sweep Seeds", SettingType::INT},
+    {"Sweep Threads", SettingType::INT},
+    {"Frontend Tick", SettingType::INT},
+    {"Frontend Health Retry", SettingType::INT},
+    {"Frontend Duration", SettingType::REAL},
+};
+
+/**
+ * @brief Tests whether all of @p text is one number of type @p type.
+ *
+ * @param text Trimmed value.
+ * @param type Expected syntax; lists are checked entry by entry.
+ * @return @c true if std::stoi(), std::stod() or std::stoull() would accept
+ *         the whole value without throwing.
+ */
+static bool isNumber(const std::string& text, SettingType type) {
+    if (type == SettingType::INT_LIST) {
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t comma = std::min(text.find(',', start), text.size());
+            std::string entry = text.substr(start, comma - start);
+            if (entry.find_first_not_of(" \t") != std::string::npos && !isNumber(entry, SettingType::INT)) {
+                return false;
+            }
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    size_t used = 0;
+    try {
+        if (type == SettingType::INT)
+            std::stoi(text, &used);
+        else if (type == SettingType::REAL)
+            std::stod(text, &used);
+        else if (text.find('-') == std::string::npos)
+            std::stoull(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return used != 0 && text.find_first_not_of(" \t", used) == std::string::npos;
+}
+
+/**
+ * @brief Drops every numeric optional setting whose value is not a number.
+ *
+ * @details Run once when the configuration is read, so the later
+ * std::stoi() and std::stod() calls, some of them on sweep worker threads,
+ * only ever see valid text. A dropped setting takes its default.
+ *
+ * @param settings Optional settings to check.
+ */
+static void validateNumericSettings(std::map<std::string, std::string>& settings) {
+    for (const NumericSetting& setting : NUMERIC_SETTINGS) {
+        auto it = settings.find(setting.key);
+        if (it != settings.end() && !isNumber(it->second, setting.type)) {
+            std::cerr << "WARNING: " << setting.key << " expects "
+                      << (setting.type == SettingType::INT_LIST ? "a list of numbers" : "a number")
+                      << ", got '" << it->second << "' — using the default." << std::endl;
+            settings.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief Parses the six positional settings, then the optional ones.
+ *
+ * @param path   Configuration file path.
+ * @param config Receives the configuration.
+ * @return @c false if the file is missing or a positional value is not a
+ *         number; a malformed numeric optional value is only warned about
+ *         and dropped.
+ */
+bool readSimulationConfig(const std::string& path, SimulationConfig& config) {
+    std::ifstream configFile(path);
+    if (!configFile) {
+        std::cerr << "ERROR: could not open configuration file '" << path << "'." << std::endl;
+        return false;
+    }
+
+    int* positional[] = {&config.initialServers, &config.clockCycles, &config.minThreshold,
+                         &config.maxThreshold, &config.cooldownTime, &config.maxProcessingTime};
+    for (int* value : positional) {
+        std::string line;
+        std::getline(configFile, line);
+        try {
+            *value = std::stoi(line.substr(line.find(":") + 1));
+        } catch (const std::exception&) {
+            std::cerr << "ERROR: expected 'Label: <int>' in " << path << ", got '" << line << "'." << std::endl;
+            return false;
+        }
+    }
+
+    config.settings = readOptionalSettings(configFile);
+    validateNumericSettings(config.settings);
+    return true;
+}
+
+/**
+ * @brief Loads the block list and sets the ban duration and rate-limit mode.
+ *
+ * @param firewall Firewall to configure.
+ * @param config   Configuration holding the settings.
+ * @param warn     Stream receiving warnings.
+ */
+void configureFirewall(Firewall& firewall, const SimulationConfig& config, std::ostream& warn) {
+    const std::map<std::string, std::string>& settings = config.settings;
+    if (settings.count("Blocklist File")) {
+        firewall.loadBlockList(settings.at("Blocklist File"), !config.quiet);
+    }
+    if (settings.count("Ban Duration")) {
+        firewall.setBanDuration(std::stoi(settings.at("Ban Duration")));
+    }
+    if (settings.count("Rate Limit Mode")) {
+        const std::string& mode = settings.at("Rate Limit Mode");
+        if (mode == "sliding")
+            firewall.setRateLimitMode(RateLimitMode::SLIDING_WINDOW);
+        else if (mode == "token")
+            firewall.setRateLimitMode(RateLimitMode::TOKEN_BUCKET);
+        else if (mode != "fixed")
+            warn << "WARNING: unknown Rate Limit Mode '" << mode << "' — using fixed." << std::endl;
+    }
+}
+
+/**
+ * @brief Sets up one simulation from @p config, runs it and totals the results.
+ *
+ * @details Follows the original start-up sequence:
+ *  -# Logs the configuration.
+ *  -# Works out the job classes, one load balancer each.
+ *  -# Opens the trace, if any, or builds the TrafficGenerator.
+ *  -# Creates @c initialServers WebServer objects for each load balancer and
+ *     pre-fills each queue with @c initialServers*100 generated requests,
+ *     unless a trace is being replayed.
+ *  -# Constructs the Switch, applies the optional settings and runs it.
+ *
+ * Configuration warnings go to @c std::cerr unless the run is quiet.
+ *
+ * @param config Run parameters.
+ * @param logger Logger for the run.
+ * @return Totals of the run.
+ */
+SimulationSummary runSimulation(const SimulationConfig& config, Logger& logger) {
+    const std::map<std::string, std::string>& settings = config.settings;
+    std::ostream silent(nullptr);
+    std::ostream& warn = config.quiet ? silent : std::cerr;
+
+    LOG_FILE(logger, LogLevel::INFO) << "Initial Servers: " << config.initialServers;
+    LOG_FILE(logger, LogLevel::INFO) << "Clock Cycles: " << config.clockCycles;
+    LOG_FILE(logger, LogLevel::INFO) << "Min Threshold: " << config.minThreshold;
+    LOG_FILE(logger, LogLevel::INFO) << "Max Threshold: " << config.maxThreshold;
+    LOG_FILE(logger, LogLevel::INFO) << "Cooldown Time: " << config.cooldownTime;
+    LOG_FILE(logger, LogLevel::INFO) << "Max Processing Time: " << config.maxProcessingTime;
+    for (const auto& setting : settings) {
+        LOG_FILE(logger, LogLevel::INFO) << setting.first << ": " << setting.second;
+    }
+
+    LOG_FILE(logger, LogLevel::INFO) << "";
+
+    std::vector<char> jobClasses;
+    for (char c : settings.count("Job Classes") ? settings.at("Job Classes") : std::string("P,S")) {
+        if (c != ',' && c != ' ' && std::find(jobClasses.begin(), jobClasses.end(), c) == jobClasses.end()) {
+            jobClasses.push_back(c);
+        }
+    }
+    if (jobClasses.empty()) {
+        warn << "WARNING: empty Job Classes — using P,S." << std::endl;
+        jobClasses = {'P', 'S'};
+    }
+
+    std::unique_ptr<TraceReader> trace;
+    if (settings.count("Trace File")) {
+        trace.reset(new TraceReader());
+        if (!trace->open(settings.at("Trace File"), !config.quiet)) {
+            trace.reset();
+        }
+    }
+    int initialRequests = trace ? 0 : config.initialServers * 100;
+
+    TrafficProfile profile;
+    profile.maxProcessTime = config.maxProcessingTime;
+    if (settings.count("Arrival Process") && !parseArrivalProcess(settings.at("Arrival Process"), profile.arrivals))
+        warn << "WARNING: unknown Arrival Process '" << settings.at("Arrival Process") << "' — using bernoulli." << std::endl;
+    if (settings.count("Arrival Rate"))
+        profile.arrivalRate = std::stod(settings.at("Arrival Rate"));
+    if (settings.count("Burst Rate"))
+        profile.burstRate = std::stod(settings.at("Burst Rate"));
+    if (settings.count("Calm Length"))
+        profile.calmLength = std::stod(settings.at("Calm Length"));
+    if (settings.count("Burst Length"))
+        profile.burstLength = std::stod(settings.at("Burst Length"));
+    if (settings.count("Process Time Distribution") && !parseServiceDistribution(settings.at("Process Time Distribution"), profile.service))
+        warn << "WARNING: unknown Process Time Distribution '" << settings.at("Process Time Distribution") << "' — using uniform." << std::endl;
+    if (settings.count("Pareto Shape"))
+        profile.paretoShape = std::stod(settings.at("Pareto Shape"));
+    uint64_t seed = settings.count("Random Seed") ? std::stoull(settings.at("Random Seed")) : 1;
+
+    std::unique_ptr<TrafficGenerator> generator;
+    if (!trace) {
+        generator.reset(new TrafficGenerator(profile, jobClasses, seed));
+    }
+
+    std::vector<std::queue<Request>> requestQueues(jobClasses.size());
+    std::vector<std::vector<WebServer>> webServers(jobClasses.size());
+
+    for (int i = 0; i < config.initialServers; i++) {
+        for (size_t k = 0; k < jobClasses.size(); k++) {
+            webServers[k].push_back(WebServer(i + static_cast<int>(k) * config.initialServers));
+        }
+    }
+
+    for (size_t k = 0; k < jobClasses.size(); k++) {
+        for (int i = 0; i < initialRequests; i++) {
+            requestQueues[k].push(generator->makeRequest(jobClasses[k]));
+        }
+    }
+
+    for (size_t k = 0; k < jobClasses.size(); k++) {
+        std::string name = jobClassName(jobClasses[k]);
+        name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+        LOG_FILE(logger, LogLevel::INFO) << "Initial " << name << " request queue populated with " << requestQueues[k].size() << " requests";
+    }
+    LOG_FILE(logger, LogLevel::INFO) << "";
+    for (size_t k = 0; k < jobClasses.size(); k++) {
+        std::string name = jobClassName(jobClasses[k]);
+        name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+        LOG_FILE(logger, LogLevel::INFO) << "Initial " << name << " servers available: " << webServers[k].size();
+    }
+    LOG_FILE(logger, LogLevel::INFO) << "";
+    if (trace)
+        LOG_FILE(logger, LogLevel::INFO) << "Requests are replayed from trace " << settings.at("Trace File");
+    else
+        LOG_FILE(logger, LogLevel::INFO) << "Traffic: " << generator->describe();
+    LOG_FILE(logger, LogLevel::INFO) << "";
+
+    std::unique_ptr<MetricsRegistry> metrics;
+    MetricsServer metricsServer;
+    EventLog eventLog;
+    Switch switch_(config.minThreshold, config.maxThreshold, config.cooldownTime, config.maxProcessingTime, !config.quiet);
+    for (size_t k = 0; k < jobClasses.size(); k++) {
+        switch_.addLoadBalancer(jobClasses[k], requestQueues[k], webServers[k]);
+    }
+
+    if (trace)
+        switch_.setTrafficSource(std::move(trace));
+    else
+        switch_.setTrafficSource(std::move(generator));
+
+    configureFirewall(switch_.getFirewall(), config, warn);
+
+    if (settings.count("Simulation Mode")) {
+        const std::string& mode = settings.at("Simulation Mode");
+        if (mode == "event")
+            switch_.setSimulationMode(SimulationMode::EVENT);
+        else if (mode != "tick")
+            warn << "WARNING: unknown Simulation Mode '" << mode << "' — using tick." << std::endl;
+    }
+
+    if (settings.count("Dispatch Policy")) {
+        DispatchPolicyKind kind;
+        if (parseDispatchPolicy(settings.at("Dispatch Policy"), kind))
+            switch_.setDispatchPolicy(kind);
+        else
+            warn << "WARNING: unknown Dispatch Policy '" << settings.at("Dispatch Policy") << "' — using first-idle." << std::endl;
+    }
+    if (settings.count("Local Queue Depth")) {
+        int depth = std::stoi(settings.at("Local Queue Depth"));
+        if (depth > 0 && static_cast<size_t>(depth) > ServerPool::MAX_LOCAL_QUEUE_DEPTH) {
+            warn << "WARNING: Local Queue Depth " << depth << " is above the limit of "
+                 << ServerPool::MAX_LOCAL_QUEUE_DEPTH << " — using " << ServerPool::MAX_LOCAL_QUEUE_DEPTH << "." << std::endl;
+        }
+        switch_.setLocalQueueDepth(depth > 0 ? static_cast<size_t>(depth) : 0);
+    }
+
+    if (settings.count("Scaling Mode") || settings.count("Target Wait") || settings.count("Scale-Up Warm-Up") || settings.count("Max Servers")) {
+        ScalingMode mode = ScalingMode::THRESHOLD;
+        if (settings.count("Scaling Mode") && !parseScalingMode(settings.at("Scaling Mode"), mode))
+            warn << "WARNING: unknown Scaling Mode '" << settings.at("Scaling Mode") << "' — using threshold." << std::endl;
+        int targetWait = settings.count("Target Wait") ? std::stoi(settings.at("Target Wait")) : 20;
+        int warmUp = settings.count("Scale-Up Warm-Up") ? std::stoi(settings.at("Scale-Up Warm-Up")) : 0;
+        int maxServers = settings.count("Max Servers") ? std::stoi(settings.at("Max Servers")) : 1000;
+        switch_.setScaling(mode, targetWait, warmUp, maxServers > 0 ? static_cast<size_t>(maxServers) : 1);
+    }
+
+    if (settings.count("Queue Capacity") || settings.count("Shedding Policy")) {
+        SheddingPolicy policy = SheddingPolicy::TAIL_DROP;
+        if (settings.count("Shedding Policy") && !parseSheddingPolicy(settings.at("Shedding Policy"), policy))
+            warn << "WARNING: unknown Shedding Policy '" << settings.at("Shedding Policy") << "' — using tail-drop." << std::endl;
+        int capacity = settings.count("Queue Capacity") ? std::stoi(settings.at("Queue Capacity")) : 0;
+        int target = settings.count("CoDel Target") ? std::stoi(settings.at("CoDel Target")) : 5;
+        int interval = settings.count("CoDel Interval") ? std::stoi(settings.at("CoDel Interval")) : 100;
+        switch_.setAdmissionControl(policy, capacity > 0 ? static_cast<size_t>(capacity) : 0, target, interval);
+    }
+    if (settings.count("Queue Discipline") || settings.count("Priority Cutoffs")) {
+        QueueDiscipline discipline = QueueDiscipline::FIFO;
+        if (settings.count("Queue Discipline") && !parseQueueDiscipline(settings.at("Queue Discipline"), discipline))
+            warn << "WARNING: unknown Queue Discipline '" << settings.at("Queue Discipline") << "' — using fifo." << std::endl;
+        std::vector<int> cutoffs = settings.count("Priority Cutoffs") ? parseIntList(settings.at("Priority Cutoffs"))
+                                                                      : std::vector<int>{config.maxProcessingTime / 2};
+        std::vector<int> weights = settings.count("Class Weights") ? parseIntList(settings.at("Class Weights")) : std::vector<int>();
+        if (!weights.empty() && weights.size() != cutoffs.size() + 1)
+            warn << "WARNING: Class Weights lists " << weights.size() << " weights for " << cutoffs.size() + 1
+                 << " priority classes — using 1 for any class without one." << std::endl;
+        int quantum = settings.count("DRR Quantum") ? std::stoi(settings.at("DRR Quantum")) : config.maxProcessingTime;
+        switch_.setQueueDiscipline(discipline, cutoffs, weights, quantum);
+    }
+    if (settings.count("Backpressure")) {
+        const std::string& mode = settings.at("Backpressure");
+        if (mode == "reject")
+            switch_.setBackpressure(BackpressureMode::REJECT);
+        else if (mode == "reroute")
+            switch_.setBackpressure(BackpressureMode::REROUTE);
+        else if (mode != "off")
+            warn << "WARNING: unknown Backpressure '" << mode << "' — using off." << std::endl;
+    }
+
+    if (settings.count("Parallel Load Balancers")) {
+        switch_.setParallel(settings.at("Parallel Load Balancers") == "on");
+    }
+
+    if (settings.count("Metrics File") || settings.count("Metrics Port")) {
+        metrics.reset(new MetricsRegistry());
+        switch_.setMetrics(*metrics);
+        if (settings.count("Metrics File")) {
+            int interval = settings.count("Metrics Interval") ? std::stoi(settings.at("Metrics Interval")) : 10000;
+            switch_.setMetricsExport(settings.at("Metrics File"), interval);
+        }
+        if (settings.count("Metrics Port") && metricsServer.start(std::stoi(settings.at("Metrics Port")), *metrics) && !config.quiet) {
+            std::cout << "[Metrics] Serving http://127.0.0.1:" << metricsServer.getPort() << "/metrics" << std::endl;
+        }
+    }
+
+    if (settings.count("Event Log")) {
+        if (eventLog.open(settings.at("Event Log")))
+            switch_.setEventLog(eventLog);
+        else
+            warn << "WARNING: could not create Event Log '" << settings.at("Event Log") << "' — logging events as text." << std::endl;
+    }
+
+    // The snapshot is restored last, into a Switch configured like the one
+    // that saved it. A copy of the fresh state is kept to fall back on, since
+    // a restore that fails part-way leaves the state mixed.
+    if (settings.count("Snapshot Load")) {
+        const std::string& path = settings.at("Snapshot Load");
+        SnapshotWriter fresh;
+        switch_.saveState(fresh);
+
+        SnapshotFile file;
+        std::string error;
+        bool restored = file.open(path, error);
+        if (restored) {
+            SnapshotReader reader = file.reader();
+            restored = switch_.restoreState(reader) && reader.remaining() == 0;
+            if (!restored)
+                error = "it does not match this configuration";
+        }
+        if (restored) {
+            LOG_FILE(logger, LogLevel::INFO) << "Restored snapshot " << path << " at clock " << switch_.getClockTime();
+        } else {
+            SnapshotReader rollback(fresh.payload().data(), fresh.payload().size());
+            switch_.restoreState(rollback);
+            warn << "WARNING: could not restore snapshot '" << path << "': " << error << " — starting from the initial state." << std::endl;
+        }
+    }
+
+    switch_.run(config.clockCycles, logger);
+    metricsServer.stop();
+
+    if (settings.count("Snapshot Save")) {
+        SnapshotWriter snapshot;
+        switch_.saveState(snapshot);
+        if (snapshot.writeFile(settings.at("Snapshot Save")))
+            LOG_FILE(logger, LogLevel::INFO) << "Saved snapshot " << settings.at("Snapshot Save") << " at clock " << switch_.getClockTime();
+        else
+            warn << "WARNING: could not write snapshot '" << settings.at("Snapshot Save") << "'." << std::endl;
+    }
+
+    if (eventLog.isOpen()) {
+        uint64_t records = eventLog.getRecordCount();
+        if (eventLog.close())
+            LOG_FILE(logger, LogLevel::INFO) << "Event log " << settings.at("Event Log") << ": " << records << " records";
+        else
+            warn << "WARNING: error writing Event Log '" << settings.at("Event Log") << "'." << std::endl;
+    }
+
+    SimulationSummary summary;
+    for (const LoadBalancer& balancer : switch_.getLoadBalancers()) {
+        summary.completed += balancer.getSojournTimes().count();
+        summary.remaining += static_cast<uint64_t>(balancer.getQueueSize());
+        summary.serverCycles += balancer.getServerCycles();
+        summary.peakServers += balancer.getPeakServers();
+        summary.shed += balancer.getShedCounts().total();
+        summary.waitTimes.merge(balancer.getWaitTimes());
+        summary.sojournTimes.merge(balancer.getSojournTimes());
+    }
+    summary.blocked = static_cast<uint64_t>(switch_.getFirewall().getTotalBlocked());
+    summary.rejected = static_cast<uint64_t>(switch_.getRejectedRequests());
+    summary.unrouted = static_cast<uint64_t>(switch_.getUnroutedRequests());
+    return summary;
+}
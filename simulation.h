@@ -0,0 +1,104 @@
+/**
+ * @file simulation.h
+ * @brief Declaration of SimulationConfig and runSimulation(), one complete simulation run.
+ *
+ * @details Everything main() used to do between reading config.txt and
+ * running the Switch lives here, so that the same setup can be run once
+ * for a normal invocation or many times, concurrently, by the SweepRunner.
+ * A run shares no state with any other: it builds its own Switch, traffic
+ * source and server pools from the configuration it is given.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include "latencyHistogram.h"
+#include "logger.h"
+
+class Firewall;
+
+/**
+ * @struct SimulationConfig
+ * @brief Parameters of one run: the six positional settings plus the optional ones.
+ */
+struct SimulationConfig {
+    int initialServers = 10;      ///< Servers each load balancer starts with.
+    int clockCycles = 10000;      ///< Length of the run.
+    int minThreshold = 50;        ///< Per-server queue lower bound for deallocation.
+    int maxThreshold = 80;        ///< Per-server queue upper bound for allocation.
+    int cooldownTime = 5;         ///< Cycles between scaling checks.
+    int maxProcessingTime = 10;   ///< Upper bound on generated processing times.
+    std::map<std::string, std::string> settings; ///< Optional "Key: value" settings.
+
+    /**
+     * @brief Suppresses console messages and configuration warnings.
+     *
+     * @details Used for all but the first run of a sweep, which would
+     * otherwise repeat the same start-up messages once per run.
+     */
+    bool quiet = false;
+};
+
+/**
+ * @struct SimulationSummary
+ * @brief Totals of one run across all load balancers.
+ */
+struct SimulationSummary {
+    uint64_t completed = 0;       ///< Requests that finished processing.
+    uint64_t remaining = 0;       ///< Requests still queued at the end.
+    uint64_t serverCycles = 0;    ///< Server-cycles provisioned.
+    uint64_t peakServers = 0;     ///< Sum of each load balancer's peak pool size.
+    uint64_t blocked = 0;         ///< Requests dropped by the firewall.
+    uint64_t shed = 0;            ///< Requests shed by admission control.
+    uint64_t rejected = 0;        ///< Requests rejected by backpressure.
+    uint64_t unrouted = 0;        ///< Requests with no load balancer for their class.
+    LatencyHistogram waitTimes;   ///< Merged enqueue-to-dispatch times.
+    LatencyHistogram sojournTimes; ///< Merged enqueue-to-completion times.
+};
+
+/**
+ * @brief Reads a configuration file in the config.txt format.
+ *
+ * @details The first six lines are read positionally as "Label: value";
+ * every later "Key: value" line becomes an optional setting. Optional
+ * settings that take a number are checked here; one that does not parse
+ * is reported on @c std::cerr and removed, so it falls back to its default.
+ *
+ * @param path   Path of the configuration file.
+ * @param config Receives the parsed configuration.
+ * @return @c false (after printing an error) if the file could not be opened
+ *         or a positional setting is missing or not a number.
+ */
+bool readSimulationConfig(const std::string& path, SimulationConfig& config);
+
+/**
+ * @brief Builds the load balancers, traffic source and Switch for @p config and runs it.
+ *
+ * @details Logs the configuration and initial state, applies every optional
+ * setting, runs the Switch for @c clockCycles and returns its totals.
+ *
+ * @param config Run parameters.
+ * @param logger Logger for the run; an empty-path Logger at LogLevel::OFF
+ *               keeps it silent.
+ * @return Totals of the run.
+ */
+SimulationSummary runSimulation(const SimulationConfig& config, Logger& logger);
+
+/**
+ * @brief Applies the @c "Blocklist File", @c "Ban Duration" and
+ *        @c "Rate Limit Mode" settings of @p config to @p firewall.
+ *
+ * @param firewall Firewall to configure.
+ * @param config   Configuration holding the settings.
+ * @param warn     Stream receiving warnings about unknown values.
+ */
+void configureFirewall(Firewall& firewall, const SimulationConfig& config, std::ostream& warn);
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * @file snapshot.cpp
+ * @brief Implementation of SnapshotWriter, SnapshotReader and SnapshotFile.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "snapshot.h"
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'L', 'B', 'S', 'N', 'A', 'P', '0', '1'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @struct SnapshotHeader
+ * @brief First 32 bytes of a snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];          ///< @c "LBSNAP01".
+    uint32_t byteOrder;     ///< @c BYTE_ORDER_MARK as written by the saving host.
+    uint32_t reserved;      ///< Zero.
+    uint64_t payloadBytes;  ///< Length of the payload that follows.
+    uint64_t checksum;      ///< FNV-1a hash of the payload.
+};
+static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader must stay 32 bytes");
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of @p size bytes.
+ * @param data Bytes to hash.
+ * @param size Number of bytes.
+ * @return Hash value.
+ */
+uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+/**
+ * @brief Appends the first four characters of @p tag.
+ * @param tag Section tag.
+ */
+void SnapshotWriter::putTag(const char* tag) {
+    bytes.append(tag, 4);
+}
+
+/**
+ * @brief Appends a 64-bit length and the string's bytes.
+ * @param text String to write.
+ */
+void SnapshotWriter::putString(const std::string& text) {
+    putArray(text.data(), text.size());
+}
+
+/**
+ * @brief Embeds @p nested as a byte array.
+ * @param nested Payload to embed.
+ */
+void SnapshotWriter::putBlob(const SnapshotWriter& nested) {
+    putArray(nested.bytes.data(), nested.bytes.size());
+}
+
+/**
+ * @brief Returns the payload.
+ * @return @c bytes.
+ */
+const std::string& SnapshotWriter::payload() const {
+    return bytes;
+}
+
+/**
+ * @brief Writes header and payload to a temporary file and renames it over @p path.
+ * @param path Destination file.
+ * @return @c true on success.
+ */
+bool SnapshotWriter::writeFile(const std::string& path) const {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.payloadBytes = bytes.size();
+    header.checksum = fnv1a(bytes.data(), bytes.size());
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Pads to the next multiple of 8 bytes.
+ */
+void SnapshotWriter::align() {
+    bytes.append((8 - bytes.size() % 8) % 8, '\0');
+}
+
+/**
+ * @brief Constructs a reader over @p size bytes at @p data.
+ * @param data Payload start.
+ * @param size Payload length.
+ */
+SnapshotReader::SnapshotReader(const char* data, size_t size) : data(data), size(size), pos(0), failed(false) {}
+
+/**
+ * @brief Reads four bytes and compares them with @p tag.
+ * @param tag Expected tag.
+ * @return @c true if they match.
+ */
+bool SnapshotReader::expectTag(const char* tag) {
+    const char* source = take(4);
+    if (source == nullptr || std::memcmp(source, tag, 4) != 0) {
+        return fail();
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a string written by SnapshotWriter::putString().
+ * @param text Receives the string.
+ * @return @c true on success.
+ */
+bool SnapshotReader::getString(std::string& text) {
+    std::vector<char> characters;
+    if (!getArray(characters)) {
+        return false;
+    }
+    text.assign(characters.begin(), characters.end());
+    return true;
+}
+
+/**
+ * @brief Reads a blob and points @p nested at its bytes, without copying them.
+ * @param nested Receives the reader.
+ * @return @c true on success.
+ */
+bool SnapshotReader::getBlob(SnapshotReader& nested) {
+    uint64_t count = 0;
+    if (!get(count) || !align() || count > size - pos) {
+        return fail();
+    }
+    nested = SnapshotReader(take(static_cast<size_t>(count)), static_cast<size_t>(count));
+    return align();
+}
+
+/**
+ * @brief Reports whether no read has failed.
+ * @return @c !failed.
+ */
+bool SnapshotReader::ok() const {
+    return !failed;
+}
+
+/**
+ * @brief Returns the unread byte count.
+ * @return @c size - @c pos.
+ */
+size_t SnapshotReader::remaining() const {
+    return size - pos;
+}
+
+/**
+ * @brief Sets the failure flag.
+ * @return @c false.
+ */
+bool SnapshotReader::fail() {
+    failed = true;
+    return false;
+}
+
+/**
+ * @brief Consumes @p count bytes if they are available.
+ * @param count Bytes wanted.
+ * @return Pointer to them, or @c nullptr.
+ */
+const char* SnapshotReader::take(size_t count) {
+    if (failed || count > size - pos) {
+        fail();
+        return nullptr;
+    }
+    const char* source = data + pos;
+    pos += count;
+    return source;
+}
+
+/**
+ * @brief Skips padding to the next multiple of 8 bytes.
+ * @return @c true on success.
+ */
+bool SnapshotReader::align() {
+    return take((8 - pos % 8) % 8) != nullptr;
+}
+
+/**
+ * @brief Constructs an object with no file.
+ */
+SnapshotFile::SnapshotFile() : data(nullptr), length(0) {}
+
+/**
+ * @brief Releases the mapping.
+ */
+SnapshotFile::~SnapshotFile() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+/**
+ * @brief Maps @p path read-only and validates the header and checksum.
+ *
+ * @param path  Snapshot file.
+ * @param error Receives the reason on failure.
+ * @return @c true on success.
+ */
+bool SnapshotFile::open(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open file";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        error = "not a snapshot file";
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map file";
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapping);
+    length = size;
+
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not a snapshot file";
+        return false;
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        error = "written on a host with a different byte order";
+        return false;
+    }
+    if (header.payloadBytes != length - sizeof(header)) {
+        error = "file is truncated";
+        return false;
+    }
+    if (fnv1a(data + sizeof(header), length - sizeof(header)) != header.checksum) {
+        error = "checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a reader over the payload.
+ * @return Reader, empty if no file is mapped.
+ */
+SnapshotReader SnapshotFile::reader() const {
+    if (data == nullptr || length < sizeof(SnapshotHeader)) {
+        return SnapshotReader();
+    }
+    return SnapshotReader(data + sizeof(SnapshotHeader), length - sizeof(SnapshotHeader));
+}
@@ -0,0 +1,269 @@
+/**
+ * @file snapshot.h
+ * @brief Declaration of SnapshotWriter, SnapshotReader and SnapshotFile, the
+ *        serialisation used to save and restore a simulation's state.
+ *
+ * @details A snapshot captures everything a Switch needs to pick a run up
+ * where it stopped: the clock, every LoadBalancer's queue, server pool,
+ * completion wheel, statistics and scaler state, the Firewall's rate and ban
+ * tables and the traffic source's position. Components write themselves
+ * with a saveState() method and read themselves back, in the same order,
+ * with restoreState().
+ *
+ * <b>File format</b> — host byte order, which the header records:
+ * @code
+ * char magic[8] = "LBSNAP01" | uint32 0x01020304 | uint32 reserved | uint64 payload bytes | uint64 FNV-1a of the payload
+ * @endcode
+ * The payload is a sequence of fixed-size values, length-prefixed strings
+ * and arrays. Array elements start on an 8-byte boundary, so large arrays
+ * (queued requests, pool columns, histogram buckets) can be read straight
+ * out of the mapped file. Four-character tags open each component's
+ * section, so a file restored into the wrong shape fails early and with a
+ * clear message.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class SnapshotWriter
+ * @brief Appends values to an in-memory snapshot payload.
+ */
+class SnapshotWriter {
+    public:
+        /**
+         * @brief Appends a trivially copyable value as raw bytes.
+         * @param value Value to write.
+         */
+        template <typename T>
+        void put(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /**
+         * @brief Appends a section tag.
+         * @param tag Four characters naming the section, e.g. @c "FWLL".
+         */
+        void putTag(const char* tag);
+
+        /**
+         * @brief Appends a length-prefixed string.
+         * @param text String to write.
+         */
+        void putString(const std::string& text);
+
+        /**
+         * @brief Appends an element count followed by the elements, 8-byte aligned.
+         * @param data  First element.
+         * @param count Number of elements.
+         */
+        template <typename T>
+        void putArray(const T* data, size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot arrays must be trivially copyable");
+            put(static_cast<uint64_t>(count));
+            align();
+            bytes.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+            align();
+        }
+
+        /**
+         * @brief Appends the contents of a vector as an array.
+         * @param values Elements to write.
+         */
+        template <typename T>
+        void putArray(const std::vector<T>& values) {
+            putArray(values.data(), values.size());
+        }
+
+        /**
+         * @brief Appends another writer's payload as a length-prefixed blob.
+         *
+         * @details Lets a reader skip a section it cannot interpret, e.g. the
+         * state of a dispatch policy other than the one now configured.
+         *
+         * @param nested Payload to embed.
+         */
+        void putBlob(const SnapshotWriter& nested);
+
+        /**
+         * @brief Returns the payload written so far.
+         * @return Payload bytes.
+         */
+        const std::string& payload() const;
+
+        /**
+         * @brief Writes the header and payload to @p path, replacing it atomically.
+         * @param path Destination file; written as @c path.tmp and renamed.
+         * @return @c false if the file could not be written.
+         */
+        bool writeFile(const std::string& path) const;
+
+    private:
+        std::string bytes;  ///< Payload.
+
+        /**
+         * @brief Pads the payload with zeros to a multiple of 8 bytes.
+         */
+        void align();
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Reads values back from a snapshot payload in the order they were written.
+ *
+ * @details Failure is sticky: once a read runs past the end or a tag does
+ * not match, every later read fails too and ok() returns @c false, so
+ * restoreState() methods can read a whole section and check once.
+ */
+class SnapshotReader {
+    public:
+        /**
+         * @brief Reads from @p size bytes at @p data, which must outlive the reader.
+         * @param data Payload start.
+         * @param size Payload length.
+         */
+        SnapshotReader(const char* data = nullptr, size_t size = 0);
+
+        /**
+         * @brief Reads a trivially copyable value.
+         * @param value Receives the value.
+         * @return @c false on failure.
+         */
+        template <typename T>
+        bool get(T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+            const char* source = take(sizeof(T));
+            if (source != nullptr) {
+                std::memcpy(&value, source, sizeof(T));
+            }
+            return source != nullptr;
+        }
+
+        /**
+         * @brief Reads a section tag and fails unless it equals @p tag.
+         * @param tag Expected four characters.
+         * @return @c false on failure.
+         */
+        bool expectTag(const char* tag);
+
+        /**
+         * @brief Reads a length-prefixed string.
+         * @param text Receives the string.
+         * @return @c false on failure.
+         */
+        bool getString(std::string& text);
+
+        /**
+         * @brief Reads an array into @p values, replacing their contents.
+         * @param values Receives the elements.
+         * @return @c false on failure.
+         */
+        template <typename T>
+        bool getArray(std::vector<T>& values) {
+            uint64_t count = 0;
+            if (!get(count) || !align() || count > (size - pos) / sizeof(T)) {
+                return fail();
+            }
+            const char* source = take(static_cast<size_t>(count) * sizeof(T));
+            values.resize(static_cast<size_t>(count));
+            if (count > 0) {
+                std::memcpy(values.data(), source, static_cast<size_t>(count) * sizeof(T));
+            }
+            return align();
+        }
+
+        /**
+         * @brief Reads a blob written with SnapshotWriter::putBlob().
+         * @param nested Receives a reader over the blob's bytes.
+         * @return @c false on failure.
+         */
+        bool getBlob(SnapshotReader& nested);
+
+        /**
+         * @brief Reports whether every read so far succeeded.
+         * @return @c true if no read has failed.
+         */
+        bool ok() const;
+
+        /**
+         * @brief Returns the bytes not yet read.
+         * @return Remaining length.
+         */
+        size_t remaining() const;
+
+        /**
+         * @brief Marks the reader failed, e.g. after reading an inconsistent value.
+         * @return @c false, for use in return statements.
+         */
+        bool fail();
+
+    private:
+        const char* data;  ///< Payload start.
+        size_t size;       ///< Payload length.
+        size_t pos;        ///< Read position.
+        bool failed;       ///< Sticky failure flag.
+
+        /**
+         * @brief Consumes @p count bytes.
+         * @param count Bytes wanted.
+         * @return Their start, or @c nullptr (and the reader fails) if too few remain.
+         */
+        const char* take(size_t count);
+
+        /**
+         * @brief Skips the padding up to the next multiple of 8 bytes.
+         * @return @c false on failure.
+         */
+        bool align();
+};
+
+/**
+ * @class SnapshotFile
+ * @brief Read-only memory mapping of a snapshot file with its header verified.
+ */
+class SnapshotFile {
+    public:
+        /**
+         * @brief Constructs an object with no file.
+         */
+        SnapshotFile();
+
+        /**
+         * @brief Releases the mapping, if any.
+         */
+        ~SnapshotFile();
+
+        SnapshotFile(const SnapshotFile&) = delete;
+        SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+        /**
+         * @brief Maps @p path and checks its header and checksum.
+         * @param path  Snapshot file.
+         * @param error Receives a description of the problem on failure.
+         * @return @c false if the file is unreadable, truncated or corrupt.
+         */
+        bool open(const std::string& path, std::string& error);
+
+        /**
+         * @brief Returns a reader positioned at the start of the payload.
+         * @return Reader over the mapping; valid while this object lives.
+         */
+        SnapshotReader reader() const;
+
+    private:
+        const char* data;  ///< Start of the mapping, or @c nullptr.
+        size_t length;     ///< Size of the mapping.
+};
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file sweepRunner.cpp
+ * @brief Implementation of the SweepRunner class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "sweepRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "logger.h"
+
+/**
+ * @brief Parses a whole string as a number.
+ *
+ * @param text  Text, possibly with surrounding spaces.
+ * @param value Receives the number.
+ * @return @c true if @p text was a number and nothing else.
+ */
+static bool parseNumber(const std::string& text, double& value) {
+    try {
+        size_t used = 0;
+        value = std::stod(text, &used);
+        return text.find_first_not_of(" \t", used) == std::string::npos && std::isfinite(value);
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Expands each comma-separated item; ranges are inclusive of @c b
+ *        up to rounding.
+ *
+ * @param text   Value list.
+ * @param values Receives the values.
+ * @return @c true if every item parsed.
+ */
+bool parseSweepValues(const std::string& text, std::vector<double>& values) {
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        size_t dots = item.find("..");
+        if (dots == std::string::npos) {
+            double value;
+            if (!parseNumber(item, value)) return false;
+            values.push_back(value);
+            continue;
+        }
+
+        std::string last = item.substr(dots + 2);
+        std::string step = "1";
+        size_t colon = last.find(':');
+        if (colon != std::string::npos) {
+            step = last.substr(colon + 1);
+            last.erase(colon);
+        }
+        double from, to, by;
+        if (!parseNumber(item.substr(0, dots), from) || !parseNumber(last, to) || !parseNumber(step, by) ||
+                by <= 0.0 || to < from) {
+            return false;
+        }
+        size_t count = static_cast<size_t>(std::floor((to - from) / by + 1e-9)) + 1;
+        for (size_t i = 0; i < count; i++) {
+            values.push_back(from + static_cast<double>(i) * by);
+        }
+    }
+    return !values.empty();
+}
+
+/**
+ * @brief Checks for keys starting with @c "Sweep ".
+ * @param config Configuration.
+ * @return @c true if one is present.
+ */
+bool SweepRunner::isSweep(const SimulationConfig& config) {
+    auto it = config.settings.lower_bound("Sweep ");
+    return it != config.settings.end() && it->first.compare(0, 6, "Sweep ") == 0;
+}
+
+/**
+ * @brief Stores the base configuration; the sweep itself is parsed by run().
+ * @param config Base configuration.
+ */
+SweepRunner::SweepRunner(const SimulationConfig& config)
+    : base(config),
+      replicates(1),
+      baseSeed(1),
+      threads(1)
+{
+}
+
+/**
+ * @brief Runs the grid on a pool of threads that claim run numbers from a
+ *        shared counter, then writes the rows in run order.
+ *
+ * @details Every run gets its own Switch, traffic source and servers, so
+ * the only shared state is the counter, the row slots (each written by one
+ * thread) and a Logger that is switched off.
+ *
+ * @return @c true on success.
+ */
+bool SweepRunner::run() {
+    if (!parse()) {
+        return false;
+    }
+
+    std::ofstream output(outputPath, std::ios::out | std::ios::trunc);
+    if (!output) {
+        std::cerr << "ERROR: could not open sweep output '" << outputPath << "'." << std::endl;
+        return false;
+    }
+
+    size_t combinations = 1;
+    for (const Axis& axis : axes) {
+        combinations *= axis.values.size();
+    }
+    size_t total = combinations * static_cast<size_t>(replicates);
+    unsigned workerCount = static_cast<unsigned>(std::min<size_t>(threads, total));
+    std::cout << "[Sweep] " << total << " runs (" << combinations << " combinations x " << replicates
+              << " seeds) on " << workerCount << (workerCount == 1 ? " thread" : " threads") << std::endl;
+
+    Logger silent("", LogLevel::OFF, false);
+    std::vector<std::string> rows(total);
+    std::atomic<size_t> nextRun(0);
+    auto worker = [&]() {
+        for (size_t index = nextRun.fetch_add(1); index < total; index = nextRun.fetch_add(1)) {
+            SimulationConfig config = configFor(index);
+            config.quiet = index != 0;
+            auto start = std::chrono::steady_clock::now();
+            SimulationSummary summary = runSimulation(config, silent);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            rows[index] = formatRow(index, summary, elapsed.count());
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < workerCount; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    output << "run";
+    for (const Axis& axis : axes) {
+        output << ',' << axis.column;
+    }
+    output << ",seed,completed,blocked,shed,rejected,unrouted,remaining,server_cycles,peak_servers,"
+              "wait_mean,wait_p50,wait_p99,sojourn_mean,sojourn_p50,sojourn_p99,sojourn_p999,wall_ms\n";
+    for (const std::string& row : rows) {
+        output << row << '\n';
+    }
+    output.close();
+    if (!output) {
+        std::cerr << "ERROR: could not write sweep output '" << outputPath << "'." << std::endl;
+        return false;
+    }
+
+    std::cout << "[Sweep] Wrote " << total << " rows to " << outputPath << " in " << elapsed.count() << " s" << std::endl;
+    return true;
+}
+
+/**
+ * @brief Builds the axes from the sweep settings, in a fixed order, and
+ *        reads the replicate, thread and output settings.
+ *
+ * @details Unknown @c "Sweep ..." keys are warned about and ignored.
+ *
+ * @return @c true if every value list parsed.
+ */
+bool SweepRunner::parse() {
+    static const struct {
+        const char* key;
+        const char* column;
+        int SimulationConfig::*field;
+        const char* setting;
+    } SWEEPABLE[] = {
+        {"Sweep Initial Servers", "initial_servers", &SimulationConfig::initialServers, ""},
+        {"Sweep Min Threshold",   "min_threshold",   &SimulationConfig::minThreshold,   ""},
+        {"Sweep Max Threshold",   "max_threshold",   &SimulationConfig::maxThreshold,   ""},
+        {"Sweep Cooldown Time",   "cooldown_time",   &SimulationConfig::cooldownTime,   ""},
+        {"Sweep Arrival Rate",    "arrival_rate",    nullptr,                           "Arrival Rate"},
+    };
+
+    const std::map<std::string, std::string>& settings = base.settings;
+    for (const auto& sweepable : SWEEPABLE) {
+        auto it = settings.find(sweepable.key);
+        if (it == settings.end()) {
+            continue;
+        }
+
+        Axis axis{sweepable.column, sweepable.field, sweepable.setting, {}};
+        if (!parseSweepValues(it->second, axis.values)) {
+            std::cerr << "ERROR: invalid " << sweepable.key << " '" << it->second
+                      << "' — expected values like '10, 20..40:10'." << std::endl;
+            return false;
+        }
+        if (axis.field != nullptr) {
+            for (double value : axis.values) {
+                if (value != std::floor(value) || std::fabs(value) > 1e9) {
+                    std::cerr << "ERROR: " << sweepable.key << " values must be integers, got " << value << "." << std::endl;
+                    return false;
+                }
+            }
+        }
+        axes.push_back(axis);
+    }
+
+    for (const auto& setting : settings) {
+        if (setting.first.compare(0, 6, "Sweep ") != 0) {
+            continue;
+        }
+        bool known = setting.first == "Sweep Seeds" || setting.first == "Sweep Threads" || setting.first == "Sweep Output";
+        for (const auto& sweepable : SWEEPABLE) {
+            known = known || setting.first == sweepable.key;
+        }
+        if (!known) {
+            std::cerr << "WARNING: unknown sweep setting '" << setting.first << "' — ignoring." << std::endl;
+        }
+    }
+
+    for (const char* key : {"Metrics File", "Metrics Port", "Event Log", "Snapshot Save", "Snapshot Load", "Frontend Listen"}) {
+        if (settings.count(key)) {
+            std::cerr << "WARNING: " << key << " is not supported in sweep mode — ignoring." << std::endl;
+            base.settings.erase(key);
+        }
+    }
+
+    if (settings.count("Sweep Arrival Rate")) {
+        auto process = settings.find("Arrival Process");
+        if (process == settings.end())
+            base.settings["Arrival Process"] = "poisson";
+        else if (process->second == "bernoulli")
+            std::cerr << "WARNING: Sweep Arrival Rate has no effect on bernoulli arrivals." << std::endl;
+    }
+
+    replicates = settings.count("Sweep Seeds") ? std::stoi(settings.at("Sweep Seeds")) : 1;
+    if (replicates < 1) {
+        std::cerr << "WARNING: Sweep Seeds must be at least 1 — using 1." << std::endl;
+        replicates = 1;
+    }
+    baseSeed = settings.count("Random Seed") ? std::stoull(settings.at("Random Seed")) : 1;
+
+    int requested = settings.count("Sweep Threads") ? std::stoi(settings.at("Sweep Threads")) : 0;
+    threads = requested > 0 ? static_cast<unsigned>(requested) : std::max(1u, std::thread::hardware_concurrency());
+
+    outputPath = settings.count("Sweep Output") ? settings.at("Sweep Output") : "sweep.csv";
+    return true;
+}
+
+/**
+ * @brief Applies the axis values and replicate seed of run @p index.
+ * @param index Run number.
+ * @return Configuration of the run.
+ */
+SimulationConfig SweepRunner::configFor(size_t index) const {
+    SimulationConfig config = base;
+    std::vector<double> chosen = valuesFor(index);
+    for (size_t a = 0; a < axes.size(); a++) {
+        const Axis& axis = axes[a];
+        double value = chosen[a];
+        if (axis.field != nullptr) {
+            config.*axis.field = static_cast<int>(value);
+        } else {
+            std::ostringstream text;
+            text.precision(17);
+            text << value;
+            config.settings[axis.setting] = text.str();
+        }
+    }
+    config.settings["Random Seed"] = std::to_string(baseSeed + index % static_cast<size_t>(replicates));
+    return config;
+}
+
+/**
+ * @brief Decodes @p index as a mixed-radix number, the last axis least significant.
+ * @param index Run number.
+ * @return Value of each axis.
+ */
+std::vector<double> SweepRunner::valuesFor(size_t index) const {
+    std::vector<double> chosen(axes.size());
+    size_t rest = index / static_cast<size_t>(replicates);
+    for (size_t a = axes.size(); a-- > 0;) {
+        chosen[a] = axes[a].values[rest % axes[a].values.size()];
+        rest /= axes[a].values.size();
+    }
+    return chosen;
+}
+
+/**
+ * @brief Writes the run's parameters followed by its totals and latency figures.
+ *
+ * @param index   Run number.
+ * @param summary Totals of the run.
+ * @param wallMs  Wall-clock time in milliseconds.
+ * @return CSV row.
+ */
+std::string SweepRunner::formatRow(size_t index, const SimulationSummary& summary, double wallMs) const {
+    std::ostringstream row;
+    row << index;
+    for (double value : valuesFor(index)) {
+        row << ',' << value;
+    }
+    row << ',' << baseSeed + index % static_cast<size_t>(replicates)
+        << ',' << summary.completed << ',' << summary.blocked << ',' << summary.shed
+        << ',' << summary.rejected << ',' << summary.unrouted << ',' << summary.remaining
+        << ',' << summary.serverCycles << ',' << summary.peakServers
+        << ',' << summary.waitTimes.mean() << ',' << summary.waitTimes.percentile(50)
+        << ',' << summary.waitTimes.percentile(99)
+        << ',' << summary.sojournTimes.mean() << ',' << summary.sojournTimes.percentile(50)
+        << ',' << summary.sojournTimes.percentile(99) << ',' << summary.sojournTimes.percentile(99.9);
+    row.precision(1);
+    row << std::fixed << ',' << wallMs;
+    return row.str();
+}
@@ -0,0 +1,127 @@
+/**
+ * @file sweepRunner.h
+ * @brief Declaration of the SweepRunner class, which runs a grid of simulations in parallel.
+ *
+ * @details A sweep is requested by adding @c "Sweep ..." settings to
+ * config.txt. Each names a parameter and the values to try:
+ *  - @c "Sweep Initial Servers", @c "Sweep Min Threshold",
+ *    @c "Sweep Max Threshold", @c "Sweep Cooldown Time" — integer values of
+ *    the positional settings.
+ *  - @c "Sweep Arrival Rate" — values of @c "Arrival Rate"; selects the
+ *    Poisson process unless @c "Arrival Process" is set.
+ *
+ * Values are comma-separated numbers or inclusive ranges @c "a..b" or
+ * @c "a..b:step" (default step 1), e.g. @c "50..80:10, 100". Every
+ * combination of the swept values (their Cartesian product) is run
+ * @c "Sweep Seeds" times (default 1) with seeds @c "Random Seed" + 0, 1, ...,
+ * so each combination sees the same traffic in each replicate. Unswept
+ * parameters keep their configured values.
+ *
+ * Runs are independent and are executed on @c "Sweep Threads" worker threads
+ * (default: one per hardware thread), each taking the next unstarted run.
+ * No log file is written; the first run prints its start-up messages and the
+ * rest are quiet. One CSV row per run is written to @c "Sweep Output"
+ * (default @c sweep.csv), in run order whatever order the runs finish in.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+/**
+ * @class SweepRunner
+ * @brief Expands the @c "Sweep ..." settings into runs and executes them on a thread pool.
+ */
+class SweepRunner {
+    public:
+        /**
+         * @brief Returns whether @p config contains any @c "Sweep ..." setting.
+         * @param config Parsed configuration.
+         * @return @c true if a sweep was requested.
+         */
+        static bool isSweep(const SimulationConfig& config);
+
+        /**
+         * @brief Constructs a runner for the sweep described by @p config.
+         * @param config Base configuration, including its @c "Sweep ..." settings.
+         */
+        explicit SweepRunner(const SimulationConfig& config);
+
+        /**
+         * @brief Parses the sweep, executes every run and writes the CSV.
+         *
+         * @return @c false (after printing an error) if a sweep value could
+         *         not be parsed or the output file could not be written.
+         */
+        bool run();
+
+    private:
+        /**
+         * @struct Axis
+         * @brief One swept parameter and its values.
+         */
+        struct Axis {
+            std::string column;          ///< CSV column name.
+            int SimulationConfig::*field; ///< Positional setting swept, or @c nullptr.
+            std::string setting;         ///< Optional setting swept when @c field is null.
+            std::vector<double> values;  ///< Values to try, in order.
+        };
+
+        SimulationConfig base;   ///< Configuration shared by every run.
+        std::vector<Axis> axes;  ///< Swept parameters, outermost first.
+        int replicates;          ///< Runs per combination.
+        uint64_t baseSeed;       ///< Seed of replicate 0.
+        unsigned threads;        ///< Worker threads.
+        std::string outputPath;  ///< CSV destination.
+
+        /**
+         * @brief Reads the @c "Sweep ..." settings into the members above.
+         * @return @c false if a value could not be parsed.
+         */
+        bool parse();
+
+        /**
+         * @brief Builds the configuration of run @p index.
+         *
+         * @details The replicate varies fastest, then the last axis.
+         *
+         * @param index Run number in [0, total runs).
+         * @return Configuration for the run.
+         */
+        SimulationConfig configFor(size_t index) const;
+
+        /**
+         * @brief Returns the value of each axis in run @p index.
+         * @param index Run number.
+         * @return One value per entry of @c axes.
+         */
+        std::vector<double> valuesFor(size_t index) const;
+
+        /**
+         * @brief Formats the CSV row of run @p index.
+         *
+         * @param index   Run number.
+         * @param summary Totals of the run.
+         * @param wallMs  Wall-clock time of the run in milliseconds.
+         * @return Row without a trailing newline.
+         */
+        std::string formatRow(size_t index, const SimulationSummary& summary, double wallMs) const;
+};
+
+/**
+ * @brief Parses a sweep value list such as @c "1, 2, 5..20:5".
+ *
+ * @param text   Comma-separated numbers and @c "a..b[:step]" ranges.
+ * @param values Receives the expanded values, in order.
+ * @return @c false if an item is malformed, a step is not positive or a range is empty.
+ */
+bool parseSweepValues(const std::string& text, std::vector<double>& values);
+
+#endif
@@ -2,23 +2,24 @@
  * @file switch.cpp
  * @brief Implementation of the Switch class.
  *
- * @details Implements the Switch constructor and the main simulation loop
- * that orchestrates the Firewall and both LoadBalancer instances.
+ * @details Implements the Switch constructor, load-balancer registration and
+ * the main simulation loop that orchestrates the Firewall and the LoadBalancers.
  *
  * @author Load Balancer Project
  * @date 2025
  */
 
 #include "switch.h"
+#include "trafficGenerator.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <utility>
 
 /**
- * @brief Constructs the Switch and wires together all simulation components.
+ * @brief Constructs the Switch and its Firewall.
  *
- * @details Uses member-initializer syntax to construct @c loadBalancer_P,
- * @c loadBalancer_S, and @c firewall in place.
- *
- * The Firewall is configured with:
+ * @details The Firewall is configured with:
  *  - @c dosRateLimit  = 5  requests per IP per window
  *  - @c dosWindowSize = 20 clock cycles
  *
@@ -27,92 +28,601 @@
  *  - @c 172.16.0.0/12 — Private class-B range
  *  - @c 192.168.0.0/16 — Private class-C range
  *
- * In a production system these would be read from a config file.
+ * Load balancers are registered afterwards with addLoadBalancer().
  *
- * @param requestQueue_P Pre-populated queue of primary requests.
- * @param requestQueue_S Pre-populated queue of secondary requests.
- * @param webServers_P   Initial server pool for the primary balancer.
- * @param webServers_S   Initial server pool for the secondary balancer.
  * @param minThreshold   Per-server queue lower bound for deallocation.
  * @param maxThreshold   Per-server queue upper bound for allocation.
  * @param cooldownTime   Cycles between auto-scaling checks.
  * @param maxProcessTime Maximum processing time for dynamically generated requests.
+ * @param announceRules  Whether to print the built-in ranges as they are added.
  */
-Switch::Switch(std::queue<Request> requestQueue_P,
-               std::queue<Request> requestQueue_S,
-               std::vector<WebServer> webServers_P,
-               std::vector<WebServer> webServers_S,
-               int minThreshold, int maxThreshold, int cooldownTime, int maxProcessTime)
-    : loadBalancer_P(requestQueue_P, webServers_P, 'P', minThreshold, maxThreshold, cooldownTime),
-      loadBalancer_S(requestQueue_S, webServers_S, 'S', minThreshold, maxThreshold, cooldownTime),
-      firewall(5, 20)
+Switch::Switch(int minThreshold, int maxThreshold, int cooldownTime, int maxProcessTime, bool announceRules)
+    : firewall(5, 20)
 {
     clockTime = 0;
+    this->minThreshold = minThreshold;
+    this->maxThreshold = maxThreshold;
+    this->cooldownTime = cooldownTime;
     this->maxProcessTime = maxProcessTime;
+    simulationMode = SimulationMode::TICK;
+    parallel = false;
+    unroutedRequests = 0;
+    nextServerId = 0;
+    backpressure = BackpressureMode::OFF;
+    rejectedRequests = 0;
+    reroutedRequests = 0;
+    metrics = nullptr;
+    metricsInterval = 0;
+    nextMetricsExport = 0;
+    serverIdsAssigned = false;
+    std::fill(std::begin(routingTable), std::end(routingTable), -1);
 
     // --- Static blocked ranges (firewall rules) ---
     // These three cover all RFC-1918 private address space, which would
     // not be valid source IPs on a public-facing load balancer.
-    firewall.blockRange("10.0.0.0/8");
-    firewall.blockRange("172.16.0.0/12");
-    firewall.blockRange("192.168.0.0/16");
+    firewall.blockRange("10.0.0.0/8", announceRules);
+    firewall.blockRange("172.16.0.0/12", announceRules);
+    firewall.blockRange("192.168.0.0/16", announceRules);
+}
+
+/**
+ * @brief Adds a balancer for @p jobClass and points its routing-table entry at it.
+ *
+ * @param jobClass     Job-type byte served by the balancer.
+ * @param requestQueue Pre-populated queue for the balancer.
+ * @param webServers   Initial server pool for the balancer.
+ * @return @c true if the balancer was added; @c false if the class was taken.
+ */
+bool Switch::addLoadBalancer(char jobClass, std::queue<Request> requestQueue, std::vector<WebServer> webServers) {
+    int& route = routingTable[static_cast<unsigned char>(jobClass)];
+    if (route >= 0) {
+        return false;
+    }
+
+    for (const WebServer& server : webServers) {
+        nextServerId = std::max(nextServerId, server.getId() + 1);
+    }
+
+    route = static_cast<int>(loadBalancers.size());
+    loadBalancers.emplace_back(requestQueue, webServers, jobClass, minThreshold, maxThreshold, cooldownTime);
+    jobClasses.push_back(jobClass);
+    batches.emplace_back();
+    return true;
 }
 
 /**
  * @brief Runs the simulation for the specified number of clock cycles.
  *
- * @details Each iteration:
- *  -# Optionally generates a burst of new requests.
+ * @details In SimulationMode::TICK, each iteration:
+ *  -# Collects the tick's arrivals, if any, from the TrafficSource.
  *  -# Passes the full burst through Firewall::filterRequests(), which enforces
  *     both static IP-range blocks and dynamic DoS rate limits.
  *  -# Splits the filtered requests by job type and forwards them to the
  *     appropriate LoadBalancer via runCycle().
  *  -# Increments @c clockTime.
  *
+ * In SimulationMode::EVENT, the clock jumps to the earliest of the next
+ * arrival and each balancer's nextEventTick(), and only that tick is run.
+ * Traffic sources draw the same numbers however the ticks are visited,
+ * so every statistic matches the per-tick loop.
+ *
+ * Before the first cycle each balancer is given an interleaved id sequence
+ * starting past every initial server id, so servers allocated by different
+ * balancers never share an id, whatever order the balancers run in. A later
+ * run(), or one after restoreState(), keeps the sequences where they are.
+ *
+ * If parallel mode is enabled, a CycleWorkers set is started for the
+ * duration of the run with one task per balancer.
+ *
  * After all cycles complete, prints a summary of how many requests the
  * Firewall blocked in total.
  *
- * @param clockCycles Total number of clock cycles to run.
- * @param logFile     Open output stream for logging all events.
+ * @param clockCycles Number of clock cycles to run, counted from the current clock.
+ * @param logger      Logger for all events.
  */
-void Switch::run(int clockCycles, std::ofstream& logFile) {
-    int requestQueueSize_P = 0;
-    int requestQueueSize_S = 0;
+void Switch::run(int clockCycles, Logger& logger) {
+    std::vector<Request> rawRequests;
+
+    if (!serverIdsAssigned) {
+        for (size_t i = 0; i < loadBalancers.size(); i++) {
+            loadBalancers[i].setServerIdSequence(nextServerId + static_cast<int>(i), static_cast<int>(loadBalancers.size()));
+        }
+        serverIdsAssigned = true;
+    }
+
+    if (parallel) {
+        std::vector<std::function<void()>> tasks;
+        for (size_t i = 0; i < loadBalancers.size(); i++) {
+            tasks.push_back([this, i, &logger] { loadBalancers[i].runCycle(&batches[i], logger); });
+        }
+        workers.reset(new CycleWorkers(std::move(tasks)));
+    }
+
+    ensureTrafficSource();
 
-    for (int i = 0; i < clockCycles; i++) {
-        std::vector<Request> rawRequests;
+    if (simulationMode == SimulationMode::TICK) {
+        for (int i = 0; i < clockCycles; i++) {
+            rawRequests.clear();
+            if (traffic->nextArrival(clockTime, clockTime + 1) == clockTime) {
+                traffic->takeArrivals(clockTime, rawRequests);
+            }
+            processTick(rawRequests, logger);
+            clockTime++;
+        }
+    } else {
+        int simulatedTicks = 0;
+        int end = clockTime + clockCycles;
+        int nextArrival = traffic->nextArrival(clockTime, end);
 
-        if (rand() % 5 == 4) {
-            int newRequests = rand() % 40 + 1;
-            for (int j = 0; j < newRequests; j++) {
-                int  processTime = rand() % maxProcessTime + 1;
-                char jobType = rand() % 2 == 0 ? 'P' : 'S';
-                rawRequests.push_back(generateRequest(processTime, jobType));
+        for (;;) {
+            int next = nextArrival;
+            for (const LoadBalancer& balancer : loadBalancers) {
+                next = std::min(next, balancer.nextEventTick());
+            }
+            if (next >= end) {
+                break;
             }
+
+            for (LoadBalancer& balancer : loadBalancers) {
+                balancer.advanceTo(next);
+            }
+            clockTime = next;
+
+            rawRequests.clear();
+            if (next == nextArrival) {
+                traffic->takeArrivals(next, rawRequests);
+                nextArrival = traffic->nextArrival(next + 1, end);
+            }
+            processTick(rawRequests, logger);
+            clockTime++;
+            simulatedTicks++;
+        }
+
+        for (LoadBalancer& balancer : loadBalancers) {
+            balancer.advanceTo(end);
+        }
+        clockTime = end;
+
+        LOG(logger, LogLevel::INFO) << "Event-driven run simulated " << simulatedTicks << " of " << clockCycles << " clock cycles";
+    }
+
+    workers.reset();
+    exportMetrics();
+
+    LOG_FILE(logger, LogLevel::INFO) << "\nSimulation complete. Final request queue sizes: ";
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        LOG_FILE(logger, LogLevel::INFO) << jobClassName(jobClasses[i]) << ": " << loadBalancers[i].getQueueSize() << " requests remaining";
+    }
+    if (unroutedRequests > 0) {
+        LOG_FILE(logger, LogLevel::INFO) << "Unrouted: " << unroutedRequests << " requests had no load balancer for their job class";
+    }
+    traffic->report(logger);
+    printLatencyStats(logger);
+
+    LOG_COLOR(logger, LogLevel::INFO, RED) << "\n[Firewall] Simulation complete. Total requests blocked: " << firewall.getTotalBlocked();
+    firewall.printBlockedRanges(logger);
+    printAdmissionStats(logger);
+}
+
+/**
+ * @brief Selects the engine used by run().
+ * @param mode SimulationMode::TICK or SimulationMode::EVENT.
+ */
+void Switch::setSimulationMode(SimulationMode mode) {
+    simulationMode = mode;
+}
+
+/**
+ * @brief Turns parallel balancer execution on or off for subsequent runs.
+ * @param enabled @c true to use one worker thread per balancer.
+ */
+void Switch::setParallel(bool enabled) {
+    parallel = enabled;
+}
+
+/**
+ * @brief Gives every balancer its own instance of policy @p kind.
+ * @param kind Policy to install.
+ */
+void Switch::setDispatchPolicy(DispatchPolicyKind kind) {
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        loadBalancers[i].setDispatchPolicy(makeDispatchPolicy(kind, 0x9E3779B9u ^ static_cast<unsigned char>(jobClasses[i])));
+    }
+}
+
+/**
+ * @brief Applies a local queue depth to every balancer's servers.
+ * @param depth Local queue capacity per server.
+ */
+void Switch::setLocalQueueDepth(size_t depth) {
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setLocalQueueDepth(depth);
+    }
+}
+
+/**
+ * @brief Applies one autoscaler configuration to every balancer.
+ *
+ * @param mode       Scaling algorithm.
+ * @param targetWait Target queueing delay for ScalingMode::PREDICTIVE.
+ * @param warmUpTime Scale-up warm-up delay in cycles.
+ * @param maxServers Pool size limit for ScalingMode::PREDICTIVE.
+ */
+void Switch::setScaling(ScalingMode mode, int targetWait, int warmUpTime, size_t maxServers) {
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setScaling(mode, targetWait, warmUpTime, maxServers);
+    }
+}
+
+/**
+ * @brief Applies one admission-control configuration to every balancer.
+ *
+ * @param policy        Shedding policy.
+ * @param capacity      Queue bound (0 = unbounded).
+ * @param codelTarget   CoDel target sojourn time.
+ * @param codelInterval CoDel interval.
+ */
+void Switch::setAdmissionControl(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval) {
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setAdmissionControl(policy, capacity, codelTarget, codelInterval);
+    }
+}
+
+/**
+ * @brief Applies one queue discipline to every balancer.
+ *
+ * @param discipline Queue discipline.
+ * @param cutoffs    Class bounds on processing time.
+ * @param weights    DRR weights.
+ * @param quantum    DRR quantum.
+ */
+void Switch::setQueueDiscipline(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum) {
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setQueueDiscipline(discipline, cutoffs, weights, quantum);
+    }
+}
+
+/**
+ * @brief Selects the backpressure handling.
+ * @param mode BackpressureMode::OFF, REJECT or REROUTE.
+ */
+void Switch::setBackpressure(BackpressureMode mode) {
+    backpressure = mode;
+}
+
+/**
+ * @brief Filters one tick's arrivals and runs every load balancer for that tick.
+ *
+ * @details Allowed requests are appended to their balancer's batch buffer
+ * through @c routingTable; the buffers keep their capacity from cycle to
+ * cycle. The balancers then run one after the other on this thread, or
+ * concurrently on the CycleWorkers threads in parallel mode.
+ *
+ * @param rawRequests Requests arriving on @c clockTime; filtered in place.
+ * @param logger      Logger for all events.
+ */
+void Switch::processTick(std::vector<Request>& rawRequests, Logger& logger) {
+    int unroutedBefore = unroutedRequests;
+    int rejectedBefore = rejectedRequests;
+    int reroutedBefore = reroutedRequests;
+    arrivalCount.add(rawRequests.size());
+
+    firewall.filterRequests(rawRequests, clockTime, logger);
+
+    for (std::vector<Request>& batch : batches) {
+        batch.clear();
+    }
+    for (const Request& req : rawRequests) {
+        int route = routingTable[static_cast<unsigned char>(req.getJobType())];
+        if (route >= 0)
+            batches[route].push_back(req);
+        else
+            unroutedRequests++;
+    }
+    if (backpressure != BackpressureMode::OFF) {
+        applyBackpressure();
+    }
+
+    if (workers) {
+        workers->runCycle();
+    } else {
+        for (size_t i = 0; i < loadBalancers.size(); i++) {
+            loadBalancers[i].runCycle(&batches[i], logger);
+        }
+    }
+
+    tickCount.add();
+    unroutedCount.add(static_cast<uint64_t>(unroutedRequests - unroutedBefore));
+    rejectedCount.add(static_cast<uint64_t>(rejectedRequests - rejectedBefore));
+    reroutedCount.add(static_cast<uint64_t>(reroutedRequests - reroutedBefore));
+    clockGauge.set(clockTime);
+    if (!metricsPath.empty() && metricsInterval > 0 && clockTime >= nextMetricsExport) {
+        nextMetricsExport = (clockTime / metricsInterval + 1) * metricsInterval;
+        exportMetrics();
+    }
+}
+
+/**
+ * @brief Creates the Switch's series and hands the registry to its components.
+ * @param registry Registry receiving the series.
+ */
+void Switch::setMetrics(MetricsRegistry& registry) {
+    metrics = &registry;
+    tickCount = registry.counter("switch_ticks_total", "Clock ticks simulated.");
+    arrivalCount = registry.counter("switch_arrivals_total", "Requests arriving at the switch, before the firewall.");
+    unroutedCount = registry.counter("switch_unrouted_total", "Allowed requests with no load balancer for their job class.");
+    rejectedCount = registry.counter("switch_rejected_total", "Requests rejected by backpressure.");
+    reroutedCount = registry.counter("switch_rerouted_total", "Requests moved to another load balancer by backpressure.");
+    clockGauge = registry.gauge("switch_clock_tick", "Most recently simulated clock tick.");
+    firewall.setMetrics(registry);
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setMetrics(registry);
+    }
+}
+
+/**
+ * @brief Configures the periodic metrics file.
+ * @param path     File to write.
+ * @param interval Cycles between writes.
+ */
+void Switch::setMetricsExport(const std::string& path, int interval) {
+    metricsPath = path;
+    metricsInterval = interval;
+    nextMetricsExport = interval > 0 ? clockTime : 0;
+}
+
+/**
+ * @brief Attaches the Firewall and every balancer to @p log.
+ * @param log Event log receiving their events.
+ */
+void Switch::setEventLog(EventLog& log) {
+    firewall.setEventLog(log);
+    for (LoadBalancer& balancer : loadBalancers) {
+        balancer.setEventLog(log);
+    }
+}
+
+/**
+ * @brief Writes the Switch's section, then the Firewall, the balancers and the traffic source.
+ * @param out Snapshot being written.
+ */
+void Switch::saveState(SnapshotWriter& out) const {
+    out.putTag("SWCH");
+    out.putArray(jobClasses);
+    out.put(clockTime);
+    out.put(unroutedRequests);
+    out.put(rejectedRequests);
+    out.put(reroutedRequests);
+    out.put(nextServerId);
+    out.put(serverIdsAssigned);
+    firewall.saveState(out);
+    for (const LoadBalancer& balancer : loadBalancers) {
+        balancer.saveState(out);
+    }
+
+    SnapshotWriter trafficState;
+    if (traffic) {
+        traffic->saveState(trafficState);
+    }
+    out.putBlob(trafficState);
+}
+
+/**
+ * @brief Reads the sections written by saveState(), checking the job classes first.
+ *
+ * @details The traffic source is created if run() has not done so yet, so
+ * the default generator can resume too; an empty traffic section, written
+ * before any source existed, leaves it fresh.
+ *
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool Switch::restoreState(SnapshotReader& in) {
+    std::vector<char> savedClasses;
+    if (!in.expectTag("SWCH") || !in.getArray(savedClasses) || savedClasses != jobClasses) {
+        return in.fail();
+    }
+    if (!in.get(clockTime) || !in.get(unroutedRequests) || !in.get(rejectedRequests) || !in.get(reroutedRequests)
+        || !in.get(nextServerId) || !in.get(serverIdsAssigned) || !firewall.restoreState(in)) {
+        return in.fail();
+    }
+    for (LoadBalancer& balancer : loadBalancers) {
+        if (!balancer.restoreState(in)) {
+            return in.fail();
         }
+    }
+
+    SnapshotReader trafficState;
+    if (!in.getBlob(trafficState)) {
+        return in.fail();
+    }
+    ensureTrafficSource();
+    if (trafficState.remaining() > 0 && !traffic->restoreState(trafficState, clockTime)) {
+        return in.fail();
+    }
+    return true;
+}
+
+/**
+ * @brief Creates a TrafficGenerator with the default profile if no source was set.
+ */
+void Switch::ensureTrafficSource() {
+    if (!traffic) {
+        TrafficProfile profile;
+        profile.maxProcessTime = maxProcessTime;
+        traffic.reset(new TrafficGenerator(profile, jobClasses, 1));
+    }
+}
+
+/**
+ * @brief Writes the registry to @c metricsPath.
+ */
+void Switch::exportMetrics() {
+    if (metrics == nullptr || metricsPath.empty()) {
+        return;
+    }
+    if (!metrics->writeFile(metricsPath)) {
+        std::cerr << "WARNING: could not write metrics file '" << metricsPath << "' — metrics export disabled." << std::endl;
+        metricsPath.clear();
+    }
+}
+
+/**
+ * @brief Installs the source run() draws arrivals from.
+ * @param source New traffic source.
+ */
+void Switch::setTrafficSource(std::unique_ptr<TrafficSource> source) {
+    traffic = std::move(source);
+}
+
+/**
+ * @brief Returns the Firewall in front of every load balancer.
+ * @return Reference to @c firewall.
+ */
+Firewall& Switch::getFirewall() {
+    return firewall;
+}
+
+/**
+ * @brief Returns the load balancers.
+ * @return Reference to @c loadBalancers.
+ */
+const std::vector<LoadBalancer>& Switch::getLoadBalancers() const {
+    return loadBalancers;
+}
+
+/**
+ * @brief Returns the backpressure rejection count.
+ * @return @c rejectedRequests.
+ */
+int Switch::getRejectedRequests() const {
+    return rejectedRequests;
+}
+
+/**
+ * @brief Returns the unrouted request count.
+ * @return @c unroutedRequests.
+ */
+int Switch::getUnroutedRequests() const {
+    return unroutedRequests;
+}
 
-        std::vector<Request> allowed = firewall.filterRequests(rawRequests, clockTime, logFile);
+/**
+ * @brief Returns the simulation clock.
+ * @return @c clockTime.
+ */
+int Switch::getClockTime() const {
+    return clockTime;
+}
 
-        std::vector<Request> filtered_P;
-        std::vector<Request> filtered_S;
-        for (const Request& req : allowed) {
-            if (req.getJobType() == 'P')
-                filtered_P.push_back(req);
-            else
-                filtered_S.push_back(req);
+/**
+ * @brief Reports each load balancer's latency percentiles, in clock cycles.
+ *
+ * @details Wait runs from enqueue to dispatch, service from dispatch to
+ * completion, and sojourn is their sum. Only completed requests contribute
+ * service and sojourn; wait also covers requests still in flight. With
+ * several priority classes, each class's sojourn times follow.
+ *
+ * @param logger Logger receiving the report.
+ */
+void Switch::printLatencyStats(Logger& logger) const {
+    LOG_COLOR(logger, LogLevel::INFO, CYAN) << "\n[Latency] Percentiles in clock cycles:";
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        const LoadBalancer& balancer = loadBalancers[i];
+        LOG(logger, LogLevel::INFO) << jobClassName(jobClasses[i]) << ": " << balancer.getSojournTimes().count() << " requests completed, "
+            << balancer.getServerCycles() << " server-cycles, peak " << balancer.getPeakServers() << " servers";
+
+        const char* labels[] = {"wait", "service", "sojourn"};
+        const LatencyHistogram* histograms[] = {&balancer.getWaitTimes(), &balancer.getServiceTimes(), &balancer.getSojournTimes()};
+        for (size_t h = 0; h < 3; h++) {
+            const LatencyHistogram& histogram = *histograms[h];
+            LOG(logger, LogLevel::INFO) << "  " << labels[h]
+                << ": p50=" << histogram.percentile(50.0)
+                << " p99=" << histogram.percentile(99.0)
+                << " p999=" << histogram.percentile(99.9)
+                << " max=" << histogram.max()
+                << " mean=" << histogram.mean();
         }
 
-        requestQueueSize_P = loadBalancer_P.runCycle(&filtered_P, logFile);
-        requestQueueSize_S = loadBalancer_S.runCycle(&filtered_S, logFile);
+        const SchedulingQueue& queue = balancer.getRequestQueue();
+        const std::vector<LatencyHistogram>& classes = balancer.getClassSojournTimes();
+        for (size_t k = 0; k < classes.size(); k++) {
+            std::string label = queue.classCutoff(k) >= 0 ? "time<=" + std::to_string(queue.classCutoff(k))
+                                                          : "time>" + std::to_string(queue.classCutoff(k - 1));
+            LOG(logger, LogLevel::INFO) << "  sojourn " << label << ": " << classes[k].count() << " completed"
+                << ", p50=" << classes[k].percentile(50.0)
+                << " p99=" << classes[k].percentile(99.0)
+                << " p999=" << classes[k].percentile(99.9)
+                << " max=" << classes[k].max()
+                << " mean=" << classes[k].mean();
+        }
+    }
+}
 
-        clockTime++;
+/**
+ * @brief Fits each routed batch to its balancer's headroom.
+ *
+ * @details The spare room of every balancer is computed from its own batch
+ * first, so rerouting never displaces a balancer's own traffic. Each
+ * overflowing request then goes to the balancer with the most spare room
+ * (lowest index on ties) or, if none has any, is rejected.
+ */
+void Switch::applyBackpressure() {
+    spareCapacity.resize(loadBalancers.size());
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        size_t headroom = loadBalancers[i].getHeadroom();
+        spareCapacity[i] = headroom > batches[i].size() ? headroom - batches[i].size() : 0;
     }
 
-    logFile << "\nSimulation complete. Final request queue sizes: " << std::endl;
-    logFile << "Processing: " << requestQueueSize_P << " requests remaining" << std::endl;
-    logFile << "Streaming: " << requestQueueSize_S << " requests remaining" << std::endl;
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        size_t headroom = loadBalancers[i].getHeadroom();
+        if (batches[i].size() <= headroom) {
+            continue;
+        }
+        overflow.assign(batches[i].begin() + headroom, batches[i].end());
+        batches[i].resize(headroom);
 
-    std::cout << RED << "\n[Firewall] Simulation complete. Total requests blocked: " << firewall.getTotalBlocked() << RESET << std::endl;
-    logFile << "\n[Firewall] Simulation complete. Total requests blocked: " << firewall.getTotalBlocked() << std::endl;
-    firewall.printBlockedRanges(logFile);
-}
\ No newline at end of file
+        for (const Request& req : overflow) {
+            size_t best = loadBalancers.size();
+            if (backpressure == BackpressureMode::REROUTE) {
+                for (size_t j = 0; j < loadBalancers.size(); j++) {
+                    if (spareCapacity[j] > 0 && (best == loadBalancers.size() || spareCapacity[j] > spareCapacity[best])) {
+                        best = j;
+                    }
+                }
+            }
+            if (best < loadBalancers.size()) {
+                batches[best].push_back(req);
+                spareCapacity[best]--;
+                reroutedRequests++;
+            } else {
+                rejectedRequests++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reports shed, rejected and rerouted requests.
+ *
+ * @details The totals line is always printed; the per-class breakdown only
+ * for balancers that shed anything.
+ *
+ * @param logger Logger receiving the report.
+ */
+void Switch::printAdmissionStats(Logger& logger) const {
+    uint64_t shed = 0;
+    for (const LoadBalancer& balancer : loadBalancers) {
+        shed += balancer.getShedCounts().total();
+    }
+
+    LOG_COLOR(logger, LogLevel::INFO, RED) << "[Admission] Total requests shed: " << shed
+        << ", rejected by backpressure: " << rejectedRequests << ", rerouted: " << reroutedRequests;
+    for (size_t i = 0; i < loadBalancers.size(); i++) {
+        const ShedCounts& counts = loadBalancers[i].getShedCounts();
+        if (counts.total() > 0) {
+            LOG(logger, LogLevel::INFO) << "  " << jobClassName(jobClasses[i]) << ": " << counts.tailDropped << " tail-dropped, "
+                << counts.oldestDropped << " oldest-dropped, " << counts.codelDropped << " CoDel-dropped";
+        }
+    }
+}
@@ -3,13 +3,15 @@
  * @brief Declaration of the Switch class, the top-level simulation coordinator.
  *
  * @details The Switch acts as the entry point for all simulated network traffic.
- * It owns two LoadBalancer instances (primary 'P' and secondary 'S') and a
- * Firewall that filters every incoming request before it reaches either balancer.
+ * It owns one LoadBalancer per job class (by default primary 'P' and secondary
+ * 'S') and a Firewall that filters every incoming request before it reaches
+ * any balancer.
  *
- * On a random subset of cycles (~10% probability) the Switch generates a burst
- * of between 1 and 80 new requests. Each request first passes through the
- * Firewall's IP-range and DoS-rate checks; only allowed requests are forwarded
- * to the appropriate LoadBalancer.
+ * New requests come from a TrafficSource: by default a TrafficGenerator,
+ * which generates a burst of between 1 and 40 requests on about one cycle in
+ * five, or a TraceReader replaying a recorded trace. Each request first passes
+ * through the Firewall's IP-range and DoS-rate checks; only allowed requests
+ * are forwarded to the LoadBalancer registered for their job class.
  *
  * @author Load Balancer Project
  * @date 2025
@@ -22,58 +24,343 @@
 #include "firewall.h"
 #include "request.h"
 #include "utils.h"
+#include "cycleWorkers.h"
+#include "trafficSource.h"
+#include "metrics.h"
+#include <memory>
+#include <string>
+
+/**
+ * @enum SimulationMode
+ * @brief How Switch::run() advances the clock.
+ */
+enum class SimulationMode {
+    TICK,   ///< Run every load balancer on every clock cycle.
+    EVENT   ///< Jump straight to the next arrival, dispatch, completion or scaling event.
+};
+
+/**
+ * @enum BackpressureMode
+ * @brief What the Switch does with requests a bounded balancer has no room for.
+ */
+enum class BackpressureMode {
+    OFF,      ///< Deliver everything; the balancer's shedding policy decides.
+    REJECT,   ///< Reject the overflow at the Switch before it reaches the balancer.
+    REROUTE   ///< Send the overflow to the balancer with the most headroom, rejecting what none can take.
+};
 
 /**
  * @class Switch
- * @brief Top-level coordinator that drives two LoadBalancer instances behind a Firewall.
+ * @brief Top-level coordinator that drives a set of LoadBalancer instances behind a Firewall.
  *
  * @details Instantiates and wires together all simulation components. The Firewall
  * is the first stop for every request; only requests that pass IP-range and
- * rate-limit checks are forwarded to @c loadBalancer_P or @c loadBalancer_S.
+ * rate-limit checks are forwarded to a balancer. Routing uses a dense table
+ * indexed by the request's job-class byte, and each balancer has a batch
+ * buffer that is refilled (not reallocated) every cycle.
  */
 class Switch {
     public:
         /**
-         * @brief Constructs the Switch, initializes both LoadBalancers and the Firewall.
+         * @brief Constructs the Switch and its Firewall with no load balancers yet.
          *
-         * @param requestQueue_P Initial request queue for the primary load balancer.
-         * @param requestQueue_S Initial request queue for the secondary load balancer.
-         * @param webServers_P   Initial server pool for the primary load balancer.
-         * @param webServers_S   Initial server pool for the secondary load balancer.
-         * @param minThreshold   Passed through to both LoadBalancer instances.
-         * @param maxThreshold   Passed through to both LoadBalancer instances.
-         * @param cooldownTime   Passed through to both LoadBalancer instances.
+         * @param minThreshold   Passed through to every LoadBalancer added later.
+         * @param maxThreshold   Passed through to every LoadBalancer added later.
+         * @param cooldownTime   Passed through to every LoadBalancer added later.
          * @param maxProcessTime Maximum processing time (in cycles) for generated requests.
+         * @param announceRules  Whether to print a line for each built-in firewall range.
          */
-        Switch(std::queue<Request> requestQueue_P,
-               std::queue<Request> requestQueue_S,
-               std::vector<WebServer> webServers_P,
-               std::vector<WebServer> webServers_S,
-               int minThreshold, int maxThreshold, int cooldownTime, int maxProcessTime);
+        Switch(int minThreshold, int maxThreshold, int cooldownTime, int maxProcessTime, bool announceRules = true);
+
+        /**
+         * @brief Registers a LoadBalancer for one job class.
+         *
+         * @details Requests whose job type equals @p jobClass are routed to the
+         * new balancer. Generated traffic picks uniformly among the registered
+         * classes in registration order. Must be called before run().
+         *
+         * @param jobClass     Job-type byte served by the balancer (e.g. 'P').
+         * @param requestQueue Initial queue of requests for the balancer.
+         * @param webServers   Initial server pool for the balancer.
+         * @return @c false if @p jobClass already has a balancer.
+         */
+        bool addLoadBalancer(char jobClass, std::queue<Request> requestQueue, std::vector<WebServer> webServers);
 
         /**
          * @brief Runs the simulation for the specified number of clock cycles.
          *
          * @details Each cycle:
-         *  -# With ~1/11 probability, generates 1–80 new requests of random job type.
+         *  -# Collects the tick's arrivals, if any, from the TrafficSource.
          *  -# Passes all new requests through the Firewall for filtering.
-         *  -# Calls loadBalancer_P.runCycle() with the filtered primary requests.
-         *  -# Calls loadBalancer_S.runCycle() with the filtered secondary requests.
+         *  -# Routes each allowed request to its job class's batch buffer.
+         *  -# Calls runCycle() on every LoadBalancer with its batch.
          *  -# Increments the internal clock counter.
          *
          * At the end of the run, prints a firewall summary (total blocked count).
          *
          * @param clockCycles Total number of cycles to simulate.
-         * @param logFile     Open output stream used for event logging.
+         * @param logger      Logger used for event logging.
+         */
+        void run(int clockCycles, Logger& logger);
+
+        /**
+         * @brief Selects the clock-advancing engine used by run().
+         *
+         * @details Both engines produce the same queue, scaling and firewall
+         * statistics for the same random seed; the event-driven engine only
+         * omits the per-cycle progress lines for cycles in which nothing happens.
+         *
+         * @param mode Engine to use.
+         */
+        void setSimulationMode(SimulationMode mode);
+
+        /**
+         * @brief Enables running the load balancers on parallel worker threads.
+         *
+         * @details When enabled, each cycle's routed requests are handed to
+         * the balancers, which then run concurrently, one per thread, and the
+         * Switch waits for all of them before starting the next cycle. Results
+         * are identical to the sequential mode; only the interleaving of the
+         * balancers' log lines within a cycle may differ.
+         *
+         * @param enabled @c true to run balancers in parallel.
+         */
+        void setParallel(bool enabled);
+
+        /**
+         * @brief Installs a fresh policy of the given kind on every load balancer.
+         *
+         * @details Each balancer gets its own instance; randomised policies are
+         * seeded from the balancer's job class so runs are repeatable.
+         *
+         * @param kind Policy to use.
+         */
+        void setDispatchPolicy(DispatchPolicyKind kind);
+
+        /**
+         * @brief Sets the per-server local queue depth on every load balancer.
+         * @param depth Requests each server may have queued behind its current one.
+         */
+        void setLocalQueueDepth(size_t depth);
+
+        /**
+         * @brief Configures the autoscaler of every load balancer.
+         *
+         * @param mode       Scaling algorithm.
+         * @param targetWait Queueing delay, in cycles, the predictive mode sizes for.
+         * @param warmUpTime Cycles between requesting a server and it taking work.
+         * @param maxServers Largest pool the predictive mode provisions.
+         */
+        void setScaling(ScalingMode mode, int targetWait, int warmUpTime, size_t maxServers);
+
+        /**
+         * @brief Bounds every load balancer's queue and sets its shedding policy.
+         *
+         * @param policy        Shedding policy.
+         * @param capacity      Maximum queue length (0 = unbounded).
+         * @param codelTarget   Head sojourn time, in cycles, CoDel tolerates.
+         * @param codelInterval Cycles above target before CoDel starts dropping.
+         */
+        void setAdmissionControl(SheddingPolicy policy, size_t capacity, int codelTarget, int codelInterval);
+
+        /**
+         * @brief Sets every load balancer's queue discipline and priority classes.
+         *
+         * @param discipline Queue discipline.
+         * @param cutoffs    Processing-time bounds of all but the last priority class.
+         * @param weights    DRR weight of each class.
+         * @param quantum    Processing time a class of weight 1 earns per DRR turn.
+         */
+        void setQueueDiscipline(QueueDiscipline discipline, const std::vector<int>& cutoffs, const std::vector<int>& weights, int quantum);
+
+        /**
+         * @brief Selects how balancer headroom is acted on before each cycle.
+         *
+         * @details Each cycle, after routing, a balancer whose batch exceeds
+         * LoadBalancer::getHeadroom() signals backpressure; depending on
+         * @p mode the excess is still delivered, rejected at the Switch, or
+         * rerouted to other balancers with spare room.
+         *
+         * @param mode Backpressure handling.
+         */
+        void setBackpressure(BackpressureMode mode);
+
+        /**
+         * @brief Replaces the source of arriving requests.
+         *
+         * @details Without a source, run() generates the default
+         * TrafficProfile over the registered job classes with seed 1. Requests whose job type has no balancer
+         * are counted as unrouted.
+         *
+         * @param source Source to draw arrivals from.
+         */
+        void setTrafficSource(std::unique_ptr<TrafficSource> source);
+
+        /**
+         * @brief Registers the Switch's series in @p registry and forwards it
+         *        to the Firewall and every registered load balancer.
+         *
+         * @details The Switch counts the ticks it processes, raw arrivals and
+         * unrouted, rejected and rerouted requests, and exposes the clock as a
+         * gauge.
+         *
+         * @param registry Registry that must outlive the Switch.
          */
-        void run(int clockCycles, std::ofstream& logFile);
+        void setMetrics(MetricsRegistry& registry);
+
+        /**
+         * @brief Writes the registry to @p path every @p interval cycles and at
+         *        the end of the run.
+         *
+         * @details Requires setMetrics(). In event mode a file is written on
+         * the first simulated tick at or past each multiple of @p interval.
+         *
+         * @param path     Prometheus text file, replaced atomically on each write.
+         * @param interval Cycles between writes; values below 1 write only at the end.
+         */
+        void setMetricsExport(const std::string& path, int interval);
+
+        /**
+         * @brief Sends the per-cycle, scaling and firewall events to @p log.
+         *
+         * @details The Firewall gets channel 0 and the load balancers the
+         * following channels in registration order, which is also the order
+         * their lines appear in the text log. Call after every balancer has
+         * been added.
+         *
+         * @param log Open event log that must outlive the Switch.
+         */
+        void setEventLog(EventLog& log);
+
+        /**
+         * @brief Writes the whole simulation state to @p out.
+         *
+         * @details Covers the clock, the Switch's own tallies, the Firewall,
+         * every LoadBalancer in registration order and the TrafficSource, so
+         * that a later run() continues exactly where this one stopped.
+         *
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const;
+
+        /**
+         * @brief Replaces the simulation state with the one read from @p in.
+         *
+         * @details The Switch must already be configured as it was when the
+         * snapshot was taken: the same job classes, in the same order, and a
+         * traffic source of the same kind. On failure the state may be partly
+         * overwritten; restore a snapshot of the intact state to undo that.
+         *
+         * @param in Snapshot positioned where saveState() wrote.
+         * @return @c false if the snapshot is malformed or does not fit this Switch.
+         */
+        bool restoreState(SnapshotReader& in);
+
+        /**
+         * @brief Gives access to the perimeter Firewall for additional configuration.
+         *
+         * @details Used at startup to install rules beyond the built-in RFC-1918
+         * ranges, e.g. by bulk-loading a block-list file.
+         *
+         * @return Reference to the Switch's Firewall instance.
+         */
+        Firewall& getFirewall();
+
+        /**
+         * @brief Returns the load balancers, in registration order.
+         * @return Read-only view of the balancers, for end-of-run totals.
+         */
+        const std::vector<LoadBalancer>& getLoadBalancers() const;
+
+        /**
+         * @brief Returns the number of requests rejected by backpressure so far.
+         * @return Rejected request count.
+         */
+        int getRejectedRequests() const;
+
+        /**
+         * @brief Returns the number of allowed requests that had no load balancer.
+         * @return Unrouted request count.
+         */
+        int getUnroutedRequests() const;
+
+        /**
+         * @brief Returns the current simulation clock.
+         * @return Tick the next run() starts at.
+         */
+        int getClockTime() const;
 
     private:
-        LoadBalancer loadBalancer_P;  ///< Load balancer handling primary ('P') requests.
-        LoadBalancer loadBalancer_S;  ///< Load balancer handling secondary ('S') requests.
+        std::vector<LoadBalancer> loadBalancers;  ///< One balancer per job class, in registration order.
+        std::vector<char> jobClasses;             ///< Job class served by each entry of @c loadBalancers.
+        int routingTable[256];                    ///< Job-type byte -> balancer index, or -1 if unrouted.
+        std::vector<std::vector<Request>> batches; ///< Per-balancer buffer for this cycle's allowed requests.
+        int unroutedRequests;                     ///< Allowed requests dropped for having no balancer.
+        int nextServerId;                         ///< One past the largest initial server id.
+        BackpressureMode backpressure;            ///< Handling of batches that exceed a balancer's headroom.
+        int rejectedRequests;                     ///< Requests rejected by backpressure.
+        int reroutedRequests;                     ///< Requests moved to another balancer by backpressure.
+        std::vector<size_t> spareCapacity;        ///< Scratch: headroom left after each balancer's own batch.
+        std::vector<Request> overflow;            ///< Scratch: requests a balancer had no room for.
+
         Firewall firewall;            ///< Perimeter firewall; filters all incoming requests.
         int clockTime;                ///< Current simulation clock (incremented each cycle).
+        int minThreshold;             ///< Scaling lower bound handed to new balancers.
+        int maxThreshold;             ///< Scaling upper bound handed to new balancers.
+        int cooldownTime;             ///< Scaling interval handed to new balancers.
         int maxProcessTime;           ///< Upper bound on randomly generated request durations.
+        SimulationMode simulationMode; ///< Engine used by run().
+        bool parallel;                ///< Whether run() drives the balancers on worker threads.
+        std::unique_ptr<CycleWorkers> workers; ///< Per-balancer threads; live only during a parallel run().
+        std::unique_ptr<TrafficSource> traffic; ///< Source of arrivals; a TrafficGenerator unless replaced.
+
+        MetricsRegistry* metrics;     ///< Registry from setMetrics(), or @c nullptr.
+        Counter tickCount;            ///< Ticks processed.
+        Counter arrivalCount;         ///< Requests arriving, before filtering.
+        Counter unroutedCount;        ///< Requests with no balancer.
+        Counter rejectedCount;        ///< Requests rejected by backpressure.
+        Counter reroutedCount;        ///< Requests rerouted by backpressure.
+        Gauge clockGauge;             ///< Last processed tick.
+        std::string metricsPath;      ///< Periodic export file, or empty.
+        int metricsInterval;          ///< Cycles between exports.
+        int nextMetricsExport;        ///< Tick at or after which the next export is due.
+        bool serverIdsAssigned;       ///< Whether the balancers' id sequences have been set.
+
+        /**
+         * @brief Filters a burst and runs one cycle of every load balancer.
+         * @param rawRequests Requests arriving on the current tick; the firewall
+         *                    compacts it in place to the allowed requests.
+         * @param logger      Logger for all events.
+         */
+        void processTick(std::vector<Request>& rawRequests, Logger& logger);
+
+        /**
+         * @brief Writes the metrics file, disabling the export after a failure.
+         */
+        void exportMetrics();
+
+        /**
+         * @brief Installs the default TrafficGenerator if no source was set.
+         */
+        void ensureTrafficSource();
+
+        /**
+         * @brief Logs p50/p99/p999 wait, service and sojourn times and the
+         *        server-cycles consumed for each load balancer.
+         * @param logger Logger receiving the report.
+         */
+        void printLatencyStats(Logger& logger) const;
+
+        /**
+         * @brief Trims or reroutes the per-balancer batches to fit their headroom.
+         */
+        void applyBackpressure();
+
+        /**
+         * @brief Logs the requests shed by admission control and backpressure.
+         * @param logger Logger receiving the report.
+         */
+        void printAdmissionStats(Logger& logger) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,440 @@
+/**
+ * @file traceReader.cpp
+ * @brief Implementation of the TraceReader class.
+ *
+ * @details The trace is mapped read-only with @c mmap and advised for
+ * sequential access. Parsing works directly on the mapped bytes: JSONL
+ * lines are found with @c memchr and scanned as @c std::string_view with
+ * @c std::from_chars, and binary records are decoded field by field from
+ * the mapping, so no record is ever copied into a temporary buffer.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "traceReader.h"
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "firewall.h"
+
+namespace {
+
+const char BINARY_MAGIC[8] = {'L', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/**
+ * @brief Advances @p pos past spaces and tabs.
+ * @param text Text being scanned.
+ * @param pos  Scan position.
+ */
+void skipSpace(std::string_view text, size_t& pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+        pos++;
+    }
+}
+
+/**
+ * @brief Reads a double-quoted string without escapes.
+ *
+ * @param text  Text being scanned.
+ * @param pos   Position of the opening quote; left after the closing quote.
+ * @param value Receives the contents, viewing @p text.
+ * @return @c false if the string is unterminated or contains a backslash.
+ */
+bool parseString(std::string_view text, size_t& pos, std::string_view& value) {
+    size_t close = text.find('"', pos + 1);
+    if (close == std::string_view::npos) {
+        return false;
+    }
+    value = text.substr(pos + 1, close - pos - 1);
+    pos = close + 1;
+    return value.find('\\') == std::string_view::npos;
+}
+
+/**
+ * @brief Reads a decimal integer.
+ *
+ * @param text  Text being scanned.
+ * @param pos   Position of the first digit or sign; left after the number.
+ * @param value Receives the number.
+ * @return @c false if no integer starts at @p pos.
+ */
+bool parseNumber(std::string_view text, size_t& pos, long long& value) {
+    const char* end = text.data() + text.size();
+    std::from_chars_result parsed = std::from_chars(text.data() + pos, end, value);
+    if (parsed.ec != std::errc()) {
+        return false;
+    }
+    pos = static_cast<size_t>(parsed.ptr - text.data());
+    return true;
+}
+
+/**
+ * @brief Decodes a little-endian 16-bit field.
+ * @param p First byte.
+ * @return Field value.
+ */
+uint32_t readLittleEndian16(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8;
+}
+
+/**
+ * @brief Decodes a little-endian 32-bit field.
+ * @param p First byte.
+ * @return Field value.
+ */
+uint32_t readLittleEndian32(const unsigned char* p) {
+    return readLittleEndian16(p) | readLittleEndian16(p + 2) << 16;
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty reader.
+ */
+TraceReader::TraceReader()
+    : data(nullptr),
+      length(0),
+      cursor(0),
+      binary(false),
+      announce(true),
+      line(0),
+      pending(),
+      hasPending(false),
+      replayed(0),
+      late(0),
+      malformed(0)
+{
+}
+
+/**
+ * @brief Releases the mapping, if any.
+ */
+TraceReader::~TraceReader() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+/**
+ * @brief Maps @p path and positions the reader on its first record.
+ *
+ * @details Any previously opened trace is released. An empty file is a
+ * valid trace with no records.
+ *
+ * @param path     Path of the trace file.
+ * @param announce Whether to print the "Replaying" line and malformed-record warnings.
+ * @return @c true on success.
+ */
+bool TraceReader::open(const std::string& path, bool announce) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[Trace] WARNING: could not open trace '" << path << "' — using generated traffic." << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        std::cerr << "[Trace] WARNING: could not stat trace '" << path << "' — using generated traffic." << std::endl;
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = nullptr;
+    if (size > 0) {
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            std::cerr << "[Trace] WARNING: could not map trace '" << path << "' — using generated traffic." << std::endl;
+            return false;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), length);
+    }
+    this->path = path;
+    this->announce = announce;
+    data = static_cast<const char*>(mapping);
+    length = size;
+    binary = length >= sizeof(BINARY_MAGIC) && std::memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+    cursor = binary ? sizeof(BINARY_MAGIC) : 0;
+    line = 0;
+    replayed = 0;
+    late = 0;
+    malformed = 0;
+    readNext();
+
+    if (announce) {
+        std::cout << "[Trace] Replaying " << path << " (" << (binary ? "binary" : "JSONL") << ", "
+                  << length << " bytes)" << std::endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Reports the tick of the next undelivered record.
+ *
+ * @details A record from an earlier tick is due immediately, at @p from.
+ *
+ * @param from First tick to consider.
+ * @param end  Exclusive upper bound.
+ * @return Arrival tick, or @p end if the trace has no record before it.
+ */
+int TraceReader::nextArrival(int from, int end) {
+    if (!hasPending) {
+        return end;
+    }
+    int tick = pending.tick > from ? pending.tick : from;
+    return tick < end ? tick : end;
+}
+
+/**
+ * @brief Delivers every record due by @p tick.
+ *
+ * @param tick Current tick.
+ * @param out  Receives the replayed requests, in trace order.
+ */
+void TraceReader::takeArrivals(int tick, std::vector<Request>& out) {
+    while (hasPending && pending.tick <= tick) {
+        if (pending.tick < tick) {
+            late++;
+        }
+        out.push_back(Request(pending.src, pending.dst, pending.processTime, pending.jobType));
+        replayed++;
+        readNext();
+    }
+}
+
+/**
+ * @brief Logs the replay totals.
+ * @param logger Logger receiving the report.
+ */
+void TraceReader::report(Logger& logger) const {
+    if (path.empty()) {
+        return;
+    }
+    LOG_FILE(logger, LogLevel::INFO) << "Trace " << path << ": " << replayed << " requests replayed, "
+                                     << late << " late, " << malformed << " malformed records skipped";
+    if (hasPending) {
+        LOG_FILE(logger, LogLevel::INFO) << "Trace " << path << ": records from tick " << pending.tick
+                                         << " onward were past the end of the run";
+    }
+}
+
+/**
+ * @brief Returns the number of requests delivered.
+ * @return Replayed count.
+ */
+uint64_t TraceReader::getReplayed() const {
+    return replayed;
+}
+
+/**
+ * @brief Returns the number of malformed records skipped.
+ * @return Malformed count.
+ */
+uint64_t TraceReader::getMalformed() const {
+    return malformed;
+}
+
+/**
+ * @brief Decodes records from @c cursor until one is valid or the mapping ends.
+ * @return Whether @c pending now holds a record.
+ */
+bool TraceReader::readNext() {
+    hasPending = false;
+
+    while (cursor < length) {
+        line++;
+
+        if (binary) {
+            if (length - cursor < BINARY_RECORD_SIZE) {
+                cursor = length;
+                skipMalformed();
+                break;
+            }
+            const unsigned char* record = reinterpret_cast<const unsigned char*>(data + cursor);
+            cursor += BINARY_RECORD_SIZE;
+
+            uint32_t tick = readLittleEndian32(record);
+            if (tick > static_cast<uint32_t>(INT_MAX)) {
+                skipMalformed();
+                continue;
+            }
+            pending.tick = static_cast<int>(tick);
+            pending.src = readLittleEndian32(record + 4);
+            pending.dst = readLittleEndian32(record + 8);
+            pending.processTime = static_cast<int>(readLittleEndian16(record + 12));
+            pending.jobType = static_cast<char>(record[14]);
+            hasPending = true;
+            break;
+        }
+
+        const char* start = data + cursor;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', length - cursor));
+        size_t size = newline ? static_cast<size_t>(newline - start) : length - cursor;
+        cursor += newline ? size + 1 : size;
+
+        std::string_view text(start, size);
+        if (!text.empty() && text.back() == '\r') {
+            text.remove_suffix(1);
+        }
+        if (text.find_first_not_of(" \t") == std::string_view::npos) {
+            continue;
+        }
+        if (parseJsonLine(text, pending)) {
+            hasPending = true;
+            break;
+        }
+        skipMalformed();
+    }
+
+    return hasPending;
+}
+
+/**
+ * @brief Parses a flat JSON object of string and integer values.
+ *
+ * @param text   One line of the trace.
+ * @param record Receives the decoded fields.
+ * @return @c true if @c tick, @c src, @c dst, @c time and @c type were all
+ *         present and in range and nothing follows the object.
+ */
+bool TraceReader::parseJsonLine(std::string_view text, TraceRecord& record) {
+    enum : unsigned { TICK = 1, SRC = 2, DST = 4, TIME = 8, TYPE = 16, ALL = 31 };
+    unsigned seen = 0;
+    size_t pos = 0;
+
+    skipSpace(text, pos);
+    if (pos >= text.size() || text[pos] != '{') {
+        return false;
+    }
+    pos++;
+
+    for (;;) {
+        std::string_view key;
+        skipSpace(text, pos);
+        if (pos >= text.size() || text[pos] != '"' || !parseString(text, pos, key)) {
+            return false;
+        }
+        skipSpace(text, pos);
+        if (pos >= text.size() || text[pos] != ':') {
+            return false;
+        }
+        pos++;
+        skipSpace(text, pos);
+        if (pos >= text.size()) {
+            return false;
+        }
+
+        std::string_view string;
+        long long number = 0;
+        bool isString = text[pos] == '"';
+        if (isString ? !parseString(text, pos, string) : !parseNumber(text, pos, number)) {
+            return false;
+        }
+
+        if (key == "tick") {
+            if (isString || number < 0 || number > INT_MAX) return false;
+            record.tick = static_cast<int>(number);
+            seen |= TICK;
+        } else if (key == "src" || key == "dst") {
+            unsigned int ip = 0;
+            if (isString) {
+                if (!Firewall::ipToUint(string, ip)) return false;
+            } else {
+                if (number < 0 || number > UINT32_MAX) return false;
+                ip = static_cast<unsigned int>(number);
+            }
+            if (key == "src") {
+                record.src = ip;
+                seen |= SRC;
+            } else {
+                record.dst = ip;
+                seen |= DST;
+            }
+        } else if (key == "time") {
+            if (isString || number < 0) return false;
+            record.processTime = number > INT_MAX ? INT_MAX : static_cast<int>(number);
+            seen |= TIME;
+        } else if (key == "type") {
+            if (!isString || string.size() != 1) return false;
+            record.jobType = string[0];
+            seen |= TYPE;
+        }
+
+        skipSpace(text, pos);
+        if (pos < text.size() && text[pos] == ',') {
+            pos++;
+        } else if (pos < text.size() && text[pos] == '}') {
+            pos++;
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    skipSpace(text, pos);
+    return pos == text.size() && seen == ALL;
+}
+
+/**
+ * @brief Counts one malformed record, warning for the first @c MAX_WARNINGS.
+ */
+void TraceReader::skipMalformed() {
+    malformed++;
+    if (!announce) {
+        return;
+    }
+    if (malformed <= MAX_WARNINGS) {
+        std::cerr << "[Trace] WARNING: malformed " << (binary ? "record " : "line ") << line
+                  << " in '" << path << "' — skipping." << std::endl;
+    }
+    if (malformed == MAX_WARNINGS) {
+        std::cerr << "[Trace] WARNING: further malformed records in '" << path << "' will be counted silently." << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the trace's size and format, then the reader's position.
+ * @param out Snapshot being written.
+ */
+void TraceReader::saveState(SnapshotWriter& out) const {
+    out.putTag("TRCE");
+    out.put(static_cast<uint64_t>(length));
+    out.put(binary);
+    out.put(static_cast<uint64_t>(cursor));
+    out.put(line);
+    out.put(pending);
+    out.put(hasPending);
+    out.put(replayed);
+    out.put(late);
+    out.put(malformed);
+}
+
+/**
+ * @brief Reads the values written by saveState() after checking they fit the open trace.
+ * @param in Snapshot being read.
+ * @return @c true on success.
+ */
+bool TraceReader::restoreState(SnapshotReader& in, int) {
+    uint64_t savedLength = 0;
+    bool savedBinary = false;
+    uint64_t savedCursor = 0;
+    if (!in.expectTag("TRCE") || !in.get(savedLength) || !in.get(savedBinary) || !in.get(savedCursor)
+        || savedLength != length || savedBinary != binary || savedCursor > length) {
+        return in.fail();
+    }
+    cursor = static_cast<size_t>(savedCursor);
+    return in.get(line) && in.get(pending) && in.get(hasPending) && in.get(replayed) && in.get(late)
+           && in.get(malformed);
+}
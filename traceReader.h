@@ -0,0 +1,162 @@
+/**
+ * @file traceReader.h
+ * @brief Declaration of the TraceReader class, which replays recorded traffic.
+ *
+ * @details TraceReader is a TrafficSource that streams requests from a
+ * trace file instead of synthesising them. The file is memory-mapped and
+ * parsed in place, one record at a time, as the simulation clock reaches
+ * it, so a capture of millions of requests costs no more memory than the
+ * mapping itself and is never copied into an intermediate container.
+ *
+ * Two formats are accepted, told apart by the first eight bytes:
+ *
+ * <b>JSONL</b> — one object per line with the keys @c tick, @c src,
+ * @c dst, @c time and @c type, in any order:
+ * @code
+ * {"tick": 12, "src": "203.0.113.5", "dst": "198.51.100.7", "time": 7, "type": "P"}
+ * @endcode
+ * Addresses may also be given as packed integers. Other keys with string
+ * or integer values are ignored; strings may not contain escapes. Blank
+ * lines are skipped.
+ *
+ * <b>Binary</b> — the magic @c "LBTRACE1" followed by 16-byte little-endian
+ * records:
+ * @code
+ * uint32 tick | uint32 src | uint32 dst | uint16 time | uint8 type | uint8 reserved
+ * @endcode
+ *
+ * Records are expected in non-decreasing tick order. A record whose tick
+ * has already passed is delivered on the next tick the Switch visits and
+ * counted as late. Malformed records are skipped with a warning.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef TRACEREADER_H
+#define TRACEREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "trafficSource.h"
+
+/**
+ * @class TraceReader
+ * @brief Streams arrivals from a memory-mapped JSONL or binary trace.
+ */
+class TraceReader : public TrafficSource {
+    public:
+        /**
+         * @brief Constructs a reader with no trace open; it yields no arrivals.
+         */
+        TraceReader();
+
+        /**
+         * @brief Unmaps the trace.
+         */
+        ~TraceReader() override;
+
+        TraceReader(const TraceReader&) = delete;
+        TraceReader& operator=(const TraceReader&) = delete;
+
+        /**
+         * @brief Maps a trace file and detects its format.
+         *
+         * @param path     Path of the trace file.
+         * @param announce Whether to print the "Replaying" line and warnings
+         *                 about malformed records; open failures are always reported.
+         * @return @c false (after printing a warning) if the file could not be
+         *         opened or mapped.
+         */
+        bool open(const std::string& path, bool announce = true);
+
+        int nextArrival(int from, int end) override;
+        void takeArrivals(int tick, std::vector<Request>& out) override;
+
+        /**
+         * @brief Logs how many records were replayed, late, malformed and unread.
+         * @param logger Logger receiving the report.
+         */
+        void report(Logger& logger) const override;
+
+        /**
+         * @brief Returns the number of requests delivered so far.
+         * @return Replayed request count.
+         */
+        uint64_t getReplayed() const;
+
+        /**
+         * @brief Returns the number of records skipped as malformed.
+         * @return Malformed record count.
+         */
+        uint64_t getMalformed() const;
+
+        /**
+         * @brief Writes the read position, the pending record and the counts.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const override;
+
+        /**
+         * @brief Resumes reading where the snapshot stopped.
+         * @param in        Snapshot being read.
+         * @param clockTime Unused; the trace's own ticks drive it.
+         * @return @c false if the snapshot was taken from a trace of another size or format.
+         */
+        bool restoreState(SnapshotReader& in, int clockTime) override;
+
+    private:
+        static constexpr size_t BINARY_RECORD_SIZE = 16;   ///< Bytes per binary record.
+        static constexpr uint64_t MAX_WARNINGS = 5;        ///< Malformed records reported individually.
+
+        /**
+         * @struct TraceRecord
+         * @brief One decoded trace entry.
+         */
+        struct TraceRecord {
+            int tick;          ///< Arrival tick.
+            uint32_t src;      ///< Packed source address.
+            uint32_t dst;      ///< Packed destination address.
+            int processTime;   ///< Processing time in cycles.
+            char jobType;      ///< Job-type byte.
+        };
+
+        std::string path;     ///< Path of the mapped file, for messages.
+        const char* data;     ///< Start of the mapping, or @c nullptr.
+        size_t length;        ///< Length of the mapping in bytes.
+        size_t cursor;        ///< Offset of the next unparsed byte.
+        bool binary;          ///< Whether the file is in the binary format.
+        bool announce;        ///< Whether to print progress and malformed-record warnings.
+        uint64_t line;        ///< Line (JSONL) or record (binary) number of @c pending.
+
+        TraceRecord pending;  ///< Next record to deliver.
+        bool hasPending;      ///< Whether @c pending holds a record.
+
+        uint64_t replayed;    ///< Requests delivered.
+        uint64_t late;        ///< Requests delivered after their tick.
+        uint64_t malformed;   ///< Records skipped.
+
+        /**
+         * @brief Decodes the next valid record into @c pending.
+         * @return @c false once the trace is exhausted.
+         */
+        bool readNext();
+
+        /**
+         * @brief Parses one JSONL object in place.
+         * @param text   Line without its terminator.
+         * @param record Receives the decoded fields.
+         * @return @c true if every required key was present and valid.
+         */
+        static bool parseJsonLine(std::string_view text, TraceRecord& record);
+
+        /**
+         * @brief Counts a malformed record and warns about the first few.
+         */
+        void skipMalformed();
+};
+
+#endif
@@ -0,0 +1,359 @@
+/**
+ * @file trafficGenerator.cpp
+ * @brief Implementation of the TrafficGenerator class.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#include "trafficGenerator.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <sstream>
+#include <utility>
+#include "utils.h"
+
+/**
+ * @brief Parses an arrival process name.
+ *
+ * @param name    Process name.
+ * @param process Receives the parsed process.
+ * @return @c true if recognised.
+ */
+bool parseArrivalProcess(const std::string& name, ArrivalProcess& process) {
+    if (name == "bernoulli")    process = ArrivalProcess::BERNOULLI;
+    else if (name == "poisson") process = ArrivalProcess::POISSON;
+    else if (name == "mmpp")    process = ArrivalProcess::MMPP;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Parses a process-time distribution name.
+ *
+ * @param name         Distribution name.
+ * @param distribution Receives the parsed distribution.
+ * @return @c true if recognised.
+ */
+bool parseServiceDistribution(const std::string& name, ServiceDistribution& distribution) {
+    if (name == "uniform")     distribution = ServiceDistribution::UNIFORM;
+    else if (name == "pareto") distribution = ServiceDistribution::PARETO;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Seeds the streams, derives the distribution constants and
+ *        schedules the first arrival.
+ *
+ * @param profile    Traffic parameters.
+ * @param jobClasses Job classes to draw from.
+ * @param seed       Seed of both streams.
+ */
+TrafficGenerator::TrafficGenerator(const TrafficProfile& profile, std::vector<char> jobClasses, uint64_t seed)
+    : profile(profile),
+      jobClasses(std::move(jobClasses)),
+      seed(seed),
+      arrivalRng(seed, 0),
+      requestRng(seed, 1),
+      arrivalChance(0.0),
+      gapLog(0.0),
+      paretoScale(1.0),
+      scheduledTick(-1),
+      scheduledCount(0),
+      steppedTo(0),
+      bursting(false)
+{
+    this->profile.maxBurst = std::max(this->profile.maxBurst, 1);
+    this->profile.maxProcessTime = std::max(this->profile.maxProcessTime, 1);
+    this->profile.paretoShape = std::max(this->profile.paretoShape, 1.01);
+
+    double shape = this->profile.paretoShape;
+    paretoScale = (this->profile.maxProcessTime + 1) / 2.0 * (shape - 1.0) / shape;
+
+    if (this->profile.arrivals == ArrivalProcess::BERNOULLI) {
+        arrivalChance = this->profile.burstProbability;
+    } else if (this->profile.arrivals == ArrivalProcess::POISSON) {
+        arrivalChance = this->profile.arrivalRate > 0.0 ? -std::expm1(-this->profile.arrivalRate) : 0.0;
+    }
+    if (arrivalChance > 0.0 && arrivalChance < 1.0) {
+        gapLog = std::log1p(-arrivalChance);
+    }
+
+    if (this->profile.arrivals != ArrivalProcess::MMPP) {
+        scheduleFrom(0);
+    }
+}
+
+/**
+ * @brief Returns the scheduled arrival tick, stepping the MMPP chain up to
+ *        @p end if no arrival is known yet.
+ *
+ * @param from First tick to consider.
+ * @param end  Exclusive upper bound.
+ * @return Arrival tick, or @p end.
+ */
+int TrafficGenerator::nextArrival(int from, int end) {
+    if (profile.arrivals == ArrivalProcess::MMPP) {
+        while (scheduledTick < 0 && steppedTo < end) {
+            stepMmpp();
+        }
+    }
+    if (scheduledTick < 0 || scheduledTick >= end) {
+        return end;
+    }
+    return scheduledTick > from ? scheduledTick : from;
+}
+
+/**
+ * @brief Generates the scheduled burst and schedules the one after it.
+ *
+ * @param tick Arrival tick returned by nextArrival().
+ * @param out  Receives the new requests.
+ */
+void TrafficGenerator::takeArrivals(int tick, std::vector<Request>& out) {
+    uint32_t classes = static_cast<uint32_t>(jobClasses.size());
+    for (int j = 0; j < scheduledCount; j++) {
+        out.push_back(makeRequest(jobClasses[requestRng.below(classes)]));
+    }
+
+    if (profile.arrivals == ArrivalProcess::MMPP) {
+        scheduledTick = -1;
+    } else {
+        scheduleFrom(tick + 1);
+    }
+}
+
+/**
+ * @brief Draws a request's processing time and both addresses.
+ * @param jobType Job class.
+ * @return New request.
+ */
+Request TrafficGenerator::makeRequest(char jobType) {
+    int processTime = drawProcessTime();
+    uint64_t addresses = requestRng.next();
+    return generateRequest(static_cast<uint32_t>(addresses >> 32), static_cast<uint32_t>(addresses),
+                           processTime, jobType);
+}
+
+/**
+ * @brief Describes the arrival process, process-time distribution and seed.
+ * @return Description for the log.
+ */
+std::string TrafficGenerator::describe() const {
+    std::ostringstream text;
+    switch (profile.arrivals) {
+        case ArrivalProcess::BERNOULLI:
+            text << "Bernoulli arrivals (burst chance " << profile.burstProbability
+                 << " per tick, 1-" << profile.maxBurst << " requests per burst)";
+            break;
+        case ArrivalProcess::POISSON:
+            text << "Poisson arrivals (mean " << profile.arrivalRate << " per tick)";
+            break;
+        case ArrivalProcess::MMPP:
+            text << "MMPP arrivals (mean " << profile.arrivalRate << " per tick calm, "
+                 << profile.burstRate << " bursting; mean spells " << profile.calmLength
+                 << " / " << profile.burstLength << " ticks)";
+            break;
+    }
+    if (profile.service == ServiceDistribution::UNIFORM) {
+        text << ", process time uniform in [1, " << profile.maxProcessTime << "]";
+    } else {
+        text << ", process time Pareto (shape " << profile.paretoShape << ", mean "
+             << (profile.maxProcessTime + 1) / 2.0 << ")";
+    }
+    text << ", seed " << seed;
+    return text.str();
+}
+
+/**
+ * @brief Draws the geometric gap to the next tick with arrivals, then its burst size.
+ *
+ * @details The number of empty ticks before a success of probability @c p
+ * is @c floor(log(U) / log(1 - p)) for U uniform in (0, 1]. Poisson bursts
+ * are conditioned on at least one arrival, since the gap already accounts
+ * for the empty ticks.
+ *
+ * @param tick First eligible tick.
+ */
+void TrafficGenerator::scheduleFrom(int tick) {
+    if (arrivalChance <= 0.0) {
+        scheduledTick = INT_MAX;
+        return;
+    }
+
+    double gap = 0.0;
+    if (arrivalChance < 1.0) {
+        gap = std::floor(std::log(arrivalRng.uniformPositive()) / gapLog);
+    }
+    if (gap >= static_cast<double>(INT_MAX - tick)) {
+        scheduledTick = INT_MAX;
+        return;
+    }
+    scheduledTick = tick + static_cast<int>(gap);
+
+    if (profile.arrivals == ArrivalProcess::BERNOULLI) {
+        scheduledCount = 1 + static_cast<int>(arrivalRng.below(static_cast<uint32_t>(profile.maxBurst)));
+    } else {
+        scheduledCount = poisson(profile.arrivalRate, true);
+    }
+}
+
+/**
+ * @brief Draws one tick's arrivals from the current MMPP state, then the
+ *        state transition.
+ *
+ * @details A spell of mean length @c L ends on each tick with probability
+ * @c 1/L, so spell lengths are geometric.
+ */
+void TrafficGenerator::stepMmpp() {
+    double rate = bursting ? profile.burstRate : profile.arrivalRate;
+    double length = bursting ? profile.burstLength : profile.calmLength;
+
+    int count = poisson(rate, false);
+    if (arrivalRng.uniform() * length < 1.0) {
+        bursting = !bursting;
+    }
+    if (count > 0) {
+        scheduledTick = steppedTo;
+        scheduledCount = count;
+    }
+    steppedTo++;
+}
+
+/**
+ * @brief Draws a Poisson variate from the arrival stream.
+ *
+ * @details Small means use inversion by sequential search; conditioning on
+ * a non-zero result starts the search above the mass at zero. Means of 30
+ * and above use Hörmann's transformed rejection (PTRS), whose cost does not
+ * grow with the mean; there the zero outcome is vanishingly rare and is
+ * simply redrawn.
+ *
+ * @param mean       Distribution mean.
+ * @param atLeastOne Whether to condition on a non-zero result.
+ * @return Variate.
+ */
+int TrafficGenerator::poisson(double mean, bool atLeastOne) {
+    if (mean <= 0.0) {
+        return atLeastOne ? 1 : 0;
+    }
+
+    if (mean < 30.0) {
+        double probability = std::exp(-mean);
+        double cdf = probability;
+        double u = arrivalRng.uniform();
+        if (atLeastOne) {
+            u = probability + u * (1.0 - probability);
+        }
+        int k = 0;
+        while (u >= cdf && probability > 0.0) {
+            k++;
+            probability *= mean / k;
+            cdf += probability;
+        }
+        return k;
+    }
+
+    double root = std::sqrt(mean);
+    double logMean = std::log(mean);
+    double b = 0.931 + 2.53 * root;
+    double a = -0.059 + 0.02483 * b;
+    double invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+    double vr = 0.9277 - 3.6224 / (b - 2.0);
+
+    for (;;) {
+        double u = arrivalRng.uniform() - 0.5;
+        double v = arrivalRng.uniform();
+        double us = 0.5 - std::fabs(u);
+        double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+
+        bool accept = us >= 0.07 && v <= vr;
+        if (!accept) {
+            if (k < 0.0 || (us < 0.013 && v > us)) {
+                continue;
+            }
+            accept = std::log(v) + std::log(invAlpha) - std::log(a / (us * us) + b)
+                     <= -mean + k * logMean - std::lgamma(k + 1.0);
+        }
+        if (accept && (k >= 1.0 || !atLeastOne)) {
+            return k < INT_MAX ? static_cast<int>(k) : INT_MAX;
+        }
+    }
+}
+
+/**
+ * @brief Draws a processing time.
+ *
+ * @details Uniform times use an unbiased bounded draw. Pareto times are
+ * @c scale / U^(1/shape), rounded and capped at the largest time a Request
+ * can hold.
+ *
+ * @return Processing time in cycles.
+ */
+int TrafficGenerator::drawProcessTime() {
+    if (profile.service == ServiceDistribution::UNIFORM) {
+        return 1 + static_cast<int>(requestRng.below(static_cast<uint32_t>(profile.maxProcessTime)));
+    }
+
+    double time = paretoScale / std::pow(requestRng.uniformPositive(), 1.0 / profile.paretoShape);
+    if (time >= UINT16_MAX) {
+        return UINT16_MAX;
+    }
+    return std::max(1, static_cast<int>(std::lround(time)));
+}
+
+/**
+ * @brief Writes the stream state and the pending burst.
+ * @param out Snapshot being written.
+ */
+void TrafficGenerator::saveState(SnapshotWriter& out) const {
+    out.putTag("TGEN");
+    out.put(seed);
+    out.putString(describe());
+    out.put(arrivalRng);
+    out.put(requestRng);
+    out.put(scheduledTick);
+    out.put(scheduledCount);
+    out.put(steppedTo);
+    out.put(bursting);
+}
+
+/**
+ * @brief Reads the values written by saveState(), keeping them only if the
+ *        seed and profile match.
+ * @param in        Snapshot being read.
+ * @param clockTime Tick the restored run resumes at.
+ * @return @c true on success.
+ */
+bool TrafficGenerator::restoreState(SnapshotReader& in, int clockTime) {
+    uint64_t savedSeed = 0;
+    std::string savedProfile;
+    Rng savedArrivals;
+    Rng savedRequests;
+    int savedTick = 0;
+    int savedCount = 0;
+    int savedStep = 0;
+    bool savedBursting = false;
+    if (!in.expectTag("TGEN") || !in.get(savedSeed) || !in.getString(savedProfile) || !in.get(savedArrivals)
+        || !in.get(savedRequests) || !in.get(savedTick) || !in.get(savedCount) || !in.get(savedStep)
+        || !in.get(savedBursting)) {
+        return in.fail();
+    }
+
+    if (savedSeed == seed && savedProfile == describe()) {
+        arrivalRng = savedArrivals;
+        requestRng = savedRequests;
+        scheduledTick = savedTick;
+        scheduledCount = savedCount;
+        steppedTo = savedStep;
+        bursting = savedBursting;
+    } else if (profile.arrivals == ArrivalProcess::MMPP) {
+        scheduledTick = -1;
+        steppedTo = clockTime;
+    } else {
+        scheduleFrom(clockTime);
+    }
+    return true;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file trafficGenerator.h
+ * @brief Declaration of the TrafficGenerator class and its traffic profile.
+ *
+ * @details TrafficGenerator is the synthetic TrafficSource. Arrivals and
+ * request attributes are drawn from two independent Rng streams of one
+ * seed, so a run is reproducible from its seed, and changing how requests
+ * look (process times, job classes) does not move when they arrive.
+ *
+ * Three arrival processes are available (see ArrivalProcess):
+ *  - **Bernoulli** (default): on each tick a burst arrives with a fixed
+ *    probability, its size uniform in [1, @c maxBurst]; by default one tick
+ *    in five and 1–40 requests, the simulation's original traffic.
+ *  - **Poisson**: the number of arrivals per tick is Poisson distributed.
+ *  - **MMPP**: a two-state Markov-modulated Poisson process that alternates
+ *    between a calm and a bursty rate, with geometrically distributed
+ *    spells in each.
+ *
+ * The gap to the next Bernoulli or Poisson arrival is drawn directly from
+ * the geometric distribution, so idle ticks cost nothing and the
+ * event-driven engine can jump over them. Only MMPP steps its modulating
+ * chain tick by tick. Either way the draws do not depend on how the Switch
+ * visits the ticks, so both engines see identical traffic.
+ *
+ * Process times are uniform in [1, @c maxProcessTime] or heavy-tailed
+ * Pareto, scaled to the same mean (see ServiceDistribution).
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "request.h"
+#include "rng.h"
+#include "trafficSource.h"
+
+/**
+ * @enum ArrivalProcess
+ * @brief How arrival ticks and burst sizes are drawn.
+ */
+enum class ArrivalProcess {
+    BERNOULLI,  ///< A uniform-sized burst on each tick with fixed probability.
+    POISSON,    ///< Poisson-distributed arrivals per tick.
+    MMPP        ///< Poisson arrivals whose rate switches between a calm and a burst state.
+};
+
+/**
+ * @enum ServiceDistribution
+ * @brief How request processing times are drawn.
+ */
+enum class ServiceDistribution {
+    UNIFORM,  ///< Uniform in [1, maxProcessTime].
+    PARETO    ///< Pareto with the uniform distribution's mean and a configurable tail.
+};
+
+/**
+ * @brief Converts an arrival process name to an ArrivalProcess.
+ *
+ * @param name    Process name: @c "bernoulli", @c "poisson" or @c "mmpp".
+ * @param process Receives the parsed process on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseArrivalProcess(const std::string& name, ArrivalProcess& process);
+
+/**
+ * @brief Converts a distribution name to a ServiceDistribution.
+ *
+ * @param name         Distribution name: @c "uniform" or @c "pareto".
+ * @param distribution Receives the parsed distribution on success.
+ * @return @c true if @p name was recognised.
+ */
+bool parseServiceDistribution(const std::string& name, ServiceDistribution& distribution);
+
+/**
+ * @struct TrafficProfile
+ * @brief Parameters of a TrafficGenerator.
+ *
+ * @details The defaults reproduce the original traffic model. The default
+ * Poisson rate matches its mean load of 0.2 x 20.5 requests per tick.
+ */
+struct TrafficProfile {
+    ArrivalProcess arrivals = ArrivalProcess::BERNOULLI; ///< Arrival process.
+    double burstProbability = 0.2;  ///< Bernoulli: chance of a burst on each tick.
+    int maxBurst = 40;              ///< Bernoulli: bursts are uniform in [1, maxBurst].
+    double arrivalRate = 4.1;       ///< Poisson mean per tick; MMPP calm-state mean.
+    double burstRate = 20.5;        ///< MMPP burst-state mean per tick.
+    double calmLength = 180.0;      ///< MMPP mean ticks per calm spell.
+    double burstLength = 20.0;      ///< MMPP mean ticks per burst spell.
+
+    ServiceDistribution service = ServiceDistribution::UNIFORM; ///< Process-time distribution.
+    int maxProcessTime = 10;        ///< Uniform upper bound; also fixes the Pareto mean.
+    double paretoShape = 1.5;       ///< Pareto tail index; smaller is heavier (must exceed 1).
+};
+
+/**
+ * @class TrafficGenerator
+ * @brief Seeded synthetic TrafficSource with configurable arrival and service distributions.
+ */
+class TrafficGenerator : public TrafficSource {
+    public:
+        /**
+         * @brief Constructs a generator and schedules its first arrival.
+         *
+         * @details Out-of-range parameters are clamped: burst sizes and
+         * process times to at least 1, and the Pareto shape to at least 1.01.
+         *
+         * @param profile    Distributions and their parameters.
+         * @param jobClasses Job classes to draw from uniformly; must not be empty.
+         * @param seed       Seed of both random streams.
+         */
+        TrafficGenerator(const TrafficProfile& profile, std::vector<char> jobClasses, uint64_t seed);
+
+        int nextArrival(int from, int end) override;
+        void takeArrivals(int tick, std::vector<Request>& out) override;
+
+        /**
+         * @brief Draws one request of the given class.
+         *
+         * @details Source and destination addresses come from a single 64-bit
+         * draw; the processing time follows the profile.
+         *
+         * @param jobType Job class of the request.
+         * @return New request.
+         */
+        Request makeRequest(char jobType);
+
+        /**
+         * @brief Summarises the profile for the log.
+         * @return One-line description including the seed.
+         */
+        std::string describe() const;
+
+        /**
+         * @brief Writes the seed, profile, both random streams and the next burst.
+         * @param out Snapshot being written.
+         */
+        void saveState(SnapshotWriter& out) const override;
+
+        /**
+         * @brief Resumes both random streams where the snapshot left them.
+         *
+         * @details If the snapshot was taken with another seed or profile, the
+         * generator keeps its own streams and schedules its first burst from
+         * @p clockTime, so a fork can explore different traffic from the same
+         * starting state.
+         *
+         * @param in        Snapshot being read.
+         * @param clockTime Tick the restored run resumes at.
+         * @return @c false if the snapshot is malformed.
+         */
+        bool restoreState(SnapshotReader& in, int clockTime) override;
+
+    private:
+        TrafficProfile profile;       ///< Distributions in use.
+        std::vector<char> jobClasses; ///< Classes drawn uniformly for each request.
+        uint64_t seed;                ///< Seed of both streams.
+        Rng arrivalRng;               ///< Stream 0: arrival ticks and burst sizes.
+        Rng requestRng;               ///< Stream 1: job classes, process times and addresses.
+
+        double arrivalChance;  ///< Bernoulli/Poisson: probability that a tick has arrivals.
+        double gapLog;         ///< log(1 - arrivalChance), the geometric gap's denominator.
+        double paretoScale;    ///< Pareto minimum giving the uniform distribution's mean.
+        int scheduledTick;     ///< Next arrival tick; -1 while MMPP is still searching.
+        int scheduledCount;    ///< Requests arriving on @c scheduledTick.
+        int steppedTo;         ///< MMPP: first tick whose chain step has not been drawn.
+        bool bursting;         ///< MMPP: whether the chain is in the burst state.
+
+        /**
+         * @brief Schedules the first Bernoulli or Poisson arrival at or after @p tick.
+         * @param tick First eligible tick.
+         */
+        void scheduleFrom(int tick);
+
+        /**
+         * @brief Draws one tick of the MMPP chain at @c steppedTo.
+         */
+        void stepMmpp();
+
+        /**
+         * @brief Draws a Poisson variate.
+         *
+         * @param mean       Distribution mean.
+         * @param atLeastOne Whether to condition on a non-zero result.
+         * @return Variate.
+         */
+        int poisson(double mean, bool atLeastOne);
+
+        /**
+         * @brief Draws a processing time from the profile's distribution.
+         * @return Processing time, at least 1.
+         */
+        int drawProcessTime();
+};
+
+#endif
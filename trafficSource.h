@@ -0,0 +1,76 @@
+/**
+ * @file trafficSource.h
+ * @brief Declaration of the TrafficSource interface.
+ *
+ * @details A TrafficSource supplies the requests that reach the Switch on
+ * each clock tick. The Switch asks it for the next tick with arrivals, so
+ * the event-driven engine can jump straight there, and then collects that
+ * tick's burst. TrafficGenerator (see trafficGenerator.h) is the synthetic
+ * default; TraceReader (see traceReader.h) replays a recorded trace instead.
+ *
+ * @author Load Balancer Project
+ * @date 2025
+ */
+
+#ifndef TRAFFICSOURCE_H
+#define TRAFFICSOURCE_H
+
+#include <vector>
+#include "request.h"
+#include "logger.h"
+#include "snapshot.h"
+
+/**
+ * @class TrafficSource
+ * @brief Interface for anything that feeds arrivals to the Switch.
+ *
+ * @details Ticks are visited in increasing order. For each tick @c t the
+ * Switch calls nextArrival() with @c from <= t and, if it returned @c t,
+ * takeArrivals(t) exactly once.
+ */
+class TrafficSource {
+    public:
+        virtual ~TrafficSource() = default;
+
+        /**
+         * @brief Returns the first tick in [@p from, @p end) with arrivals.
+         *
+         * @details May consume source state (random draws, trace records)
+         * for the ticks it skips, but not for the tick it returns.
+         *
+         * @param from First tick to consider.
+         * @param end  Exclusive upper bound.
+         * @return Arrival tick, or @p end if there is none before it.
+         */
+        virtual int nextArrival(int from, int end) = 0;
+
+        /**
+         * @brief Appends the burst arriving on @p tick.
+         * @param tick Tick last returned by nextArrival().
+         * @param out  Receives the new, unfiltered requests.
+         */
+        virtual void takeArrivals(int tick, std::vector<Request>& out) = 0;
+
+        /**
+         * @brief Logs end-of-run statistics about the source, if it has any.
+         * @param logger Logger receiving the report.
+         */
+        virtual void report(Logger& logger) const { (void)logger; }
+
+        /**
+         * @brief Writes the source's position to @p out.
+         * @param out Snapshot being written.
+         */
+        virtual void saveState(SnapshotWriter& out) const { (void)out; }
+
+        /**
+         * @brief Resumes from the position read from @p in.
+         *
+         * @param in        Snapshot positioned where saveState() wrote.
+         * @param clockTime Tick the restored run resumes at.
+         * @return @c false if the snapshot does not fit this source.
+         */
+        virtual bool restoreState(SnapshotReader& in, int clockTime) { (void)in; (void)clockTime; return true; }
+};
+
+#endif
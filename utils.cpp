@@ -12,13 +12,49 @@
  * @brief Creates and returns a new Request with the given parameters.
  *
  * @details Delegates directly to the Request parameterized constructor.
- * Source and destination IP addresses are randomly generated inside
- * the Request constructor.
  *
+ * @param IPin        Packed source address.
+ * @param IPout       Packed destination address.
  * @param processTime The number of clock cycles the request will take to process.
  * @param jobType     The job category identifier ('P' or 'S').
  * @return A new Request object ready to be queued.
  */
-Request generateRequest(int processTime, char jobType) {
-    return Request(processTime, jobType);
+Request generateRequest(uint32_t IPin, uint32_t IPout, int processTime, char jobType) {
+    return Request(IPin, IPout, processTime, jobType);
+}
+
+/**
+ * @brief Renders a packed IPv4 address in dotted-decimal form.
+ *
+ * @details Writes the four octets into a fixed stack buffer before building
+ * the result, so the only allocation is the returned string itself.
+ *
+ * @param ip Address packed into 32 bits, MSB = first octet.
+ * @return The dotted-decimal representation of @p ip.
+ */
+std::string formatIP(uint32_t ip) {
+    char buf[16];
+    char* out = buf;
+
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        unsigned int octet = (ip >> shift) & 0xFFu;
+        if (octet >= 100) *out++ = static_cast<char>('0' + octet / 100);
+        if (octet >= 10)  *out++ = static_cast<char>('0' + (octet / 10) % 10);
+        *out++ = static_cast<char>('0' + octet % 10);
+        if (shift > 0) *out++ = '.';
+    }
+
+    return std::string(buf, out);
+}
+
+/**
+ * @brief Names a job class for logs and summaries.
+ *
+ * @param jobClass Job-type byte.
+ * @return Human-readable class name.
+ */
+std::string jobClassName(char jobClass) {
+    if (jobClass == 'P') return "Processing";
+    if (jobClass == 'S') return "Streaming";
+    return std::string("Class ") + jobClass;
 }
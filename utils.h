@@ -4,7 +4,8 @@
  *
  * @details Declares helper functions used across multiple translation units
  * in the load balancer system. Currently exposes a factory function for
- * creating Request objects.
+ * creating Request objects, a formatter for packed IPv4 addresses, and the
+ * display names of job classes.
  *
  * @author Load Balancer Project
  * @date 2025
@@ -13,6 +14,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdint>
+#include <string>
 #include "request.h"
 
 // Define codes for colors and resetting
@@ -28,12 +31,34 @@
  *
  * @details Provides a centralized way to create Request objects outside
  * of the Request class itself, supporting cleaner separation of concerns
- * between the Switch/LoadBalancer and the Request data model.
+ * between the traffic sources and the Request data model.
  *
+ * @param IPin        Packed source address.
+ * @param IPout       Packed destination address.
  * @param processTime The number of clock cycles needed to process the request.
  * @param jobType     The job category ('P' for primary, 'S' for secondary).
  * @return A fully initialized Request object.
  */
-Request generateRequest(int processTime, char jobType);
+Request generateRequest(uint32_t IPin, uint32_t IPout, int processTime, char jobType);
+
+/**
+ * @brief Renders a packed IPv4 address in dotted-decimal form.
+ *
+ * @details Only intended for the logging edge; requests carry their
+ * addresses packed and are never converted back to text on the hot path.
+ *
+ * @param ip Address packed into 32 bits, MSB = first octet.
+ * @return A string such as @c "192.168.1.1".
+ */
+std::string formatIP(uint32_t ip);
+
+/**
+ * @brief Returns the display name of a job class.
+ *
+ * @param jobClass Job-type byte.
+ * @return @c "Processing" for 'P', @c "Streaming" for 'S', otherwise
+ *         @c "Class X" where X is @p jobClass.
+ */
+std::string jobClassName(char jobClass);
 
 #endif
@@ -20,6 +20,28 @@ WebServer::WebServer(int id) {
     this->id = id;
     this->isAvailable = true;
     this->timeRemaining = 0;
+    this->address = 0;
+    this->port = 0;
+    this->healthy = true;
+    this->inFlight = 0;
+}
+
+/**
+ * @brief Constructs a WebServer already processing @p request.
+ *
+ * @param id            Unique integer identifier for this server.
+ * @param request       Request in progress.
+ * @param timeRemaining Cycles left; the server is idle if this is not positive.
+ */
+WebServer::WebServer(int id, const Request& request, int timeRemaining) {
+    this->id = id;
+    this->currentRequest = request;
+    this->timeRemaining = timeRemaining;
+    this->isAvailable = timeRemaining <= 0;
+    this->address = 0;
+    this->port = 0;
+    this->healthy = true;
+    this->inFlight = 0;
 }
 
 /**
@@ -52,6 +74,14 @@ void WebServer::update() {
     }
 }
 
+/**
+ * @brief Completes the current request without waiting for the timer.
+ */
+void WebServer::finish() {
+    isAvailable = true;
+    timeRemaining = 0;
+}
+
 /**
  * @brief Returns whether the server is idle and ready for a new request.
  * @return @c true if isAvailable is set; @c false otherwise.
@@ -67,3 +97,85 @@ bool WebServer::isReady() const {
 int WebServer::getId() const {
     return id;
 }
+
+/**
+ * @brief Returns the request most recently assigned to this server.
+ * @return Reference to the stored request.
+ */
+const Request& WebServer::getCurrentRequest() const {
+    return currentRequest;
+}
+
+/**
+ * @brief Returns the cycles left on the current request.
+ * @return Remaining processing time.
+ */
+int WebServer::getTimeRemaining() const {
+    return timeRemaining;
+}
+
+/**
+ * @brief Sets the backend address and port.
+ * @param address Packed IPv4 address.
+ * @param port    TCP port.
+ */
+void WebServer::setBackend(uint32_t address, uint16_t port) {
+    this->address = address;
+    this->port = port;
+}
+
+/**
+ * @brief Returns the backend address.
+ * @return Packed IPv4 address.
+ */
+uint32_t WebServer::getAddress() const {
+    return address;
+}
+
+/**
+ * @brief Returns the backend port.
+ * @return TCP port.
+ */
+uint16_t WebServer::getPort() const {
+    return port;
+}
+
+/**
+ * @brief Updates the health flag.
+ * @param healthy New state.
+ */
+void WebServer::setHealthy(bool healthy) {
+    this->healthy = healthy;
+}
+
+/**
+ * @brief Returns the health flag.
+ * @return @c healthy.
+ */
+bool WebServer::isHealthy() const {
+    return healthy;
+}
+
+/**
+ * @brief Increments the in-flight connection count.
+ */
+void WebServer::openConnection() {
+    inFlight++;
+}
+
+/**
+ * @brief Decrements the in-flight connection count.
+ */
+void WebServer::closeConnection() {
+    if (inFlight > 0) {
+        inFlight--;
+    }
+}
+
+/**
+ * @brief Returns the in-flight connection count.
+ * @return @c inFlight.
+ */
+int WebServer::getInFlight() const {
+    return inFlight;
+}
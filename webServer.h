@@ -8,6 +8,10 @@
  * cycle, a busy server decrements its remaining processing time until it
  * becomes available again.
  *
+ * The same class also serves as the handle of a real backend behind the
+ * NetworkFrontend: setBackend() gives it an address, and the front end keeps
+ * its health and the number of connections it is proxying up to date.
+ *
  * @author Load Balancer Project
  * @date 2025
  */
@@ -15,6 +19,7 @@
 #ifndef WEBSERVER_H
 #define WEBSERVER_H
 
+#include <cstdint>
 #include "request.h"
 
 /**
@@ -36,6 +41,18 @@ class WebServer {
          */
         WebServer(int id);
 
+        /**
+         * @brief Constructs a WebServer that is partway through a request.
+         *
+         * @details Used by ServerPool::view() to present one slot of the pool
+         * as a WebServer. A @p timeRemaining of zero or less yields an idle server.
+         *
+         * @param id            Unique server identifier.
+         * @param request       Request being processed.
+         * @param timeRemaining Clock cycles left on @p request.
+         */
+        WebServer(int id, const Request& request, int timeRemaining);
+
         /**
          * @brief Assigns a request to this server and marks it as busy.
          *
@@ -54,6 +71,15 @@ class WebServer {
          */
         void update();
 
+        /**
+         * @brief Ends the current request immediately and marks the server available.
+         *
+         * @details Used by the LoadBalancer's completion wheel, which knows in
+         * advance the tick on which each request finishes and so does not need
+         * to call update() on every busy server every cycle.
+         */
+        void finish();
+
         /**
          * @brief Checks whether the server is available to accept a new request.
          * @return @c true if the server is idle; @c false if it is still processing.
@@ -66,11 +92,74 @@ class WebServer {
          */
         int getId() const;
 
+        /**
+         * @brief Returns the request most recently assigned to this server.
+         * @return The current (or last completed) request.
+         */
+        const Request& getCurrentRequest() const;
+
+        /**
+         * @brief Returns the clock cycles left on the current request.
+         * @return Remaining cycles; zero or less when the server is idle.
+         */
+        int getTimeRemaining() const;
+
+        /**
+         * @brief Points this server at a real backend.
+         * @param address Packed IPv4 address.
+         * @param port    TCP port.
+         */
+        void setBackend(uint32_t address, uint16_t port);
+
+        /**
+         * @brief Returns the backend's packed IPv4 address.
+         * @return Address, or 0 for a simulated server.
+         */
+        uint32_t getAddress() const;
+
+        /**
+         * @brief Returns the backend's TCP port.
+         * @return Port, or 0 for a simulated server.
+         */
+        uint16_t getPort() const;
+
+        /**
+         * @brief Records whether the last connection attempt to the backend succeeded.
+         * @param healthy @c false after a failed connect, @c true after a successful one.
+         */
+        void setHealthy(bool healthy);
+
+        /**
+         * @brief Reports whether the backend is believed to be up.
+         * @return @c true until a connection to it fails.
+         */
+        bool isHealthy() const;
+
+        /**
+         * @brief Counts one more connection proxied to the backend.
+         */
+        void openConnection();
+
+        /**
+         * @brief Counts one connection to the backend as finished.
+         */
+        void closeConnection();
+
+        /**
+         * @brief Returns the number of connections currently proxied to the backend.
+         * @return Open connection count.
+         */
+        int getInFlight() const;
+
     private:
         int id;                  ///< Unique server identifier.
         bool isAvailable;        ///< True when the server is idle and ready for work.
         Request currentRequest;  ///< The request currently being processed.
         int timeRemaining;       ///< Clock cycles remaining to finish current request.
+        uint32_t address;        ///< Backend address (packed), or 0 when simulated.
+        uint16_t port;           ///< Backend port, or 0 when simulated.
+        bool healthy;            ///< Whether the backend accepted its last connection.
+        int inFlight;            ///< Connections currently proxied to the backend.
 };
 
 #endif